@@ -16,3 +16,8 @@ package(
 
 # Backwards-compatible uasyncio module.
 module("uasyncio.py", opt=3)
+
+# The io_uring event loop, which needs the _uring module of the unix port.
+options.defaults(uring=False)
+if options.uring:
+    package("asyncio", ("uring.py",), base_path="..", opt=3)
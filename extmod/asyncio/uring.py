@@ -0,0 +1,300 @@
+# MicroPython asyncio module, io_uring backend
+# MIT license; Copyright (c) 2026 MicroPython contributors
+
+from . import core
+from .event import ThreadSafeFlag
+from .stream import Stream, Server
+from select import POLLIN, POLLOUT
+from _uring import Ring
+
+
+# Queue for stream IO that uses io_uring.  Reads, writes and accepts on sockets
+# are done by the kernel, which then resumes the waiting task with the result,
+# and other streams with a file descriptor are polled by the kernel.  Many such
+# operations are submitted, and their results collected, with one system call.
+# Streams without a file descriptor are left to a core.IOQueue.
+class IOQueue:
+    def __init__(self, entries):
+        self.ring = Ring(entries)
+        self.pq = core.IOQueue()
+        # Maps op to [task, result, None, stream, buf] for ops on the ring,
+        # see wait_op.  This is shared with self.pq, which maps id(stream) to
+        # [task_waiting_read, task_waiting_write, stream]; ids are addresses so
+        # never clash with ops, which are small ints.
+        self.map = self.pq.map
+        self.nops = 0
+
+    def _add(self, op, s=None, buf=None):
+        entry = [core.cur_task, None, None, s, buf]
+        self.map[op] = entry
+        self.nops += 1
+        # Link task to this IOQueue so it can be removed if needed
+        core.cur_task.data = self
+        return entry
+
+    def _queue_poll(self, s, ev, idx):
+        op = self.ring.poll(s, ev)
+        if op is None:
+            self.pq._enqueue(s, idx)
+        else:
+            self._add(op)
+
+    def queue_read(self, s):
+        self._queue_poll(s, POLLIN, 0)
+
+    def queue_write(self, s):
+        self._queue_poll(s, POLLOUT, 1)
+
+    # Wait for an op started on self.ring, and return its result.  For a read, s
+    # is the Stream and buf is the buffer passed to Ring.readinto, if any, so the
+    # data can be kept if the task is cancelled after the kernel received it.
+    # async
+    def wait_op(self, op, s=None, buf=None):
+        entry = self._add(op, s, buf)
+        try:
+            yield
+        except core.CancelledError:
+            if entry[1] is not None:
+                # The op completed but the task was cancelled before it resumed.
+                self._keep(entry, entry[1])
+            raise
+        res = entry[1]
+        if isinstance(res, int) and res < 0:
+            raise OSError(-res)
+        return res
+
+    def remove(self, task):
+        for op in self.map:  # Iterate without allocating on the heap
+            entry = self.map[op]
+            if entry[0] is task and entry[2] is None:
+                # The entry is removed when the cancelled op completes
+                self.ring.cancel(op)
+                entry[0] = None
+                break
+
+    # Keep the result of an op whose task was cancelled: data received by a read
+    # is kept in the Stream for its next read, and an accepted socket is closed.
+    def _keep(self, entry, res):
+        if isinstance(res, tuple):
+            res[0].close()
+        elif entry[3] is not None and (isinstance(res, bytes) or res > 0):
+            entry[3].in_buf += res if entry[4] is None else entry[4][:res]
+
+    def _reap(self, dt):
+        for op, res in self.ring.wait(dt):
+            entry = self.map.pop(op)
+            self.nops -= 1
+            if entry[0] is None:
+                self._keep(entry, res)
+            else:
+                entry[1] = res
+                core._task_queue.push(entry[0])
+
+    # Whether every stream without a file descriptor is a ThreadSafeFlag, which
+    # wakes the ring when it's set.
+    def _pq_wakes(self):
+        for k in self.map:  # Iterate without allocating on the heap
+            s = self.map[k][2]
+            if s is not None and not isinstance(s, ThreadSafeFlag):
+                return False
+        return True
+
+    def wait_io_event(self, dt):
+        if len(self.map) > self.nops:
+            # Streams without a file descriptor are checked after waiting on the
+            # ring.  Other than ThreadSafeFlag they can only be polled, so then
+            # the wait is kept short, as select.poll does.
+            if (dt < 0 or dt > 1) and not self._pq_wakes():
+                dt = 1
+            self._reap(dt)
+            self.pq.wait_io_event(0)
+        else:
+            self._reap(dt)
+
+
+################################################################################
+# Stream methods used with this event loop
+
+# The poll-based methods, which are used when another event loop is running.
+_read = Stream.read
+_readexactly = Stream.readexactly
+_readline = Stream.readline
+_drain = Stream.drain
+_serve = Server._serve
+
+
+# Return up to n bytes (all if n < 0) of s.in_buf, which holds data that the
+# ring received for a read that was then cancelled.
+def _take(s, n):
+    r = s.in_buf
+    if n < 0 or n >= len(r):
+        s.in_buf = b""
+        return r
+    s.in_buf = r[n:]
+    return r[:n]
+
+
+def _take_into(s, buf):
+    r = _take(s, len(buf))
+    buf[: len(r)] = r
+    return len(r)
+
+
+# Wait for the result of a read op on the ring.
+# async
+def _read_op(s, q, op, n):
+    r = yield from q.wait_op(op, s)
+    if s.in_buf:
+        # Data kept from a cancelled read was received first.
+        s.in_buf += r
+        r = _take(s, n)
+    return r
+
+
+# async
+def stream_read(self, n=-1):
+    if self.in_buf:
+        if n >= 0:
+            return _take(self, n)
+        return _take(self, -1) + (yield from _read(self, n))
+    q = core._io_queue
+    if n >= 0 and type(q) is IOQueue:
+        op = q.ring.read(self.s, n)
+        if op is not None:
+            return (yield from _read_op(self, q, op, n))
+    return (yield from _read(self, n))
+
+
+# async
+def stream_readinto(self, buf):
+    if self.in_buf:
+        return _take_into(self, buf)
+    q = core._io_queue
+    op = q.ring.readinto(self.s, buf) if type(q) is IOQueue else None
+    if op is None:
+        yield q.queue_read(self.s)
+        return self.s.readinto(buf)
+    n = yield from q.wait_op(op, self, buf)
+    if self.in_buf:
+        # Data kept from a cancelled read was received first.
+        self.in_buf += buf[:n]
+        n = _take_into(self, buf)
+    return n
+
+
+# async
+def stream_readexactly(self, n):
+    r = _take(self, n)
+    n -= len(r)
+    q = core._io_queue
+    if type(q) is not IOQueue:
+        return r + (yield from _readexactly(self, n))
+    while n:
+        op = q.ring.read(self.s, n)
+        if op is not None:
+            r2 = yield from _read_op(self, q, op, n)
+        else:
+            yield q.queue_read(self.s)
+            r2 = self.s.read(n)
+        if r2 is not None:
+            if not len(r2):
+                raise EOFError
+            r += r2
+            n -= len(r2)
+    return r
+
+
+# async
+def stream_readline(self):
+    if self.in_buf:
+        # Data kept from a cancelled read comes first.
+        i = self.in_buf.find(b"\n") + 1
+        l = _take(self, i or -1)
+        if i:
+            return l
+        return l + (yield from _readline(self))
+    return (yield from _readline(self))
+
+
+# async
+def stream_drain(self):
+    q = core._io_queue
+    if not self.out_buf or type(q) is not IOQueue:
+        return (yield from _drain(self))
+    mv = memoryview(self.out_buf)
+    off = 0
+    while off < len(mv):
+        op = q.ring.write(self.s, mv[off:])
+        if op is not None:
+            ret = yield from q.wait_op(op)
+        else:
+            yield q.queue_write(self.s)
+            ret = self.s.write(mv[off:])
+        if ret is not None:
+            off += ret
+    self.out_buf = b""
+
+
+async def server_serve(self, s, cb, ssl):
+    q = core._io_queue
+    if type(q) is not IOQueue:
+        return await _serve(self, s, cb, ssl)
+    self.state = False
+    # Accept incoming connections
+    while True:
+        op = q.ring.accept(s)
+        try:
+            if op is not None:
+                s2, addr = await q.wait_op(op)
+            else:
+                yield q.queue_read(s)
+                s2, addr = s.accept()
+        except core.CancelledError as er:
+            # The server task was cancelled, shutdown server and close socket.
+            s.close()
+            if self.state:
+                # If the server was explicitly closed, ignore the cancellation.
+                return
+            else:
+                # Otherwise e.g. the parent task was cancelled, propagate
+                # cancellation.
+                raise er
+        except:
+            # Ignore a failed accept
+            continue
+        if ssl:
+            try:
+                s2 = ssl.wrap_socket(s2, server_side=True, do_handshake_on_connect=False)
+            except OSError as e:
+                core.sys.print_exception(e)
+                s2.close()
+                continue
+        s2.setblocking(False)
+        s2s = Stream(s2, {"peername": addr})
+        core.create_task(cb(s2s, s2s))
+
+
+def flag_set(self):
+    self.state = 1
+    q = core._io_queue
+    if type(q) is IOQueue:
+        # End a wait on the ring, which doesn't poll the flag.
+        q.ring.notify()
+
+
+# Replace the event loop with one that does stream IO with io_uring.  Raises
+# OSError if the kernel doesn't support it.
+def new_event_loop(entries=256):
+    core.new_event_loop()
+    core._io_queue = IOQueue(entries)
+    # The methods fall back to the poll-based ones if the event loop is
+    # replaced again, so they are left in place after that.
+    Stream.in_buf = b""
+    Stream.read = stream_read
+    Stream.readinto = stream_readinto
+    Stream.readexactly = stream_readexactly
+    Stream.readline = stream_readline
+    Stream.drain = stream_drain
+    Server._serve = server_serve
+    ThreadSafeFlag.set = flag_set
+    return core.Loop
@@ -0,0 +1,69 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_EXTMOD_CPU_X64_H
+#define MICROPY_INCLUDED_EXTMOD_CPU_X64_H
+
+// Runtime detection of optional x86-64 instruction set extensions, used by
+// modules that provide accelerated code paths alongside portable C code.
+
+#include <stdbool.h>
+#include <cpuid.h>
+
+#define MP_CPU_X64_SSSE3    (0x01)
+#define MP_CPU_X64_SSE41    (0x02)
+#define MP_CPU_X64_SSE42    (0x04)
+#define MP_CPU_X64_PCLMUL   (0x08)
+#define MP_CPU_X64_AES      (0x10)
+#define MP_CPU_X64_SHA      (0x20)
+#define MP_CPU_X64_DETECTED (0x80000000)
+
+static inline unsigned int mp_cpu_x64_features(void) {
+    static unsigned int features;
+    if (features == 0) {
+        unsigned int f = MP_CPU_X64_DETECTED;
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            f |= (ecx & bit_SSSE3) ? MP_CPU_X64_SSSE3 : 0;
+            f |= (ecx & bit_SSE4_1) ? MP_CPU_X64_SSE41 : 0;
+            f |= (ecx & bit_SSE4_2) ? MP_CPU_X64_SSE42 : 0;
+            f |= (ecx & bit_PCLMUL) ? MP_CPU_X64_PCLMUL : 0;
+            f |= (ecx & bit_AES) ? MP_CPU_X64_AES : 0;
+        }
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            f |= (ebx & bit_SHA) ? MP_CPU_X64_SHA : 0;
+        }
+        // Racing threads compute the same value, so no locking is needed.
+        features = f;
+    }
+    return features;
+}
+
+// Returns true if all of the given MP_CPU_X64_xxx features are available.
+static inline bool mp_cpu_x64_has(unsigned int mask) {
+    return (mp_cpu_x64_features() & mask) == mask;
+}
+
+#endif // MICROPY_INCLUDED_EXTMOD_CPU_X64_H
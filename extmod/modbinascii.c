@@ -34,51 +34,288 @@
 
 #if MICROPY_PY_BINASCII
 
-#if MICROPY_PY_BUILTINS_BYTES_HEX
-STATIC mp_obj_t bytes_hex_as_bytes(size_t n_args, const mp_obj_t *args) {
-    return mp_obj_bytes_hex(n_args, args, &mp_type_bytes);
+#if MICROPY_PY_BINASCII_X64
+#include <immintrin.h>
+#include "extmod/cpu_x64.h"
+#define BINASCII_HAVE_SSSE3() mp_cpu_x64_has(MP_CPU_X64_SSSE3)
+#endif
+
+// Get the caller-provided buffer to write output into, checking that it can
+// hold at least min_len bytes.
+STATIC void mod_binascii_get_out_buf(mp_obj_t out, size_t min_len, mp_buffer_info_t *bufinfo) {
+    mp_get_buffer_raise(out, bufinfo, MP_BUFFER_WRITE);
+    if (bufinfo->len < min_len) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(bytes_hex_as_bytes_obj, 1, 2, bytes_hex_as_bytes);
 
-STATIC mp_obj_t bytes_fromhex_bytes(mp_obj_t data) {
-    return mp_obj_bytes_fromhex(MP_OBJ_FROM_PTR(&mp_type_bytes), data);
+#if MICROPY_PY_BUILTINS_BYTES_HEX
+
+static const char mod_binascii_hex_digits[16] = "0123456789abcdef";
+
+#if MICROPY_PY_BINASCII_X64
+// Convert 16 bytes to 32 hex digits at a time; returns the number of input
+// bytes processed.
+__attribute__((target("ssse3")))
+STATIC size_t mod_binascii_hexlify_x64(const byte *in, size_t len, byte *out) {
+    const __m128i lut = _mm_loadu_si128((const __m128i *)mod_binascii_hex_digits);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    size_t n = len & ~(size_t)15;
+    for (size_t i = 0; i < n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+        _mm_storeu_si128((__m128i *)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return n;
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_1(bytes_fromhex_obj, bytes_fromhex_bytes);
 #endif
 
-// If ch is a character in the base64 alphabet, and is not a pad character, then
-// the corresponding integer between 0 and 63, inclusively, is returned.
-// Otherwise, -1 is returned.
-static int mod_binascii_sextet(byte ch) {
-    if (ch >= 'A' && ch <= 'Z') {
-        return ch - 'A';
-    } else if (ch >= 'a' && ch <= 'z') {
-        return ch - 'a' + 26;
-    } else if (ch >= '0' && ch <= '9') {
-        return ch - '0' + 52;
-    } else if (ch == '+') {
-        return 62;
-    } else if (ch == '/') {
-        return 63;
+STATIC void mod_binascii_hexlify_buf(const byte *in, size_t len, int sep, byte *out) {
+    if (sep < 0) {
+        #if MICROPY_PY_BINASCII_X64
+        if (len >= 16 && BINASCII_HAVE_SSSE3()) {
+            size_t n = mod_binascii_hexlify_x64(in, len, out);
+            in += n;
+            out += 2 * n;
+            len -= n;
+        }
+        #endif
+        for (; len > 0; --len) {
+            byte b = *in++;
+            *out++ = mod_binascii_hex_digits[b >> 4];
+            *out++ = mod_binascii_hex_digits[b & 0xf];
+        }
     } else {
-        return -1;
+        for (size_t i = 0; i < len; ++i) {
+            if (i != 0) {
+                *out++ = sep;
+            }
+            byte b = in[i];
+            *out++ = mod_binascii_hex_digits[b >> 4];
+            *out++ = mod_binascii_hex_digits[b & 0xf];
+        }
     }
 }
 
-STATIC mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
+STATIC mp_obj_t mod_binascii_hexlify(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_data, ARG_sep, ARG_out };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_data, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_sep, MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_out, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
     mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
-    byte *in = bufinfo.buf;
+    mp_get_buffer_raise(args[ARG_data].u_obj, &bufinfo, MP_BUFFER_READ);
+    int sep = -1;
+    size_t out_len = bufinfo.len * 2;
+    if (args[ARG_sep].u_obj != mp_const_none) {
+        // 1-char separator between hex numbers
+        sep = *mp_obj_str_get_str(args[ARG_sep].u_obj);
+        if (bufinfo.len != 0) {
+            out_len += bufinfo.len - 1;
+        }
+    }
 
+    if (args[ARG_out].u_obj != mp_const_none) {
+        mp_buffer_info_t outinfo;
+        mod_binascii_get_out_buf(args[ARG_out].u_obj, out_len, &outinfo);
+        mod_binascii_hexlify_buf(bufinfo.buf, bufinfo.len, sep, outinfo.buf);
+        return MP_OBJ_NEW_SMALL_INT(out_len);
+    }
+    if (out_len == 0) {
+        return mp_const_empty_bytes;
+    }
     vstr_t vstr;
-    vstr_init(&vstr, (bufinfo.len * 3) / 4 + 1); // Potentially over-allocate
-    byte *out = (byte *)vstr.buf;
+    vstr_init_len(&vstr, out_len);
+    mod_binascii_hexlify_buf(bufinfo.buf, bufinfo.len, sep, (byte *)vstr.buf);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_binascii_hexlify_obj, 1, mod_binascii_hexlify);
+
+// Returns the value of a hex digit, or a value greater than 15 if c is not one.
+static inline unsigned int mod_binascii_xdigit(byte c) {
+    if ((unsigned int)(c - '0') < 10) {
+        return c - '0';
+    }
+    c |= 0x20;
+    if ((unsigned int)(c - 'a') < 6) {
+        return c - 'a' + 10;
+    }
+    return 0xff;
+}
+
+STATIC mp_obj_t mod_binascii_unhexlify(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_data, ARG_out };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_data, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_out, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_data].u_obj, &bufinfo, MP_BUFFER_READ);
+    if ((bufinfo.len & 1) != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("odd-length string"));
+    }
+    size_t out_len = bufinfo.len / 2;
+    byte *out;
+    vstr_t vstr;
+    if (args[ARG_out].u_obj != mp_const_none) {
+        mp_buffer_info_t outinfo;
+        mod_binascii_get_out_buf(args[ARG_out].u_obj, out_len, &outinfo);
+        out = outinfo.buf;
+    } else {
+        vstr_init_len(&vstr, out_len);
+        out = (byte *)vstr.buf;
+    }
+    const byte *in = bufinfo.buf;
+    for (size_t i = 0; i < out_len; ++i, in += 2) {
+        unsigned int hi = mod_binascii_xdigit(in[0]);
+        unsigned int lo = mod_binascii_xdigit(in[1]);
+        if ((hi | lo) > 0xf) {
+            mp_raise_ValueError(MP_ERROR_TEXT("non-hex digit found"));
+        }
+        out[i] = hi << 4 | lo;
+    }
+    if (args[ARG_out].u_obj != mp_const_none) {
+        return MP_OBJ_NEW_SMALL_INT(out_len);
+    }
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_binascii_unhexlify_obj, 1, mod_binascii_unhexlify);
+#endif
+
+// Maps an ASCII character in the base64 alphabet, other than the pad
+// character, to its sextet value; anything else maps to 0xff.
+static const byte mod_binascii_sextet_table[128] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+static const char mod_binascii_base64_alphabet[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static inline uint32_t mod_binascii_sextet(byte ch) {
+    return ch < 128 ? mod_binascii_sextet_table[ch] : 0xff;
+}
+
+#if MICROPY_PY_BINASCII_X64
+
+// Decode 16 base64 characters to 12 bytes.  Returns false, without writing
+// anything, if any of the characters is not in the base64 alphabet (this
+// includes padding), so the caller can fall back to the scalar decoder.
+__attribute__((target("ssse3")))
+STATIC bool mod_binascii_a2b_base64_x64(const byte *in, byte *out) {
+    __m128i v = _mm_loadu_si128((const __m128i *)in);
+    // Bytes >= 0x80 are negative as signed bytes so fail every range check.
+    __m128i az_upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    __m128i az_lower = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    __m128i plus = _mm_cmpeq_epi8(v, _mm_set1_epi8('+'));
+    __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+    __m128i valid = _mm_or_si128(_mm_or_si128(az_upper, az_lower), _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+    if (_mm_movemask_epi8(valid) != 0xffff) {
+        return false;
+    }
+    __m128i shift = _mm_and_si128(az_upper, _mm_set1_epi8(-'A'));
+    shift = _mm_or_si128(shift, _mm_and_si128(az_lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+    shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+    v = _mm_add_epi8(v, shift);
+    // Pack 4 sextets per 32-bit lane into 24 bits, then gather the bytes.
+    v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+    v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+    v = _mm_shuffle_epi8(v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storel_epi64((__m128i *)out, v);
+    uint32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+    memcpy(out + 8, &tail, 4);
+    return true;
+}
 
-    uint shift = 0;
+// Encode 12 bytes to 16 base64 characters at a time, reading 16 bytes of
+// input per step.  Returns the number of input bytes processed.
+__attribute__((target("ssse3")))
+STATIC size_t mod_binascii_b2a_base64_x64(const byte *in, size_t len, byte *out) {
+    size_t n = 0;
+    for (; len - n >= 16; n += 12, out += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + n));
+        // Spread each group of 3 bytes over a 32-bit lane, then isolate the
+        // four 6-bit indices into separate bytes.
+        v = _mm_shuffle_epi8(v, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        __m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        __m128i idx = _mm_or_si128(t0, t1);
+        // Map each index range to the offset that turns it into ASCII.
+        __m128i r = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+        r = _mm_or_si128(r, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), idx), _mm_set1_epi8(13)));
+        const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        _mm_storeu_si128((__m128i *)out, _mm_add_epi8(idx, _mm_shuffle_epi8(offsets, r)));
+    }
+    return n;
+}
+
+#endif
+
+// Decode base64 data into out, which has room for out_len bytes.  Invalid
+// characters are skipped.  Returns the number of bytes written.
+STATIC size_t mod_binascii_a2b_base64_buf(const byte *in, size_t len, byte *out, size_t out_len) {
+    const byte *in_top = in + len;
+    byte *out_start = out;
+    byte *out_top = out + out_len;
+    uint32_t shift = 0;
     int nbits = 0; // Number of meaningful bits in shift
     bool hadpad = false; // Had a pad character since last valid character
-    for (size_t i = 0; i < bufinfo.len; i++) {
-        if (in[i] == '=') {
+    #if MICROPY_PY_BINASCII_X64
+    bool use_simd = BINASCII_HAVE_SSSE3();
+    #endif
+    while (in < in_top) {
+        if (nbits == 0) {
+            #if MICROPY_PY_BINASCII_X64
+            if (use_simd && in_top - in >= 16 && out_top - out >= 12 && mod_binascii_a2b_base64_x64(in, out)) {
+                in += 16;
+                out += 12;
+                hadpad = false;
+                continue;
+            }
+            #endif
+            // Fast path for a whole group of 4 valid characters.
+            if (in_top - in >= 4) {
+                uint32_t a = mod_binascii_sextet(in[0]);
+                uint32_t b = mod_binascii_sextet(in[1]);
+                uint32_t c = mod_binascii_sextet(in[2]);
+                uint32_t d = mod_binascii_sextet(in[3]);
+                if ((a | b | c | d) < 64) {
+                    uint32_t v = a << 18 | b << 12 | c << 6 | d;
+                    if (out_top - out < 3) {
+                        goto too_small;
+                    }
+                    out[0] = v >> 16;
+                    out[1] = v >> 8;
+                    out[2] = v;
+                    in += 4;
+                    out += 3;
+                    hadpad = false;
+                    continue;
+                }
+            }
+        }
+
+        byte ch = *in++;
+        if (ch == '=') {
             if ((nbits == 2) || ((nbits == 4) && hadpad)) {
                 nbits = 0;
                 break;
@@ -86,8 +323,8 @@ STATIC mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
             hadpad = true;
         }
 
-        int sextet = mod_binascii_sextet(in[i]);
-        if (sextet == -1) {
+        uint32_t sextet = mod_binascii_sextet(ch);
+        if (sextet == 0xff) {
             continue;
         }
         hadpad = false;
@@ -96,7 +333,10 @@ STATIC mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
 
         if (nbits >= 8) {
             nbits -= 8;
-            out[vstr.len++] = (shift >> nbits) & 0xFF;
+            if (out == out_top) {
+                goto too_small;
+            }
+            *out++ = (shift >> nbits) & 0xFF;
         }
     }
 
@@ -104,14 +344,70 @@ STATIC mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
         mp_raise_ValueError(MP_ERROR_TEXT("incorrect padding"));
     }
 
+    return out - out_start;
+
+too_small:
+    mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+}
+
+STATIC mp_obj_t mod_binascii_a2b_base64(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_data, ARG_out };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_data, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_out, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_data].u_obj, &bufinfo, MP_BUFFER_READ);
+
+    if (args[ARG_out].u_obj != mp_const_none) {
+        mp_buffer_info_t outinfo;
+        mod_binascii_get_out_buf(args[ARG_out].u_obj, 0, &outinfo);
+        return MP_OBJ_NEW_SMALL_INT(mod_binascii_a2b_base64_buf(bufinfo.buf, bufinfo.len, outinfo.buf, outinfo.len));
+    }
+
+    vstr_t vstr;
+    vstr_init(&vstr, (bufinfo.len * 3) / 4 + 1); // Potentially over-allocate
+    vstr.len = mod_binascii_a2b_base64_buf(bufinfo.buf, bufinfo.len, (byte *)vstr.buf, vstr.alloc);
     return mp_obj_new_bytes_from_vstr(&vstr);
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_a2b_base64_obj, mod_binascii_a2b_base64);
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_binascii_a2b_base64_obj, 1, mod_binascii_a2b_base64);
+
+// Encode data as base64 into out, which must have room for the whole result.
+STATIC void mod_binascii_b2a_base64_buf(const byte *in, size_t len, byte *out) {
+    #if MICROPY_PY_BINASCII_X64
+    if (len >= 16 && BINASCII_HAVE_SSSE3()) {
+        size_t n = mod_binascii_b2a_base64_x64(in, len, out);
+        in += n;
+        out += n / 3 * 4;
+        len -= n;
+    }
+    #endif
+    for (; len >= 3; len -= 3) {
+        uint32_t v = in[0] << 16 | in[1] << 8 | in[2];
+        out[0] = mod_binascii_base64_alphabet[v >> 18];
+        out[1] = mod_binascii_base64_alphabet[(v >> 12) & 0x3f];
+        out[2] = mod_binascii_base64_alphabet[(v >> 6) & 0x3f];
+        out[3] = mod_binascii_base64_alphabet[v & 0x3f];
+        in += 3;
+        out += 4;
+    }
+    if (len != 0) {
+        uint32_t v = in[0] << 16 | (len == 2 ? in[1] << 8 : 0);
+        out[0] = mod_binascii_base64_alphabet[v >> 18];
+        out[1] = mod_binascii_base64_alphabet[(v >> 12) & 0x3f];
+        out[2] = len == 2 ? mod_binascii_base64_alphabet[(v >> 6) & 0x3f] : '=';
+        out[3] = '=';
+    }
+}
 
 STATIC mp_obj_t mod_binascii_b2a_base64(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
-    enum { ARG_newline };
+    enum { ARG_newline, ARG_out };
     static const mp_arg_t allowed_args[] = {
         { MP_QSTR_newline, MP_ARG_BOOL, {.u_bool = true} },
+        { MP_QSTR_out, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
     };
 
     mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
@@ -120,51 +416,23 @@ STATIC mp_obj_t mod_binascii_b2a_base64(size_t n_args, const mp_obj_t *pos_args,
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(pos_args[0], &bufinfo, MP_BUFFER_READ);
 
+    size_t len = ((bufinfo.len != 0) ? (((bufinfo.len - 1) / 3) + 1) * 4 : 0) + newline;
+    byte *out;
     vstr_t vstr;
-    vstr_init_len(&vstr, ((bufinfo.len != 0) ? (((bufinfo.len - 1) / 3) + 1) * 4 : 0) + newline);
-
-    // First pass, we convert input buffer to numeric base 64 values
-    byte *in = bufinfo.buf, *out = (byte *)vstr.buf;
-    mp_uint_t i;
-    for (i = bufinfo.len; i >= 3; i -= 3) {
-        *out++ = (in[0] & 0xFC) >> 2;
-        *out++ = (in[0] & 0x03) << 4 | (in[1] & 0xF0) >> 4;
-        *out++ = (in[1] & 0x0F) << 2 | (in[2] & 0xC0) >> 6;
-        *out++ = in[2] & 0x3F;
-        in += 3;
-    }
-    if (i != 0) {
-        *out++ = (in[0] & 0xFC) >> 2;
-        if (i == 2) {
-            *out++ = (in[0] & 0x03) << 4 | (in[1] & 0xF0) >> 4;
-            *out++ = (in[1] & 0x0F) << 2;
-        } else {
-            *out++ = (in[0] & 0x03) << 4;
-            *out++ = 64;
-        }
-        *out = 64;
-    }
-
-    // Second pass, we convert number base 64 values to actual base64 ascii encoding
-    out = (byte *)vstr.buf;
-    for (mp_uint_t j = vstr.len - newline; j--;) {
-        if (*out < 26) {
-            *out += 'A';
-        } else if (*out < 52) {
-            *out += 'a' - 26;
-        } else if (*out < 62) {
-            *out += '0' - 52;
-        } else if (*out == 62) {
-            *out = '+';
-        } else if (*out == 63) {
-            *out = '/';
-        } else {
-            *out = '=';
-        }
-        out++;
+    if (args[ARG_out].u_obj != mp_const_none) {
+        mp_buffer_info_t outinfo;
+        mod_binascii_get_out_buf(args[ARG_out].u_obj, len, &outinfo);
+        out = outinfo.buf;
+    } else {
+        vstr_init_len(&vstr, len);
+        out = (byte *)vstr.buf;
     }
+    mod_binascii_b2a_base64_buf(bufinfo.buf, bufinfo.len, out);
     if (newline) {
-        *out = '\n';
+        out[len - 1] = '\n';
+    }
+    if (args[ARG_out].u_obj != mp_const_none) {
+        return MP_OBJ_NEW_SMALL_INT(len);
     }
     return mp_obj_new_bytes_from_vstr(&vstr);
 }
@@ -173,11 +441,96 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_binascii_b2a_base64_obj, 1, mod_binascii_b
 #if MICROPY_PY_BINASCII_CRC32 && MICROPY_PY_DEFLATE
 #include "lib/uzlib/uzlib.h"
 
+#if MICROPY_PY_BINASCII_X64
+
+// CRC32 of a buffer by folding 64 bytes at a time with carry-less multiply,
+// following "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+// Instruction" (Intel, 2009).  The constants are for the bit-reflected
+// IEEE 802.3 polynomial.  len must be at least 64 and a multiple of 16, and
+// crc is the running (inverted) value as used by uzlib_crc32.
+__attribute__((target("pclmul,sse4.1")))
+STATIC uint32_t mod_binascii_crc32_x64(const byte *buf, size_t len, uint32_t crc) {
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+    buf += 64;
+    len -= 64;
+
+    // Fold four 128-bit lanes in parallel.
+    while (len >= 64) {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(buf + 0x30)));
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold the four lanes into one, then fold any remaining 16-byte blocks.
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+    while (len >= 16) {
+        x2 = _mm_loadu_si128((const __m128i *)buf);
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    // Fold 128 bits down to 64 bits.
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2);
+
+    // Barrett reduction to 32 bits.
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return _mm_extract_epi32(x1, 1);
+}
+#endif
+
 STATIC mp_obj_t mod_binascii_crc32(size_t n_args, const mp_obj_t *args) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
     uint32_t crc = (n_args > 1) ? mp_obj_get_int_truncated(args[1]) : 0;
-    crc = uzlib_crc32(bufinfo.buf, bufinfo.len, crc ^ 0xffffffff);
+    crc ^= 0xffffffff;
+    const byte *buf = bufinfo.buf;
+    size_t len = bufinfo.len;
+    #if MICROPY_PY_BINASCII_X64
+    if (len >= 64 && mp_cpu_x64_has(MP_CPU_X64_PCLMUL | MP_CPU_X64_SSE41)) {
+        size_t n = len & ~(size_t)15;
+        crc = mod_binascii_crc32_x64(buf, n, crc);
+        buf += n;
+        len -= n;
+    }
+    #endif
+    crc = uzlib_crc32(buf, len, crc);
     return mp_obj_new_int_from_uint(crc ^ 0xffffffff);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_crc32_obj, 1, 2, mod_binascii_crc32);
@@ -186,8 +539,8 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_crc32_obj, 1, 2, mod_bin
 STATIC const mp_rom_map_elem_t mp_module_binascii_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_binascii) },
     #if MICROPY_PY_BUILTINS_BYTES_HEX
-    { MP_ROM_QSTR(MP_QSTR_hexlify), MP_ROM_PTR(&bytes_hex_as_bytes_obj) },
-    { MP_ROM_QSTR(MP_QSTR_unhexlify), MP_ROM_PTR(&bytes_fromhex_obj) },
+    { MP_ROM_QSTR(MP_QSTR_hexlify), MP_ROM_PTR(&mod_binascii_hexlify_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unhexlify), MP_ROM_PTR(&mod_binascii_unhexlify_obj) },
     #endif
     { MP_ROM_QSTR(MP_QSTR_a2b_base64), MP_ROM_PTR(&mod_binascii_a2b_base64_obj) },
     { MP_ROM_QSTR(MP_QSTR_b2a_base64), MP_ROM_PTR(&mod_binascii_b2a_base64_obj) },
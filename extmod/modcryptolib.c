@@ -44,6 +44,7 @@ enum {
     UCRYPTOLIB_MODE_ECB = 1,
     UCRYPTOLIB_MODE_CBC = 2,
     UCRYPTOLIB_MODE_CTR = 6,
+    UCRYPTOLIB_MODE_GCM = 11, // as used by PyCryptodome
 };
 
 struct ctr_params {
@@ -79,9 +80,32 @@ struct mbedtls_aes_ctx_with_key {
 #define AES_CTX_IMPL struct mbedtls_aes_ctx_with_key
 #endif
 
+#if MICROPY_PY_CRYPTOLIB_GCM
+struct gcm_params {
+    uint64_t aad_len; // bytes of associated data
+    uint64_t data_len; // bytes of plaintext/ciphertext
+    uint8_t h[16]; // hash subkey, E(K, 0^128)
+    uint8_t tag_mask[16]; // E(K, J0), applied to the final GHASH value
+    uint8_t counter[16]; // next counter block
+    uint8_t keystream[16]; // keystream for a partial block of data
+    uint8_t ghash[16]; // GHASH accumulator, holds the tag once finished
+    uint8_t ghash_pos; // bytes absorbed into the current GHASH block
+#define AES_GCM_STATE_AAD  0
+#define AES_GCM_STATE_DATA 1
+#define AES_GCM_STATE_DONE 2
+    uint8_t state;
+};
+#endif
+
 typedef struct _mp_obj_aes_t {
     mp_obj_base_t base;
     AES_CTX_IMPL ctx;
+    #if MICROPY_PY_CRYPTOLIB_X64
+    // AES-NI round keys; when x64_rounds is non-zero these are used instead
+    // of ctx (but the IV/counter is still kept in ctx.iv).
+    uint8_t x64_rk[15][16];
+    uint8_t x64_rounds;
+    #endif
     uint8_t block_mode : 6;
 #define AES_KEYTYPE_NONE 0
 #define AES_KEYTYPE_ENC  1
@@ -97,11 +121,26 @@ static inline bool is_ctr_mode(int block_mode) {
     #endif
 }
 
+static inline bool is_gcm_mode(int block_mode) {
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    return block_mode == UCRYPTOLIB_MODE_GCM;
+    #else
+    return false;
+    #endif
+}
+
 static inline struct ctr_params *ctr_params_from_aes(mp_obj_aes_t *o) {
     // ctr_params follows aes object struct
     return (struct ctr_params *)&o[1];
 }
 
+#if MICROPY_PY_CRYPTOLIB_GCM
+static inline struct gcm_params *gcm_params_from_aes(mp_obj_aes_t *o) {
+    // gcm_params follows aes object struct
+    return (struct gcm_params *)&o[1];
+}
+#endif
+
 #if MICROPY_SSL_AXTLS
 STATIC void aes_initial_set_key_impl(AES_CTX_IMPL *ctx, const uint8_t *key, size_t keysize, const uint8_t iv[16]) {
     assert(16 == keysize || 32 == keysize);
@@ -211,6 +250,571 @@ STATIC void aes_process_ctr_impl(AES_CTX_IMPL *ctx, const uint8_t *in, uint8_t *
 
 #endif
 
+#if MICROPY_PY_CRYPTOLIB_X64
+// AES using the x86-64 AES-NI instructions, with carry-less multiply for
+// GHASH.  Used in place of the library implementation above when the CPU
+// supports it.
+
+#include <immintrin.h>
+#include "extmod/cpu_x64.h"
+
+#define AES_X64_FEATURES (MP_CPU_X64_AES | MP_CPU_X64_PCLMUL | MP_CPU_X64_SSE41)
+#define AES_X64_TARGET __attribute__((target("aes,pclmul,sse4.1")))
+
+static inline __m128i aes_x64_expand_step(__m128i key, __m128i t) {
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, t);
+}
+
+// Expand the encryption key schedule into self->x64_rk.
+AES_X64_TARGET
+STATIC void aes_x64_set_key(mp_obj_aes_t *self, const uint8_t *key, size_t keysize) {
+    __m128i rk[15];
+    rk[0] = _mm_loadu_si128((const __m128i *)key);
+    if (keysize == 16) {
+        #define AES_X64_EXPAND_128(i, rcon) \
+    rk[i] = aes_x64_expand_step(rk[i - 1], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(rk[i - 1], rcon), 0xff))
+        AES_X64_EXPAND_128(1, 0x01);
+        AES_X64_EXPAND_128(2, 0x02);
+        AES_X64_EXPAND_128(3, 0x04);
+        AES_X64_EXPAND_128(4, 0x08);
+        AES_X64_EXPAND_128(5, 0x10);
+        AES_X64_EXPAND_128(6, 0x20);
+        AES_X64_EXPAND_128(7, 0x40);
+        AES_X64_EXPAND_128(8, 0x80);
+        AES_X64_EXPAND_128(9, 0x1b);
+        AES_X64_EXPAND_128(10, 0x36);
+        #undef AES_X64_EXPAND_128
+        self->x64_rounds = 10;
+    } else {
+        rk[1] = _mm_loadu_si128((const __m128i *)(key + 16));
+        #define AES_X64_EXPAND_256(i, rcon) \
+    rk[i] = aes_x64_expand_step(rk[i - 2], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(rk[i - 1], rcon), 0xff)); \
+    if (i < 14) { \
+        rk[i + 1] = aes_x64_expand_step(rk[i - 1], _mm_shuffle_epi32(_mm_aeskeygenassist_si128(rk[i], 0), 0xaa)); \
+    }
+        AES_X64_EXPAND_256(2, 0x01);
+        AES_X64_EXPAND_256(4, 0x02);
+        AES_X64_EXPAND_256(6, 0x04);
+        AES_X64_EXPAND_256(8, 0x08);
+        AES_X64_EXPAND_256(10, 0x10);
+        AES_X64_EXPAND_256(12, 0x20);
+        AES_X64_EXPAND_256(14, 0x40);
+        #undef AES_X64_EXPAND_256
+        self->x64_rounds = 14;
+    }
+    for (int i = 0; i <= self->x64_rounds; ++i) {
+        _mm_storeu_si128((__m128i *)self->x64_rk[i], rk[i]);
+    }
+}
+
+// Convert the key schedule in self->x64_rk for use with AESDEC.
+AES_X64_TARGET
+STATIC void aes_x64_set_key_dec(mp_obj_aes_t *self) {
+    int nr = self->x64_rounds;
+    __m128i rk[15];
+    for (int i = 0; i <= nr; ++i) {
+        rk[i] = _mm_loadu_si128((const __m128i *)self->x64_rk[i]);
+    }
+    _mm_storeu_si128((__m128i *)self->x64_rk[0], rk[nr]);
+    for (int i = 1; i < nr; ++i) {
+        _mm_storeu_si128((__m128i *)self->x64_rk[i], _mm_aesimc_si128(rk[nr - i]));
+    }
+    _mm_storeu_si128((__m128i *)self->x64_rk[nr], rk[0]);
+}
+
+AES_X64_TARGET MP_ALWAYSINLINE
+static inline int aes_x64_load_key(mp_obj_aes_t *self, __m128i rk[15]) {
+    int nr = self->x64_rounds;
+    for (int i = 0; i <= nr; ++i) {
+        rk[i] = _mm_loadu_si128((const __m128i *)self->x64_rk[i]);
+    }
+    return nr;
+}
+
+AES_X64_TARGET MP_ALWAYSINLINE
+static inline __m128i aes_x64_enc(const __m128i *rk, int nr, __m128i x) {
+    x = _mm_xor_si128(x, rk[0]);
+    for (int i = 1; i < nr; ++i) {
+        x = _mm_aesenc_si128(x, rk[i]);
+    }
+    return _mm_aesenclast_si128(x, rk[nr]);
+}
+
+AES_X64_TARGET MP_ALWAYSINLINE
+static inline __m128i aes_x64_dec(const __m128i *rk, int nr, __m128i x) {
+    x = _mm_xor_si128(x, rk[0]);
+    for (int i = 1; i < nr; ++i) {
+        x = _mm_aesdec_si128(x, rk[i]);
+    }
+    return _mm_aesdeclast_si128(x, rk[nr]);
+}
+
+// Encrypt or decrypt 4 independent blocks at once, to keep the AES unit busy.
+// Written out by hand so the blocks stay in registers even at -Os.
+AES_X64_TARGET MP_ALWAYSINLINE
+static inline void aes_x64_crypt4(const __m128i *rk, int nr, __m128i b[4], bool encrypt) {
+    __m128i b0 = _mm_xor_si128(b[0], rk[0]);
+    __m128i b1 = _mm_xor_si128(b[1], rk[0]);
+    __m128i b2 = _mm_xor_si128(b[2], rk[0]);
+    __m128i b3 = _mm_xor_si128(b[3], rk[0]);
+    if (encrypt) {
+        for (int i = 1; i < nr; ++i) {
+            b0 = _mm_aesenc_si128(b0, rk[i]);
+            b1 = _mm_aesenc_si128(b1, rk[i]);
+            b2 = _mm_aesenc_si128(b2, rk[i]);
+            b3 = _mm_aesenc_si128(b3, rk[i]);
+        }
+        b[0] = _mm_aesenclast_si128(b0, rk[nr]);
+        b[1] = _mm_aesenclast_si128(b1, rk[nr]);
+        b[2] = _mm_aesenclast_si128(b2, rk[nr]);
+        b[3] = _mm_aesenclast_si128(b3, rk[nr]);
+    } else {
+        for (int i = 1; i < nr; ++i) {
+            b0 = _mm_aesdec_si128(b0, rk[i]);
+            b1 = _mm_aesdec_si128(b1, rk[i]);
+            b2 = _mm_aesdec_si128(b2, rk[i]);
+            b3 = _mm_aesdec_si128(b3, rk[i]);
+        }
+        b[0] = _mm_aesdeclast_si128(b0, rk[nr]);
+        b[1] = _mm_aesdeclast_si128(b1, rk[nr]);
+        b[2] = _mm_aesdeclast_si128(b2, rk[nr]);
+        b[3] = _mm_aesdeclast_si128(b3, rk[nr]);
+    }
+}
+
+static inline void aes_x64_load4(__m128i b[4], const uint8_t *in) {
+    b[0] = _mm_loadu_si128((const __m128i *)in);
+    b[1] = _mm_loadu_si128((const __m128i *)(in + 16));
+    b[2] = _mm_loadu_si128((const __m128i *)(in + 32));
+    b[3] = _mm_loadu_si128((const __m128i *)(in + 48));
+}
+
+// Store the 4 blocks b xored with the 4 blocks at x.
+static inline void aes_x64_store4_xor(uint8_t *out, const __m128i b[4], const uint8_t *x) {
+    __m128i x0 = _mm_loadu_si128((const __m128i *)x);
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(x + 16));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(x + 32));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(x + 48));
+    _mm_storeu_si128((__m128i *)out, _mm_xor_si128(b[0], x0));
+    _mm_storeu_si128((__m128i *)(out + 16), _mm_xor_si128(b[1], x1));
+    _mm_storeu_si128((__m128i *)(out + 32), _mm_xor_si128(b[2], x2));
+    _mm_storeu_si128((__m128i *)(out + 48), _mm_xor_si128(b[3], x3));
+}
+
+AES_X64_TARGET
+STATIC void aes_x64_encrypt_block(mp_obj_aes_t *self, const uint8_t in[16], uint8_t out[16]) {
+    __m128i rk[15];
+    int nr = aes_x64_load_key(self, rk);
+    _mm_storeu_si128((__m128i *)out, aes_x64_enc(rk, nr, _mm_loadu_si128((const __m128i *)in)));
+}
+
+AES_X64_TARGET
+STATIC void aes_x64_process_ecb(mp_obj_aes_t *self, const uint8_t *in, uint8_t *out, size_t in_len, bool encrypt) {
+    __m128i rk[15];
+    int nr = aes_x64_load_key(self, rk);
+    for (; in_len >= 64; in_len -= 64, in += 64, out += 64) {
+        __m128i b[4];
+        aes_x64_load4(b, in);
+        aes_x64_crypt4(rk, nr, b, encrypt);
+        _mm_storeu_si128((__m128i *)out, b[0]);
+        _mm_storeu_si128((__m128i *)(out + 16), b[1]);
+        _mm_storeu_si128((__m128i *)(out + 32), b[2]);
+        _mm_storeu_si128((__m128i *)(out + 48), b[3]);
+    }
+    for (; in_len != 0; in_len -= 16, in += 16, out += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)in);
+        x = encrypt ? aes_x64_enc(rk, nr, x) : aes_x64_dec(rk, nr, x);
+        _mm_storeu_si128((__m128i *)out, x);
+    }
+}
+
+AES_X64_TARGET
+STATIC void aes_x64_process_cbc(mp_obj_aes_t *self, const uint8_t *in, uint8_t *out, size_t in_len, bool encrypt) {
+    __m128i rk[15];
+    int nr = aes_x64_load_key(self, rk);
+    __m128i iv = _mm_loadu_si128((const __m128i *)self->ctx.iv);
+    if (encrypt) {
+        // Each block depends on the previous one, so no interleaving here.
+        for (; in_len != 0; in_len -= 16, in += 16, out += 16) {
+            iv = aes_x64_enc(rk, nr, _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), iv));
+            _mm_storeu_si128((__m128i *)out, iv);
+        }
+    } else {
+        // Input is loaded before output is stored so this works in-place.
+        for (; in_len >= 64; in_len -= 64, in += 64, out += 64) {
+            __m128i b[4];
+            aes_x64_load4(b, in);
+            __m128i c0 = b[0], c1 = b[1], c2 = b[2], c3 = b[3];
+            aes_x64_crypt4(rk, nr, b, false);
+            _mm_storeu_si128((__m128i *)out, _mm_xor_si128(b[0], iv));
+            _mm_storeu_si128((__m128i *)(out + 16), _mm_xor_si128(b[1], c0));
+            _mm_storeu_si128((__m128i *)(out + 32), _mm_xor_si128(b[2], c1));
+            _mm_storeu_si128((__m128i *)(out + 48), _mm_xor_si128(b[3], c2));
+            iv = c3;
+        }
+        for (; in_len != 0; in_len -= 16, in += 16, out += 16) {
+            __m128i c = _mm_loadu_si128((const __m128i *)in);
+            _mm_storeu_si128((__m128i *)out, _mm_xor_si128(aes_x64_dec(rk, nr, c), iv));
+            iv = c;
+        }
+    }
+    _mm_storeu_si128((__m128i *)self->ctx.iv, iv);
+}
+
+#if MICROPY_PY_CRYPTOLIB_CTR
+AES_X64_TARGET
+STATIC void aes_x64_process_ctr(mp_obj_aes_t *self, const uint8_t *in, uint8_t *out, size_t in_len, struct ctr_params *ctr_params) {
+    size_t n = ctr_params->offset;
+    uint8_t *const counter = self->ctx.iv;
+
+    // Use up the keystream left over from the previous call.
+    for (; n != 0 && in_len != 0; --in_len) {
+        *out++ = *in++ ^ ctr_params->encrypted_counter[n];
+        n = (n + 1) & 0xf;
+    }
+
+    // Keep the 128-bit big-endian counter as two native 64-bit halves.
+    uint64_t hi, lo;
+    memcpy(&hi, counter, 8);
+    memcpy(&lo, counter + 8, 8);
+    hi = __builtin_bswap64(hi);
+    lo = __builtin_bswap64(lo);
+    #define AES_X64_CTR_NEXT(x) \
+    x = _mm_set_epi64x(__builtin_bswap64(lo), __builtin_bswap64(hi)); \
+    hi += (++lo == 0)
+
+    __m128i rk[15];
+    int nr = aes_x64_load_key(self, rk);
+    for (; in_len >= 64; in_len -= 64, in += 64, out += 64) {
+        __m128i b[4];
+        AES_X64_CTR_NEXT(b[0]);
+        AES_X64_CTR_NEXT(b[1]);
+        AES_X64_CTR_NEXT(b[2]);
+        AES_X64_CTR_NEXT(b[3]);
+        aes_x64_crypt4(rk, nr, b, true);
+        aes_x64_store4_xor(out, b, in);
+    }
+    for (; in_len != 0; in_len -= n) {
+        __m128i b;
+        AES_X64_CTR_NEXT(b);
+        b = aes_x64_enc(rk, nr, b);
+        if (in_len >= 16) {
+            __m128i x = _mm_loadu_si128((const __m128i *)in);
+            _mm_storeu_si128((__m128i *)out, _mm_xor_si128(x, b));
+            in += 16;
+            out += 16;
+            n = 16;
+        } else {
+            // Partial final block: keep the rest of the keystream for later.
+            _mm_storeu_si128((__m128i *)ctr_params->encrypted_counter, b);
+            for (n = 0; n < in_len; ++n) {
+                out[n] = in[n] ^ ctr_params->encrypted_counter[n];
+            }
+        }
+    }
+    #undef AES_X64_CTR_NEXT
+    ctr_params->offset = n & 0xf;
+
+    hi = __builtin_bswap64(hi);
+    lo = __builtin_bswap64(lo);
+    memcpy(counter, &hi, 8);
+    memcpy(counter + 8, &lo, 8);
+}
+#endif
+
+#if MICROPY_PY_CRYPTOLIB_GCM
+// Multiply in GF(2^128) as defined for GHASH.  Operands are byte-reversed
+// GCM field elements (see the Intel carry-less multiplication white paper).
+AES_X64_TARGET MP_ALWAYSINLINE
+static inline __m128i aes_x64_gfmul(__m128i a, __m128i b) {
+    __m128i lo = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    __m128i hi = _mm_clmulepi64_si128(a, b, 0x11);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    // Shift the 256-bit product left by one bit, for the reflected operands.
+    __m128i lo_carry = _mm_srli_epi32(lo, 31);
+    __m128i hi_carry = _mm_srli_epi32(hi, 31);
+    lo = _mm_or_si128(_mm_slli_epi32(lo, 1), _mm_slli_si128(lo_carry, 4));
+    hi = _mm_or_si128(_mm_slli_epi32(hi, 1), _mm_slli_si128(hi_carry, 4));
+    hi = _mm_or_si128(hi, _mm_srli_si128(lo_carry, 12));
+
+    // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+    __m128i t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    __m128i t_hi = _mm_srli_si128(t, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(t, 12));
+    t = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    t = _mm_xor_si128(t, t_hi);
+    return _mm_xor_si128(hi, _mm_xor_si128(lo, t));
+}
+
+AES_X64_TARGET
+STATIC void aes_x64_ghash_blocks(struct gcm_params *p, const uint8_t *data, size_t nblocks) {
+    const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    __m128i h = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p->h), bswap);
+    __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p->ghash), bswap);
+    for (; nblocks != 0; --nblocks, data += 16) {
+        __m128i d = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap);
+        x = aes_x64_gfmul(_mm_xor_si128(x, d), h);
+    }
+    _mm_storeu_si128((__m128i *)p->ghash, _mm_shuffle_epi8(x, bswap));
+}
+
+// Encrypt or decrypt whole blocks, updating the counter and GHASH.
+AES_X64_TARGET
+STATIC void aes_x64_gcm_blocks(mp_obj_aes_t *self, struct gcm_params *p, const uint8_t *in, uint8_t *out, size_t nblocks, bool encrypt) {
+    const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    __m128i h = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p->h), bswap);
+    __m128i x = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p->ghash), bswap);
+    __m128i counter = _mm_loadu_si128((const __m128i *)p->counter);
+    uint32_t ctr = __builtin_bswap32((uint32_t)_mm_extract_epi32(counter, 3));
+    __m128i h2 = aes_x64_gfmul(h, h);
+    __m128i h3 = aes_x64_gfmul(h2, h);
+    __m128i h4 = aes_x64_gfmul(h3, h);
+    __m128i rk[15];
+    int nr = aes_x64_load_key(self, rk);
+
+    for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+        __m128i b[4], d[4];
+        b[0] = _mm_insert_epi32(counter, __builtin_bswap32(ctr), 3);
+        b[1] = _mm_insert_epi32(counter, __builtin_bswap32(ctr + 1), 3);
+        b[2] = _mm_insert_epi32(counter, __builtin_bswap32(ctr + 2), 3);
+        b[3] = _mm_insert_epi32(counter, __builtin_bswap32(ctr + 3), 3);
+        ctr += 4;
+        aes_x64_crypt4(rk, nr, b, true);
+        // The ciphertext is hashed, which is the input when decrypting.
+        if (!encrypt) {
+            aes_x64_load4(d, in);
+        }
+        aes_x64_store4_xor(out, b, in);
+        if (encrypt) {
+            aes_x64_load4(d, out);
+        }
+        // Hash the 4 blocks as independent multiplies by powers of H.
+        x = aes_x64_gfmul(_mm_xor_si128(x, _mm_shuffle_epi8(d[0], bswap)), h4);
+        x = _mm_xor_si128(x, aes_x64_gfmul(_mm_shuffle_epi8(d[1], bswap), h3));
+        x = _mm_xor_si128(x, aes_x64_gfmul(_mm_shuffle_epi8(d[2], bswap), h2));
+        x = _mm_xor_si128(x, aes_x64_gfmul(_mm_shuffle_epi8(d[3], bswap), h));
+    }
+    for (; nblocks != 0; --nblocks, in += 16, out += 16) {
+        __m128i b = aes_x64_enc(rk, nr, _mm_insert_epi32(counter, __builtin_bswap32(ctr++), 3));
+        __m128i d = _mm_loadu_si128((const __m128i *)in);
+        __m128i o = _mm_xor_si128(d, b);
+        _mm_storeu_si128((__m128i *)out, o);
+        x = aes_x64_gfmul(_mm_xor_si128(x, _mm_shuffle_epi8(encrypt ? o : d, bswap)), h);
+    }
+
+    _mm_storeu_si128((__m128i *)p->ghash, _mm_shuffle_epi8(x, bswap));
+    _mm_storeu_si128((__m128i *)p->counter, _mm_insert_epi32(counter, __builtin_bswap32(ctr), 3));
+}
+#endif
+
+#endif // MICROPY_PY_CRYPTOLIB_X64
+
+STATIC void aes_final_set_key(mp_obj_aes_t *self, bool encrypt) {
+    #if MICROPY_PY_CRYPTOLIB_X64
+    if (self->x64_rounds != 0) {
+        if (!encrypt) {
+            aes_x64_set_key_dec(self);
+        }
+        return;
+    }
+    #endif
+    aes_final_set_key_impl(&self->ctx, encrypt);
+}
+
+#if MICROPY_PY_CRYPTOLIB_GCM
+// Galois/Counter Mode, per NIST SP 800-38D.  Uses the block cipher in the
+// encrypt direction only, for both encryption and decryption.
+
+STATIC void aes_gcm_encrypt_block(mp_obj_aes_t *self, const uint8_t in[16], uint8_t out[16]) {
+    #if MICROPY_PY_CRYPTOLIB_X64
+    if (self->x64_rounds != 0) {
+        aes_x64_encrypt_block(self, in, out);
+        return;
+    }
+    #endif
+    aes_process_ecb_impl(&self->ctx, in, out, true);
+}
+
+static inline uint64_t aes_gcm_get_be64(const uint8_t *buf) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) {
+        v = v << 8 | buf[i];
+    }
+    return v;
+}
+
+static inline void aes_gcm_put_be64(uint8_t *buf, uint64_t v) {
+    for (int i = 7; i >= 0; --i) {
+        buf[i] = v;
+        v >>= 8;
+    }
+}
+
+// Increment the low 32 bits of the counter block.
+static inline void aes_gcm_inc32(uint8_t counter[16]) {
+    for (int i = 15; i >= 12; --i) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+// Compute x = x * h in GF(2^128).  Constant time, bit at a time; this is
+// slow but small, and only used when there's no hardware support.
+STATIC void aes_gcm_gf128_mul(uint8_t x[16], const uint8_t h[16]) {
+    uint64_t zh = 0, zl = 0;
+    uint64_t vh = aes_gcm_get_be64(h), vl = aes_gcm_get_be64(h + 8);
+    for (int i = 0; i < 128; ++i) {
+        uint64_t mask = -(uint64_t)((x[i >> 3] >> (7 - (i & 7))) & 1);
+        zh ^= vh & mask;
+        zl ^= vl & mask;
+        mask = -(vl & 1);
+        vl = (vl >> 1) | (vh << 63);
+        vh = (vh >> 1) ^ (0xe100000000000000ULL & mask);
+    }
+    aes_gcm_put_be64(x, zh);
+    aes_gcm_put_be64(x + 8, zl);
+}
+
+STATIC void aes_gcm_ghash_blocks(mp_obj_aes_t *self, struct gcm_params *p, const uint8_t *data, size_t nblocks) {
+    #if MICROPY_PY_CRYPTOLIB_X64
+    if (self->x64_rounds != 0) {
+        aes_x64_ghash_blocks(p, data, nblocks);
+        return;
+    }
+    #endif
+    for (; nblocks != 0; --nblocks, data += 16) {
+        for (int i = 0; i < 16; ++i) {
+            p->ghash[i] ^= data[i];
+        }
+        aes_gcm_gf128_mul(p->ghash, p->h);
+    }
+}
+
+// Complete a partially absorbed GHASH block, padding it with zeros.
+STATIC void aes_gcm_ghash_flush(mp_obj_aes_t *self, struct gcm_params *p) {
+    if (p->ghash_pos != 0) {
+        static const uint8_t zero[16];
+        aes_gcm_ghash_blocks(self, p, zero, 1);
+        p->ghash_pos = 0;
+    }
+}
+
+STATIC void aes_gcm_ghash(mp_obj_aes_t *self, struct gcm_params *p, const uint8_t *data, size_t len) {
+    while (len != 0) {
+        if (p->ghash_pos == 0 && len >= 16) {
+            size_t n = len / 16;
+            aes_gcm_ghash_blocks(self, p, data, n);
+            data += n * 16;
+            len -= n * 16;
+        } else {
+            p->ghash[p->ghash_pos++] ^= *data++;
+            --len;
+            if (p->ghash_pos == 16) {
+                aes_gcm_ghash_flush(self, p);
+            }
+        }
+    }
+}
+
+STATIC void aes_gcm_init(mp_obj_aes_t *self, const uint8_t *nonce, size_t nonce_len) {
+    struct gcm_params *p = gcm_params_from_aes(self);
+    memset(p, 0, sizeof(*p));
+    aes_final_set_key(self, true);
+    aes_gcm_encrypt_block(self, p->h, p->h);
+
+    // Derive the pre-counter block J0 from the nonce.
+    if (nonce_len == 12) {
+        memcpy(p->counter, nonce, 12);
+        p->counter[15] = 1;
+    } else {
+        uint8_t len_block[16] = {0};
+        aes_gcm_put_be64(len_block + 8, (uint64_t)nonce_len * 8);
+        aes_gcm_ghash(self, p, nonce, nonce_len);
+        aes_gcm_ghash_flush(self, p);
+        aes_gcm_ghash_blocks(self, p, len_block, 1);
+        memcpy(p->counter, p->ghash, 16);
+        memset(p->ghash, 0, 16);
+    }
+    aes_gcm_encrypt_block(self, p->counter, p->tag_mask);
+    aes_gcm_inc32(p->counter);
+}
+
+STATIC void aes_gcm_crypt_blocks(mp_obj_aes_t *self, struct gcm_params *p, const uint8_t *in, uint8_t *out, size_t nblocks, bool encrypt) {
+    #if MICROPY_PY_CRYPTOLIB_X64
+    if (self->x64_rounds != 0) {
+        aes_x64_gcm_blocks(self, p, in, out, nblocks, encrypt);
+        return;
+    }
+    #endif
+    for (; nblocks != 0; --nblocks, in += 16, out += 16) {
+        if (!encrypt) {
+            aes_gcm_ghash_blocks(self, p, in, 1);
+        }
+        aes_gcm_encrypt_block(self, p->counter, p->keystream);
+        aes_gcm_inc32(p->counter);
+        for (int i = 0; i < 16; ++i) {
+            out[i] = in[i] ^ p->keystream[i];
+        }
+        if (encrypt) {
+            aes_gcm_ghash_blocks(self, p, out, 1);
+        }
+    }
+}
+
+STATIC void aes_process_gcm(mp_obj_aes_t *self, const uint8_t *in, uint8_t *out, size_t in_len, bool encrypt) {
+    struct gcm_params *p = gcm_params_from_aes(self);
+    if (p->state == AES_GCM_STATE_AAD) {
+        aes_gcm_ghash_flush(self, p);
+        p->state = AES_GCM_STATE_DATA;
+    }
+    size_t n = p->data_len & 0xf;
+    p->data_len += in_len;
+
+    while (in_len != 0) {
+        if (n == 0 && in_len >= 16) {
+            size_t nblocks = in_len / 16;
+            aes_gcm_crypt_blocks(self, p, in, out, nblocks, encrypt);
+            in += nblocks * 16;
+            out += nblocks * 16;
+            in_len -= nblocks * 16;
+            continue;
+        }
+        if (n == 0) {
+            aes_gcm_encrypt_block(self, p->counter, p->keystream);
+            aes_gcm_inc32(p->counter);
+        }
+        // Byte at a time until the end of the block; in may equal out.
+        uint8_t c = *in++;
+        uint8_t o = c ^ p->keystream[n];
+        *out++ = o;
+        aes_gcm_ghash(self, p, encrypt ? &o : &c, 1);
+        n = (n + 1) & 0xf;
+        --in_len;
+    }
+}
+
+STATIC void aes_gcm_finish(mp_obj_aes_t *self, struct gcm_params *p) {
+    if (p->state != AES_GCM_STATE_DONE) {
+        uint8_t len_block[16];
+        aes_gcm_put_be64(len_block, p->aad_len * 8);
+        aes_gcm_put_be64(len_block + 8, p->data_len * 8);
+        aes_gcm_ghash_flush(self, p);
+        aes_gcm_ghash_blocks(self, p, len_block, 1);
+        for (int i = 0; i < 16; ++i) {
+            p->ghash[i] ^= p->tag_mask[i];
+        }
+        p->state = AES_GCM_STATE_DONE;
+    }
+}
+#endif
+
 STATIC mp_obj_t cryptolib_aes_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 2, 3, false);
 
@@ -221,6 +825,9 @@ STATIC mp_obj_t cryptolib_aes_make_new(const mp_obj_type_t *type, size_t n_args,
         case UCRYPTOLIB_MODE_CBC:
         #if MICROPY_PY_CRYPTOLIB_CTR
         case UCRYPTOLIB_MODE_CTR:
+        #endif
+        #if MICROPY_PY_CRYPTOLIB_GCM
+        case UCRYPTOLIB_MODE_GCM:
         #endif
             break;
 
@@ -228,7 +835,16 @@ STATIC mp_obj_t cryptolib_aes_make_new(const mp_obj_type_t *type, size_t n_args,
             mp_raise_ValueError(MP_ERROR_TEXT("mode"));
     }
 
-    mp_obj_aes_t *o = mp_obj_malloc_var(mp_obj_aes_t, struct ctr_params, !!is_ctr_mode(block_mode), type);
+    size_t params_size = 0;
+    if (is_ctr_mode(block_mode)) {
+        params_size = sizeof(struct ctr_params);
+    }
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    if (is_gcm_mode(block_mode)) {
+        params_size = sizeof(struct gcm_params);
+    }
+    #endif
+    mp_obj_aes_t *o = mp_obj_malloc_var(mp_obj_aes_t, uint8_t, params_size, type);
 
     o->block_mode = block_mode;
     o->key_type = AES_KEYTYPE_NONE;
@@ -244,10 +860,11 @@ STATIC mp_obj_t cryptolib_aes_make_new(const mp_obj_type_t *type, size_t n_args,
     if (n_args > 2 && args[2] != mp_const_none) {
         mp_get_buffer_raise(args[2], &ivinfo, MP_BUFFER_READ);
 
-        if (16 != ivinfo.len) {
+        // For GCM this is the nonce, which can be any (non-zero) length.
+        if (is_gcm_mode(block_mode) ? ivinfo.len == 0 : 16 != ivinfo.len) {
             mp_raise_ValueError(MP_ERROR_TEXT("IV"));
         }
-    } else if (o->block_mode == UCRYPTOLIB_MODE_CBC || is_ctr_mode(o->block_mode)) {
+    } else if (o->block_mode == UCRYPTOLIB_MODE_CBC || is_ctr_mode(o->block_mode) || is_gcm_mode(o->block_mode)) {
         mp_raise_ValueError(MP_ERROR_TEXT("IV"));
     }
 
@@ -255,7 +872,21 @@ STATIC mp_obj_t cryptolib_aes_make_new(const mp_obj_type_t *type, size_t n_args,
         ctr_params_from_aes(o)->offset = 0;
     }
 
-    aes_initial_set_key_impl(&o->ctx, keyinfo.buf, keyinfo.len, ivinfo.buf);
+    aes_initial_set_key_impl(&o->ctx, keyinfo.buf, keyinfo.len, is_gcm_mode(block_mode) ? NULL : ivinfo.buf);
+
+    #if MICROPY_PY_CRYPTOLIB_X64
+    o->x64_rounds = 0;
+    if (mp_cpu_x64_has(AES_X64_FEATURES)) {
+        aes_x64_set_key(o, keyinfo.buf, keyinfo.len);
+    }
+    #endif
+
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    if (is_gcm_mode(block_mode)) {
+        // GCM needs the key schedule now, to hash associated data.
+        aes_gcm_init(o, ivinfo.buf, ivinfo.len);
+    }
+    #endif
 
     return MP_OBJ_FROM_PTR(o);
 }
@@ -272,7 +903,7 @@ STATIC mp_obj_t aes_process(size_t n_args, const mp_obj_t *args, bool encrypt) {
     mp_buffer_info_t in_bufinfo;
     mp_get_buffer_raise(in_buf, &in_bufinfo, MP_BUFFER_READ);
 
-    if (!is_ctr_mode(self->block_mode) && in_bufinfo.len % 16 != 0) {
+    if (!is_ctr_mode(self->block_mode) && !is_gcm_mode(self->block_mode) && in_bufinfo.len % 16 != 0) {
         mp_raise_ValueError(MP_ERROR_TEXT("blksize % 16"));
     }
 
@@ -292,9 +923,11 @@ STATIC mp_obj_t aes_process(size_t n_args, const mp_obj_t *args, bool encrypt) {
     }
 
     if (AES_KEYTYPE_NONE == self->key_type) {
-        // always set key for encryption if CTR mode.
+        // always set key for encryption if CTR mode; GCM did so at creation.
         const bool encrypt_mode = encrypt || is_ctr_mode(self->block_mode);
-        aes_final_set_key_impl(&self->ctx, encrypt_mode);
+        if (!is_gcm_mode(self->block_mode)) {
+            aes_final_set_key(self, encrypt_mode);
+        }
         self->key_type = encrypt ? AES_KEYTYPE_ENC : AES_KEYTYPE_DEC;
     } else {
         if ((encrypt && self->key_type == AES_KEYTYPE_DEC) ||
@@ -304,8 +937,20 @@ STATIC mp_obj_t aes_process(size_t n_args, const mp_obj_t *args, bool encrypt) {
         }
     }
 
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    if (is_gcm_mode(self->block_mode) && gcm_params_from_aes(self)->state == AES_GCM_STATE_DONE) {
+        mp_raise_ValueError(MP_ERROR_TEXT("tag already computed"));
+    }
+    #endif
+
     switch (self->block_mode) {
         case UCRYPTOLIB_MODE_ECB: {
+            #if MICROPY_PY_CRYPTOLIB_X64
+            if (self->x64_rounds != 0) {
+                aes_x64_process_ecb(self, in_bufinfo.buf, out_buf_ptr, in_bufinfo.len, encrypt);
+                break;
+            }
+            #endif
             uint8_t *in = in_bufinfo.buf, *out = out_buf_ptr;
             uint8_t *top = in + in_bufinfo.len;
             for (; in < top; in += 16, out += 16) {
@@ -315,15 +960,34 @@ STATIC mp_obj_t aes_process(size_t n_args, const mp_obj_t *args, bool encrypt) {
         }
 
         case UCRYPTOLIB_MODE_CBC:
+            #if MICROPY_PY_CRYPTOLIB_X64
+            if (self->x64_rounds != 0) {
+                aes_x64_process_cbc(self, in_bufinfo.buf, out_buf_ptr, in_bufinfo.len, encrypt);
+                break;
+            }
+            #endif
             aes_process_cbc_impl(&self->ctx, in_bufinfo.buf, out_buf_ptr, in_bufinfo.len, encrypt);
             break;
 
         #if MICROPY_PY_CRYPTOLIB_CTR
         case UCRYPTOLIB_MODE_CTR:
+            #if MICROPY_PY_CRYPTOLIB_X64
+            if (self->x64_rounds != 0) {
+                aes_x64_process_ctr(self, in_bufinfo.buf, out_buf_ptr, in_bufinfo.len,
+                    ctr_params_from_aes(self));
+                break;
+            }
+            #endif
             aes_process_ctr_impl(&self->ctx, in_bufinfo.buf, out_buf_ptr, in_bufinfo.len,
                 ctr_params_from_aes(self));
             break;
         #endif
+
+        #if MICROPY_PY_CRYPTOLIB_GCM
+        case UCRYPTOLIB_MODE_GCM:
+            aes_process_gcm(self, in_bufinfo.buf, out_buf_ptr, in_bufinfo.len, encrypt);
+            break;
+        #endif
     }
 
     if (out_buf != MP_OBJ_NULL) {
@@ -342,9 +1006,65 @@ STATIC mp_obj_t cryptolib_aes_decrypt(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(cryptolib_aes_decrypt_obj, 2, 3, cryptolib_aes_decrypt);
 
+#if MICROPY_PY_CRYPTOLIB_GCM
+STATIC struct gcm_params *cryptolib_aes_get_gcm_params(mp_obj_t self_in) {
+    mp_obj_aes_t *self = MP_OBJ_TO_PTR(self_in);
+    if (!is_gcm_mode(self->block_mode)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("mode"));
+    }
+    return gcm_params_from_aes(self);
+}
+
+STATIC mp_obj_t cryptolib_aes_update(mp_obj_t self_in, mp_obj_t data_in) {
+    struct gcm_params *p = cryptolib_aes_get_gcm_params(self_in);
+    if (p->state != AES_GCM_STATE_AAD) {
+        mp_raise_ValueError(MP_ERROR_TEXT("update() after encrypt/decrypt"));
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data_in, &bufinfo, MP_BUFFER_READ);
+    p->aad_len += bufinfo.len;
+    aes_gcm_ghash(MP_OBJ_TO_PTR(self_in), p, bufinfo.buf, bufinfo.len);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(cryptolib_aes_update_obj, cryptolib_aes_update);
+
+STATIC mp_obj_t cryptolib_aes_digest(mp_obj_t self_in) {
+    struct gcm_params *p = cryptolib_aes_get_gcm_params(self_in);
+    aes_gcm_finish(MP_OBJ_TO_PTR(self_in), p);
+    return mp_obj_new_bytes(p->ghash, 16);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(cryptolib_aes_digest_obj, cryptolib_aes_digest);
+
+STATIC mp_obj_t cryptolib_aes_verify(mp_obj_t self_in, mp_obj_t tag_in) {
+    struct gcm_params *p = cryptolib_aes_get_gcm_params(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(tag_in, &bufinfo, MP_BUFFER_READ);
+    if (bufinfo.len < 4 || bufinfo.len > 16) {
+        mp_raise_ValueError(MP_ERROR_TEXT("tag"));
+    }
+    aes_gcm_finish(MP_OBJ_TO_PTR(self_in), p);
+    // Compare in constant time, allowing a truncated tag.
+    const uint8_t *tag = bufinfo.buf;
+    uint8_t diff = 0;
+    for (size_t i = 0; i < bufinfo.len; ++i) {
+        diff |= tag[i] ^ p->ghash[i];
+    }
+    if (diff != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("MAC check failed"));
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(cryptolib_aes_verify_obj, cryptolib_aes_verify);
+#endif
+
 STATIC const mp_rom_map_elem_t cryptolib_aes_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_encrypt), MP_ROM_PTR(&cryptolib_aes_encrypt_obj) },
     { MP_ROM_QSTR(MP_QSTR_decrypt), MP_ROM_PTR(&cryptolib_aes_decrypt_obj) },
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    { MP_ROM_QSTR(MP_QSTR_update), MP_ROM_PTR(&cryptolib_aes_update_obj) },
+    { MP_ROM_QSTR(MP_QSTR_digest), MP_ROM_PTR(&cryptolib_aes_digest_obj) },
+    { MP_ROM_QSTR(MP_QSTR_verify), MP_ROM_PTR(&cryptolib_aes_verify_obj) },
+    #endif
 };
 STATIC MP_DEFINE_CONST_DICT(cryptolib_aes_locals_dict, cryptolib_aes_locals_dict_table);
 
@@ -365,6 +1085,9 @@ STATIC const mp_rom_map_elem_t mp_module_cryptolib_globals_table[] = {
     #if MICROPY_PY_CRYPTOLIB_CTR
     { MP_ROM_QSTR(MP_QSTR_MODE_CTR), MP_ROM_INT(UCRYPTOLIB_MODE_CTR) },
     #endif
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    { MP_ROM_QSTR(MP_QSTR_MODE_GCM), MP_ROM_INT(UCRYPTOLIB_MODE_GCM) },
+    #endif
     #endif
 };
 
@@ -28,6 +28,8 @@
 #include <string.h>
 
 #include "py/runtime.h"
+#include "py/objarray.h"
+#include "py/stream.h"
 
 #if MICROPY_PY_HASHLIB
 
@@ -37,12 +39,21 @@
 
 #if MICROPY_PY_HASHLIB_SHA256
 
-#if MICROPY_SSL_MBEDTLS
+// The SHA extensions path is built on the crypto-algorithms context, so it
+// takes precedence over mbedtls (which has no x86-64 acceleration).
+#if MICROPY_SSL_MBEDTLS && !MICROPY_PY_HASHLIB_SHA256_X64
+#define HASHLIB_SHA256_MBEDTLS (1)
 #include "mbedtls/sha256.h"
 #else
+#define HASHLIB_SHA256_MBEDTLS (0)
 #include "lib/crypto-algorithms/sha256.h"
 #endif
 
+#if MICROPY_PY_HASHLIB_SHA256_X64
+#include <immintrin.h>
+#include "extmod/cpu_x64.h"
+#endif
+
 #endif
 
 #if MICROPY_PY_HASHLIB_SHA1 || MICROPY_PY_HASHLIB_MD5
@@ -73,7 +84,7 @@ static void hashlib_ensure_not_final(mp_obj_hash_t *self) {
 #if MICROPY_PY_HASHLIB_SHA256
 STATIC mp_obj_t hashlib_sha256_update(mp_obj_t self_in, mp_obj_t arg);
 
-#if MICROPY_SSL_MBEDTLS
+#if HASHLIB_SHA256_MBEDTLS
 
 #if MBEDTLS_VERSION_NUMBER < 0x02070000 || MBEDTLS_VERSION_NUMBER >= 0x03000000
 #define mbedtls_sha256_starts_ret mbedtls_sha256_starts
@@ -116,6 +127,85 @@ STATIC mp_obj_t hashlib_sha256_digest(mp_obj_t self_in) {
 
 #include "lib/crypto-algorithms/sha256.c"
 
+#if MICROPY_PY_HASHLIB_SHA256_X64
+
+// Process whole 64-byte blocks using the SHA extensions.  The state is kept
+// in the ABEF/CDGH lane order required by sha256rnds2 for the whole run.
+__attribute__((target("sha,sse4.1,ssse3")))
+STATIC void hashlib_sha256_blocks_x64(WORD state[8], const BYTE *data, size_t nblocks) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xb1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1b);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+    for (; nblocks > 0; --nblocks, data += 64) {
+        __m128i abef = state0;
+        __m128i cdgh = state1;
+        __m128i w[4];
+        for (int i = 0; i < 4; ++i) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * i)), bswap);
+        }
+        #pragma GCC unroll 16
+        for (int i = 0; i < 16; ++i) {
+            if (i >= 4) {
+                // W[4i..4i+3] from W[4i-16..4i-1]
+                __m128i m = _mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]);
+                m = _mm_add_epi32(m, _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4));
+                w[i & 3] = _mm_sha256msg2_epu32(m, w[(i + 3) & 3]);
+            }
+            __m128i m = _mm_add_epi32(w[i & 3], _mm_loadu_si128((const __m128i *)&k[4 * i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(m, 0x0e));
+        }
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(tmp, state1, 0xf0));
+    _mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#endif
+
+// Like sha256_update but whole blocks are transformed directly from the
+// caller's buffer, rather than being copied through ctx->data byte by byte.
+STATIC void hashlib_sha256_update_buf(CRYAL_SHA256_CTX *ctx, const BYTE *data, size_t len) {
+    if (ctx->datalen > 0) {
+        size_t n = MIN(len, 64 - ctx->datalen);
+        memcpy(ctx->data + ctx->datalen, data, n);
+        ctx->datalen += n;
+        data += n;
+        len -= n;
+        if (ctx->datalen < 64) {
+            return;
+        }
+        sha256_transform(ctx, ctx->data);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
+    }
+    size_t nblocks = len / 64;
+    if (nblocks > 0) {
+        #if MICROPY_PY_HASHLIB_SHA256_X64
+        if (mp_cpu_x64_has(MP_CPU_X64_SHA | MP_CPU_X64_SSE41 | MP_CPU_X64_SSSE3)) {
+            hashlib_sha256_blocks_x64(ctx->state, data, nblocks);
+        } else
+        #endif
+        {
+            for (size_t i = 0; i < nblocks; ++i) {
+                sha256_transform(ctx, data + 64 * i);
+            }
+        }
+        ctx->bitlen += (unsigned long long)nblocks * 512;
+        data += nblocks * 64;
+        len -= nblocks * 64;
+    }
+    memcpy(ctx->data, data, len);
+    ctx->datalen = len;
+}
+
 STATIC mp_obj_t hashlib_sha256_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 0, 1, false);
     mp_obj_hash_t *o = mp_obj_malloc_var(mp_obj_hash_t, char, sizeof(CRYAL_SHA256_CTX), type);
@@ -132,7 +222,7 @@ STATIC mp_obj_t hashlib_sha256_update(mp_obj_t self_in, mp_obj_t arg) {
     hashlib_ensure_not_final(self);
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(arg, &bufinfo, MP_BUFFER_READ);
-    sha256_update((CRYAL_SHA256_CTX *)self->state, bufinfo.buf, bufinfo.len);
+    hashlib_sha256_update_buf((CRYAL_SHA256_CTX *)self->state, bufinfo.buf, bufinfo.len);
     return mp_const_none;
 }
 
@@ -354,6 +444,69 @@ STATIC MP_DEFINE_CONST_OBJ_TYPE(
     );
 #endif // MICROPY_PY_HASHLIB_MD5
 
+#if MICROPY_PY_HASHLIB_FILE_DIGEST
+STATIC const mp_obj_dict_t mp_module_hashlib_globals;
+
+// file_digest(fileobj, digest, /, *, _bufsize=4096)
+// Hash the contents of a stream, reading it through a single buffer that is
+// reused for every chunk.  digest is either the name of an algorithm in this
+// module or a callable that returns a new hash object.
+STATIC mp_obj_t hashlib_file_digest(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_fileobj, ARG_digest, ARG__bufsize };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR_, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_NONE} },
+        { MP_QSTR__bufsize, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = 4096} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_obj_t digest = args[ARG_digest].u_obj;
+    if (mp_obj_is_str(digest)) {
+        size_t len;
+        const char *name = mp_obj_str_get_data(digest, &len);
+        qstr q = qstr_find_strn(name, len);
+        mp_map_elem_t *elem = NULL;
+        if (q != MP_QSTRnull) {
+            elem = mp_map_lookup((mp_map_t *)&mp_module_hashlib_globals.map, MP_OBJ_NEW_QSTR(q), MP_MAP_LOOKUP);
+        }
+        if (elem == NULL || !mp_obj_is_type(elem->value, &mp_type_type)) {
+            mp_raise_ValueError(MP_ERROR_TEXT("unsupported hash type"));
+        }
+        digest = elem->value;
+    }
+    mp_obj_t hash = mp_call_function_0(digest);
+
+    mp_int_t bufsize = args[ARG__bufsize].u_int;
+    if (bufsize <= 0) {
+        mp_raise_ValueError(NULL);
+    }
+    mp_obj_t fileobj = args[ARG_fileobj].u_obj;
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(fileobj, MP_STREAM_OP_READ);
+    mp_obj_array_t *buf = MP_OBJ_TO_PTR(mp_obj_new_bytearray_by_ref(bufsize, m_new(byte, bufsize)));
+    mp_obj_t dest[3];
+    for (;;) {
+        int errcode;
+        mp_uint_t n = stream_p->read(fileobj, buf->items, bufsize, &errcode);
+        if (n == MP_STREAM_ERROR) {
+            mp_raise_OSError(errcode);
+        }
+        if (n == 0) {
+            break;
+        }
+        // Shrink the buffer's visible length for a short read instead of
+        // making a new object, so update() sees exactly the bytes read.
+        buf->free = bufsize - n;
+        buf->len = n;
+        mp_load_method(hash, MP_QSTR_update, dest);
+        dest[2] = MP_OBJ_FROM_PTR(buf);
+        mp_call_method_n_kw(1, 0, dest);
+    }
+    return hash;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(hashlib_file_digest_obj, 2, hashlib_file_digest);
+#endif
+
 STATIC const mp_rom_map_elem_t mp_module_hashlib_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_hashlib) },
     #if MICROPY_PY_HASHLIB_SHA256
@@ -365,6 +518,9 @@ STATIC const mp_rom_map_elem_t mp_module_hashlib_globals_table[] = {
     #if MICROPY_PY_HASHLIB_MD5
     { MP_ROM_QSTR(MP_QSTR_md5), MP_ROM_PTR(&hashlib_md5_type) },
     #endif
+    #if MICROPY_PY_HASHLIB_FILE_DIGEST
+    { MP_ROM_QSTR(MP_QSTR_file_digest), MP_ROM_PTR(&hashlib_file_digest_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_hashlib_globals, mp_module_hashlib_globals_table);
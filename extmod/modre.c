@@ -45,8 +45,22 @@
 
 #define FLAG_DEBUG 0x1000
 
+// The compiled pattern cache needs root pointers, so it's not available to natmods.
+#define RE_USE_CACHE (MICROPY_PY_RE_CACHE_SIZE > 0 && !MICROPY_ENABLE_DYNRUNTIME)
+#define RE_USE_PREFILTER (MICROPY_PY_RE_PREFILTER && !MICROPY_ENABLE_DYNRUNTIME)
+
+// Maximum number of literal prefix bytes kept for the search prefilter.
+#define RE_PREFIX_MAX (15)
+
 typedef struct _mp_obj_re_t {
     mp_obj_base_t base;
+    #if RE_USE_CACHE
+    mp_obj_t pattern;
+    #endif
+    #if RE_USE_PREFILTER
+    uint8_t prefix_len;
+    char prefix[RE_PREFIX_MAX];
+    #endif
     ByteProg re;
 } mp_obj_re_t;
 
@@ -62,6 +76,118 @@ STATIC mp_obj_t mod_re_compile(size_t n_args, const mp_obj_t *args);
 STATIC const mp_obj_type_t re_type;
 #endif
 
+#if RE_USE_CACHE
+
+// Look up a compiled pattern in the cache, moving it to the front if found.
+STATIC mp_obj_re_t *re_cache_lookup(mp_obj_t pattern) {
+    mp_obj_re_t **cache = MP_STATE_VM(re_cache);
+    size_t len = 0;
+    const char *data = NULL;
+    for (size_t i = 0; i < MICROPY_PY_RE_CACHE_SIZE; ++i) {
+        mp_obj_re_t *o = cache[i];
+        if (o == NULL) {
+            break;
+        }
+        bool hit = o->pattern == pattern;
+        if (!hit && !(mp_obj_is_qstr(pattern) && mp_obj_is_qstr(o->pattern))) {
+            if (data == NULL) {
+                data = mp_obj_str_get_data(pattern, &len);
+            }
+            size_t o_len;
+            const char *o_data = mp_obj_str_get_data(o->pattern, &o_len);
+            hit = len == o_len && memcmp(data, o_data, len) == 0;
+        }
+        if (hit) {
+            // Entries are single pointers so a concurrent update can only
+            // lose or duplicate an entry, never pair a pattern with the
+            // wrong compiled code.
+            memmove(&cache[1], &cache[0], i * sizeof(*cache));
+            cache[0] = o;
+            return o;
+        }
+    }
+    return NULL;
+}
+
+// Insert a compiled pattern at the front of the cache, evicting the least
+// recently used entry if the cache is full.
+STATIC void re_cache_insert(mp_obj_re_t *o) {
+    mp_obj_re_t **cache = MP_STATE_VM(re_cache);
+    memmove(&cache[1], &cache[0], (MICROPY_PY_RE_CACHE_SIZE - 1) * sizeof(*cache));
+    cache[0] = o;
+}
+
+#endif
+
+// Get the compiled form of the pattern passed as the first argument to a
+// module-level function, which may either be a compiled regex object or a
+// string that needs compiling.
+STATIC mp_obj_re_t *re_get_compiled(mp_obj_t pattern) {
+    if (mp_obj_is_type(pattern, (mp_obj_type_t *)&re_type)) {
+        return MP_OBJ_TO_PTR(pattern);
+    }
+    #if RE_USE_CACHE
+    mp_obj_re_t *o = re_cache_lookup(pattern);
+    if (o == NULL) {
+        o = MP_OBJ_TO_PTR(mod_re_compile(1, &pattern));
+        re_cache_insert(o);
+    }
+    return o;
+    #else
+    return MP_OBJ_TO_PTR(mod_re_compile(1, &pattern));
+    #endif
+}
+
+#if RE_USE_PREFILTER
+
+// Extract the literal bytes that any match must begin with.  These are the
+// Char instructions executed in a straight line from the start of the
+// anchored program, before the first branch, class or assertion.
+STATIC void re_compute_prefix(mp_obj_re_t *self) {
+    const char *pc = HANDLE_ANCHORED(self->re.insts, true);
+    size_t n = 0;
+    while (n < RE_PREFIX_MAX) {
+        if (*pc == Char) {
+            self->prefix[n++] = pc[1];
+        } else if (*pc != Save) {
+            break;
+        }
+        pc += 2;
+    }
+    self->prefix_len = n;
+}
+
+#endif
+
+// Run the regex against the subject.  For a non-anchored search with a
+// literal prefix, candidate start positions are located with memchr/memcmp
+// and the anchored program is only run at those positions.
+STATIC int re_exec_prog(mp_obj_re_t *self, Subject *subj, const char **caps, int caps_num, bool is_anchored) {
+    #if RE_USE_PREFILTER
+    size_t prefix_len = self->prefix_len;
+    if (!is_anchored && prefix_len > 0) {
+        const char *sp = subj->begin;
+        const char *top = subj->end - prefix_len;
+        while (sp <= top) {
+            sp = memchr(sp, (unsigned char)self->prefix[0], top - sp + 1);
+            if (sp == NULL) {
+                break;
+            }
+            if (memcmp(sp + 1, self->prefix + 1, prefix_len - 1) == 0) {
+                Subject s = *subj;
+                s.begin = sp;
+                if (re1_5_recursiveloopprog(&self->re, &s, caps, caps_num, true)) {
+                    return 1;
+                }
+            }
+            ++sp;
+        }
+        return 0;
+    }
+    #endif
+    return re1_5_recursiveloopprog(&self->re, subj, caps, caps_num, is_anchored);
+}
+
 STATIC void match_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     (void)kind;
     mp_obj_match_t *self = MP_OBJ_TO_PTR(self_in);
@@ -196,12 +322,7 @@ STATIC void re_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t
 
 STATIC mp_obj_t re_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
     (void)n_args;
-    mp_obj_re_t *self;
-    if (mp_obj_is_type(args[0], (mp_obj_type_t *)&re_type)) {
-        self = MP_OBJ_TO_PTR(args[0]);
-    } else {
-        self = MP_OBJ_TO_PTR(mod_re_compile(1, args));
-    }
+    mp_obj_re_t *self = re_get_compiled(args[0]);
     Subject subj;
     size_t len;
     subj.begin_line = subj.begin = mp_obj_str_get_data(args[1], &len);
@@ -210,7 +331,7 @@ STATIC mp_obj_t re_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
     mp_obj_match_t *match = m_new_obj_var(mp_obj_match_t, caps, char *, caps_num);
     // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
     memset((char *)match->caps, 0, caps_num * sizeof(char *));
-    int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, is_anchored);
+    int res = re_exec_prog(self, &subj, match->caps, caps_num, is_anchored);
     if (res == 0) {
         m_del_var(mp_obj_match_t, caps, char *, caps_num, match);
         return mp_const_none;
@@ -251,7 +372,7 @@ STATIC mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
     while (true) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char **)caps, 0, caps_num * sizeof(char *));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, caps, caps_num, false);
+        int res = re_exec_prog(self, &subj, caps, caps_num, false);
 
         // if we didn't have a match, or had an empty match, it's time to stop
         if (!res || caps[0] == caps[1]) {
@@ -280,12 +401,7 @@ MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(re_split_obj, 2, 3, re_split);
 #if MICROPY_PY_RE_SUB
 
 STATIC mp_obj_t re_sub_helper(size_t n_args, const mp_obj_t *args) {
-    mp_obj_re_t *self;
-    if (mp_obj_is_type(args[0], (mp_obj_type_t *)&re_type)) {
-        self = MP_OBJ_TO_PTR(args[0]);
-    } else {
-        self = MP_OBJ_TO_PTR(mod_re_compile(1, args));
-    }
+    mp_obj_re_t *self = re_get_compiled(args[0]);
     mp_obj_t replace = args[1];
     mp_obj_t where = args[2];
     mp_int_t count = 0;
@@ -311,7 +427,7 @@ STATIC mp_obj_t re_sub_helper(size_t n_args, const mp_obj_t *args) {
     for (;;) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char *)match->caps, 0, caps_num * sizeof(char *));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, false);
+        int res = re_exec_prog(self, &subj, match->caps, caps_num, false);
 
         // If we didn't have a match, or had an empty match, it's time to stop
         if (!res || match->caps[0] == match->caps[1]) {
@@ -445,6 +561,12 @@ STATIC mp_obj_t mod_re_compile(size_t n_args, const mp_obj_t *args) {
         re1_5_dumpcode(&o->re);
     }
     #endif
+    #if RE_USE_CACHE
+    o->pattern = args[0];
+    #endif
+    #if RE_USE_PREFILTER
+    re_compute_prefix(o);
+    #endif
     return MP_OBJ_FROM_PTR(o);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_compile_obj, 1, 2, mod_re_compile);
@@ -471,6 +593,10 @@ const mp_obj_module_t mp_module_re = {
 };
 
 MP_REGISTER_EXTENSIBLE_MODULE(MP_QSTR_re, mp_module_re);
+
+#if RE_USE_CACHE
+MP_REGISTER_ROOT_POINTER(struct _mp_obj_re_t *re_cache[MICROPY_PY_RE_CACHE_SIZE]);
+#endif
 #endif
 
 // Source files #include'd here to make sure they're compiled in
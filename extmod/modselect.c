@@ -76,6 +76,11 @@ typedef struct _poll_obj_t {
     struct pollfd *pollfd;
     uint16_t nonfd_events;
     uint16_t nonfd_revents;
+    #if MICROPY_STREAMS_READ_BUFFER
+    // If the object has a file descriptor and a read-ahead buffer then data in the
+    // buffer can be read even when the file descriptor isn't readable.
+    mp_stream_rbuf_t *rbuf;
+    #endif
     #else
     mp_uint_t events;
     mp_uint_t revents;
@@ -92,6 +97,9 @@ typedef struct _poll_set_t {
     unsigned short alloc; // memory allocated for pollfds
     unsigned short max_used; // maximum number of used entries in pollfds
     unsigned short used; // actual number of used entries in pollfds
+    #if MICROPY_STREAMS_READ_BUFFER
+    unsigned short used_rbuf; // number of objects with a file descriptor and read-ahead buffer
+    #endif
     struct pollfd *pollfds;
     #endif
 } poll_set_t;
@@ -102,6 +110,9 @@ STATIC void poll_set_init(poll_set_t *poll_set, size_t n) {
     poll_set->alloc = 0;
     poll_set->max_used = 0;
     poll_set->used = 0;
+    #if MICROPY_STREAMS_READ_BUFFER
+    poll_set->used_rbuf = 0;
+    #endif
     poll_set->pollfds = NULL;
     #endif
 }
@@ -208,6 +219,32 @@ static inline bool poll_set_all_are_fds(poll_set_t *poll_set) {
     return poll_set->map.used == poll_set->used;
 }
 
+#if MICROPY_STREAMS_READ_BUFFER
+// Find the objects waiting to read which have data in their read-ahead buffer.
+// If mark is true then they're made ready to read, and the number of them that
+// weren't already ready is returned, otherwise just the number is returned.
+STATIC mp_uint_t poll_set_poll_rbufs(poll_set_t *poll_set, bool mark) {
+    mp_uint_t n = 0;
+    for (mp_uint_t i = 0; i < poll_set->map.alloc; ++i) {
+        if (!mp_map_slot_is_filled(&poll_set->map, i)) {
+            continue;
+        }
+        poll_obj_t *poll_obj = MP_OBJ_TO_PTR(poll_set->map.table[i].value);
+        if (poll_obj->pollfd == NULL || poll_obj->rbuf == NULL
+            || !(poll_obj->pollfd->events & POLLIN) || mp_stream_rbuf_unread(poll_obj->rbuf) == 0) {
+            continue;
+        }
+        if (!mark) {
+            n += 1;
+        } else {
+            n += poll_obj->pollfd->revents == 0;
+            poll_obj->pollfd->revents |= POLLIN;
+        }
+    }
+    return n;
+}
+#endif
+
 #else
 
 static inline mp_uint_t poll_obj_get_events(poll_obj_t *poll_obj) {
@@ -249,6 +286,9 @@ STATIC void poll_set_add_obj(poll_set_t *poll_set, const mp_obj_t *obj, mp_uint_
                     mp_raise_ValueError(NULL);
                 }
                 poll_obj->ioctl = NULL;
+                #if MICROPY_STREAMS_READ_BUFFER
+                poll_obj->rbuf = NULL;
+                #endif
             } else {
                 // An object passed in.  Check if it has a file descriptor.
                 const mp_stream_p_t *stream_p = mp_get_stream_raise(obj[i], MP_STREAM_OP_IOCTL);
@@ -258,6 +298,12 @@ STATIC void poll_set_add_obj(poll_set_t *poll_set, const mp_obj_t *obj, mp_uint_
                 if (res != MP_STREAM_ERROR) {
                     fd = res;
                 }
+                #if MICROPY_STREAMS_READ_BUFFER
+                poll_obj->rbuf = fd >= 0 ? mp_stream_get_rbuf(obj[i], stream_p) : NULL;
+                if (poll_obj->rbuf != NULL) {
+                    ++poll_set->used_rbuf;
+                }
+                #endif
             }
             if (fd >= 0) {
                 // Object has a file descriptor so add it to pollfds.
@@ -345,6 +391,11 @@ STATIC mp_uint_t poll_set_poll_until_ready_or_timeout(poll_set_t *poll_set, size
     #if MICROPY_PY_SELECT_POSIX_OPTIMISATIONS
 
     for (;;) {
+        #if MICROPY_STREAMS_READ_BUFFER
+        // Buffered data means that poll() below mustn't wait.
+        bool buffered = poll_set->used_rbuf != 0 && poll_set_poll_rbufs(poll_set, false) != 0;
+        #endif
+
         MP_THREAD_GIL_EXIT();
 
         // Compute the timeout.
@@ -363,6 +414,11 @@ STATIC mp_uint_t poll_set_poll_until_ready_or_timeout(poll_set_t *poll_set, size
                 }
             }
         }
+        #if MICROPY_STREAMS_READ_BUFFER
+        if (buffered) {
+            t = 0;
+        }
+        #endif
 
         // Call system poll for those objects that have a file descriptor.
         int n_ready = poll(poll_set->pollfds, poll_set->max_used, t);
@@ -379,6 +435,12 @@ STATIC mp_uint_t poll_set_poll_until_ready_or_timeout(poll_set_t *poll_set, size
             n_ready = 0;
         }
 
+        #if MICROPY_STREAMS_READ_BUFFER
+        if (buffered) {
+            n_ready += poll_set_poll_rbufs(poll_set, true);
+        }
+        #endif
+
         // Explicitly poll any objects that do not have a file descriptor.
         if (!poll_set_all_are_fds(poll_set)) {
             n_ready += poll_set_poll_once(poll_set, rwx_num);
@@ -511,6 +573,11 @@ STATIC mp_obj_t poll_unregister(mp_obj_t self_in, mp_obj_t obj_in) {
             poll_obj->pollfd->fd = -1;
             --self->poll_set.used;
         }
+        #if MICROPY_STREAMS_READ_BUFFER
+        if (poll_obj->rbuf != NULL) {
+            --self->poll_set.used_rbuf;
+        }
+        #endif
         elem->value = MP_OBJ_NULL;
     }
     #else
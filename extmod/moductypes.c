@@ -31,6 +31,8 @@
 #include "py/runtime.h"
 #include "py/objtuple.h"
 #include "py/binary.h"
+#include "py/smallint.h"
+#include "py/stackctrl.h"
 
 #if MICROPY_PY_UCTYPES
 
@@ -89,6 +91,36 @@ typedef struct _mp_obj_uctypes_struct_t {
     uint32_t flags;
 } mp_obj_uctypes_struct_t;
 
+#if MICROPY_PY_UCTYPES_COMPILE
+
+// A compiled descriptor holds the fields of a STRUCT descriptor already
+// decoded, in a table sorted by name, so that accessing a field doesn't need a
+// dict lookup and the offset/type decoding each time.
+STATIC const mp_obj_type_t uctypes_compiled_type;
+
+// Kind of a compiled field, in addition to the aggregate types STRUCT/PTR/ARRAY
+#define FIELD_SCALAR (3)
+
+typedef struct _uctypes_field_t {
+    qstr name;
+    uint32_t offset;
+    uint8_t kind;
+    uint8_t val_type;
+    uint8_t bit_offset;
+    uint8_t bit_len;
+    // For STRUCT, the (compiled) nested descriptor; for PTR and ARRAY, the tuple
+    mp_obj_t sub;
+} uctypes_field_t;
+
+typedef struct _mp_obj_uctypes_compiled_t {
+    mp_obj_base_t base;
+    mp_obj_t desc;
+    size_t n_fields;
+    uctypes_field_t fields[];
+} mp_obj_uctypes_compiled_t;
+
+#endif
+
 STATIC NORETURN void syntax_error(void) {
     mp_raise_TypeError(MP_ERROR_TEXT("syntax error in uctypes descriptor"));
 }
@@ -109,7 +141,11 @@ STATIC void uctypes_struct_print(const mp_print_t *print, mp_obj_t self_in, mp_p
     (void)kind;
     mp_obj_uctypes_struct_t *self = MP_OBJ_TO_PTR(self_in);
     const char *typen = "unk";
-    if (mp_obj_is_dict_or_ordereddict(self->desc)) {
+    if (mp_obj_is_dict_or_ordereddict(self->desc)
+        #if MICROPY_PY_UCTYPES_COMPILE
+        || mp_obj_is_type(self->desc, &uctypes_compiled_type)
+        #endif
+        ) {
         typen = "STRUCT";
     } else if (mp_obj_is_type(self->desc, &mp_type_tuple)) {
         mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->desc);
@@ -182,6 +218,11 @@ STATIC mp_uint_t uctypes_struct_agg_size(mp_obj_tuple_t *t, int layout_type, mp_
 }
 
 STATIC mp_uint_t uctypes_struct_size(mp_obj_t desc_in, int layout_type, mp_uint_t *max_field_size) {
+    #if MICROPY_PY_UCTYPES_COMPILE
+    if (mp_obj_is_type(desc_in, &uctypes_compiled_type)) {
+        desc_in = ((mp_obj_uctypes_compiled_t *)MP_OBJ_TO_PTR(desc_in))->desc;
+    }
+    #endif
     if (!mp_obj_is_dict_or_ordereddict(desc_in)) {
         if (mp_obj_is_type(desc_in, &mp_type_tuple)) {
             return uctypes_struct_agg_size((mp_obj_tuple_t *)MP_OBJ_TO_PTR(desc_in), layout_type, max_field_size);
@@ -264,13 +305,128 @@ STATIC mp_obj_t uctypes_struct_sizeof(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(uctypes_struct_sizeof_obj, 1, 2, uctypes_struct_sizeof);
 
+#if MICROPY_PY_UCTYPES_COMPILE
+
+// compile()
+// Decode a STRUCT descriptor into a compiled descriptor that can be passed to
+// struct() in its place.  Nested STRUCT descriptors are compiled as well.
+STATIC mp_obj_t uctypes_compile(mp_obj_t desc_in) {
+    MP_STACK_CHECK();
+    if (mp_obj_is_type(desc_in, &uctypes_compiled_type)) {
+        return desc_in;
+    }
+    if (!mp_obj_is_dict_or_ordereddict(desc_in)) {
+        syntax_error();
+    }
+
+    mp_obj_dict_t *d = MP_OBJ_TO_PTR(desc_in);
+    size_t n = d->map.used;
+    mp_obj_uctypes_compiled_t *o = mp_obj_malloc_var(mp_obj_uctypes_compiled_t, uctypes_field_t, n, &uctypes_compiled_type);
+    o->desc = desc_in;
+    o->n_fields = 0;
+
+    for (size_t i = 0; i < d->map.alloc; i++) {
+        if (!mp_map_slot_is_filled(&d->map, i)) {
+            continue;
+        }
+        uctypes_field_t f;
+        f.name = mp_obj_str_get_qstr(d->map.table[i].key);
+        f.bit_offset = 0;
+        f.bit_len = 0;
+        f.sub = MP_OBJ_NULL;
+        mp_obj_t v = d->map.table[i].value;
+        if (mp_obj_is_small_int(v)) {
+            mp_int_t offset = MP_OBJ_SMALL_INT_VALUE(v);
+            f.kind = FIELD_SCALAR;
+            f.val_type = GET_TYPE(offset, VAL_TYPE_BITS);
+            offset &= VALUE_MASK(VAL_TYPE_BITS);
+            if (f.val_type >= BFUINT8 && f.val_type <= BFINT32) {
+                f.bit_offset = (offset >> OFFSET_BITS) & 31;
+                f.bit_len = (offset >> LEN_BITS) & 31;
+                offset &= (1 << OFFSET_BITS) - 1;
+            }
+            f.offset = offset;
+        } else {
+            if (!mp_obj_is_type(v, &mp_type_tuple)) {
+                syntax_error();
+            }
+            mp_obj_tuple_t *t = MP_OBJ_TO_PTR(v);
+            mp_int_t offset = MP_OBJ_SMALL_INT_VALUE(t->items[0]);
+            f.kind = GET_TYPE(offset, AGG_TYPE_BITS);
+            f.val_type = 0;
+            f.offset = offset & VALUE_MASK(AGG_TYPE_BITS);
+            f.sub = v;
+            if (f.kind == STRUCT) {
+                f.sub = t->items[1];
+                if (mp_obj_is_dict_or_ordereddict(f.sub)) {
+                    f.sub = uctypes_compile(f.sub);
+                }
+            }
+        }
+
+        // Insert the field keeping the table sorted by name
+        size_t j = o->n_fields++;
+        for (; j > 0 && o->fields[j - 1].name > f.name; --j) {
+            o->fields[j] = o->fields[j - 1];
+        }
+        o->fields[j] = f;
+    }
+
+    return MP_OBJ_FROM_PTR(o);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(uctypes_compile_obj, uctypes_compile);
+
+STATIC const uctypes_field_t *uctypes_compiled_lookup(mp_obj_uctypes_compiled_t *self, qstr attr) {
+    size_t lo = 0;
+    size_t hi = self->n_fields;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (self->fields[mid].name < attr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == self->n_fields || self->fields[lo].name != attr) {
+        mp_raise_type_arg(&mp_type_KeyError, MP_OBJ_NEW_QSTR(attr));
+    }
+    return &self->fields[lo];
+}
+
+STATIC MP_DEFINE_CONST_OBJ_TYPE(
+    uctypes_compiled_type,
+    MP_QSTR_descriptor,
+    MP_TYPE_FLAG_NONE
+    );
+
+#endif
+
 static inline mp_obj_t get_unaligned(uint val_type, byte *p, int big_endian) {
+    if (val_type <= INT64) {
+        // Load integers directly, instead of going via a struct type code
+        long long val = mp_binary_get_int(GET_SCALAR_SIZE(val_type), val_type & 1, big_endian, p);
+        if (val_type & 1) {
+            if ((long long)MP_SMALL_INT_MIN <= val && val <= (long long)MP_SMALL_INT_MAX) {
+                return MP_OBJ_NEW_SMALL_INT((mp_int_t)val);
+            }
+            return mp_obj_new_int_from_ll(val);
+        } else {
+            if ((unsigned long long)val <= (unsigned long long)MP_SMALL_INT_MAX) {
+                return MP_OBJ_NEW_SMALL_INT((mp_int_t)val);
+            }
+            return mp_obj_new_int_from_ull(val);
+        }
+    }
     char struct_type = big_endian ? '>' : '<';
     static const char type2char[16] = "BbHhIiQq------fd";
     return mp_binary_get_val(struct_type, type2char[val_type], p, &p);
 }
 
 static inline void set_unaligned(uint val_type, byte *p, int big_endian, mp_obj_t val) {
+    if (val_type <= INT64 && (size_t)GET_SCALAR_SIZE(val_type) <= sizeof(mp_uint_t)) {
+        mp_binary_set_int(GET_SCALAR_SIZE(val_type), big_endian, p, mp_obj_get_int_truncated(val));
+        return;
+    }
     char struct_type = big_endian ? '>' : '<';
     static const char type2char[16] = "BbHhIiQq------fd";
     mp_binary_set_val(struct_type, type2char[val_type], val, p, &p);
@@ -379,97 +535,82 @@ STATIC void set_aligned(uint val_type, void *p, mp_int_t index, mp_obj_t val) {
     }
 }
 
-STATIC mp_obj_t uctypes_struct_attr_op(mp_obj_t self_in, qstr attr, mp_obj_t set_val) {
-    mp_obj_uctypes_struct_t *self = MP_OBJ_TO_PTR(self_in);
-
-    if (!mp_obj_is_dict_or_ordereddict(self->desc)) {
-        mp_raise_TypeError(MP_ERROR_TEXT("struct: no fields"));
-    }
-
-    mp_obj_t deref = mp_obj_dict_get(self->desc, MP_OBJ_NEW_QSTR(attr));
-    if (mp_obj_is_small_int(deref)) {
-        mp_int_t offset = MP_OBJ_SMALL_INT_VALUE(deref);
-        mp_uint_t val_type = GET_TYPE(offset, VAL_TYPE_BITS);
-        offset &= VALUE_MASK(VAL_TYPE_BITS);
-
-        if (val_type <= INT64 || val_type == FLOAT32 || val_type == FLOAT64) {
-            if (self->flags == LAYOUT_NATIVE) {
-                if (set_val == MP_OBJ_NULL) {
-                    return get_aligned(val_type, self->addr + offset, 0);
-                } else {
-                    set_aligned(val_type, self->addr + offset, 0, set_val);
-                    return set_val; // just !MP_OBJ_NULL
-                }
-            } else {
-                if (set_val == MP_OBJ_NULL) {
-                    return get_unaligned(val_type, self->addr + offset, self->flags);
-                } else {
-                    set_unaligned(val_type, self->addr + offset, self->flags, set_val);
-                    return set_val; // just !MP_OBJ_NULL
-                }
-            }
-        } else if (val_type >= BFUINT8 && val_type <= BFINT32) {
-            uint bit_offset = (offset >> OFFSET_BITS) & 31;
-            uint bit_len = (offset >> LEN_BITS) & 31;
-            offset &= (1 << OFFSET_BITS) - 1;
-            mp_uint_t val;
-            if (self->flags == LAYOUT_NATIVE) {
-                val = get_aligned_basic(val_type & 6, self->addr + offset);
+// Load or store a scalar field at the given offset of a struct; for bitfields
+// bit_offset and bit_len give the position of the field within the word.
+STATIC mp_obj_t uctypes_struct_scalar_op(mp_obj_uctypes_struct_t *self, mp_uint_t val_type, mp_uint_t offset,
+    uint bit_offset, uint bit_len, mp_obj_t set_val) {
+    if (val_type <= INT64 || val_type == FLOAT32 || val_type == FLOAT64) {
+        if (self->flags == LAYOUT_NATIVE) {
+            if (set_val == MP_OBJ_NULL) {
+                return get_aligned(val_type, self->addr + offset, 0);
             } else {
-                val = mp_binary_get_int(GET_SCALAR_SIZE(val_type & 7), val_type & 1, self->flags, self->addr + offset);
+                set_aligned(val_type, self->addr + offset, 0, set_val);
+                return set_val; // just !MP_OBJ_NULL
             }
+        } else {
             if (set_val == MP_OBJ_NULL) {
-                val >>= bit_offset;
-                val &= (1 << bit_len) - 1;
-                // TODO: signed
-                assert((val_type & 1) == 0);
-                return mp_obj_new_int(val);
+                return get_unaligned(val_type, self->addr + offset, self->flags);
             } else {
-                mp_uint_t set_val_int = (mp_uint_t)mp_obj_get_int(set_val);
-                mp_uint_t mask = (1 << bit_len) - 1;
-                set_val_int &= mask;
-                set_val_int <<= bit_offset;
-                mask <<= bit_offset;
-                val = (val & ~mask) | set_val_int;
-
-                if (self->flags == LAYOUT_NATIVE) {
-                    set_aligned_basic(val_type & 6, self->addr + offset, val);
-                } else {
-                    mp_binary_set_int(GET_SCALAR_SIZE(val_type & 7), self->flags == LAYOUT_BIG_ENDIAN,
-                        self->addr + offset, val);
-                }
+                set_unaligned(val_type, self->addr + offset, self->flags, set_val);
                 return set_val; // just !MP_OBJ_NULL
             }
         }
+    } else if (val_type >= BFUINT8 && val_type <= BFINT32) {
+        mp_uint_t val;
+        if (self->flags == LAYOUT_NATIVE) {
+            val = get_aligned_basic(val_type & 6, self->addr + offset);
+        } else {
+            val = mp_binary_get_int(GET_SCALAR_SIZE(val_type & 7), val_type & 1, self->flags, self->addr + offset);
+        }
+        if (set_val == MP_OBJ_NULL) {
+            val >>= bit_offset;
+            val &= (1 << bit_len) - 1;
+            // TODO: signed
+            assert((val_type & 1) == 0);
+            return mp_obj_new_int(val);
+        } else {
+            mp_uint_t set_val_int = (mp_uint_t)mp_obj_get_int(set_val);
+            mp_uint_t mask = (1 << bit_len) - 1;
+            set_val_int &= mask;
+            set_val_int <<= bit_offset;
+            mask <<= bit_offset;
+            val = (val & ~mask) | set_val_int;
 
-        assert(0);
-        return MP_OBJ_NULL;
+            if (self->flags == LAYOUT_NATIVE) {
+                set_aligned_basic(val_type & 6, self->addr + offset, val);
+            } else {
+                mp_binary_set_int(GET_SCALAR_SIZE(val_type & 7), self->flags == LAYOUT_BIG_ENDIAN,
+                    self->addr + offset, val);
+            }
+            return set_val; // just !MP_OBJ_NULL
+        }
     }
 
-    if (!mp_obj_is_type(deref, &mp_type_tuple)) {
-        syntax_error();
-    }
+    assert(0);
+    return MP_OBJ_NULL;
+}
 
+// Load an aggregate field at the given offset of a struct.  For STRUCT the
+// desc is the descriptor of the nested struct, otherwise it is the PTR or
+// ARRAY tuple itself.
+STATIC mp_obj_t uctypes_struct_agg_op(mp_obj_uctypes_struct_t *self, mp_uint_t agg_type, mp_uint_t offset,
+    mp_obj_t desc, mp_obj_t set_val) {
     if (set_val != MP_OBJ_NULL) {
         // Cannot assign to aggregate
         syntax_error();
     }
 
-    mp_obj_tuple_t *sub = MP_OBJ_TO_PTR(deref);
-    mp_int_t offset = MP_OBJ_SMALL_INT_VALUE(sub->items[0]);
-    mp_uint_t agg_type = GET_TYPE(offset, AGG_TYPE_BITS);
-    offset &= VALUE_MASK(AGG_TYPE_BITS);
-
     switch (agg_type) {
         case STRUCT: {
             mp_obj_uctypes_struct_t *o = mp_obj_malloc(mp_obj_uctypes_struct_t, &uctypes_struct_type);
-            o->desc = sub->items[1];
+            o->desc = desc;
             o->addr = self->addr + offset;
             o->flags = self->flags;
             return MP_OBJ_FROM_PTR(o);
         }
         case ARRAY: {
             mp_uint_t dummy;
+            mp_obj_tuple_t *sub = MP_OBJ_TO_PTR(desc);
             if (IS_SCALAR_ARRAY(sub) && IS_SCALAR_ARRAY_OF_BYTES(sub)) {
                 return mp_obj_new_bytearray_by_ref(uctypes_struct_agg_size(sub, self->flags, &dummy), self->addr + offset);
             }
@@ -478,7 +619,7 @@ STATIC mp_obj_t uctypes_struct_attr_op(mp_obj_t self_in, qstr attr, mp_obj_t set
         }
         case PTR: {
             mp_obj_uctypes_struct_t *o = mp_obj_malloc(mp_obj_uctypes_struct_t, &uctypes_struct_type);
-            o->desc = MP_OBJ_FROM_PTR(sub);
+            o->desc = desc;
             o->addr = self->addr + offset;
             o->flags = self->flags;
             return MP_OBJ_FROM_PTR(o);
@@ -489,6 +630,48 @@ STATIC mp_obj_t uctypes_struct_attr_op(mp_obj_t self_in, qstr attr, mp_obj_t set
     return MP_OBJ_NULL;
 }
 
+STATIC mp_obj_t uctypes_struct_attr_op(mp_obj_t self_in, qstr attr, mp_obj_t set_val) {
+    mp_obj_uctypes_struct_t *self = MP_OBJ_TO_PTR(self_in);
+
+    #if MICROPY_PY_UCTYPES_COMPILE
+    if (mp_obj_is_type(self->desc, &uctypes_compiled_type)) {
+        const uctypes_field_t *f = uctypes_compiled_lookup(MP_OBJ_TO_PTR(self->desc), attr);
+        if (f->kind == FIELD_SCALAR) {
+            return uctypes_struct_scalar_op(self, f->val_type, f->offset, f->bit_offset, f->bit_len, set_val);
+        }
+        return uctypes_struct_agg_op(self, f->kind, f->offset, f->sub, set_val);
+    }
+    #endif
+
+    if (!mp_obj_is_dict_or_ordereddict(self->desc)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("struct: no fields"));
+    }
+
+    mp_obj_t deref = mp_obj_dict_get(self->desc, MP_OBJ_NEW_QSTR(attr));
+    if (mp_obj_is_small_int(deref)) {
+        mp_int_t offset = MP_OBJ_SMALL_INT_VALUE(deref);
+        mp_uint_t val_type = GET_TYPE(offset, VAL_TYPE_BITS);
+        offset &= VALUE_MASK(VAL_TYPE_BITS);
+        uint bit_offset = (offset >> OFFSET_BITS) & 31;
+        uint bit_len = (offset >> LEN_BITS) & 31;
+        if (val_type >= BFUINT8 && val_type <= BFINT32) {
+            offset &= (1 << OFFSET_BITS) - 1;
+        }
+        return uctypes_struct_scalar_op(self, val_type, offset, bit_offset, bit_len, set_val);
+    }
+
+    if (!mp_obj_is_type(deref, &mp_type_tuple)) {
+        syntax_error();
+    }
+
+    mp_obj_tuple_t *sub = MP_OBJ_TO_PTR(deref);
+    mp_int_t offset = MP_OBJ_SMALL_INT_VALUE(sub->items[0]);
+    mp_uint_t agg_type = GET_TYPE(offset, AGG_TYPE_BITS);
+    offset &= VALUE_MASK(AGG_TYPE_BITS);
+
+    return uctypes_struct_agg_op(self, agg_type, offset, agg_type == STRUCT ? sub->items[1] : deref, set_val);
+}
+
 STATIC void uctypes_struct_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
     if (dest[0] == MP_OBJ_NULL) {
         // load attribute
@@ -653,6 +836,9 @@ STATIC const mp_rom_map_elem_t mp_module_uctypes_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_addressof), MP_ROM_PTR(&uctypes_struct_addressof_obj) },
     { MP_ROM_QSTR(MP_QSTR_bytes_at), MP_ROM_PTR(&uctypes_struct_bytes_at_obj) },
     { MP_ROM_QSTR(MP_QSTR_bytearray_at), MP_ROM_PTR(&uctypes_struct_bytearray_at_obj) },
+    #if MICROPY_PY_UCTYPES_COMPILE
+    { MP_ROM_QSTR(MP_QSTR_compile), MP_ROM_PTR(&uctypes_compile_obj) },
+    #endif
 
     { MP_ROM_QSTR(MP_QSTR_NATIVE), MP_ROM_INT(LAYOUT_NATIVE) },
     { MP_ROM_QSTR(MP_QSTR_LITTLE_ENDIAN), MP_ROM_INT(LAYOUT_LITTLE_ENDIAN) },
@@ -62,6 +62,9 @@ const byte fresult_to_errno_table[20] = {
 typedef struct _pyb_file_obj_t {
     mp_obj_base_t base;
     FIL fp;
+    #if MICROPY_STREAMS_READ_BUFFER
+    mp_stream_rbuf_t rbuf;
+    #endif
 } pyb_file_obj_t;
 
 STATIC void file_obj_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
@@ -69,7 +72,7 @@ STATIC void file_obj_print(const mp_print_t *print, mp_obj_t self_in, mp_print_k
     mp_printf(print, "<io.%s %p>", mp_obj_get_type_str(self_in), MP_OBJ_TO_PTR(self_in));
 }
 
-STATIC mp_uint_t file_obj_read(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
+STATIC mp_uint_t file_obj_read_raw(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
     pyb_file_obj_t *self = MP_OBJ_TO_PTR(self_in);
     UINT sz_out;
     FRESULT res = f_read(&self->fp, buf, size, &sz_out);
@@ -80,8 +83,24 @@ STATIC mp_uint_t file_obj_read(mp_obj_t self_in, void *buf, mp_uint_t size, int
     return sz_out;
 }
 
+STATIC mp_uint_t file_obj_read(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
+    #if MICROPY_STREAMS_READ_BUFFER
+    pyb_file_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_stream_rbuf_read(&self->rbuf, self_in, buf, size, errcode);
+    #else
+    return file_obj_read_raw(self_in, buf, size, errcode);
+    #endif
+}
+
 STATIC mp_uint_t file_obj_write(mp_obj_t self_in, const void *buf, mp_uint_t size, int *errcode) {
     pyb_file_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_STREAMS_READ_BUFFER
+    // Write at the position the caller has read up to.
+    if (mp_stream_rbuf_unread(&self->rbuf) != 0) {
+        f_lseek(&self->fp, f_tell(&self->fp) - mp_stream_rbuf_unread(&self->rbuf));
+        mp_stream_rbuf_discard(&self->rbuf);
+    }
+    #endif
     UINT sz_out;
     FRESULT res = f_write(&self->fp, buf, size, &sz_out);
     if (res != FR_OK) {
@@ -108,6 +127,9 @@ STATIC mp_uint_t file_obj_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg,
                 break;
 
             case 1: // SEEK_CUR
+                #if MICROPY_STREAMS_READ_BUFFER
+                s->offset -= mp_stream_rbuf_unread(&self->rbuf);
+                #endif
                 f_lseek(&self->fp, f_tell(&self->fp) + s->offset);
                 break;
 
@@ -116,6 +138,9 @@ STATIC mp_uint_t file_obj_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg,
                 break;
         }
 
+        #if MICROPY_STREAMS_READ_BUFFER
+        mp_stream_rbuf_discard(&self->rbuf);
+        #endif
         s->offset = f_tell(&self->fp);
         return 0;
 
@@ -136,6 +161,10 @@ STATIC mp_uint_t file_obj_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg,
                 return MP_STREAM_ERROR;
             }
         }
+        #if MICROPY_STREAMS_READ_BUFFER
+        mp_stream_rbuf_discard(&self->rbuf);
+        self->rbuf.buf = NULL;
+        #endif
         return 0;
 
     } else {
@@ -167,6 +196,9 @@ STATIC const mp_stream_p_t vfs_fat_fileio_stream_p = {
     .read = file_obj_read,
     .write = file_obj_write,
     .ioctl = file_obj_ioctl,
+    #if MICROPY_STREAMS_READ_BUFFER
+    .rbuf_offset = offsetof(pyb_file_obj_t, rbuf),
+    #endif
 };
 
 MP_DEFINE_CONST_OBJ_TYPE(
@@ -182,6 +214,9 @@ STATIC const mp_stream_p_t vfs_fat_textio_stream_p = {
     .read = file_obj_read,
     .write = file_obj_write,
     .ioctl = file_obj_ioctl,
+    #if MICROPY_STREAMS_READ_BUFFER
+    .rbuf_offset = offsetof(pyb_file_obj_t, rbuf),
+    #endif
     .is_text = true,
 };
 
@@ -243,6 +278,10 @@ STATIC mp_obj_t fat_vfs_open(mp_obj_t self_in, mp_obj_t path_in, mp_obj_t mode_i
         f_lseek(&o->fp, f_size(&o->fp));
     }
 
+    #if MICROPY_STREAMS_READ_BUFFER
+    mp_stream_rbuf_init(&o->rbuf, file_obj_read_raw, MICROPY_STREAMS_READ_BUFFER_SIZE);
+    #endif
+
     return MP_OBJ_FROM_PTR(o);
 }
 MP_DEFINE_CONST_FUN_OBJ_3(fat_vfs_open_obj, fat_vfs_open);
@@ -26,6 +26,7 @@
 
 #include "py/runtime.h"
 #include "py/mphal.h"
+#include "py/stream.h"
 
 #if MICROPY_VFS && (MICROPY_VFS_LFS1 || MICROPY_VFS_LFS2)
 
@@ -69,6 +70,9 @@ typedef struct _mp_obj_vfs_lfs1_file_t {
     mp_obj_vfs_lfs1_t *vfs;
     lfs1_file_t file;
     struct lfs1_file_config cfg;
+    #if MICROPY_STREAMS_READ_BUFFER
+    mp_stream_rbuf_t rbuf;
+    #endif
     uint8_t file_buffer[0];
 } mp_obj_vfs_lfs1_file_t;
 
@@ -121,6 +125,9 @@ typedef struct _mp_obj_vfs_lfs2_file_t {
     lfs2_file_t file;
     struct lfs2_file_config cfg;
     struct lfs2_attr attrs[1];
+    #if MICROPY_STREAMS_READ_BUFFER
+    mp_stream_rbuf_t rbuf;
+    #endif
     uint8_t file_buffer[0];
 } mp_obj_vfs_lfs2_file_t;
 
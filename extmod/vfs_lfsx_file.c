@@ -47,6 +47,8 @@ STATIC void MP_VFS_LFSx(file_print)(const mp_print_t * print, mp_obj_t self_in,
     mp_printf(print, "<io.%s>", mp_obj_get_type_str(self_in));
 }
 
+STATIC mp_uint_t MP_VFS_LFSx(file_read_raw)(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode);
+
 mp_obj_t MP_VFS_LFSx(file_open)(mp_obj_t self_in, mp_obj_t path_in, mp_obj_t mode_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
 
@@ -101,6 +103,9 @@ mp_obj_t MP_VFS_LFSx(file_open)(mp_obj_t self_in, mp_obj_t path_in, mp_obj_t mod
     memset(&o->cfg, 0, sizeof(o->cfg));
     #endif
     o->cfg.buffer = &o->file_buffer[0];
+    #if MICROPY_STREAMS_READ_BUFFER
+    mp_stream_rbuf_init(&o->rbuf, MP_VFS_LFSx(file_read_raw), MICROPY_STREAMS_READ_BUFFER_SIZE);
+    #endif
 
     #if LFS_BUILD_VERSION == 2
     if (self->enable_mtime) {
@@ -123,9 +128,8 @@ mp_obj_t MP_VFS_LFSx(file_open)(mp_obj_t self_in, mp_obj_t path_in, mp_obj_t mod
     return MP_OBJ_FROM_PTR(o);
 }
 
-STATIC mp_uint_t MP_VFS_LFSx(file_read)(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
+STATIC mp_uint_t MP_VFS_LFSx(file_read_raw)(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
     MP_OBJ_VFS_LFSx_FILE *self = MP_OBJ_TO_PTR(self_in);
-    MP_VFS_LFSx(check_open)(self);
     LFSx_API(ssize_t) sz = LFSx_API(file_read)(&self->vfs->lfs, &self->file, buf, size);
     if (sz < 0) {
         *errcode = -sz;
@@ -134,9 +138,26 @@ STATIC mp_uint_t MP_VFS_LFSx(file_read)(mp_obj_t self_in, void *buf, mp_uint_t s
     return sz;
 }
 
+STATIC mp_uint_t MP_VFS_LFSx(file_read)(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
+    MP_OBJ_VFS_LFSx_FILE *self = MP_OBJ_TO_PTR(self_in);
+    MP_VFS_LFSx(check_open)(self);
+    #if MICROPY_STREAMS_READ_BUFFER
+    return mp_stream_rbuf_read(&self->rbuf, self_in, buf, size, errcode);
+    #else
+    return MP_VFS_LFSx(file_read_raw)(self_in, buf, size, errcode);
+    #endif
+}
+
 STATIC mp_uint_t MP_VFS_LFSx(file_write)(mp_obj_t self_in, const void *buf, mp_uint_t size, int *errcode) {
     MP_OBJ_VFS_LFSx_FILE *self = MP_OBJ_TO_PTR(self_in);
     MP_VFS_LFSx(check_open)(self);
+    #if MICROPY_STREAMS_READ_BUFFER
+    // Write at the position the caller has read up to.
+    if (mp_stream_rbuf_unread(&self->rbuf) != 0) {
+        LFSx_API(file_seek)(&self->vfs->lfs, &self->file, -(LFSx_API(soff_t))mp_stream_rbuf_unread(&self->rbuf), LFSx_MACRO(_SEEK_CUR));
+        mp_stream_rbuf_discard(&self->rbuf);
+    }
+    #endif
     #if LFS_BUILD_VERSION == 2
     if (self->vfs->enable_mtime) {
         lfs_get_mtime(&self->mtime[0]);
@@ -159,11 +180,19 @@ STATIC mp_uint_t MP_VFS_LFSx(file_ioctl)(mp_obj_t self_in, mp_uint_t request, ui
 
     if (request == MP_STREAM_SEEK) {
         struct mp_stream_seek_t *s = (struct mp_stream_seek_t *)(uintptr_t)arg;
+        #if MICROPY_STREAMS_READ_BUFFER
+        if (s->whence == MP_SEEK_CUR) {
+            s->offset -= mp_stream_rbuf_unread(&self->rbuf);
+        }
+        #endif
         int res = LFSx_API(file_seek)(&self->vfs->lfs, &self->file, s->offset, s->whence);
         if (res < 0) {
             *errcode = -res;
             return MP_STREAM_ERROR;
         }
+        #if MICROPY_STREAMS_READ_BUFFER
+        mp_stream_rbuf_discard(&self->rbuf);
+        #endif
         res = LFSx_API(file_tell)(&self->vfs->lfs, &self->file);
         if (res < 0) {
             *errcode = -res;
@@ -184,6 +213,10 @@ STATIC mp_uint_t MP_VFS_LFSx(file_ioctl)(mp_obj_t self_in, mp_uint_t request, ui
         }
         int res = LFSx_API(file_close)(&self->vfs->lfs, &self->file);
         self->vfs = NULL; // indicate a closed file
+        #if MICROPY_STREAMS_READ_BUFFER
+        mp_stream_rbuf_discard(&self->rbuf);
+        self->rbuf.buf = NULL;
+        #endif
         if (res < 0) {
             *errcode = -res;
             return MP_STREAM_ERROR;
@@ -215,6 +248,9 @@ STATIC const mp_stream_p_t MP_VFS_LFSx(fileio_stream_p) = {
     .read = MP_VFS_LFSx(file_read),
     .write = MP_VFS_LFSx(file_write),
     .ioctl = MP_VFS_LFSx(file_ioctl),
+    #if MICROPY_STREAMS_READ_BUFFER
+    .rbuf_offset = offsetof(MP_OBJ_VFS_LFSx_FILE, rbuf),
+    #endif
 };
 
 MP_DEFINE_CONST_OBJ_TYPE(
@@ -230,6 +266,9 @@ STATIC const mp_stream_p_t MP_VFS_LFSx(textio_stream_p) = {
     .read = MP_VFS_LFSx(file_read),
     .write = MP_VFS_LFSx(file_write),
     .ioctl = MP_VFS_LFSx(file_ioctl),
+    #if MICROPY_STREAMS_READ_BUFFER
+    .rbuf_offset = offsetof(MP_OBJ_VFS_LFSx_FILE, rbuf),
+    #endif
     .is_text = true,
 };
 
@@ -34,6 +34,7 @@
 
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/stat.h>
 
 #ifdef _WIN32
 #define fsync _commit
@@ -44,6 +45,9 @@
 typedef struct _mp_obj_vfs_posix_file_t {
     mp_obj_base_t base;
     int fd;
+    #if MICROPY_STREAMS_READ_BUFFER
+    mp_stream_rbuf_t rbuf;
+    #endif
 } mp_obj_vfs_posix_file_t;
 
 #if MICROPY_CPYTHON_COMPAT
@@ -62,6 +66,51 @@ STATIC void vfs_posix_file_print(const mp_print_t *print, mp_obj_t self_in, mp_p
     mp_printf(print, "<io.%s %d>", mp_obj_get_type_str(self_in), self->fd);
 }
 
+STATIC mp_uint_t vfs_posix_file_read_raw(mp_obj_t o_in, void *buf, mp_uint_t size, int *errcode);
+
+#if MICROPY_STREAMS_READ_BUFFER
+// Regular files and sockets get a read-ahead buffer.  Other kinds of files,
+// like ttys and pipes, are left unbuffered so that polling them still works.
+STATIC void vfs_posix_file_init_rbuf(mp_obj_vfs_posix_file_t *o) {
+    size_t alloc = 0;
+    struct stat st;
+    int ret;
+    MP_THREAD_GIL_EXIT();
+    ret = fstat(o->fd, &st);
+    MP_THREAD_GIL_ENTER();
+    if (ret == 0) {
+        if (S_ISREG(st.st_mode)) {
+            alloc = MICROPY_STREAMS_READ_BUFFER_SIZE;
+        }
+        #ifdef S_ISSOCK
+        if (S_ISSOCK(st.st_mode)) {
+            alloc = MICROPY_STREAMS_READ_BUFFER_SIZE;
+        }
+        #endif
+    }
+    mp_stream_rbuf_init(&o->rbuf, vfs_posix_file_read_raw, alloc);
+}
+
+// Moves the file position back over data that was read ahead but not consumed,
+// and drops it from the buffer.  Fails for non-seekable files, in which case the
+// buffered data is kept so it can still be read.
+STATIC int vfs_posix_file_unread(mp_obj_vfs_posix_file_t *o) {
+    mp_uint_t unread = mp_stream_rbuf_unread(&o->rbuf);
+    if (unread != 0) {
+        MP_THREAD_GIL_EXIT();
+        off_t off = lseek(o->fd, -(off_t)unread, SEEK_CUR);
+        MP_THREAD_GIL_ENTER();
+        if (off == (off_t)-1) {
+            return errno;
+        }
+    }
+    mp_stream_rbuf_discard(&o->rbuf);
+    return 0;
+}
+#else
+#define vfs_posix_file_init_rbuf(o)
+#endif
+
 mp_obj_t mp_vfs_posix_file_open(const mp_obj_type_t *type, mp_obj_t file_in, mp_obj_t mode_in) {
     mp_obj_vfs_posix_file_t *o = m_new_obj_with_finaliser(mp_obj_vfs_posix_file_t);
     const char *mode_s = mp_obj_str_get_str(mode_in);
@@ -98,6 +147,7 @@ mp_obj_t mp_vfs_posix_file_open(const mp_obj_type_t *type, mp_obj_t file_in, mp_
 
     if (mp_obj_is_small_int(fid)) {
         o->fd = MP_OBJ_SMALL_INT_VALUE(fid);
+        vfs_posix_file_init_rbuf(o);
         return MP_OBJ_FROM_PTR(o);
     }
 
@@ -105,6 +155,7 @@ mp_obj_t mp_vfs_posix_file_open(const mp_obj_type_t *type, mp_obj_t file_in, mp_
     int fd;
     MP_HAL_RETRY_SYSCALL(fd, open(fname, mode_x | mode_rw, 0644), mp_raise_OSError(err));
     o->fd = fd;
+    vfs_posix_file_init_rbuf(o);
     return MP_OBJ_FROM_PTR(o);
 }
 
@@ -115,9 +166,8 @@ STATIC mp_obj_t vfs_posix_file_fileno(mp_obj_t self_in) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(vfs_posix_file_fileno_obj, vfs_posix_file_fileno);
 
-STATIC mp_uint_t vfs_posix_file_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *errcode) {
+STATIC mp_uint_t vfs_posix_file_read_raw(mp_obj_t o_in, void *buf, mp_uint_t size, int *errcode) {
     mp_obj_vfs_posix_file_t *o = MP_OBJ_TO_PTR(o_in);
-    check_fd_is_open(o);
     ssize_t r;
     MP_HAL_RETRY_SYSCALL(r, read(o->fd, buf, size), {
         *errcode = err;
@@ -126,9 +176,29 @@ STATIC mp_uint_t vfs_posix_file_read(mp_obj_t o_in, void *buf, mp_uint_t size, i
     return (mp_uint_t)r;
 }
 
+STATIC mp_uint_t vfs_posix_file_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_vfs_posix_file_t *o = MP_OBJ_TO_PTR(o_in);
+    check_fd_is_open(o);
+    #if MICROPY_STREAMS_READ_BUFFER
+    if (o->rbuf.alloc != 0) {
+        return mp_stream_rbuf_read(&o->rbuf, o_in, buf, size, errcode);
+    }
+    #else
+    (void)o;
+    #endif
+    return vfs_posix_file_read_raw(o_in, buf, size, errcode);
+}
+
 STATIC mp_uint_t vfs_posix_file_write(mp_obj_t o_in, const void *buf, mp_uint_t size, int *errcode) {
     mp_obj_vfs_posix_file_t *o = MP_OBJ_TO_PTR(o_in);
     check_fd_is_open(o);
+    #if MICROPY_STREAMS_READ_BUFFER
+    // Write at the position the caller has read up to.  Sockets can't seek,
+    // their read-ahead data stays buffered.
+    if (o->rbuf.alloc != 0) {
+        vfs_posix_file_unread(o);
+    }
+    #endif
     #if MICROPY_PY_OS_DUPTERM
     if (o->fd <= STDERR_FILENO) {
         mp_hal_stdout_tx_strn(buf, size);
@@ -176,13 +246,23 @@ STATIC mp_uint_t vfs_posix_file_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_
         }
         case MP_STREAM_SEEK: {
             struct mp_stream_seek_t *s = (struct mp_stream_seek_t *)arg;
+            off_t offset = s->offset;
+            #if MICROPY_STREAMS_READ_BUFFER
+            if (s->whence == SEEK_CUR) {
+                // The OS file position is ahead of the caller's by the unread data.
+                offset -= mp_stream_rbuf_unread(&o->rbuf);
+            }
+            #endif
             MP_THREAD_GIL_EXIT();
-            off_t off = lseek(o->fd, s->offset, s->whence);
+            off_t off = lseek(o->fd, offset, s->whence);
             MP_THREAD_GIL_ENTER();
             if (off == (off_t)-1) {
                 *errcode = errno;
                 return MP_STREAM_ERROR;
             }
+            #if MICROPY_STREAMS_READ_BUFFER
+            mp_stream_rbuf_discard(&o->rbuf);
+            #endif
             s->offset = off;
             return 0;
         }
@@ -193,6 +273,10 @@ STATIC mp_uint_t vfs_posix_file_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_
                 MP_THREAD_GIL_ENTER();
             }
             o->fd = -1;
+            #if MICROPY_STREAMS_READ_BUFFER
+            mp_stream_rbuf_discard(&o->rbuf);
+            o->rbuf.buf = NULL;
+            #endif
             return 0;
         case MP_STREAM_GET_FILENO:
             return o->fd;
@@ -209,6 +293,13 @@ STATIC mp_uint_t vfs_posix_file_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_
             if (arg & MP_STREAM_POLL_WR) {
                 pollevents |= POLLOUT;
             }
+            #if MICROPY_STREAMS_READ_BUFFER
+            if ((arg & MP_STREAM_POLL_RD) && mp_stream_rbuf_unread(&o->rbuf) != 0) {
+                // Data that was read ahead can be read without blocking.
+                ret |= MP_STREAM_POLL_RD;
+                pollevents &= ~POLLIN;
+            }
+            #endif
             struct pollfd pfd = { .fd = o->fd, .events = pollevents };
             if (poll(&pfd, 1, 0) > 0) {
                 if (pfd.revents & POLLIN) {
@@ -259,6 +350,9 @@ STATIC const mp_stream_p_t vfs_posix_fileio_stream_p = {
     .read = vfs_posix_file_read,
     .write = vfs_posix_file_write,
     .ioctl = vfs_posix_file_ioctl,
+    #if MICROPY_STREAMS_READ_BUFFER
+    .rbuf_offset = offsetof(mp_obj_vfs_posix_file_t, rbuf),
+    #endif
 };
 
 MP_DEFINE_CONST_OBJ_TYPE(
@@ -274,14 +368,17 @@ STATIC const mp_stream_p_t vfs_posix_textio_stream_p = {
     .read = vfs_posix_file_read,
     .write = vfs_posix_file_write,
     .ioctl = vfs_posix_file_ioctl,
+    #if MICROPY_STREAMS_READ_BUFFER
+    .rbuf_offset = offsetof(mp_obj_vfs_posix_file_t, rbuf),
+    #endif
     .is_text = true,
 };
 
 #if MICROPY_PY_SYS_STDIO_BUFFER
 
-mp_obj_vfs_posix_file_t mp_sys_stdin_buffer_obj = {{&mp_type_vfs_posix_fileio}, STDIN_FILENO};
-mp_obj_vfs_posix_file_t mp_sys_stdout_buffer_obj = {{&mp_type_vfs_posix_fileio}, STDOUT_FILENO};
-mp_obj_vfs_posix_file_t mp_sys_stderr_buffer_obj = {{&mp_type_vfs_posix_fileio}, STDERR_FILENO};
+mp_obj_vfs_posix_file_t mp_sys_stdin_buffer_obj = {.base = {&mp_type_vfs_posix_fileio}, .fd = STDIN_FILENO};
+mp_obj_vfs_posix_file_t mp_sys_stdout_buffer_obj = {.base = {&mp_type_vfs_posix_fileio}, .fd = STDOUT_FILENO};
+mp_obj_vfs_posix_file_t mp_sys_stderr_buffer_obj = {.base = {&mp_type_vfs_posix_fileio}, .fd = STDERR_FILENO};
 
 // Forward declarations.
 mp_obj_vfs_posix_file_t mp_sys_stdin_obj;
@@ -332,8 +429,8 @@ MP_DEFINE_CONST_OBJ_TYPE(
     locals_dict, &vfs_posix_rawfile_locals_dict
     );
 
-mp_obj_vfs_posix_file_t mp_sys_stdin_obj = {{&mp_type_vfs_posix_textio}, STDIN_FILENO};
-mp_obj_vfs_posix_file_t mp_sys_stdout_obj = {{&mp_type_vfs_posix_textio}, STDOUT_FILENO};
-mp_obj_vfs_posix_file_t mp_sys_stderr_obj = {{&mp_type_vfs_posix_textio}, STDERR_FILENO};
+mp_obj_vfs_posix_file_t mp_sys_stdin_obj = {.base = {&mp_type_vfs_posix_textio}, .fd = STDIN_FILENO};
+mp_obj_vfs_posix_file_t mp_sys_stdout_obj = {.base = {&mp_type_vfs_posix_textio}, .fd = STDOUT_FILENO};
+mp_obj_vfs_posix_file_t mp_sys_stderr_obj = {.base = {&mp_type_vfs_posix_textio}, .fd = STDERR_FILENO};
 
 #endif // MICROPY_VFS_POSIX
@@ -52,20 +52,18 @@ typedef struct _mp_reader_vfs_t {
 STATIC mp_uint_t mp_reader_vfs_readbyte(void *data) {
     mp_reader_vfs_t *reader = (mp_reader_vfs_t *)data;
     if (reader->bufpos >= reader->buflen) {
-        if (reader->buflen < reader->bufsize) {
+        // A short read doesn't mean EOF (the file may have a read-ahead buffer
+        // that only had part of the request), so read until nothing is returned.
+        int errcode;
+        reader->buflen = mp_stream_rw(reader->file, reader->buf, reader->bufsize, &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
+        if (errcode != 0) {
+            // TODO handle errors properly
             return MP_READER_EOF;
-        } else {
-            int errcode;
-            reader->buflen = mp_stream_rw(reader->file, reader->buf, reader->bufsize, &errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
-            if (errcode != 0) {
-                // TODO handle errors properly
-                return MP_READER_EOF;
-            }
-            if (reader->buflen == 0) {
-                return MP_READER_EOF;
-            }
-            reader->bufpos = 0;
         }
+        if (reader->buflen == 0) {
+            return MP_READER_EOF;
+        }
+        reader->bufpos = 0;
     }
     return reader->buf[reader->bufpos++];
 }
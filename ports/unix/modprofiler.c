@@ -0,0 +1,236 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "py/bc.h"
+#include "py/runtime.h"
+#include "py/stream.h"
+#include "py/mphal.h"
+
+#if MICROPY_PY_PROFILER
+
+// A sampling profiler for Python code.
+//
+// While the profiler runs, a SIGPROF timer interrupts the process every so
+// often while it's using CPU time.  The signal handler copies the location of
+// each bytecode frame running on the interrupted thread into a ring of
+// samples.  It never blocks or allocates, so it's safe whatever the thread was
+// doing, and the samples are only turned into text when dump() drains them.
+//
+// Any number of signal handlers, on different threads, can claim a sample in
+// the ring by moving its head on.  Each marks the sample as written by setting
+// its seq, and dump() stops at the first one that isn't written yet.
+
+typedef struct _profiler_frame_t {
+    uint32_t source_file;
+    uint32_t block_name;
+    uint32_t line;
+} profiler_frame_t;
+
+typedef struct _profiler_sample_t {
+    size_t seq; // index of the sample in the ring plus 1, once written
+    size_t depth;
+    profiler_frame_t frame[MICROPY_PY_PROFILER_DEPTH]; // innermost first
+} profiler_sample_t;
+
+MP_REGISTER_ROOT_POINTER(struct _profiler_sample_t *profiler_ring);
+
+// The size of the ring, and indices into it that only ever count up: samples
+// from tail to head have been claimed and not yet drained.
+STATIC size_t profiler_size;
+STATIC size_t profiler_head;
+STATIC size_t profiler_tail;
+STATIC size_t profiler_dropped;
+STATIC volatile bool profiler_running;
+
+STATIC void profiler_sighandler(int signum) {
+    (void)signum;
+    if (!profiler_running) {
+        return;
+    }
+    #if MICROPY_PY_THREAD
+    if (mp_thread_get_state() == NULL) {
+        // Not a thread that runs Python code.
+        return;
+    }
+    #endif
+
+    size_t head = __atomic_load_n(&profiler_head, __ATOMIC_RELAXED);
+    do {
+        if (head - __atomic_load_n(&profiler_tail, __ATOMIC_ACQUIRE) >= profiler_size) {
+            __atomic_fetch_add(&profiler_dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&profiler_head, &head, head + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    profiler_sample_t *sample = &MP_STATE_VM(profiler_ring)[head % profiler_size];
+    size_t depth = 0;
+    for (const mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+         code_state != NULL && depth < MICROPY_PY_PROFILER_DEPTH;
+         code_state = code_state->prev_state) {
+        qstr source_file, block_name;
+        size_t line;
+        mp_code_state_get_location(code_state, &source_file, &block_name, &line);
+        profiler_frame_t *frame = &sample->frame[depth++];
+        frame->source_file = source_file;
+        frame->block_name = block_name;
+        frame->line = line;
+    }
+    sample->depth = depth;
+    __atomic_store_n(&sample->seq, head + 1, __ATOMIC_RELEASE);
+}
+
+STATIC void profiler_set_timer(mp_int_t freq) {
+    struct itimerval it = { { 0, 0 }, { 0, 0 } };
+    if (freq != 0) {
+        mp_int_t period_us = 1000000 / freq;
+        it.it_interval.tv_sec = period_us / 1000000;
+        it.it_interval.tv_usec = period_us % 1000000;
+        it.it_value = it.it_interval;
+    }
+    setitimer(ITIMER_PROF, &it, NULL);
+}
+
+STATIC mp_obj_t profiler_start(size_t n_args, const mp_obj_t *args) {
+    mp_int_t freq = n_args > 0 ? mp_obj_get_int(args[0]) : 1000;
+    mp_int_t size = n_args > 1 ? mp_obj_get_int(args[1]) : MICROPY_PY_PROFILER_SAMPLES;
+    if (freq <= 0 || freq > 1000000 || size <= 0) {
+        mp_raise_ValueError(NULL);
+    }
+
+    profiler_running = false;
+    profiler_set_timer(0);
+
+    // Any samples not yet dumped are discarded.
+    if (MP_STATE_VM(profiler_ring) == NULL || profiler_size != (size_t)size) {
+        profiler_size = 0;
+        MP_STATE_VM(profiler_ring) = m_new(profiler_sample_t, size);
+        profiler_size = size;
+    }
+    memset(MP_STATE_VM(profiler_ring), 0, profiler_size * sizeof(profiler_sample_t));
+    profiler_head = 0;
+    profiler_tail = 0;
+    profiler_dropped = 0;
+
+    struct sigaction sa;
+    sa.sa_flags = SA_RESTART;
+    sa.sa_handler = profiler_sighandler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, NULL);
+
+    profiler_running = true;
+    profiler_set_timer(freq);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(profiler_start_obj, 0, 2, profiler_start);
+
+STATIC mp_obj_t profiler_stop(void) {
+    // The samples are kept until they are dumped.
+    profiler_running = false;
+    profiler_set_timer(0);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(profiler_stop_obj, profiler_stop);
+
+STATIC void profiler_print_stack(const mp_print_t *print, const profiler_sample_t *sample, size_t count) {
+    if (sample->depth == 0) {
+        // No Python code was running.
+        mp_print_str(print, "[unknown]");
+    }
+    for (size_t i = sample->depth; i-- > 0;) {
+        const profiler_frame_t *frame = &sample->frame[i];
+        mp_printf(print, "%s%q:%q:%u", i + 1 == sample->depth ? "" : ";",
+            (qstr)frame->source_file, (qstr)frame->block_name, (uint)frame->line);
+    }
+    mp_printf(print, " %u\n", (uint)count);
+}
+
+STATIC mp_obj_t profiler_dump(size_t n_args, const mp_obj_t *args) {
+    mp_print_t print = mp_plat_print;
+    if (n_args == 1) {
+        mp_get_stream_raise(args[0], MP_STREAM_OP_WRITE);
+        print.data = MP_OBJ_TO_PTR(args[0]);
+        print.print_strn = mp_stream_write_adaptor;
+    }
+
+    // Drain the samples written so far, printing them as folded stacks: the
+    // frames of each one, outermost first, separated by semicolons, followed
+    // by the number of samples.  Runs of the same stack share a line.
+    profiler_sample_t stack;
+    size_t count = 0;
+    for (;;) {
+        size_t tail = profiler_tail;
+        const profiler_sample_t *sample = NULL;
+        if (tail != __atomic_load_n(&profiler_head, __ATOMIC_ACQUIRE)) {
+            sample = &MP_STATE_VM(profiler_ring)[tail % profiler_size];
+            if (__atomic_load_n(&sample->seq, __ATOMIC_ACQUIRE) != tail + 1) {
+                sample = NULL;
+            }
+        }
+        if (sample != NULL && count > 0 && sample->depth == stack.depth
+            && memcmp(sample->frame, stack.frame, stack.depth * sizeof(profiler_frame_t)) == 0) {
+            ++count;
+        } else {
+            if (count > 0) {
+                profiler_print_stack(&print, &stack, count);
+            }
+            if (sample == NULL) {
+                break;
+            }
+            stack = *sample;
+            count = 1;
+        }
+        __atomic_store_n(&profiler_tail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    size_t dropped = __atomic_exchange_n(&profiler_dropped, 0, __ATOMIC_RELAXED);
+    if (dropped != 0) {
+        // Samples taken while the ring was full.
+        mp_printf(&print, "[dropped] %u\n", (uint)dropped);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(profiler_dump_obj, 0, 1, profiler_dump);
+
+STATIC const mp_rom_map_elem_t mp_module_profiler_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_profiler) },
+    { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&profiler_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&profiler_stop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dump), MP_ROM_PTR(&profiler_dump_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(mp_module_profiler_globals, mp_module_profiler_globals_table);
+
+const mp_obj_module_t mp_module_profiler = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t *)&mp_module_profiler_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR_profiler, mp_module_profiler);
+
+#endif // MICROPY_PY_PROFILER
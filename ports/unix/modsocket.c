@@ -25,6 +25,11 @@
  * THE SOFTWARE.
  */
 
+#if defined(__linux__)
+// For recvmmsg() and sendmmsg().
+#define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
@@ -33,6 +38,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -361,6 +367,326 @@ STATIC mp_obj_t socket_sendto(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_sendto_obj, 3, 4, socket_sendto);
 
+// The methods below read into and send from existing buffers, so that
+// receiving and sending many messages doesn't allocate for each one.
+
+// Maximum number of buffers passed to sendmsg() and recvmsg_into().
+#define SOCKET_IOV_MAX (16)
+
+// Maximum number of messages handled by one recvmmsg() or sendmmsg() call.
+#define SOCKET_MMSG_MAX (32)
+
+STATIC mp_obj_t socket_recv_into(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+    size_t sz = bufinfo.len;
+    int flags = 0;
+
+    if (n_args > 2 && (sz = mp_obj_get_int(args[2])) == 0) {
+        sz = bufinfo.len;
+    }
+    if (sz > bufinfo.len) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
+    if (n_args > 3) {
+        flags = MP_OBJ_SMALL_INT_VALUE(args[3]);
+    }
+
+    ssize_t out_sz;
+    MP_HAL_RETRY_SYSCALL(out_sz, recv(self->fd, bufinfo.buf, sz, flags), mp_raise_OSError(err));
+    return MP_OBJ_NEW_SMALL_INT(out_sz);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recv_into_obj, 2, 4, socket_recv_into);
+
+STATIC mp_obj_t socket_recvfrom_into(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+    size_t sz = bufinfo.len;
+    int flags = 0;
+
+    if (n_args > 2 && (sz = mp_obj_get_int(args[2])) == 0) {
+        sz = bufinfo.len;
+    }
+    if (sz > bufinfo.len) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
+    if (n_args > 3) {
+        flags = MP_OBJ_SMALL_INT_VALUE(args[3]);
+    }
+
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    ssize_t out_sz;
+    MP_HAL_RETRY_SYSCALL(out_sz, recvfrom(self->fd, bufinfo.buf, sz, flags, (struct sockaddr *)&addr, &addr_len),
+        mp_raise_OSError(err));
+
+    mp_obj_t items[2] = {
+        MP_OBJ_NEW_SMALL_INT(out_sz),
+        mp_obj_from_sockaddr((struct sockaddr *)&addr, addr_len),
+    };
+    return mp_obj_new_tuple(2, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recvfrom_into_obj, 2, 4, socket_recvfrom_into);
+
+// Fill in an iovec array from a sequence of buffer objects, returning its length.
+STATIC size_t socket_get_iovec(mp_obj_t buffers_in, struct iovec *iov, size_t max, mp_uint_t flags) {
+    size_t n;
+    mp_obj_t *buffers;
+    mp_obj_get_array(buffers_in, &n, &buffers);
+    if (n > max) {
+        mp_raise_ValueError(MP_ERROR_TEXT("too many buffers"));
+    }
+    for (size_t i = 0; i < n; ++i) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(buffers[i], &bufinfo, flags);
+        iov[i].iov_base = bufinfo.buf;
+        iov[i].iov_len = bufinfo.len;
+    }
+    return n;
+}
+
+// sendmsg(buffers[, ancdata[, flags[, address]]])
+// Ancillary data is not supported, ancdata must be empty.
+STATIC mp_obj_t socket_sendmsg(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    struct iovec iov[SOCKET_IOV_MAX];
+    struct msghdr msg = { 0 };
+    int flags = 0;
+
+    msg.msg_iov = iov;
+    msg.msg_iovlen = socket_get_iovec(args[1], iov, SOCKET_IOV_MAX, MP_BUFFER_READ);
+    if (n_args > 2 && mp_obj_is_true(args[2])) {
+        mp_raise_NotImplementedError(MP_ERROR_TEXT("ancillary data"));
+    }
+    if (n_args > 3) {
+        flags = MP_OBJ_SMALL_INT_VALUE(args[3]);
+    }
+    if (n_args > 4 && args[4] != mp_const_none) {
+        mp_buffer_info_t addr_bi;
+        mp_get_buffer_raise(args[4], &addr_bi, MP_BUFFER_READ);
+        msg.msg_name = addr_bi.buf;
+        msg.msg_namelen = addr_bi.len;
+    }
+
+    ssize_t out_sz;
+    MP_HAL_RETRY_SYSCALL(out_sz, sendmsg(self->fd, &msg, flags), mp_raise_OSError(err));
+    return MP_OBJ_NEW_SMALL_INT(out_sz);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_sendmsg_obj, 2, 5, socket_sendmsg);
+
+// recvmsg_into(buffers[, ancbufsize[, flags]])
+// Returns (nbytes, ancdata, msg_flags, address), ancdata is always empty.
+STATIC mp_obj_t socket_recvmsg_into(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    struct iovec iov[SOCKET_IOV_MAX];
+    struct sockaddr_storage addr;
+    struct msghdr msg = { 0 };
+    int flags = 0;
+
+    msg.msg_name = &addr;
+    msg.msg_namelen = sizeof(addr);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = socket_get_iovec(args[1], iov, SOCKET_IOV_MAX, MP_BUFFER_WRITE);
+    if (n_args > 2 && mp_obj_get_int(args[2]) != 0) {
+        mp_raise_NotImplementedError(MP_ERROR_TEXT("ancillary data"));
+    }
+    if (n_args > 3) {
+        flags = MP_OBJ_SMALL_INT_VALUE(args[3]);
+    }
+
+    ssize_t out_sz;
+    MP_HAL_RETRY_SYSCALL(out_sz, recvmsg(self->fd, &msg, flags), mp_raise_OSError(err));
+
+    mp_obj_t items[4] = {
+        MP_OBJ_NEW_SMALL_INT(out_sz),
+        mp_obj_new_list(0, NULL),
+        MP_OBJ_NEW_SMALL_INT(msg.msg_flags),
+        mp_const_none,
+    };
+    if (msg.msg_namelen != 0) {
+        items[3] = mp_obj_from_sockaddr((struct sockaddr *)&addr, msg.msg_namelen);
+    }
+    return mp_obj_new_tuple(4, items);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recvmsg_into_obj, 2, 4, socket_recvmsg_into);
+
+// recvmmsg(buffers, lengths[, flags[, addresses]])
+// Receives up to one message into each buffer of the sequence buffers, blocking
+// (for a blocking socket) only until the first one arrives.  The length of each
+// message is stored in the list lengths, and if given the source address in
+// the list addresses.  Returns the number of messages received.
+STATIC mp_obj_t socket_recvmmsg(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    size_t n;
+    mp_obj_t *buffers;
+    mp_obj_get_array(args[1], &n, &buffers);
+    mp_obj_list_t *lengths = MP_OBJ_TO_PTR(args[2]);
+    mp_obj_list_t *addresses = NULL;
+    int flags = 0;
+
+    if (!mp_obj_is_type(args[2], &mp_type_list)) {
+        mp_raise_TypeError(NULL);
+    }
+    if (n_args > 3) {
+        flags = MP_OBJ_SMALL_INT_VALUE(args[3]);
+    }
+    if (n_args > 4) {
+        if (!mp_obj_is_type(args[4], &mp_type_list)) {
+            mp_raise_TypeError(NULL);
+        }
+        addresses = MP_OBJ_TO_PTR(args[4]);
+        n = MIN(n, addresses->len);
+    }
+    n = MIN(n, MIN(lengths->len, SOCKET_MMSG_MAX));
+
+    struct iovec iov[SOCKET_MMSG_MAX];
+    struct sockaddr_storage addr[SOCKET_MMSG_MAX];
+    #if defined(__linux__)
+    struct mmsghdr msgs[SOCKET_MMSG_MAX];
+    memset(msgs, 0, n * sizeof(msgs[0]));
+    for (size_t i = 0; i < n; ++i) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(buffers[i], &bufinfo, MP_BUFFER_WRITE);
+        iov[i].iov_base = bufinfo.buf;
+        iov[i].iov_len = bufinfo.len;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        if (addresses != NULL) {
+            msgs[i].msg_hdr.msg_name = &addr[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addr[i]);
+        }
+    }
+
+    int n_recv;
+    MP_HAL_RETRY_SYSCALL(n_recv, recvmmsg(self->fd, msgs, n, flags | MSG_WAITFORONE, NULL), mp_raise_OSError(err));
+    for (int i = 0; i < n_recv; ++i) {
+        lengths->items[i] = MP_OBJ_NEW_SMALL_INT(msgs[i].msg_len);
+        if (addresses != NULL) {
+            addresses->items[i] = mp_obj_from_sockaddr((struct sockaddr *)&addr[i], msgs[i].msg_hdr.msg_namelen);
+        }
+    }
+    #else
+    // Without recvmmsg(), receive one message at a time until there are no more.
+    int n_recv = 0;
+    for (; (size_t)n_recv < n; ++n_recv) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(buffers[n_recv], &bufinfo, MP_BUFFER_WRITE);
+        socklen_t addr_len = sizeof(addr[0]);
+        ssize_t out_sz;
+        MP_HAL_RETRY_SYSCALL(out_sz, recvfrom(self->fd, bufinfo.buf, bufinfo.len, n_recv == 0 ? flags : flags | MSG_DONTWAIT,
+            (struct sockaddr *)&addr[0], &addr_len), {
+            if (n_recv != 0 && (err == EAGAIN || err == EWOULDBLOCK)) {
+                goto done;
+            }
+            mp_raise_OSError(err);
+        });
+        lengths->items[n_recv] = MP_OBJ_NEW_SMALL_INT(out_sz);
+        if (addresses != NULL) {
+            addresses->items[n_recv] = mp_obj_from_sockaddr((struct sockaddr *)&addr[0], addr_len);
+        }
+    }
+done:
+    (void)iov;
+    #endif
+    return MP_OBJ_NEW_SMALL_INT(n_recv);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recvmmsg_obj, 3, 5, socket_recvmmsg);
+
+// sendmmsg(buffers[, flags[, address]])
+// Sends each buffer of the sequence buffers as a separate message, all to the
+// same address if given.  Returns the number of messages sent.
+STATIC mp_obj_t socket_sendmmsg(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    size_t n;
+    mp_obj_t *buffers;
+    mp_obj_get_array(args[1], &n, &buffers);
+    n = MIN(n, SOCKET_MMSG_MAX);
+    int flags = 0;
+    mp_buffer_info_t addr_bi = { .buf = NULL, .len = 0 };
+
+    if (n_args > 2) {
+        flags = MP_OBJ_SMALL_INT_VALUE(args[2]);
+    }
+    if (n_args > 3 && args[3] != mp_const_none) {
+        mp_get_buffer_raise(args[3], &addr_bi, MP_BUFFER_READ);
+    }
+
+    #if defined(__linux__)
+    struct iovec iov[SOCKET_MMSG_MAX];
+    struct mmsghdr msgs[SOCKET_MMSG_MAX];
+    memset(msgs, 0, n * sizeof(msgs[0]));
+    for (size_t i = 0; i < n; ++i) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(buffers[i], &bufinfo, MP_BUFFER_READ);
+        iov[i].iov_base = bufinfo.buf;
+        iov[i].iov_len = bufinfo.len;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = addr_bi.buf;
+        msgs[i].msg_hdr.msg_namelen = addr_bi.len;
+    }
+
+    int n_sent;
+    MP_HAL_RETRY_SYSCALL(n_sent, sendmmsg(self->fd, msgs, n, flags), mp_raise_OSError(err));
+    #else
+    int n_sent = 0;
+    for (; (size_t)n_sent < n; ++n_sent) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(buffers[n_sent], &bufinfo, MP_BUFFER_READ);
+        ssize_t out_sz;
+        MP_HAL_RETRY_SYSCALL(out_sz, sendto(self->fd, bufinfo.buf, bufinfo.len, flags,
+            (struct sockaddr *)addr_bi.buf, addr_bi.len), {
+            if (n_sent != 0) {
+                goto done;
+            }
+            mp_raise_OSError(err);
+        });
+    }
+done:
+    #endif
+    return MP_OBJ_NEW_SMALL_INT(n_sent);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_sendmmsg_obj, 2, 4, socket_sendmmsg);
+
+// sendfile(file[, offset[, count]])
+// Sends the contents of file from offset (default 0) until EOF or until count
+// bytes were sent, and leaves the file position after the last byte sent.
+// Files are copied within the OS when possible, see mp_stream_copy().
+STATIC mp_obj_t socket_sendfile(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_obj_t file = args[1];
+    const mp_stream_p_t *file_p = mp_get_stream_raise(file, MP_STREAM_OP_READ | MP_STREAM_OP_IOCTL);
+    struct mp_stream_seek_t seek_s = { .offset = 0, .whence = MP_SEEK_SET };
+    mp_uint_t count = (mp_uint_t)-1;
+
+    if (!self->blocking) {
+        mp_raise_ValueError(MP_ERROR_TEXT("socket must be blocking"));
+    }
+    if (n_args > 2) {
+        seek_s.offset = mp_obj_get_int(args[2]);
+    }
+    if (n_args > 3 && args[3] != mp_const_none) {
+        mp_int_t n = mp_obj_get_int(args[3]);
+        if (n <= 0) {
+            mp_raise_ValueError(MP_ERROR_TEXT("count must be positive"));
+        }
+        count = n;
+    }
+
+    int errcode;
+    if (file_p->ioctl(file, MP_STREAM_SEEK, (uintptr_t)&seek_s, &errcode) == MP_STREAM_ERROR) {
+        mp_raise_OSError(errcode);
+    }
+    mp_uint_t sent = mp_stream_copy(file, args[0], count, &errcode);
+    if (errcode != 0) {
+        mp_raise_OSError(errcode);
+    }
+    return mp_obj_new_int_from_uint(sent);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_sendfile_obj, 2, 4, socket_sendfile);
+
 STATIC mp_obj_t socket_setsockopt(size_t n_args, const mp_obj_t *args) {
     (void)n_args; // always 4
     mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
@@ -484,6 +810,10 @@ STATIC mp_obj_t socket_make_new(const mp_obj_type_t *type_in, size_t n_args, siz
             if (n_args > 2) {
                 assert(mp_obj_is_small_int(args[2]));
                 proto = MP_OBJ_SMALL_INT_VALUE(args[2]);
+                if (n_args > 3 && args[3] != mp_const_none) {
+                    // Wrap an existing socket file descriptor, as CPython does.
+                    return MP_OBJ_FROM_PTR(socket_new(mp_obj_get_int(args[3])));
+                }
             }
         }
     }
@@ -510,6 +840,13 @@ STATIC const mp_rom_map_elem_t socket_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_recvfrom), MP_ROM_PTR(&socket_recvfrom_obj) },
     { MP_ROM_QSTR(MP_QSTR_send), MP_ROM_PTR(&socket_send_obj) },
     { MP_ROM_QSTR(MP_QSTR_sendto), MP_ROM_PTR(&socket_sendto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recv_into), MP_ROM_PTR(&socket_recv_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recvfrom_into), MP_ROM_PTR(&socket_recvfrom_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sendmsg), MP_ROM_PTR(&socket_sendmsg_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recvmsg_into), MP_ROM_PTR(&socket_recvmsg_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sendmmsg), MP_ROM_PTR(&socket_sendmmsg_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sendfile), MP_ROM_PTR(&socket_sendfile_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recvmmsg), MP_ROM_PTR(&socket_recvmmsg_obj) },
     { MP_ROM_QSTR(MP_QSTR_setsockopt), MP_ROM_PTR(&socket_setsockopt_obj) },
     { MP_ROM_QSTR(MP_QSTR_setblocking), MP_ROM_PTR(&socket_setblocking_obj) },
     { MP_ROM_QSTR(MP_QSTR_settimeout), MP_ROM_PTR(&socket_settimeout_obj) },
@@ -0,0 +1,652 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+#include "py/objtuple.h"
+#include "py/runtime.h"
+#include "py/stream.h"
+#include "py/mphal.h"
+
+#if MICROPY_PY_URING
+
+#include <linux/io_uring.h>
+
+// Completion-based I/O using io_uring, for asyncio.uring.
+//
+// A Ring object queues operations on file descriptors and returns a small
+// integer for each, which identifies it when its result is reaped with wait().
+// Operations are only passed to the kernel by wait(), so any number of them
+// are submitted and their results collected with a single system call.
+//
+// The objects whose memory the kernel reads or writes are referenced from the
+// ring until the result of the operation has been reaped, so they are not
+// reclaimed by the GC in the meantime.
+//
+// notify() ends a wait() early, from any thread.  It writes to an eventfd which
+// the ring polls while waiting, so wait() can block until an op completes or a
+// ThreadSafeFlag is set, without periodically checking the flags.
+
+#define URING_OP_FREE (0)
+#define URING_OP_POLL (1)
+#define URING_OP_READ (2)
+#define URING_OP_READINTO (3)
+#define URING_OP_WRITE (4)
+#define URING_OP_ACCEPT (5)
+
+// wait() with a zero timeout, which asyncio does between running tasks, only
+// submits queued ops every this many calls, so they're batched.
+#define URING_SUBMIT_BATCH (8)
+
+// user_data for cancel requests and the poll of the notify eventfd, whose own
+// results are not reported.
+#define URING_USER_DATA_CANCEL (~(uint64_t)0)
+#define URING_USER_DATA_NOTIFY (~(uint64_t)1)
+
+extern const mp_obj_type_t mp_type_socket;
+
+typedef struct _uring_accept_addr_t {
+    socklen_t len;
+    byte addr[32];
+} uring_accept_addr_t;
+
+typedef struct _uring_op_t {
+    mp_obj_t obj; // buffer object in use by the kernel
+    void *mem; // memory allocated for the result: read data or peer address
+    size_t len; // size of the read
+    size_t next_free;
+    uint8_t kind;
+} uring_op_t;
+
+typedef struct _mp_obj_uring_t {
+    mp_obj_base_t base;
+    int fd;
+    int notify_fd;
+    bool notify_armed;
+    void *ring_mem;
+    size_t ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned sq_pending;
+    unsigned sq_deferred;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    struct io_uring_cqe *cqes;
+    unsigned cq_mask;
+    uring_op_t *ops;
+    size_t ops_alloc;
+    size_t ops_free;
+    size_t ops_used;
+    mp_obj_tuple_t *ret_tuple;
+} mp_obj_uring_t;
+
+STATIC int uring_enter(mp_obj_uring_t *self, unsigned to_submit, unsigned min_complete, int timeout) {
+    struct __kernel_timespec ts = { .tv_sec = timeout / 1000, .tv_nsec = (timeout % 1000) * 1000000 };
+    struct io_uring_getevents_arg arg = { .ts = timeout < 0 ? 0 : (uintptr_t)&ts };
+    unsigned flags = IORING_ENTER_EXT_ARG;
+    if (min_complete) {
+        flags |= IORING_ENTER_GETEVENTS;
+    }
+    MP_THREAD_GIL_EXIT();
+    int ret = syscall(__NR_io_uring_enter, self->fd, to_submit, min_complete, flags, &arg, sizeof(arg));
+    MP_THREAD_GIL_ENTER();
+    if (ret < 0) {
+        int err = errno;
+        if (err == EINTR) {
+            // Let a KeyboardInterrupt or scheduled callback run, then return
+            // so the caller can reap what's there and wait again.
+            mp_handle_pending(true);
+        } else if (err != ETIME && err != EBUSY && err != EAGAIN) {
+            mp_raise_OSError(err);
+        }
+        return 0;
+    }
+    self->sq_pending -= ret;
+    self->sq_deferred = 0;
+    return ret;
+}
+
+STATIC void uring_check_open(mp_obj_uring_t *self) {
+    if (self->fd < 0) {
+        mp_raise_OSError(MP_EBADF);
+    }
+}
+
+STATIC struct io_uring_sqe *uring_get_sqe(mp_obj_uring_t *self) {
+    unsigned tail = *self->sq_tail;
+    if (tail - __atomic_load_n(self->sq_head, __ATOMIC_ACQUIRE) == self->sq_entries) {
+        // The submission queue is full, so hand what's there to the kernel.
+        uring_enter(self, self->sq_pending, 0, 0);
+        if (tail - __atomic_load_n(self->sq_head, __ATOMIC_ACQUIRE) == self->sq_entries) {
+            mp_raise_OSError(MP_EBUSY);
+        }
+    }
+    struct io_uring_sqe *sqe = &self->sqes[tail & self->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+STATIC void uring_push_sqe(mp_obj_uring_t *self) {
+    unsigned tail = *self->sq_tail;
+    self->sq_array[tail & self->sq_mask] = tail & self->sq_mask;
+    __atomic_store_n(self->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    self->sq_pending += 1;
+}
+
+STATIC size_t uring_alloc_op(mp_obj_uring_t *self) {
+    if (self->ops_free == self->ops_alloc) {
+        // No free ops, so grow the table.  The kernel only sees the index of
+        // an op, so the table can move.
+        size_t new_alloc = self->ops_alloc * 2;
+        self->ops = m_renew(uring_op_t, self->ops, self->ops_alloc, new_alloc);
+        memset(self->ops + self->ops_alloc, 0, (new_alloc - self->ops_alloc) * sizeof(uring_op_t));
+        for (size_t i = self->ops_alloc; i < new_alloc; ++i) {
+            self->ops[i].next_free = i + 1;
+        }
+        self->ops_free = self->ops_alloc;
+        self->ops_alloc = new_alloc;
+    }
+    size_t idx = self->ops_free;
+    self->ops_free = self->ops[idx].next_free;
+    self->ops_used += 1;
+    return idx;
+}
+
+STATIC void uring_free_op(mp_obj_uring_t *self, size_t idx) {
+    uring_op_t *op = &self->ops[idx];
+    op->obj = MP_OBJ_NULL;
+    op->mem = NULL;
+    op->kind = URING_OP_FREE;
+    op->next_free = self->ops_free;
+    self->ops_free = idx;
+    self->ops_used -= 1;
+}
+
+// Get the file descriptor of an int or stream object, or -1 if it has none.
+// If direct is true then only socket objects qualify (besides raw file
+// descriptors), because other streams may buffer or transform their data.
+STATIC int uring_get_fd(mp_obj_t obj, bool direct) {
+    if (mp_obj_is_int(obj)) {
+        return mp_obj_get_int(obj);
+    }
+    #if MICROPY_PY_SOCKET
+    if (direct && !mp_obj_is_type(obj, &mp_type_socket)) {
+        return -1;
+    }
+    #else
+    if (direct) {
+        return -1;
+    }
+    #endif
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(obj, MP_STREAM_OP_IOCTL);
+    int err;
+    mp_uint_t res = stream_p->ioctl(obj, MP_STREAM_GET_FILENO, 0, &err);
+    if (res == MP_STREAM_ERROR) {
+        return -1;
+    }
+    return res;
+}
+
+STATIC mp_obj_t uring_queue_op(mp_obj_uring_t *self, struct io_uring_sqe *sqe, uint8_t kind, mp_obj_t obj, void *mem, size_t len) {
+    size_t idx = uring_alloc_op(self);
+    uring_op_t *op = &self->ops[idx];
+    op->kind = kind;
+    op->obj = obj;
+    op->mem = mem;
+    op->len = len;
+    sqe->user_data = idx;
+    uring_push_sqe(self);
+    return MP_OBJ_NEW_SMALL_INT(idx);
+}
+
+STATIC mp_obj_t uring_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 0, 1, false);
+    mp_int_t entries = n_args > 0 ? mp_obj_get_int(args[0]) : 64;
+    if (entries <= 0) {
+        mp_raise_ValueError(NULL);
+    }
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = syscall(__NR_io_uring_setup, (unsigned)entries, &p);
+    RAISE_ERRNO(fd, errno);
+
+    // Waiting with a timeout needs IORING_FEAT_EXT_ARG (Linux 5.11).
+    if (!(p.features & IORING_FEAT_EXT_ARG) || !(p.features & IORING_FEAT_SINGLE_MMAP)) {
+        close(fd);
+        mp_raise_OSError(MP_EOPNOTSUPP);
+    }
+
+    size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    size_t ring_size = MAX(sq_size, cq_size);
+    size_t sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    byte *ring_mem = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring_mem == MAP_FAILED) {
+        int err = errno;
+        close(fd);
+        mp_raise_OSError(err);
+    }
+    void *sqes = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        int err = errno;
+        munmap(ring_mem, ring_size);
+        close(fd);
+        mp_raise_OSError(err);
+    }
+    int notify_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (notify_fd < 0) {
+        int err = errno;
+        munmap(sqes, sqes_size);
+        munmap(ring_mem, ring_size);
+        close(fd);
+        mp_raise_OSError(err);
+    }
+
+    mp_obj_uring_t *self = m_new_obj_with_finaliser(mp_obj_uring_t);
+    self->base.type = type;
+    self->fd = fd;
+    self->notify_fd = notify_fd;
+    self->notify_armed = false;
+    self->ring_mem = ring_mem;
+    self->ring_size = ring_size;
+    self->sqes = sqes;
+    self->sqes_size = sqes_size;
+    self->sq_head = (unsigned *)(ring_mem + p.sq_off.head);
+    self->sq_tail = (unsigned *)(ring_mem + p.sq_off.tail);
+    self->sq_array = (unsigned *)(ring_mem + p.sq_off.array);
+    self->sq_mask = *(unsigned *)(ring_mem + p.sq_off.ring_mask);
+    self->sq_entries = p.sq_entries;
+    self->sq_pending = 0;
+    self->sq_deferred = 0;
+    self->cq_head = (unsigned *)(ring_mem + p.cq_off.head);
+    self->cq_tail = (unsigned *)(ring_mem + p.cq_off.tail);
+    self->cqes = (struct io_uring_cqe *)(ring_mem + p.cq_off.cqes);
+    self->cq_mask = *(unsigned *)(ring_mem + p.cq_off.ring_mask);
+    self->ops_alloc = p.cq_entries;
+    self->ops = m_new0(uring_op_t, self->ops_alloc);
+    for (size_t i = 0; i < self->ops_alloc; ++i) {
+        self->ops[i].next_free = i + 1;
+    }
+    self->ops_free = 0;
+    self->ops_used = 0;
+    self->ret_tuple = MP_OBJ_TO_PTR(mp_obj_new_tuple(2, NULL));
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// The following functions cancel the ops that are still in flight when the ring
+// is closed, and wait for them to complete, because otherwise the kernel would
+// complete them in the background, writing to buffers that may have been freed.
+// This is also done by the finaliser, so they don't allocate or raise.
+
+STATIC bool uring_drain_enter(mp_obj_uring_t *self, unsigned min_complete) {
+    int ret = syscall(__NR_io_uring_enter, self->fd, self->sq_pending, min_complete, min_complete ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    if (ret < 0) {
+        return errno == EINTR || errno == EBUSY || errno == EAGAIN;
+    }
+    self->sq_pending -= ret;
+    return true;
+}
+
+// Discard the results of completed ops, closing any sockets they accepted.
+STATIC void uring_drain_reap(mp_obj_uring_t *self) {
+    unsigned head = *self->cq_head;
+    while (head != __atomic_load_n(self->cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe *cqe = &self->cqes[head & self->cq_mask];
+        if (cqe->user_data == URING_USER_DATA_NOTIFY) {
+            self->notify_armed = false;
+        } else if (cqe->user_data != URING_USER_DATA_CANCEL) {
+            if (self->ops[cqe->user_data].kind == URING_OP_ACCEPT && cqe->res >= 0) {
+                close(cqe->res);
+            }
+            uring_free_op(self, cqe->user_data);
+        }
+        __atomic_store_n(self->cq_head, ++head, __ATOMIC_RELEASE);
+    }
+}
+
+STATIC bool uring_drain_cancel(mp_obj_uring_t *self, uint64_t user_data) {
+    while (*self->sq_tail - __atomic_load_n(self->sq_head, __ATOMIC_ACQUIRE) == self->sq_entries) {
+        if (!uring_drain_enter(self, 0)) {
+            return false;
+        }
+        uring_drain_reap(self);
+    }
+    struct io_uring_sqe *sqe = &self->sqes[*self->sq_tail & self->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = user_data;
+    sqe->user_data = URING_USER_DATA_CANCEL;
+    uring_push_sqe(self);
+    return true;
+}
+
+STATIC void uring_drain(mp_obj_uring_t *self) {
+    for (size_t idx = 0; idx < self->ops_alloc; ++idx) {
+        if (self->ops[idx].kind != URING_OP_FREE && !uring_drain_cancel(self, idx)) {
+            return;
+        }
+    }
+    if (self->notify_armed && !uring_drain_cancel(self, URING_USER_DATA_NOTIFY)) {
+        return;
+    }
+    while (self->ops_used || self->notify_armed) {
+        if (!uring_drain_enter(self, 1)) {
+            return;
+        }
+        uring_drain_reap(self);
+    }
+}
+
+STATIC mp_obj_t uring_close(mp_obj_t self_in) {
+    mp_obj_uring_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->fd >= 0) {
+        uring_drain(self);
+        munmap(self->sqes, self->sqes_size);
+        munmap(self->ring_mem, self->ring_size);
+        close(self->fd);
+        close(self->notify_fd);
+        self->fd = -1;
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uring_close_obj, uring_close);
+
+STATIC mp_obj_t uring_fileno(mp_obj_t self_in) {
+    mp_obj_uring_t *self = MP_OBJ_TO_PTR(self_in);
+    uring_check_open(self);
+    return MP_OBJ_NEW_SMALL_INT(self->fd);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uring_fileno_obj, uring_fileno);
+
+// Ring.poll(obj, eventmask): wait for obj to be ready as for select.poll.
+// Returns the op, or None if obj has no file descriptor.
+STATIC mp_obj_t uring_poll(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t eventmask_in) {
+    mp_obj_uring_t *self = MP_OBJ_TO_PTR(self_in);
+    uring_check_open(self);
+    int fd = uring_get_fd(obj_in, false);
+    if (fd < 0) {
+        return mp_const_none;
+    }
+    struct io_uring_sqe *sqe = uring_get_sqe(self);
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = mp_obj_get_int(eventmask_in);
+    return uring_queue_op(self, sqe, URING_OP_POLL, obj_in, NULL, 0);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(uring_poll_obj, uring_poll);
+
+// Ring.read(sock, n): receive up to n bytes, with the bytes as the result.
+// Ring.readinto(sock, buf): receive into buf, with the length as the result.
+// Ring.write(sock, buf): send from buf, with the length sent as the result.
+// Each returns the op, or None if the object isn't suitable for direct I/O.
+STATIC mp_obj_t uring_rw(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t arg_in, uint8_t kind) {
+    mp_obj_uring_t *self = MP_OBJ_TO_PTR(self_in);
+    uring_check_open(self);
+    int fd = uring_get_fd(obj_in, true);
+    if (fd < 0) {
+        return mp_const_none;
+    }
+    mp_obj_t buf_obj = MP_OBJ_NULL;
+    void *mem = NULL;
+    mp_buffer_info_t bufinfo;
+    if (kind == URING_OP_READ) {
+        mp_int_t len = mp_obj_get_int(arg_in);
+        if (len < 0) {
+            mp_raise_ValueError(NULL);
+        }
+        // Allocated as for vstr_init_len(), so it can become a bytes object.
+        bufinfo.buf = mem = m_new(byte, len + 1);
+        bufinfo.len = len;
+    } else {
+        mp_get_buffer_raise(arg_in, &bufinfo, kind == URING_OP_WRITE ? MP_BUFFER_READ : MP_BUFFER_WRITE);
+        buf_obj = arg_in;
+    }
+    struct io_uring_sqe *sqe = uring_get_sqe(self);
+    sqe->opcode = kind == URING_OP_WRITE ? IORING_OP_SEND : IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->addr = (uintptr_t)bufinfo.buf;
+    sqe->len = bufinfo.len;
+    return uring_queue_op(self, sqe, kind, buf_obj, mem, bufinfo.len);
+}
+
+STATIC mp_obj_t uring_read(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t len_in) {
+    return uring_rw(self_in, obj_in, len_in, URING_OP_READ);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(uring_read_obj, uring_read);
+
+STATIC mp_obj_t uring_readinto(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t buf_in) {
+    return uring_rw(self_in, obj_in, buf_in, URING_OP_READINTO);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(uring_readinto_obj, uring_readinto);
+
+STATIC mp_obj_t uring_write(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t buf_in) {
+    return uring_rw(self_in, obj_in, buf_in, URING_OP_WRITE);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(uring_write_obj, uring_write);
+
+// Ring.accept(sock): accept a connection, with the result being a
+// (socket, address) tuple as returned by socket.accept().
+STATIC mp_obj_t uring_accept(mp_obj_t self_in, mp_obj_t obj_in) {
+    mp_obj_uring_t *self = MP_OBJ_TO_PTR(self_in);
+    uring_check_open(self);
+    int fd = uring_get_fd(obj_in, true);
+    if (fd < 0) {
+        return mp_const_none;
+    }
+    uring_accept_addr_t *addr = m_new_obj(uring_accept_addr_t);
+    addr->len = sizeof(addr->addr);
+    struct io_uring_sqe *sqe = uring_get_sqe(self);
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = fd;
+    sqe->addr = (uintptr_t)&addr->addr;
+    sqe->addr2 = (uintptr_t)&addr->len;
+    return uring_queue_op(self, sqe, URING_OP_ACCEPT, MP_OBJ_NULL, addr, 0);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(uring_accept_obj, uring_accept);
+
+// Ring.notify(): make a wait() in progress, or else the next one, return early.
+// This can be called from any thread, and does nothing if the ring is closed.
+STATIC mp_obj_t uring_notify(mp_obj_t self_in) {
+    mp_obj_uring_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->fd >= 0) {
+        eventfd_write(self->notify_fd, 1);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(uring_notify_obj, uring_notify);
+
+// Ring.cancel(op): ask the kernel to cancel an op.  The op still completes
+// and must be reaped, usually with a result of -ECANCELED.
+STATIC mp_obj_t uring_cancel(mp_obj_t self_in, mp_obj_t op_in) {
+    mp_obj_uring_t *self = MP_OBJ_TO_PTR(self_in);
+    uring_check_open(self);
+    mp_uint_t idx = mp_obj_get_int(op_in);
+    if (idx >= self->ops_alloc || self->ops[idx].kind == URING_OP_FREE) {
+        mp_raise_ValueError(NULL);
+    }
+    struct io_uring_sqe *sqe = uring_get_sqe(self);
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = idx;
+    sqe->user_data = URING_USER_DATA_CANCEL;
+    uring_push_sqe(self);
+    // Submit straight away, so that the op releases its file promptly.
+    uring_enter(self, self->sq_pending, 0, 0);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(uring_cancel_obj, uring_cancel);
+
+// Ring.wait(timeout=-1): submit queued ops, and wait up to timeout ms for at
+// least one of them to complete, or for notify() to be called.  A zero timeout
+// may defer the submission, see URING_SUBMIT_BATCH.  Returns an iterator over (op, result) pairs of the
+// completed ops, which reuses the same tuple for each pair.  A result that is
+// a negative int is an error, being minus the errno value.
+STATIC mp_obj_t uring_wait(size_t n_args, const mp_obj_t *args) {
+    mp_obj_uring_t *self = MP_OBJ_TO_PTR(args[0]);
+    uring_check_open(self);
+    int timeout = -1;
+    if (n_args > 1 && args[1] != mp_const_none) {
+        timeout = mp_obj_get_int(args[1]);
+    }
+    if (timeout == 0) {
+        // Don't wait, and only submit queued ops every so often.
+        if (self->sq_pending && ++self->sq_deferred >= URING_SUBMIT_BATCH) {
+            uring_enter(self, self->sq_pending, 0, 0);
+        }
+    } else if (*self->cq_head != __atomic_load_n(self->cq_tail, __ATOMIC_ACQUIRE)) {
+        // Results are ready, so don't wait, but submit anything that's queued.
+        if (self->sq_pending) {
+            uring_enter(self, self->sq_pending, 0, 0);
+        }
+    } else {
+        if (!self->notify_armed) {
+            struct io_uring_sqe *sqe = uring_get_sqe(self);
+            sqe->opcode = IORING_OP_POLL_ADD;
+            sqe->fd = self->notify_fd;
+            sqe->poll32_events = POLLIN;
+            sqe->user_data = URING_USER_DATA_NOTIFY;
+            uring_push_sqe(self);
+            self->notify_armed = true;
+        }
+        uring_enter(self, self->sq_pending, 1, timeout);
+    }
+    return args[0];
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(uring_wait_obj, 1, 2, uring_wait);
+
+STATIC mp_obj_t uring_result(uring_op_t *op, int res) {
+    if (res < 0) {
+        if (op->kind == URING_OP_READ) {
+            m_del(byte, op->mem, op->len + 1);
+        }
+        return MP_OBJ_NEW_SMALL_INT(res);
+    }
+    if (op->kind == URING_OP_READ) {
+        vstr_t vstr = { .alloc = op->len + 1, .len = res, .buf = op->mem, .fixed_buf = false };
+        return mp_obj_new_bytes_from_vstr(&vstr);
+    }
+    #if MICROPY_PY_SOCKET
+    if (op->kind == URING_OP_ACCEPT) {
+        uring_accept_addr_t *addr = op->mem;
+        mp_obj_t sock_args[4] = {
+            MP_OBJ_NEW_SMALL_INT(AF_INET),
+            MP_OBJ_NEW_SMALL_INT(SOCK_STREAM),
+            MP_OBJ_NEW_SMALL_INT(0),
+            MP_OBJ_NEW_SMALL_INT(res),
+        };
+        mp_obj_t items[2] = {
+            MP_OBJ_TYPE_GET_SLOT(&mp_type_socket, make_new)(&mp_type_socket, 4, 0, sock_args),
+            mp_obj_new_bytearray(MIN(addr->len, sizeof(addr->addr)), addr->addr),
+        };
+        return mp_obj_new_tuple(2, items);
+    }
+    #endif
+    return MP_OBJ_NEW_SMALL_INT(res);
+}
+
+STATIC mp_obj_t uring_iternext(mp_obj_t self_in) {
+    mp_obj_uring_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->fd < 0) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    unsigned head = *self->cq_head;
+    while (head != __atomic_load_n(self->cq_tail, __ATOMIC_ACQUIRE)) {
+        struct io_uring_cqe *cqe = &self->cqes[head & self->cq_mask];
+        uint64_t user_data = cqe->user_data;
+        int res = cqe->res;
+        __atomic_store_n(self->cq_head, ++head, __ATOMIC_RELEASE);
+        if (user_data == URING_USER_DATA_CANCEL) {
+            continue;
+        }
+        if (user_data == URING_USER_DATA_NOTIFY) {
+            // Reset the eventfd, and poll it again on the next wait.
+            eventfd_t value;
+            eventfd_read(self->notify_fd, &value);
+            self->notify_armed = false;
+            continue;
+        }
+        uring_op_t *op = &self->ops[user_data];
+        mp_obj_t result = uring_result(op, res);
+        uring_free_op(self, user_data);
+        self->ret_tuple->items[0] = MP_OBJ_NEW_SMALL_INT(user_data);
+        self->ret_tuple->items[1] = result;
+        return MP_OBJ_FROM_PTR(self->ret_tuple);
+    }
+    return MP_OBJ_STOP_ITERATION;
+}
+
+STATIC const mp_rom_map_elem_t uring_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&uring_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&uring_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fileno), MP_ROM_PTR(&uring_fileno_obj) },
+    { MP_ROM_QSTR(MP_QSTR_poll), MP_ROM_PTR(&uring_poll_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&uring_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&uring_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&uring_write_obj) },
+    { MP_ROM_QSTR(MP_QSTR_accept), MP_ROM_PTR(&uring_accept_obj) },
+    { MP_ROM_QSTR(MP_QSTR_notify), MP_ROM_PTR(&uring_notify_obj) },
+    { MP_ROM_QSTR(MP_QSTR_cancel), MP_ROM_PTR(&uring_cancel_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wait), MP_ROM_PTR(&uring_wait_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(uring_locals_dict, uring_locals_dict_table);
+
+STATIC MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_uring_ring,
+    MP_QSTR_Ring,
+    MP_TYPE_FLAG_ITER_IS_ITERNEXT,
+    make_new, uring_make_new,
+    iter, uring_iternext,
+    locals_dict, &uring_locals_dict
+    );
+
+STATIC const mp_rom_map_elem_t mp_module_uring_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR__uring) },
+    { MP_ROM_QSTR(MP_QSTR_Ring), MP_ROM_PTR(&mp_type_uring_ring) },
+};
+STATIC MP_DEFINE_CONST_DICT(mp_module_uring_globals, mp_module_uring_globals_table);
+
+const mp_obj_module_t mp_module_uring = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t *)&mp_module_uring_globals,
+};
+
+MP_REGISTER_MODULE(MP_QSTR__uring, mp_module_uring);
+
+#endif // MICROPY_PY_URING
@@ -70,6 +70,29 @@
     #define MICROPY_EMIT_ARM        (1)
 #endif
 
+// Use x86-64 instruction set extensions, when the CPU has them, for hashing,
+// ciphers and binary/ASCII conversions.
+#if defined(__x86_64__) && defined(__GNUC__)
+#ifndef MICROPY_PY_HASHLIB_SHA256_X64
+#define MICROPY_PY_HASHLIB_SHA256_X64 (1)
+#endif
+#ifndef MICROPY_PY_BINASCII_X64
+#define MICROPY_PY_BINASCII_X64 (1)
+#endif
+#ifndef MICROPY_PY_CRYPTOLIB_X64
+#define MICROPY_PY_CRYPTOLIB_X64 (1)
+#endif
+#endif
+
+// Without the GIL, let threads allocate small objects without contending
+// for the GC mutex (not supported with a split heap).
+#if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL && !MICROPY_GC_SPLIT_HEAP
+#ifndef MICROPY_GC_THREAD_REGION
+#define MICROPY_GC_THREAD_REGION (1)
+#endif
+#define MICROPY_GC_THREAD_REGION_WAIT() sched_yield()
+#endif
+
 // Type definitions for the specific machine based on the word size.
 #ifndef MICROPY_OBJ_REPR
 #ifdef __LP64__
@@ -121,6 +144,38 @@ typedef long mp_off_t;
 #define MICROPY_TRACKED_ALLOC       (MICROPY_BLUETOOTH_BTSTACK)
 #endif
 
+// Read files and sockets in page-sized chunks.
+#define MICROPY_STREAMS_READ_BUFFER_SIZE (4096)
+
+// Copy from files to sockets and files with sendfile().
+#if defined(__linux__)
+#define MICROPY_STREAMS_COPY_FD     (1)
+#endif
+
+// The _uring module, for completion-based socket I/O with asyncio.uring.
+#if defined(__linux__) && !defined(MICROPY_PY_URING)
+#define MICROPY_PY_URING            (1)
+#endif
+
+// The profiler module, a sampling profiler for Python code driven by SIGPROF.
+// It needs the VM to keep track of the running frames, which makes calls a
+// little slower, so it's only built when asked for.
+#ifndef MICROPY_PY_PROFILER
+#define MICROPY_PY_PROFILER         (0)
+#endif
+#if MICROPY_PY_PROFILER
+#define MICROPY_TRACK_FRAMES        (1)
+#endif
+#ifndef MICROPY_PY_PROFILER_DEPTH
+#define MICROPY_PY_PROFILER_DEPTH   (16)
+#endif
+#ifndef MICROPY_PY_PROFILER_SAMPLES
+#define MICROPY_PY_PROFILER_SAMPLES (256)
+#endif
+
+// There's no cycle counter, so time calls for micropython.vm_stats in ns.
+#define MICROPY_PY_MICROPYTHON_VM_STATS_TICKS() mp_hal_time_ns()
+
 // VFS stat functions should return time values relative to 1970/1/1
 #define MICROPY_EPOCH_IS_1970       (1)
 
@@ -41,6 +41,9 @@ MICROPY_STANDALONE = 0
 
 MICROPY_ROM_TEXT_COMPRESSION = 1
 
+# Generate ROM map lookup hints for faster builtin attribute lookup
+MICROPY_OPT_MAP_LOOKUP_ROM_HINT = 1
+
 MICROPY_VFS_FAT = 1
 MICROPY_VFS_LFS1 = 1
 MICROPY_VFS_LFS2 = 1
@@ -34,8 +34,13 @@
 #include "py/mphal.h"
 #include "py/mpthread.h"
 #include "py/runtime.h"
+#include "py/stream.h"
 #include "extmod/misc.h"
 
+#if MICROPY_STREAMS_COPY_FD
+#include <sys/sendfile.h>
+#endif
+
 #if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
 #if __GLIBC_PREREQ(2, 25)
 #include <sys/random.h>
@@ -259,3 +264,16 @@ void mp_hal_get_random(size_t n, void *buf) {
     close(fd);
     #endif
 }
+
+#if MICROPY_STREAMS_COPY_FD
+mp_uint_t mp_hal_stream_copy_fd(int src_fd, int dst_fd, mp_uint_t len, int *errcode) {
+    // sendfile() transfers at most 0x7ffff000 bytes per call anyway.
+    size_t n = MIN(len, 0x7ffff000);
+    ssize_t r;
+    MP_HAL_RETRY_SYSCALL(r, sendfile(dst_fd, src_fd, NULL, n), {
+        *errcode = err;
+        return MP_STREAM_ERROR;
+    });
+    return r;
+}
+#endif
@@ -0,0 +1,16 @@
+# test frozen module that only defines functions and constants, so its globals
+# can be pre-evaluated into ROM
+from micropython import const
+
+X = const(2)
+NAME = "frzrom"
+DATA = (1, 2.5, b"abc")
+
+
+def f(a, b=X, c="c"):
+    return (a, b, c, NAME)
+
+
+def gen(n):
+    for i in range(n):
+        yield i * X
@@ -42,3 +42,6 @@
 #define MICROPY_TRACKED_ALLOC          (1)
 #define MICROPY_WARNINGS_CATEGORY      (1)
 #define MICROPY_PY_CRYPTOLIB_CTR       (1)
+#define MICROPY_PY_PROFILER            (1)
+#define MICROPY_PY_MICROPYTHON_VM_STATS (1)
+#define MICROPY_MODULE_FROZEN_ROM_GLOBALS (1)
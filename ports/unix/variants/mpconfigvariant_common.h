@@ -67,6 +67,11 @@
 // Allow loading of .mpy files.
 #define MICROPY_PERSISTENT_CODE_LOAD   (1)
 
+// Cache the bytecode of imported .py files in __pycache__ directories.
+#ifndef MICROPY_MODULE_CACHE
+#define MICROPY_MODULE_CACHE           (1)
+#endif
+
 // Extra memory debugging.
 #define MICROPY_MALLOC_USES_ALLOCATED_SIZE (1)
 #define MICROPY_MEM_STATS              (1)
@@ -104,6 +109,7 @@
 #define MICROPY_PY_HASHLIB_MD5         (1)
 #define MICROPY_PY_HASHLIB_SHA1        (1)
 #define MICROPY_PY_CRYPTOLIB           (1)
+#define MICROPY_PY_CRYPTOLIB_GCM       (1)
 #endif
 
 // The "select" module is enabled by default, but disable select.select().
@@ -44,7 +44,14 @@
 
 #include <stdint.h>
 
+#ifdef __LP64__
+typedef long mp_int_t;
+typedef unsigned long mp_uint_t;
+#define UINT_FMT "%lu"
+#define INT_FMT "%ld"
+#else
 typedef int64_t mp_int_t;
 typedef uint64_t mp_uint_t;
 #define UINT_FMT "%llu"
 #define INT_FMT "%lld"
+#endif
@@ -1,3 +1,4 @@
 # build interpreter with nan-boxing as object model (object repr D)
+# (pass MICROPY_FORCE_32BIT=0 to build it for a 64-bit machine instead)
 
 MICROPY_FORCE_32BIT = 1
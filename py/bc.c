@@ -325,13 +325,38 @@ void mp_setup_code_state(mp_code_state_t *code_state, size_t n_args, size_t n_kw
     #if MICROPY_STACKLESS
     code_state->prev = NULL;
     #endif
-    #if MICROPY_PY_SYS_SETTRACE
+    #if MICROPY_TRACK_FRAMES
     code_state->prev_state = NULL;
+    #endif
+    #if MICROPY_PY_SYS_SETTRACE
     code_state->frame = NULL;
     #endif
     mp_setup_code_state_helper(code_state, n_args, n_kw, args);
 }
 
+// Get the source file, function name and line number of the instruction that
+// code_state is executing, as decoded from its bytecode prelude.
+void mp_code_state_get_location(const mp_code_state_t *code_state, qstr *source_file, qstr *block_name, size_t *source_line) {
+    const byte *ip = code_state->fun_bc->bytecode;
+    MP_BC_PRELUDE_SIG_DECODE(ip);
+    MP_BC_PRELUDE_SIZE_DECODE(ip);
+    const byte *line_info_top = ip + n_info;
+    const byte *bytecode_start = ip + n_info + n_cell;
+    size_t bc = code_state->ip - bytecode_start;
+    qstr name = mp_decode_uint_value(ip);
+    for (size_t i = 0; i < 1 + n_pos_args + n_kwonly_args; ++i) {
+        ip = mp_decode_uint_skip(ip);
+    }
+    #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
+    *block_name = code_state->fun_bc->context->constants.qstr_table[name];
+    *source_file = code_state->fun_bc->context->constants.qstr_table[0];
+    #else
+    *block_name = name;
+    *source_file = code_state->fun_bc->context->constants.source_file;
+    #endif
+    *source_line = mp_bytecode_get_source_line(ip, line_info_top, bc);
+}
+
 #if MICROPY_EMIT_NATIVE
 // On entry code_state should be allocated somewhere (stack/heap) and
 // contain the following valid entries:
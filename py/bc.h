@@ -227,6 +227,10 @@ typedef struct _mp_compiled_module_t {
 typedef struct _mp_frozen_module_t {
     const mp_module_constants_t constants;
     const struct _mp_raw_code_t *rc;
+    #if MICROPY_MODULE_FROZEN_ROM_GLOBALS
+    // The module with its globals pre-evaluated in ROM, or NULL if it must be executed.
+    const mp_module_context_t *context;
+    #endif
 } mp_frozen_module_t;
 
 // State for an executing function.
@@ -244,8 +248,10 @@ typedef struct _mp_code_state_t {
     #if MICROPY_STACKLESS
     struct _mp_code_state_t *prev;
     #endif
-    #if MICROPY_PY_SYS_SETTRACE
+    #if MICROPY_TRACK_FRAMES
     struct _mp_code_state_t *prev_state;
+    #endif
+    #if MICROPY_PY_SYS_SETTRACE
     struct _mp_obj_frame_t *frame;
     #endif
     // Variable-length
@@ -281,6 +287,31 @@ mp_vm_return_kind_t mp_execute_bytecode(mp_code_state_t *code_state,
 mp_code_state_t *mp_obj_fun_bc_prepare_codestate(mp_obj_t func, size_t n_args, size_t n_kw, const mp_obj_t *args);
 void mp_setup_code_state(mp_code_state_t *code_state, size_t n_args, size_t n_kw, const mp_obj_t *args);
 void mp_setup_code_state_native(mp_code_state_native_t *code_state, size_t n_args, size_t n_kw, const mp_obj_t *args);
+#if MICROPY_PY_MICROPYTHON_VM_STATS
+typedef struct _mp_vm_stats_fun_t {
+    const byte *bytecode;
+    qstr source_file;
+    qstr block_name;
+    size_t calls;
+    uint64_t ticks;
+} mp_vm_stats_fun_t;
+
+// What the VM has executed since the stats were last reset.  The time spent
+// in each function includes the functions it calls.
+typedef struct _mp_vm_stats_t {
+    size_t opcode[256];
+    size_t opcode_pair[256][256]; // opcode_pair[0] counts the first opcodes run
+    mp_vm_stats_fun_t fun[MICROPY_PY_MICROPYTHON_VM_STATS_FUNCS];
+    size_t fun_other_calls; // calls to functions that didn't fit in fun
+} mp_vm_stats_t;
+
+extern mp_vm_stats_t mp_vm_stats;
+
+uint64_t mp_vm_stats_ticks(void);
+void mp_vm_stats_call(const struct _mp_obj_fun_bc_t *fun, uint64_t start_ticks);
+#endif
+
+void mp_code_state_get_location(const mp_code_state_t *code_state, qstr *source_file, qstr *block_name, size_t *source_line);
 void mp_bytecode_print(const mp_print_t *print, const struct _mp_raw_code_t *rc, const mp_module_constants_t *cm);
 void mp_bytecode_print2(const mp_print_t *print, const byte *ip, size_t len, struct _mp_raw_code_t *const *child_table, const mp_module_constants_t *cm);
 const byte *mp_bytecode_print_str(const mp_print_t *print, const byte *ip_start, const byte *ip, struct _mp_raw_code_t *const *child_table, const mp_module_constants_t *cm);
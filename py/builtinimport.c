@@ -36,6 +36,7 @@
 #include "py/runtime.h"
 #include "py/builtin.h"
 #include "py/frozenmod.h"
+#include "py/stream.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_PRINT (1)
@@ -195,6 +196,171 @@ STATIC void do_execute_raw_code(const mp_module_context_t *context, const mp_raw
 }
 #endif
 
+#if MICROPY_MODULE_CACHE
+
+// The bytecode of "dir/mod.py" is cached in "dir/__pycache__/mod.mpy", if the
+// __pycache__ directory exists.  The file is this header followed by the .mpy
+// data, and the header records the source that the .mpy was compiled from (its
+// path, which the bytecode refers to, and the compiler options used) along with
+// the length and hash of the .mpy data, so a stale or partly-written cache file,
+// or one for the module at a different path, is never loaded.
+typedef struct _module_cache_header_t {
+    uint64_t source_hash;
+    uint64_t mpy_hash;
+    uint32_t source_len;
+    uint32_t mpy_len;
+} module_cache_header_t;
+
+// 64-bit FNV-1a hash.
+STATIC uint64_t module_cache_hash(uint64_t hash, const byte *data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001b3;
+    }
+    return hash;
+}
+
+STATIC void module_cache_read_file(const char *path, vstr_t *buf) {
+    mp_obj_t args[2] = { mp_obj_new_str(path, strlen(path)), MP_OBJ_NEW_QSTR(MP_QSTR_rb) };
+    mp_obj_t stream = mp_builtin_open(2, args, (mp_map_t *)&mp_const_empty_map);
+    int errcode = 0;
+    mp_uint_t n;
+    do {
+        char *p = vstr_add_len(buf, 512);
+        n = mp_stream_rw(stream, p, 512, &errcode, MP_STREAM_RW_READ);
+        vstr_cut_tail_bytes(buf, 512 - n);
+    } while (n == 512 && errcode == 0);
+    mp_stream_close(stream);
+    if (errcode != 0) {
+        mp_raise_OSError(errcode);
+    }
+}
+
+STATIC void module_cache_write_file(const char *path, const vstr_t *buf) {
+    mp_obj_t args[2] = { mp_obj_new_str(path, strlen(path)), MP_OBJ_NEW_QSTR(MP_QSTR_wb) };
+    mp_obj_t stream = mp_builtin_open(2, args, (mp_map_t *)&mp_const_empty_map);
+    int errcode;
+    mp_stream_write_exactly(stream, buf->buf, buf->len, &errcode);
+    mp_stream_close(stream);
+    if (errcode != 0) {
+        mp_raise_OSError(errcode);
+    }
+}
+
+// Exceptions from reading or writing the cache are ignored, and the module is
+// compiled as if there was no cache, unless they're more serious than the file
+// being inaccessible or incompatible.
+STATIC void module_cache_check_exception(nlr_buf_t *nlr) {
+    mp_obj_t exc = MP_OBJ_FROM_PTR(nlr->ret_val);
+    if (!mp_obj_exception_match(exc, MP_OBJ_FROM_PTR(&mp_type_OSError))
+        && !mp_obj_exception_match(exc, MP_OBJ_FROM_PTR(&mp_type_ValueError))) {
+        nlr_jump(nlr->ret_val);
+    }
+}
+
+// Load the module from file_str (a .py file) using its cached bytecode if the
+// cache is up to date, otherwise compile it and update the cache.  Returns false
+// without doing anything if there is no __pycache__ directory.
+STATIC bool do_load_cached(mp_module_context_t *context, qstr file_qstr, const char *file_str, size_t file_len) {
+    // Work out the path to the cache file.
+    const char *name = file_str + file_len - 3;
+    while (name > file_str && name[-1] != PATH_SEP_CHAR[0]) {
+        --name;
+    }
+    vstr_t cache_path;
+    vstr_init(&cache_path, file_len + 16);
+    vstr_add_strn(&cache_path, file_str, name - file_str);
+    vstr_add_str(&cache_path, "__pycache__");
+    if (stat_path(vstr_null_terminated_str(&cache_path)) != MP_IMPORT_STAT_DIR) {
+        vstr_clear(&cache_path);
+        return false;
+    }
+    vstr_add_char(&cache_path, PATH_SEP_CHAR[0]);
+    vstr_add_strn(&cache_path, name, file_str + file_len - 3 - name);
+    vstr_add_str(&cache_path, ".mpy");
+    const char *cache_str = vstr_null_terminated_str(&cache_path);
+
+    // The source is always read, to check that the cache matches it.
+    vstr_t source;
+    vstr_init(&source, 512);
+    module_cache_read_file(file_str, &source);
+    module_cache_header_t header;
+    byte opts[2] = { MP_STATE_VM(mp_optimise_value), 0 };
+    #if MICROPY_EMIT_NATIVE
+    opts[1] = MP_STATE_VM(default_emit_opt);
+    #endif
+    header.source_hash = module_cache_hash(0xcbf29ce484222325, opts, sizeof(opts));
+    header.source_hash = module_cache_hash(header.source_hash, (const byte *)file_str, file_len + 1);
+    header.source_hash = module_cache_hash(header.source_hash, (const byte *)source.buf, source.len);
+    header.source_len = source.len;
+
+    mp_compiled_module_t cm;
+    cm.context = context;
+
+    if (stat_path(cache_str) == MP_IMPORT_STAT_FILE) {
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            vstr_t cache;
+            vstr_init(&cache, sizeof(header) + source.len);
+            module_cache_read_file(cache_str, &cache);
+            module_cache_header_t cache_header;
+            bool valid = false;
+            if (cache.len >= sizeof(cache_header)) {
+                memcpy(&cache_header, cache.buf, sizeof(cache_header));
+                const byte *mpy = (const byte *)cache.buf + sizeof(cache_header);
+                valid = cache_header.source_hash == header.source_hash
+                    && cache_header.source_len == header.source_len
+                    && cache_header.mpy_len == cache.len - sizeof(cache_header)
+                    && cache_header.mpy_hash == module_cache_hash(0xcbf29ce484222325, mpy, cache_header.mpy_len);
+                if (valid) {
+                    mp_raw_code_load_mem(mpy, cache_header.mpy_len, &cm);
+                }
+            }
+            vstr_clear(&cache);
+            nlr_pop();
+            if (valid) {
+                vstr_clear(&source);
+                vstr_clear(&cache_path);
+                do_execute_raw_code(context, cm.rc, file_qstr);
+                return true;
+            }
+        } else {
+            module_cache_check_exception(&nlr);
+        }
+    }
+
+    // Compile the source.
+    mp_lexer_t *lex = mp_lexer_new_from_str_len(file_qstr, source.buf, source.len, 0);
+    mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+    mp_compile_to_raw_code(&parse_tree, file_qstr, false, &cm);
+    vstr_clear(&source);
+
+    // Update the cache, unless there's machine code that can't be saved.
+    if (!cm.has_native) {
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            vstr_t cache;
+            mp_print_t print;
+            vstr_init_print(&cache, 512, &print);
+            vstr_add_len(&cache, sizeof(header));
+            mp_raw_code_save(&cm, &print);
+            header.mpy_len = cache.len - sizeof(header);
+            header.mpy_hash = module_cache_hash(0xcbf29ce484222325, (const byte *)cache.buf + sizeof(header), header.mpy_len);
+            memcpy(cache.buf, &header, sizeof(header));
+            module_cache_write_file(cache_str, &cache);
+            vstr_clear(&cache);
+            nlr_pop();
+        } else {
+            module_cache_check_exception(&nlr);
+        }
+    }
+    vstr_clear(&cache_path);
+
+    do_execute_raw_code(context, cm.rc, file_qstr);
+    return true;
+}
+
+#endif // MICROPY_MODULE_CACHE
+
 STATIC void do_load(mp_module_context_t *module_obj, vstr_t *file) {
     #if MICROPY_MODULE_FROZEN || MICROPY_ENABLE_COMPILER || (MICROPY_PERSISTENT_CODE_LOAD && MICROPY_HAS_FILE_READER)
     const char *file_str = vstr_null_terminated_str(file);
@@ -254,6 +420,11 @@ STATIC void do_load(mp_module_context_t *module_obj, vstr_t *file) {
     // If we can compile scripts then load the file and compile and execute it.
     #if MICROPY_ENABLE_COMPILER
     {
+        #if MICROPY_MODULE_CACHE
+        if (do_load_cached(module_obj, file_qstr, file_str, file->len)) {
+            return;
+        }
+        #endif
         mp_lexer_t *lex = mp_lexer_new_from_file(file_qstr);
         do_load_from_lexer(module_obj, lex);
         return;
@@ -264,6 +435,27 @@ STATIC void do_load(mp_module_context_t *module_obj, vstr_t *file) {
     #endif
 }
 
+#if MICROPY_MODULE_FROZEN_ROM_GLOBALS
+// If the given path is a frozen module with its globals in ROM, and it was
+// frozen under the name that it's being imported as, return that module.
+STATIC mp_obj_t find_frozen_rom_module(vstr_t *path, qstr mod_name) {
+    const char *path_str = vstr_null_terminated_str(path);
+    const int frozen_path_prefix_len = strlen(MP_FROZEN_PATH_PREFIX);
+    if (strncmp(path_str, MP_FROZEN_PATH_PREFIX, frozen_path_prefix_len) != 0) {
+        return MP_OBJ_NULL;
+    }
+    const mp_module_context_t *context = mp_find_frozen_rom_module(path_str + frozen_path_prefix_len);
+    if (context == NULL) {
+        return MP_OBJ_NULL;
+    }
+    mp_map_elem_t *elem = mp_map_lookup(&context->module.globals->map, MP_OBJ_NEW_QSTR(MP_QSTR___name__), MP_MAP_LOOKUP);
+    if (elem == NULL || elem->value != MP_OBJ_NEW_QSTR(mod_name)) {
+        return MP_OBJ_NULL;
+    }
+    return MP_OBJ_FROM_PTR(&context->module);
+}
+#endif
+
 // Convert a relative (to the current module) import, going up "level" levels,
 // into an absolute import.
 STATIC void evaluate_relative_import(mp_int_t level, const char **module_name, size_t *module_name_len) {
@@ -457,6 +649,21 @@ STATIC mp_obj_t process_import_at_level(qstr full_mod_name, qstr level_mod_name,
     // Module was found on the filesystem/frozen, try and load it.
     DEBUG_printf("Found path to load: %.*s\n", (int)vstr_len(&path), vstr_str(&path));
 
+    #if MICROPY_MODULE_FROZEN_ROM_GLOBALS
+    // A frozen module whose globals were pre-evaluated into ROM by mpy-tool
+    // doesn't need to be executed, it only needs to be registered.
+    if (stat == MP_IMPORT_STAT_FILE && !override_main) {
+        module_obj = find_frozen_rom_module(&path, full_mod_name);
+        if (module_obj != MP_OBJ_NULL) {
+            mp_map_lookup(&MP_STATE_VM(mp_loaded_modules_dict).map, MP_OBJ_NEW_QSTR(full_mod_name), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = module_obj;
+            if (outer_module_obj != MP_OBJ_NULL) {
+                mp_store_attr(outer_module_obj, level_mod_name, module_obj);
+            }
+            return module_obj;
+        }
+    }
+    #endif
+
     // Prepare for loading from the filesystem. Create a new shell module
     // and register it in sys.modules.  Also make sure we remove it if
     // there is any problem below.
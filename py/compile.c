@@ -214,14 +214,16 @@ STATIC void mp_emit_common_init(mp_emit_common_t *emit, qstr source_file) {
 }
 
 STATIC void mp_emit_common_start_pass(mp_emit_common_t *emit, pass_kind_t pass) {
-    emit->pass = pass;
-    if (pass == MP_PASS_CODE_SIZE) {
+    // The number of children is known after the MP_PASS_STACK_SIZE pass, so
+    // allocate them for the next pass (MP_PASS_CODE_SIZE or MP_PASS_EMIT).
+    if (pass > MP_PASS_STACK_SIZE && emit->pass <= MP_PASS_STACK_SIZE) {
         if (emit->ct_cur_child == 0) {
             emit->children = NULL;
         } else {
             emit->children = m_new0(mp_raw_code_t *, emit->ct_cur_child);
         }
     }
+    emit->pass = pass;
     emit->ct_cur_child = 0;
 }
 
@@ -3566,7 +3568,8 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
             compile_scope(comp, s, MP_PASS_STACK_SIZE);
 
             // second last pass: compute code size
-            if (comp->compile_error == MP_OBJ_NULL) {
+            // the bytecode emitter does this at the end of the previous pass
+            if (comp->compile_error == MP_OBJ_NULL && comp->emit != emit_bc) {
                 compile_scope(comp, s, MP_PASS_CODE_SIZE);
             }
 
@@ -42,7 +42,7 @@
 typedef enum {
     MP_PASS_SCOPE = 1,      // work out id's and their kind, and number of labels
     MP_PASS_STACK_SIZE = 2, // work out maximum stack size
-    MP_PASS_CODE_SIZE = 3,  // work out code size and label offsets
+    MP_PASS_CODE_SIZE = 3,  // work out code size and label offsets (not used by the bytecode emitter)
     MP_PASS_EMIT = 4,       // emit code (may be run multiple times if the emitter requests it)
 } pass_kind_t;
 
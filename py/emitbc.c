@@ -73,8 +73,54 @@ struct _emit_t {
 
     size_t n_info;
     size_t n_cell;
+
+    // The jumps emitted by the MP_PASS_STACK_SIZE pass, used to work out the
+    // final offset of each label before the first MP_PASS_EMIT pass.
+    size_t jumps_alloc;
+    size_t jumps_len;
+    struct _emit_bc_jump_t *jumps;
+
+    #if MICROPY_COMP_PEEPHOLE
+    // Whether to optimise the bytecode, using what the MP_PASS_STACK_SIZE
+    // pass found out about each label.
+    bool peep;
+    bool peep_pending_none;
+    byte peep_cond_pending;
+    size_t peep_n_pending;
+    size_t peep_pending[4];
+    size_t peep_n_jumps;
+    size_t peep_cond_jump;
+    size_t peep_cond_label;
+    size_t peep_cond_over_jump;
+    struct _peep_label_t *peep_labels;
+    #endif
 };
 
+typedef struct _emit_bc_jump_t {
+    size_t offset; // offset of the jump in the MP_PASS_STACK_SIZE pass
+    size_t target; // offset of the label in the MP_PASS_STACK_SIZE pass
+    size_t saved; // bytes saved by the short jumps before this one
+    mp_uint_t label;
+    bool is_signed;
+    bool is_short;
+} emit_bc_jump_t;
+
+#if MICROPY_COMP_PEEPHOLE
+// What the code at a label starts with.
+#define PEEP_LABEL_OTHER (0)
+#define PEEP_LABEL_JUMP (1)
+#define PEEP_LABEL_RETURN_NONE (2)
+
+typedef struct _peep_label_t {
+    byte kind; // one of PEEP_LABEL_xxx
+    bool used; // whether anything jumps to the label
+    size_t jump_target; // for PEEP_LABEL_JUMP, the label jumped to
+    // If non-zero, the number (counting from 1) of a conditional jump to this
+    // label that is followed by an unconditional jump and then this label.
+    size_t cond_over_jump;
+} peep_label_t;
+#endif
+
 emit_t *emit_bc_new(mp_emit_common_t *emit_common) {
     emit_t *emit = m_new0(emit_t, 1);
     emit->emit_common = emit_common;
@@ -84,10 +130,17 @@ emit_t *emit_bc_new(mp_emit_common_t *emit_common) {
 void emit_bc_set_max_num_labels(emit_t *emit, mp_uint_t max_num_labels) {
     emit->max_num_labels = max_num_labels;
     emit->label_offsets = m_new(size_t, emit->max_num_labels);
+    #if MICROPY_COMP_PEEPHOLE
+    emit->peep_labels = m_new(peep_label_t, emit->max_num_labels);
+    #endif
 }
 
 void emit_bc_free(emit_t *emit) {
     m_del(size_t, emit->label_offsets, emit->max_num_labels);
+    m_del(emit_bc_jump_t, emit->jumps, emit->jumps_alloc);
+    #if MICROPY_COMP_PEEPHOLE
+    m_del(peep_label_t, emit->peep_labels, emit->max_num_labels);
+    #endif
     m_del_obj(emit_t, emit);
 }
 
@@ -159,13 +212,79 @@ STATIC uint8_t *emit_get_cur_to_write_bytecode(void *emit_in, size_t num_bytes_t
     }
 }
 
+#if MICROPY_COMP_PEEPHOLE
+
+STATIC void emit_peep_set_pending(emit_t *emit, byte kind, size_t jump_target) {
+    for (size_t i = 0; i < emit->peep_n_pending; ++i) {
+        peep_label_t *l = &emit->peep_labels[emit->peep_pending[i]];
+        l->kind = kind;
+        l->jump_target = jump_target;
+    }
+    emit->peep_n_pending = 0;
+    emit->peep_pending_none = false;
+}
+
+// Called for each opcode emitted, to record what the code at any labels just
+// assigned starts with, and to find conditional jumps over an unconditional
+// jump.  This is only done in the MP_PASS_STACK_SIZE pass, and later passes
+// use the information to improve the jumps.
+STATIC void emit_peep_record(emit_t *emit, byte op, mp_uint_t label) {
+    if (emit->pass != MP_PASS_STACK_SIZE || emit->suppress) {
+        return;
+    }
+
+    if (op == MP_BC_POP_JUMP_IF_TRUE || op == MP_BC_POP_JUMP_IF_FALSE) {
+        emit->peep_cond_jump = emit->peep_n_jumps;
+        emit->peep_cond_label = label;
+        emit->peep_cond_over_jump = 0;
+    } else if (op == MP_BC_JUMP && emit->peep_cond_jump != 0) {
+        emit->peep_cond_over_jump = emit->peep_cond_jump;
+        emit->peep_cond_jump = 0;
+    } else {
+        emit->peep_cond_jump = 0;
+        emit->peep_cond_over_jump = 0;
+    }
+
+    if (emit->peep_n_pending == 0) {
+        return;
+    }
+    if (emit->peep_pending_none) {
+        emit_peep_set_pending(emit, op == MP_BC_RETURN_VALUE ? PEEP_LABEL_RETURN_NONE : PEEP_LABEL_OTHER, 0);
+    } else if (op == MP_BC_LOAD_CONST_NONE) {
+        // Wait for the next opcode to see if this is "return None".
+        emit->peep_pending_none = true;
+    } else if (op == MP_BC_JUMP) {
+        emit_peep_set_pending(emit, PEEP_LABEL_JUMP, label);
+    } else {
+        emit_peep_set_pending(emit, PEEP_LABEL_OTHER, 0);
+    }
+}
+
+// Follow a chain of labels whose code is just an unconditional jump, to find
+// where a jump to the given label would end up.  The number of steps is
+// limited so that loops of jumps terminate.
+STATIC mp_uint_t emit_peep_jump_target(emit_t *emit, mp_uint_t label) {
+    for (int i = 0; i < 8 && emit->peep_labels[label].kind == PEEP_LABEL_JUMP; ++i) {
+        label = emit->peep_labels[label].jump_target;
+    }
+    return label;
+}
+
+#endif
+
 STATIC void emit_write_bytecode_raw_byte(emit_t *emit, byte b1) {
+    #if MICROPY_COMP_PEEPHOLE
+    emit_peep_record(emit, b1, 0);
+    #endif
     byte *c = emit_get_cur_to_write_bytecode(emit, 1);
     c[0] = b1;
 }
 
 STATIC void emit_write_bytecode_byte(emit_t *emit, int stack_adj, byte b1) {
     mp_emit_bc_adjust_stack_size(emit, stack_adj);
+    #if MICROPY_COMP_PEEPHOLE
+    emit_peep_record(emit, b1, 0);
+    #endif
     byte *c = emit_get_cur_to_write_bytecode(emit, 1);
     c[0] = b1;
 }
@@ -222,6 +341,84 @@ STATIC void emit_write_bytecode_byte_child(emit_t *emit, int stack_adj, byte b,
     #endif
 }
 
+// Whether a jump with the given offset can use a 1-byte encoding of the offset.
+STATIC bool emit_bc_jump_is_short(bool is_signed, ssize_t bytecode_offset) {
+    return (is_signed && -64 <= bytecode_offset && bytecode_offset <= 63)
+           || (!is_signed && (size_t)bytecode_offset <= 127);
+}
+
+STATIC void emit_bc_record_jump(emit_t *emit, mp_uint_t label, bool is_signed) {
+    if (emit->jumps_len >= emit->jumps_alloc) {
+        size_t new_alloc = emit->jumps_alloc * 2 + 16;
+        emit->jumps = m_renew(emit_bc_jump_t, emit->jumps, emit->jumps_alloc, new_alloc);
+        emit->jumps_alloc = new_alloc;
+    }
+    emit_bc_jump_t *j = &emit->jumps[emit->jumps_len++];
+    j->offset = emit->bytecode_offset;
+    j->label = label;
+    j->is_signed = is_signed;
+}
+
+// Returns the number of bytes saved by the short jumps before the given offset
+// in the code emitted by the MP_PASS_STACK_SIZE pass.
+STATIC size_t emit_bc_jumps_saved_before(emit_t *emit, size_t offset, size_t total) {
+    size_t lo = 0;
+    size_t hi = emit->jumps_len;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (emit->jumps[mid].offset < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo == emit->jumps_len ? total : emit->jumps[lo].saved;
+}
+
+// The MP_PASS_STACK_SIZE pass emits every jump with a 2-byte offset.  Work out
+// which jumps can use a 1-byte offset instead, and the resulting label offsets,
+// which is what successive MP_PASS_EMIT passes would otherwise find out by
+// walking the parse tree again.  Jumps can only shrink, so this converges.
+// Returns the number of bytes saved.
+STATIC size_t emit_bc_relax_jumps(emit_t *emit) {
+    emit_bc_jump_t *jumps = emit->jumps;
+    size_t n = emit->jumps_len;
+    for (size_t i = 0; i < n; ++i) {
+        jumps[i].target = emit->label_offsets[jumps[i].label];
+        jumps[i].saved = 0;
+        jumps[i].is_short = false;
+    }
+    size_t total = 0;
+    for (;;) {
+        // Choose the encoding of each jump based on the previous layout.
+        bool changed = false;
+        for (size_t i = 0; i < n; ++i) {
+            emit_bc_jump_t *j = &jumps[i];
+            if (!j->is_short) {
+                size_t target = j->target - emit_bc_jumps_saved_before(emit, j->target, total);
+                ssize_t bytecode_offset = target - (j->offset - j->saved) - 2;
+                if (emit_bc_jump_is_short(j->is_signed, bytecode_offset)) {
+                    j->is_short = true;
+                    changed = true;
+                }
+            }
+        }
+        if (!changed) {
+            break;
+        }
+        // Compute the new layout.
+        total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            jumps[i].saved = total;
+            total += jumps[i].is_short;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        emit->label_offsets[jumps[i].label] = jumps[i].target - emit_bc_jumps_saved_before(emit, jumps[i].target, total);
+    }
+    return total;
+}
+
 // Emit a jump opcode to a destination label.
 // The offset to the label is relative to the ip following this instruction.
 // The offset is encoded as either 1 or 2 bytes, depending on how big it is.
@@ -230,13 +427,48 @@ STATIC void emit_write_bytecode_byte_child(emit_t *emit, int stack_adj, byte b,
 STATIC void emit_write_bytecode_byte_label(emit_t *emit, int stack_adj, byte b1, mp_uint_t label) {
     mp_emit_bc_adjust_stack_size(emit, stack_adj);
 
+    #if MICROPY_COMP_PEEPHOLE
+    // Jumps are numbered the same way in every pass, including dead ones.
+    ++emit->peep_n_jumps;
+    #endif
+
     if (emit->suppress) {
         return;
     }
 
+    #if MICROPY_COMP_PEEPHOLE
+    if (emit->peep && emit->pass == MP_PASS_STACK_SIZE) {
+        emit_peep_record(emit, b1, label);
+        emit->peep_labels[label].used = true;
+    } else if (emit->peep && emit->pass > MP_PASS_STACK_SIZE) {
+        if ((b1 == MP_BC_POP_JUMP_IF_TRUE || b1 == MP_BC_POP_JUMP_IF_FALSE)
+            && emit->peep_labels[label].cond_over_jump == emit->peep_n_jumps) {
+            // This jumps over the unconditional jump that comes next, so
+            // instead make that jump conditional, on the opposite condition.
+            emit->peep_cond_pending = b1 ^ MP_BC_POP_JUMP_IF_TRUE ^ MP_BC_POP_JUMP_IF_FALSE;
+            return;
+        }
+        if (emit->peep_cond_pending != 0) {
+            assert(b1 == MP_BC_JUMP);
+            b1 = emit->peep_cond_pending;
+            emit->peep_cond_pending = 0;
+        }
+        if (b1 <= MP_BC_POP_JUMP_IF_FALSE) {
+            // A jump to a jump can go straight to the final destination.  This
+            // is only done for jumps that can go backwards, because the final
+            // destination may be behind this jump.
+            label = emit_peep_jump_target(emit, label);
+        }
+    }
+    #endif
+
     // Determine if the jump offset is signed or unsigned, based on the opcode.
     const bool is_signed = b1 <= MP_BC_POP_JUMP_IF_FALSE;
 
+    if (emit->pass == MP_PASS_STACK_SIZE) {
+        emit_bc_record_jump(emit, label, is_signed);
+    }
+
     // Default to a 2-byte encoding (the largest) with an unknown jump offset.
     unsigned int jump_encoding_size = 1;
     ssize_t bytecode_offset = 0;
@@ -247,8 +479,7 @@ STATIC void emit_write_bytecode_byte_label(emit_t *emit, int stack_adj, byte b1,
         bytecode_offset = emit->label_offsets[label] - emit->bytecode_offset - 2;
 
         // Check if the bytecode_offset is small enough to use a 1-byte encoding.
-        if ((is_signed && -64 <= bytecode_offset && bytecode_offset <= 63)
-            || (!is_signed && (size_t)bytecode_offset <= 127)) {
+        if (emit_bc_jump_is_short(is_signed, bytecode_offset)) {
             // Use a 1-byte jump offset.
             jump_encoding_size = 0;
         }
@@ -280,41 +511,58 @@ STATIC void emit_write_bytecode_byte_label(emit_t *emit, int stack_adj, byte b1,
     }
 }
 
+// Write local state size, exception stack size, scope flags, number of arguments,
+// number of cells and size of the source code info.
+STATIC void emit_write_code_info_prelude(emit_t *emit, scope_t *scope) {
+    mp_uint_t n_state = scope->num_locals + scope->stack_size;
+    if (n_state == 0) {
+        // Need at least 1 entry in the state, in the case an exception is
+        // propagated through this function, the exception is returned in
+        // the highest slot in the state (fastn[0], see vm.c).
+        n_state = 1;
+    }
+    #if MICROPY_DEBUG_VM_STACK_OVERFLOW
+    // An extra slot in the stack is needed to detect VM stack overflow
+    n_state += 1;
+    #endif
+
+    size_t n_exc_stack = scope->exc_stack_size;
+    MP_BC_PRELUDE_SIG_ENCODE(n_state, n_exc_stack, scope, emit_write_code_info_byte, emit);
+
+    size_t n_info = emit->n_info;
+    size_t n_cell = emit->n_cell;
+    MP_BC_PRELUDE_SIZE_ENCODE(n_info, n_cell, emit_write_code_info_byte, emit);
+}
+
 void mp_emit_bc_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     emit->pass = pass;
     emit->stack_size = 0;
     emit->suppress = false;
     emit->scope = scope;
+    #if MICROPY_COMP_PEEPHOLE
+    emit->peep = MP_STATE_VM(mp_optimise_value) >= 1;
+    emit->peep_cond_pending = 0;
+    emit->peep_n_jumps = 0;
+    if (pass == MP_PASS_STACK_SIZE) {
+        emit->peep_n_pending = 0;
+        emit->peep_pending_none = false;
+        emit->peep_cond_jump = 0;
+        emit->peep_cond_over_jump = 0;
+        memset(emit->peep_labels, 0, emit->max_num_labels * sizeof(peep_label_t));
+    }
+    #endif
     emit->last_source_line_offset = 0;
     emit->last_source_line = 1;
     emit->bytecode_offset = 0;
     emit->code_info_offset = 0;
     emit->overflow = false;
-
-    // Write local state size, exception stack size, scope flags and number of arguments
-    {
-        mp_uint_t n_state = scope->num_locals + scope->stack_size;
-        if (n_state == 0) {
-            // Need at least 1 entry in the state, in the case an exception is
-            // propagated through this function, the exception is returned in
-            // the highest slot in the state (fastn[0], see vm.c).
-            n_state = 1;
-        }
-        #if MICROPY_DEBUG_VM_STACK_OVERFLOW
-        // An extra slot in the stack is needed to detect VM stack overflow
-        n_state += 1;
-        #endif
-
-        size_t n_exc_stack = scope->exc_stack_size;
-        MP_BC_PRELUDE_SIG_ENCODE(n_state, n_exc_stack, scope, emit_write_code_info_byte, emit);
+    if (pass == MP_PASS_STACK_SIZE) {
+        emit->jumps_len = 0;
     }
 
-    // Write number of cells and size of the source code info
-    if (emit->pass >= MP_PASS_CODE_SIZE) {
-        size_t n_info = emit->n_info;
-        size_t n_cell = emit->n_cell;
-        MP_BC_PRELUDE_SIZE_ENCODE(n_info, n_cell, emit_write_code_info_byte, emit);
-    }
+    // The sizes in the prelude are only correct once the MP_PASS_STACK_SIZE
+    // pass is done, before that this just reserves space for them.
+    emit_write_code_info_prelude(emit, scope);
 
     emit->n_info = emit->code_info_offset;
 
@@ -369,10 +617,22 @@ bool mp_emit_bc_end_pass(emit_t *emit) {
         }
     }
 
-    if (emit->pass == MP_PASS_CODE_SIZE) {
-        // calculate size of total code-info + bytecode, in bytes
-        emit->code_info_size = emit->code_info_offset;
+    if (emit->pass == MP_PASS_STACK_SIZE) {
+        // The stack size is now known, and the code size can be worked out
+        // from this pass without another one: shorten the jumps that can be
+        // shortened, and redo the prelude with the final sizes.
         emit->bytecode_size = emit->bytecode_offset;
+        #if MICROPY_COMP_PEEPHOLE
+        // The peephole optimiser changes the code in later passes, so leave
+        // it to MP_PASS_EMIT to find the final jumps.
+        if (!emit->peep)
+        #endif
+        {
+            emit->bytecode_size -= emit_bc_relax_jumps(emit);
+        }
+        emit->code_info_offset = 0;
+        emit_write_code_info_prelude(emit, emit->scope);
+        emit->code_info_size = emit->code_info_offset + emit->n_info + emit->n_cell;
         emit->code_base = m_new0(byte, emit->code_info_size + emit->bytecode_size);
 
     } else if (emit->pass == MP_PASS_EMIT) {
@@ -440,8 +700,26 @@ void mp_emit_bc_set_source_line(emit_t *emit, mp_uint_t source_line) {
 
 void mp_emit_bc_label_assign(emit_t *emit, mp_uint_t l) {
     // Assigning a label ends any dead-code region, and all following opcodes
-    // should be emitted (until another unconditional flow control).
-    emit->suppress = false;
+    // should be emitted (until another unconditional flow control).  But if
+    // nothing jumps to the label then the region continues.
+    #if MICROPY_COMP_PEEPHOLE
+    if (emit->peep && emit->pass == MP_PASS_STACK_SIZE) {
+        if (emit->peep_pending_none) {
+            // The code at the labels already pending isn't "return None".
+            emit_peep_set_pending(emit, PEEP_LABEL_OTHER, 0);
+        }
+        if (emit->peep_n_pending < MP_ARRAY_SIZE(emit->peep_pending)) {
+            emit->peep_pending[emit->peep_n_pending++] = l;
+        }
+        if (emit->peep_cond_over_jump != 0 && emit->peep_cond_label == l) {
+            emit->peep_labels[l].cond_over_jump = emit->peep_cond_over_jump;
+        }
+    }
+    if (!(emit->peep && emit->pass > MP_PASS_STACK_SIZE && !emit->peep_labels[l].used))
+    #endif
+    {
+        emit->suppress = false;
+    }
 
     mp_emit_bc_adjust_stack_size(emit, 0);
     if (emit->pass == MP_PASS_SCOPE) {
@@ -605,6 +883,21 @@ void mp_emit_bc_rot_three(emit_t *emit) {
 }
 
 void mp_emit_bc_jump(emit_t *emit, mp_uint_t label) {
+    #if MICROPY_COMP_PEEPHOLE
+    if (emit->peep && emit->pass > MP_PASS_STACK_SIZE && emit->peep_cond_pending == 0
+        && emit->peep_labels[emit_peep_jump_target(emit, label)].kind == PEEP_LABEL_RETURN_NONE) {
+        // A jump to "return None" is replaced by "return None", which is no
+        // bigger.  The stack already has room for the None, because the code
+        // at the label pushes it with the stack at the same depth as here.
+        // This is still counted as a jump, to keep the numbering of later
+        // jumps the same as in the MP_PASS_STACK_SIZE pass.
+        ++emit->peep_n_jumps;
+        emit_write_bytecode_byte(emit, 0, MP_BC_LOAD_CONST_NONE);
+        emit_write_bytecode_byte(emit, 0, MP_BC_RETURN_VALUE);
+        emit->suppress = true;
+        return;
+    }
+    #endif
     emit_write_bytecode_byte_label(emit, 0, MP_BC_JUMP, label);
     emit->suppress = true;
 }
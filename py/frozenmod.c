@@ -61,24 +61,21 @@ extern const mp_frozen_module_t *const mp_frozen_mpy_content[];
 
 #endif // MICROPY_MODULE_FROZEN_MPY
 
-// Search for "str" as a frozen entry, returning the stat result
-// (no-exist/file/dir), as well as the type (none/str/mpy) and data.
-// frozen_type can be NULL if its value isn't needed (and then data is assumed to be NULL).
-mp_import_stat_t mp_find_frozen_module(const char *str, int *frozen_type, void **data) {
-    size_t len = strlen(str);
-    const char *name = mp_frozen_names;
-
-    if (frozen_type != NULL) {
-        *frozen_type = MP_FROZEN_NONE;
-    }
-
-    // Count the number of str lengths we have to find how many str entries.
+// Return the number of string-type entries in mp_frozen_names.
+STATIC size_t frozen_num_str(void) {
     size_t num_str = 0;
     #if MICROPY_MODULE_FROZEN_STR && MICROPY_MODULE_FROZEN_MPY
     for (const uint32_t *s = mp_frozen_str_sizes; *s != 0; ++s) {
         ++num_str;
     }
     #endif
+    return num_str;
+}
+
+// Search for "str" (of length "len") in mp_frozen_names, returning the stat
+// result (no-exist/file/dir) and, for a file, the index of its entry.
+STATIC mp_import_stat_t find_frozen_entry(const char *str, size_t len, size_t *index) {
+    const char *name = mp_frozen_names;
 
     for (size_t i = 0; *name != 0; i++) {
         size_t entry_len = strlen(name);
@@ -86,38 +83,7 @@ mp_import_stat_t mp_find_frozen_module(const char *str, int *frozen_type, void *
             // Query is a prefix of the current entry.
             if (entry_len == len) {
                 // Exact match --> file.
-
-                if (frozen_type != NULL) {
-                    #if MICROPY_MODULE_FROZEN_STR
-                    if (i < num_str) {
-                        *frozen_type = MP_FROZEN_STR;
-                        // Use the size table to figure out where this index starts.
-                        size_t offset = 0;
-                        for (size_t j = 0; j < i; ++j) {
-                            offset += mp_frozen_str_sizes[j] + 1;
-                        }
-                        size_t content_len = mp_frozen_str_sizes[i];
-                        const char *content = &mp_frozen_str_content[offset];
-
-                        // Note: str & len have been updated by find_frozen_entry to strip
-                        // the ".frozen/" prefix (to avoid this being a distinct qstr to
-                        // the original path QSTR in frozen_content.c).
-                        qstr source = qstr_from_strn(str, len);
-                        mp_lexer_t *lex = MICROPY_MODULE_FROZEN_LEXER(source, content, content_len, 0);
-                        *data = lex;
-                    }
-                    #endif
-
-                    #if MICROPY_MODULE_FROZEN_MPY
-                    if (i >= num_str) {
-                        *frozen_type = MP_FROZEN_MPY;
-                        // Load the corresponding index as a raw_code, taking
-                        // into account any string entries to offset by.
-                        *data = (void *)mp_frozen_mpy_content[i - num_str];
-                    }
-                    #endif
-                }
-
+                *index = i;
                 return MP_IMPORT_STAT_FILE;
             } else if (name[len] == '/') {
                 // Matches up to directory separator, this is a valid
@@ -132,4 +98,71 @@ mp_import_stat_t mp_find_frozen_module(const char *str, int *frozen_type, void *
     return MP_IMPORT_STAT_NO_EXIST;
 }
 
+// Search for "str" as a frozen entry, returning the stat result
+// (no-exist/file/dir), as well as the type (none/str/mpy) and data.
+// frozen_type can be NULL if its value isn't needed (and then data is assumed to be NULL).
+mp_import_stat_t mp_find_frozen_module(const char *str, int *frozen_type, void **data) {
+    size_t len = strlen(str);
+
+    if (frozen_type != NULL) {
+        *frozen_type = MP_FROZEN_NONE;
+    }
+
+    size_t i = 0;
+    mp_import_stat_t stat = find_frozen_entry(str, len, &i);
+    if (stat != MP_IMPORT_STAT_FILE || frozen_type == NULL) {
+        return stat;
+    }
+
+    // Count the number of str lengths we have to find how many str entries.
+    size_t num_str = frozen_num_str();
+
+    #if MICROPY_MODULE_FROZEN_STR
+    if (i < num_str) {
+        *frozen_type = MP_FROZEN_STR;
+        // Use the size table to figure out where this index starts.
+        size_t offset = 0;
+        for (size_t j = 0; j < i; ++j) {
+            offset += mp_frozen_str_sizes[j] + 1;
+        }
+        size_t content_len = mp_frozen_str_sizes[i];
+        const char *content = &mp_frozen_str_content[offset];
+
+        // Note: str & len have been updated by find_frozen_entry to strip
+        // the ".frozen/" prefix (to avoid this being a distinct qstr to
+        // the original path QSTR in frozen_content.c).
+        qstr source = qstr_from_strn(str, len);
+        mp_lexer_t *lex = MICROPY_MODULE_FROZEN_LEXER(source, content, content_len, 0);
+        *data = lex;
+    }
+    #endif
+
+    #if MICROPY_MODULE_FROZEN_MPY
+    if (i >= num_str) {
+        *frozen_type = MP_FROZEN_MPY;
+        // Load the corresponding index as a raw_code, taking
+        // into account any string entries to offset by.
+        *data = (void *)mp_frozen_mpy_content[i - num_str];
+    }
+    #endif
+
+    return MP_IMPORT_STAT_FILE;
+}
+
+#if MICROPY_MODULE_FROZEN_ROM_GLOBALS
+// Search for "str" as a frozen mpy entry, returning its module if mpy-tool
+// pre-evaluated its globals into ROM, or NULL otherwise.
+const mp_module_context_t *mp_find_frozen_rom_module(const char *str) {
+    size_t i = 0;
+    if (find_frozen_entry(str, strlen(str), &i) != MP_IMPORT_STAT_FILE) {
+        return NULL;
+    }
+    size_t num_str = frozen_num_str();
+    if (i < num_str) {
+        return NULL;
+    }
+    return mp_frozen_mpy_content[i - num_str]->context;
+}
+#endif
+
 #endif // MICROPY_MODULE_FROZEN
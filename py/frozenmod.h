@@ -27,6 +27,7 @@
 #ifndef MICROPY_INCLUDED_PY_FROZENMOD_H
 #define MICROPY_INCLUDED_PY_FROZENMOD_H
 
+#include "py/bc.h"
 #include "py/builtin.h"
 
 enum {
@@ -37,4 +38,8 @@ enum {
 
 mp_import_stat_t mp_find_frozen_module(const char *str, int *frozen_type, void **data);
 
+#if MICROPY_MODULE_FROZEN_ROM_GLOBALS
+const mp_module_context_t *mp_find_frozen_rom_module(const char *str);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_FROZENMOD_H
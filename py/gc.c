@@ -31,6 +31,7 @@
 
 #include "py/gc.h"
 #include "py/runtime.h"
+#include "py/bc.h"
 
 #if MICROPY_DEBUG_VALGRIND
 #include <valgrind/memcheck.h>
@@ -84,11 +85,47 @@
 #define NEXT_AREA(area) (NULL)
 #endif
 
+#if MICROPY_GC_THREAD_REGION
+#if !MICROPY_PY_THREAD || MICROPY_PY_THREAD_GIL || MICROPY_GC_SPLIT_HEAP
+#error "MICROPY_GC_THREAD_REGION requires threads without the GIL, and no split heap"
+#endif
+// Threads update the ATB of their own region without holding the GC mutex (see
+// gc_region_alloc), so other updates that can happen outside of a collection
+// must not clobber neighbouring blocks in the same ATB byte.  Updates made
+// during a collection (marking and sweeping) don't need to be atomic.
+#define ATB_AND(ptr, mask) __atomic_fetch_and((ptr), (mask), __ATOMIC_RELAXED)
+#define ATB_OR(ptr, mask) __atomic_fetch_or((ptr), (mask), __ATOMIC_RELAXED)
+#define ATB_XOR(ptr, mask) __atomic_fetch_xor((ptr), (mask), __ATOMIC_RELAXED)
+#else
+#define ATB_AND(ptr, mask) (*(ptr) &= (mask))
+#define ATB_OR(ptr, mask) (*(ptr) |= (mask))
+#define ATB_XOR(ptr, mask) (*(ptr) ^= (mask))
+#endif
+
+#if MICROPY_GC_ARENA
+#if MICROPY_GC_SPLIT_HEAP || (MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL && !MICROPY_GC_THREAD_REGION)
+#error "MICROPY_GC_ARENA requires no split heap, and MICROPY_GC_THREAD_REGION without the GIL"
+#endif
+#if MICROPY_PY_THREAD
+#define GC_THREAD_STATE() mp_thread_get_state()
+#else
+#define GC_THREAD_STATE() (&mp_state_ctx.thread)
+#endif
+#define GC_ARENA_COLLECTING() (MP_STATE_THREAD(gc_arena_collecting))
+// Blocks freed in this thread's arena region are left for the arena to reuse,
+// rather than pulling back where gc_alloc starts searching for free blocks.
+#define GC_IN_ARENA(ptr) ((uintptr_t)(ptr) - (uintptr_t)GC_THREAD_STATE()->gc_arena_start < MICROPY_GC_ARENA_BLOCKS * BYTES_PER_BLOCK)
+#else
+#define GC_ARENA_COLLECTING() (false)
+#define GC_IN_ARENA(ptr) (false)
+#endif
+
 #define BLOCK_SHIFT(block) (2 * ((block) & (BLOCKS_PER_ATB - 1)))
 #define ATB_GET_KIND(area, block) (((area)->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] >> BLOCK_SHIFT(block)) & 3)
-#define ATB_ANY_TO_FREE(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] &= (~(AT_MARK << BLOCK_SHIFT(block))); } while (0)
-#define ATB_FREE_TO_HEAD(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_HEAD << BLOCK_SHIFT(block)); } while (0)
-#define ATB_FREE_TO_TAIL(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_TAIL << BLOCK_SHIFT(block)); } while (0)
+#define ATB_ANY_TO_FREE(area, block) do { ATB_AND(&area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB], ~(AT_MARK << BLOCK_SHIFT(block))); } while (0)
+#define ATB_FREE_TO_HEAD(area, block) do { ATB_OR(&area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB], AT_HEAD << BLOCK_SHIFT(block)); } while (0)
+#define ATB_FREE_TO_TAIL(area, block) do { ATB_OR(&area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB], AT_TAIL << BLOCK_SHIFT(block)); } while (0)
+#define ATB_SWEEP_TO_FREE(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] &= (~(AT_MARK << BLOCK_SHIFT(block))); } while (0)
 #define ATB_HEAD_TO_MARK(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] |= (AT_MARK << BLOCK_SHIFT(block)); } while (0)
 #define ATB_MARK_TO_HEAD(area, block) do { area->gc_alloc_table_start[(block) / BLOCKS_PER_ATB] &= (~(AT_TAIL << BLOCK_SHIFT(block))); } while (0)
 
@@ -120,6 +157,43 @@
 #define GC_EXIT()
 #endif
 
+// Start searches for free blocks from the beginning of the area.
+STATIC void gc_reset_free_atb_index(mp_state_mem_area_t *area) {
+    area->gc_last_free_atb_index = 0;
+    #if MICROPY_GC_SIZE_CLASSES > 1
+    memset(area->gc_last_free_atb_index_sized, 0, sizeof(area->gc_last_free_atb_index_sized));
+    #endif
+}
+
+// Where to start searching for a run of n_blocks free blocks.
+static inline size_t gc_get_free_atb_index(mp_state_mem_area_t *area, size_t n_blocks) {
+    #if MICROPY_GC_SIZE_CLASSES > 1
+    if (n_blocks >= 2 && n_blocks <= MICROPY_GC_SIZE_CLASSES) {
+        return MAX(area->gc_last_free_atb_index, area->gc_last_free_atb_index_sized[n_blocks - 2]);
+    }
+    #else
+    (void)n_blocks;
+    #endif
+    return area->gc_last_free_atb_index;
+}
+
+// Blocks have been freed from the given block onwards, which may have made a
+// run of free blocks that starts there, or just before it if it joins onto
+// free blocks that were already there.
+STATIC void gc_lower_free_atb_index(mp_state_mem_area_t *area, size_t block) {
+    if (block / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
+        area->gc_last_free_atb_index = block / BLOCKS_PER_ATB;
+    }
+    #if MICROPY_GC_SIZE_CLASSES > 1
+    for (size_t n = 2; n <= MICROPY_GC_SIZE_CLASSES; n++) {
+        size_t i = (block < n - 1 ? 0 : block - (n - 1)) / BLOCKS_PER_ATB;
+        if (i < area->gc_last_free_atb_index_sized[n - 2]) {
+            area->gc_last_free_atb_index_sized[n - 2] = i;
+        }
+    }
+    #endif
+}
+
 // TODO waste less memory; currently requires that all entries in alloc_table have a corresponding block in pool
 STATIC void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     // calculate parameters for GC (T=total, A=alloc table, F=finaliser table, P=pool; all in bytes):
@@ -163,7 +237,7 @@ STATIC void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     memset(area->gc_alloc_table_start, 0, area->gc_alloc_table_byte_len + ALLOC_TABLE_GAP_BYTE);
     #endif
 
-    area->gc_last_free_atb_index = 0;
+    gc_reset_free_atb_index(area);
     area->gc_last_used_block = 0;
 
     #if MICROPY_GC_SPLIT_HEAP
@@ -213,6 +287,38 @@ void gc_init(void *start, void *end) {
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     mp_thread_mutex_init(&MP_STATE_MEM(gc_mutex));
     #endif
+
+    #if MICROPY_GC_THREAD_REGION
+    MP_STATE_MEM(gc_region_threads) = NULL;
+    MP_STATE_MEM(gc_region_atb_index) = 0;
+    MP_STATE_MEM(gc_region_collecting) = 0;
+    #endif
+
+    #if MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+    MP_STATE_MEM(gc_alloc_profile_countdown) = 0;
+    MP_STATE_MEM(gc_alloc_profile_period) = 0;
+    MP_STATE_MEM(gc_alloc_profile_last) = NULL;
+    MP_STATE_MEM(gc_alloc_profile_n_sites) = 0;
+    MP_STATE_VM(gc_alloc_profile_sites) = NULL;
+    #endif
+
+    #if MICROPY_GC_ARENA
+    MP_STATE_MEM(gc_trace_start) = MP_STATE_MEM(area).gc_pool_start;
+    MP_STATE_MEM(gc_trace_end) = MP_STATE_MEM(area).gc_pool_end;
+    MP_STATE_MEM(gc_arena_no_room) = false;
+    MP_STATE_THREAD(gc_arena_start) = NULL;
+    MP_STATE_THREAD(gc_arena_cur) = NULL;
+    MP_STATE_THREAD(gc_arena_depth) = 0;
+    MP_STATE_THREAD(gc_arena_collecting) = false;
+    #if MICROPY_GC_THREAD_REGION
+    // This thread's arena is carved up without the GC mutex, so collections
+    // started by other threads must be able to wait for it.
+    MP_STATE_THREAD(gc_region_busy) = 0;
+    MP_STATE_THREAD(gc_region_enabled) = false;
+    MP_STATE_THREAD(gc_region_next) = NULL;
+    MP_STATE_MEM(gc_region_threads) = GC_THREAD_STATE();
+    #endif
+    #endif
 }
 
 #if MICROPY_GC_SPLIT_HEAP
@@ -370,6 +476,17 @@ STATIC inline mp_state_mem_area_t *gc_get_ptr_area(const void *ptr) {
     && ptr < (void *)MP_STATE_MEM(area).gc_pool_end         /* must be below end of pool */ \
     )
 
+#if MICROPY_GC_ARENA
+// While an arena is being collected, only pointers into it are followed.
+#define VERIFY_MARK_PTR(ptr) ( \
+    ((uintptr_t)(ptr) & (BYTES_PER_BLOCK - 1)) == 0          /* must be aligned on a block */ \
+    && ptr >= (void *)MP_STATE_MEM(gc_trace_start)          /* must be above start of traced blocks */ \
+    && ptr < (void *)MP_STATE_MEM(gc_trace_end)             /* must be below end of traced blocks */ \
+    )
+#else
+#define VERIFY_MARK_PTR(ptr) VERIFY_PTR(ptr)
+#endif
+
 #ifndef TRACE_MARK
 #if DEBUG_PRINT
 #define TRACE_MARK(block, ptr) DEBUG_printf("gc_mark(%p)\n", ptr)
@@ -418,7 +535,7 @@ STATIC void gc_mark_subtree(size_t block)
                 continue;
             }
             #else
-            if (!VERIFY_PTR(ptr)) {
+            if (!VERIFY_MARK_PTR(ptr)) {
                 continue;
             }
             mp_state_mem_area_t *ptr_area = area;
@@ -477,12 +594,73 @@ STATIC void gc_deal_with_stack_overflow(void) {
     }
 }
 
+// Free the unmarked heads in blocks [block, end_block) and their tails, and
+// unmark the marked heads.  Returns the last block still in use.
+STATIC size_t gc_sweep_blocks(mp_state_mem_area_t *area, size_t block, size_t end_block) {
+    int free_tail = 0;
+    size_t last_used_block = 0;
+
+    for (; block < end_block; block++) {
+        MICROPY_GC_HOOK_LOOP(block);
+        switch (ATB_GET_KIND(area, block)) {
+            case AT_HEAD:
+                #if MICROPY_ENABLE_FINALISER
+                if (FTB_GET(area, block)) {
+                    mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(area, block);
+                    if (obj->type != NULL) {
+                        // if the object has a type then see if it has a __del__ method
+                        mp_obj_t dest[2];
+                        mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
+                        if (dest[0] != MP_OBJ_NULL) {
+                            // load_method returned a method, execute it in a protected environment
+                            #if MICROPY_ENABLE_SCHEDULER
+                            mp_sched_lock();
+                            #endif
+                            mp_call_function_1_protected(dest[0], dest[1]);
+                            #if MICROPY_ENABLE_SCHEDULER
+                            mp_sched_unlock();
+                            #endif
+                        }
+                    }
+                    // clear finaliser flag
+                    FTB_CLEAR(area, block);
+                }
+                #endif
+                free_tail = 1;
+                DEBUG_printf("gc_sweep(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
+                #if MICROPY_PY_GC_COLLECT_RETVAL
+                MP_STATE_MEM(gc_collected)++;
+                #endif
+                // fall through to free the head
+                MP_FALLTHROUGH
+
+            case AT_TAIL:
+                if (free_tail) {
+                    ATB_SWEEP_TO_FREE(area, block);
+                    #if CLEAR_ON_SWEEP
+                    memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
+                    #endif
+                } else {
+                    last_used_block = block;
+                }
+                break;
+
+            case AT_MARK:
+                ATB_MARK_TO_HEAD(area, block);
+                free_tail = 0;
+                last_used_block = block;
+                break;
+        }
+    }
+
+    return last_used_block;
+}
+
 STATIC void gc_sweep(void) {
     #if MICROPY_PY_GC_COLLECT_RETVAL
     MP_STATE_MEM(gc_collected) = 0;
     #endif
     // free unmarked heads and their tails
-    int free_tail = 0;
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     mp_state_mem_area_t *prev_area = NULL;
     #endif
@@ -492,60 +670,7 @@ STATIC void gc_sweep(void) {
             end_block = area->gc_last_used_block + 1;
         }
 
-        size_t last_used_block = 0;
-
-        for (size_t block = 0; block < end_block; block++) {
-            MICROPY_GC_HOOK_LOOP(block);
-            switch (ATB_GET_KIND(area, block)) {
-                case AT_HEAD:
-                    #if MICROPY_ENABLE_FINALISER
-                    if (FTB_GET(area, block)) {
-                        mp_obj_base_t *obj = (mp_obj_base_t *)PTR_FROM_BLOCK(area, block);
-                        if (obj->type != NULL) {
-                            // if the object has a type then see if it has a __del__ method
-                            mp_obj_t dest[2];
-                            mp_load_method_maybe(MP_OBJ_FROM_PTR(obj), MP_QSTR___del__, dest);
-                            if (dest[0] != MP_OBJ_NULL) {
-                                // load_method returned a method, execute it in a protected environment
-                                #if MICROPY_ENABLE_SCHEDULER
-                                mp_sched_lock();
-                                #endif
-                                mp_call_function_1_protected(dest[0], dest[1]);
-                                #if MICROPY_ENABLE_SCHEDULER
-                                mp_sched_unlock();
-                                #endif
-                            }
-                        }
-                        // clear finaliser flag
-                        FTB_CLEAR(area, block);
-                    }
-                    #endif
-                    free_tail = 1;
-                    DEBUG_printf("gc_sweep(%p)\n", (void *)PTR_FROM_BLOCK(area, block));
-                    #if MICROPY_PY_GC_COLLECT_RETVAL
-                    MP_STATE_MEM(gc_collected)++;
-                    #endif
-                    // fall through to free the head
-                    MP_FALLTHROUGH
-
-                case AT_TAIL:
-                    if (free_tail) {
-                        ATB_ANY_TO_FREE(area, block);
-                        #if CLEAR_ON_SWEEP
-                        memset((void *)PTR_FROM_BLOCK(area, block), 0, BYTES_PER_BLOCK);
-                        #endif
-                    } else {
-                        last_used_block = block;
-                    }
-                    break;
-
-                case AT_MARK:
-                    ATB_MARK_TO_HEAD(area, block);
-                    free_tail = 0;
-                    last_used_block = block;
-                    break;
-            }
-        }
+        size_t last_used_block = gc_sweep_blocks(area, 0, end_block);
 
         area->gc_last_used_block = last_used_block;
 
@@ -565,8 +690,27 @@ STATIC void gc_sweep(void) {
 void gc_collect_start(void) {
     GC_ENTER();
     MP_STATE_THREAD(gc_lock_depth)++;
+    #if MICROPY_GC_THREAD_REGION
+    // Stop other threads carving objects out of their regions while the ATB is
+    // marked and swept, and wait for any that are part way through doing so.
+    __atomic_store_n(&MP_STATE_MEM(gc_region_collecting), 1, __ATOMIC_SEQ_CST);
+    for (mp_state_thread_t *ts = MP_STATE_MEM(gc_region_threads); ts != NULL; ts = ts->gc_region_next) {
+        while (__atomic_load_n(&ts->gc_region_busy, __ATOMIC_SEQ_CST)) {
+            MICROPY_GC_THREAD_REGION_WAIT();
+        }
+    }
+    #endif
+    #if MICROPY_GC_ARENA
+    if (GC_ARENA_COLLECTING()) {
+        // Only trace and sweep this thread's arena region, see gc_arena_collect.
+        MP_STATE_MEM(gc_trace_start) = MP_STATE_THREAD(gc_arena_start);
+        MP_STATE_MEM(gc_trace_end) = MP_STATE_THREAD(gc_arena_end);
+    }
+    #endif
     #if MICROPY_GC_ALLOC_THRESHOLD
-    MP_STATE_MEM(gc_alloc_amount) = 0;
+    if (!GC_ARENA_COLLECTING()) {
+        MP_STATE_MEM(gc_alloc_amount) = 0;
+    }
     #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
 
@@ -613,7 +757,7 @@ void gc_collect_root(void **ptrs, size_t len) {
             continue;
         }
         #else
-        if (!VERIFY_PTR(ptr)) {
+        if (!VERIFY_MARK_PTR(ptr)) {
             continue;
         }
         #endif
@@ -630,15 +774,97 @@ void gc_collect_root(void **ptrs, size_t len) {
     }
 }
 
+#if MICROPY_GC_ARENA
+
+STATIC void gc_arena_reset(mp_state_thread_t *ts);
+
+// Trace from every block in use outside blocks [arena_start, arena_end), as the
+// objects there are all taken to be alive when an arena is collected.  This is
+// a linear scan for pointers into the arena, which is quicker than marking the
+// rest of the heap, and doesn't need to find where each object starts.
+STATIC void gc_arena_trace_heap(mp_state_mem_area_t *area, size_t arena_start, size_t arena_end) {
+    uintptr_t arena_ptr = PTR_FROM_BLOCK(area, arena_start);
+    uintptr_t arena_len = (arena_end - arena_start) * BYTES_PER_BLOCK;
+    size_t end_block = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+    if (area->gc_last_used_block < end_block) {
+        end_block = area->gc_last_used_block + 1;
+    }
+
+    // An object that starts before the region may have grown into a free part
+    // of it, in which case its tail is scanned too.
+    for (size_t block = arena_start; ATB_GET_KIND(area, block) == AT_TAIL; block++) {
+        gc_collect_root((void **)PTR_FROM_BLOCK(area, block), BYTES_PER_BLOCK / sizeof(void *));
+    }
+
+    for (size_t i = 0; i < (end_block + BLOCKS_PER_ATB - 1) / BLOCKS_PER_ATB; i++) {
+        MICROPY_GC_HOOK_LOOP(i);
+        if (i == arena_start / BLOCKS_PER_ATB) {
+            i = arena_end / BLOCKS_PER_ATB - 1;
+            continue;
+        }
+        byte a = area->gc_alloc_table_start[i];
+        if (a == 0) {
+            continue;
+        }
+        void **ptrs = (void **)PTR_FROM_BLOCK(area, i * BLOCKS_PER_ATB);
+        for (size_t j = 0; j < BLOCKS_PER_ATB; j++, a >>= 2) {
+            if ((a & 3) == AT_FREE) {
+                ptrs += BYTES_PER_BLOCK / sizeof(void *);
+                continue;
+            }
+            for (size_t k = 0; k < BYTES_PER_BLOCK / sizeof(void *); k++, ptrs++) {
+                if ((uintptr_t)*ptrs - arena_ptr < arena_len) {
+                    gc_collect_root(ptrs, 1);
+                }
+            }
+        }
+    }
+}
+
+#endif
+
 void gc_collect_end(void) {
-    gc_deal_with_stack_overflow();
-    gc_sweep();
-    #if MICROPY_GC_SPLIT_HEAP
-    MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+    #if MICROPY_GC_ARENA
+    if (GC_ARENA_COLLECTING()) {
+        mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+        size_t start_block = BLOCK_FROM_PTR(area, MP_STATE_MEM(gc_trace_start));
+        size_t end_block = BLOCK_FROM_PTR(area, MP_STATE_MEM(gc_trace_end));
+        gc_arena_trace_heap(area, start_block, end_block);
+        gc_deal_with_stack_overflow();
+        // Sweep the region, including the tail of any object that runs past it.
+        while (ATB_GET_KIND(area, end_block) == AT_TAIL) {
+            end_block += 1;
+        }
+        #if MICROPY_PY_GC_COLLECT_RETVAL
+        MP_STATE_MEM(gc_collected) = 0;
+        #endif
+        gc_sweep_blocks(area, start_block, end_block);
+        // The blocks freed in the region are left for the arena, so searches
+        // for free blocks elsewhere carry on from where they were.
+        gc_arena_reset(GC_THREAD_STATE());
+        MP_STATE_MEM(gc_trace_start) = area->gc_pool_start;
+        MP_STATE_MEM(gc_trace_end) = area->gc_pool_end;
+    } else
     #endif
-    for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
-        area->gc_last_free_atb_index = 0;
+    {
+        gc_deal_with_stack_overflow();
+        gc_sweep();
+        #if MICROPY_GC_SPLIT_HEAP
+        MP_STATE_MEM(gc_last_free_area) = &MP_STATE_MEM(area);
+        #endif
+        for (mp_state_mem_area_t *area = &MP_STATE_MEM(area); area != NULL; area = NEXT_AREA(area)) {
+            gc_reset_free_atb_index(area);
+        }
+        #if MICROPY_GC_THREAD_REGION
+        __atomic_store_n(&MP_STATE_MEM(gc_region_atb_index), 0, __ATOMIC_RELAXED);
+        #endif
+        #if MICROPY_GC_ARENA
+        MP_STATE_MEM(gc_arena_no_room) = false;
+        #endif
     }
+    #if MICROPY_GC_THREAD_REGION
+    __atomic_store_n(&MP_STATE_MEM(gc_region_collecting), 0, __ATOMIC_RELEASE);
+    #endif
     MP_STATE_THREAD(gc_lock_depth)--;
     GC_EXIT();
 }
@@ -723,6 +949,436 @@ void gc_info(gc_info_t *info) {
     GC_EXIT();
 }
 
+#if MICROPY_GC_THREAD_REGION || MICROPY_GC_ARENA
+
+// Mark n_atb ATB bytes, starting at atb_index, as a single chain of blocks, and
+// return a pointer to its first block.  The GC lock must be held.
+STATIC byte *gc_mark_run(mp_state_mem_area_t *area, size_t atb_index, size_t n_atb) {
+    byte *atb = &area->gc_alloc_table_start[atb_index];
+    atb[0] = AT_HEAD | AT_TAIL << 2 | AT_TAIL << 4 | AT_TAIL << 6;
+    memset(atb + 1, AT_TAIL | AT_TAIL << 2 | AT_TAIL << 4 | AT_TAIL << 6, n_atb - 1);
+    size_t block = atb_index * BLOCKS_PER_ATB;
+    area->gc_last_used_block = MAX(area->gc_last_used_block, block + n_atb * BLOCKS_PER_ATB - 1);
+    return (byte *)PTR_FROM_BLOCK(area, block);
+}
+
+// Search for n_atb free ATB bytes in a row, starting at ATB byte *index, and
+// mark them as a single chain of blocks.  On return *index is where a later
+// search can carry on from.  The GC lock must be held.
+STATIC byte *gc_reserve_run(mp_state_mem_area_t *area, size_t *index, size_t n_atb) {
+    size_t n_free = 0;
+    for (size_t i = *index; i < area->gc_alloc_table_byte_len; i++) {
+        if (area->gc_alloc_table_start[i] != 0) {
+            n_free = 0;
+        } else if (++n_free == n_atb) {
+            *index = i + 1;
+            #if MICROPY_GC_ALLOC_THRESHOLD
+            MP_STATE_MEM(gc_alloc_amount) += n_atb * BLOCKS_PER_ATB;
+            #endif
+            return gc_mark_run(area, i + 1 - n_atb, n_atb);
+        }
+    }
+    *index = area->gc_alloc_table_byte_len;
+    return NULL;
+}
+
+// Carve n_bytes off the front of the chain of blocks at *cur, which ends at
+// end: the first blocks become the new object, and the block after them is
+// changed from a tail to a head so the rest stays a valid chain.  Returns NULL
+// if a collection has started, in which case the chain must not be touched.
+STATIC void *gc_region_carve(mp_state_thread_t *ts, byte **cur, byte *end, size_t n_bytes) {
+    #if MICROPY_GC_THREAD_REGION
+    // A collection must not see the ATB half updated, so announce that this
+    // thread is busy and back off to the locked path if one has started.
+    __atomic_store_n(&ts->gc_region_busy, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&MP_STATE_MEM(gc_region_collecting), __ATOMIC_SEQ_CST)) {
+        __atomic_store_n(&ts->gc_region_busy, 0, __ATOMIC_RELEASE);
+        return NULL;
+    }
+    #else
+    (void)ts;
+    #endif
+    byte *ptr = *cur;
+    byte *next = ptr + n_bytes;
+    if (next < end) {
+        mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+        size_t block = BLOCK_FROM_PTR(area, next);
+        ATB_XOR(&area->gc_alloc_table_start[block / BLOCKS_PER_ATB], (AT_TAIL ^ AT_HEAD) << BLOCK_SHIFT(block));
+        *cur = next;
+    } else {
+        *cur = NULL;
+    }
+    #if MICROPY_GC_THREAD_REGION
+    __atomic_store_n(&ts->gc_region_busy, 0, __ATOMIC_RELEASE);
+    #endif
+    return ptr;
+}
+
+#endif
+
+#if MICROPY_GC_THREAD_REGION
+
+// Each thread started by the _thread module reserves a run of blocks from the
+// heap, which is marked in the ATB as a single allocation.  Small objects are
+// then carved off the front of this region without taking the GC mutex: the
+// first block of the region becomes the new object, and the block after it is
+// changed from a tail to a head so the rest of the region stays a valid chain.
+// The thread state holds a pointer to the remaining part, which keeps it alive
+// across collections.  Once a thread runs out of space, the unused part of its
+// region is freed and a new region is reserved.
+
+void gc_thread_region_init(void) {
+    mp_state_thread_t *ts = mp_thread_get_state();
+    ts->gc_region_cur = NULL;
+    ts->gc_region_end = NULL;
+    ts->gc_region_busy = 0;
+    GC_ENTER();
+    ts->gc_region_next = MP_STATE_MEM(gc_region_threads);
+    MP_STATE_MEM(gc_region_threads) = ts;
+    GC_EXIT();
+    ts->gc_region_enabled = true;
+}
+
+void gc_thread_region_deinit(void) {
+    mp_state_thread_t *ts = mp_thread_get_state();
+    ts->gc_region_enabled = false;
+    GC_ENTER();
+    mp_state_thread_t **link = &MP_STATE_MEM(gc_region_threads);
+    while (*link != ts) {
+        link = &(*link)->gc_region_next;
+    }
+    *link = ts->gc_region_next;
+    GC_EXIT();
+    void *ptr = ts->gc_region_cur;
+    ts->gc_region_cur = NULL;
+    gc_free(ptr);
+}
+
+// Regions take up whole ATB bytes so the ATB of a region is only shared with
+// the objects carved from it.  They are found by searching for free ATB bytes,
+// carrying on from where the previous search left off until the next
+// collection.  If there is no room, small allocations fall back to the locked
+// path, which is then responsible for triggering a collection.
+STATIC byte *gc_region_reserve(void) {
+    const size_t n_atb = MICROPY_GC_THREAD_REGION_BLOCKS / BLOCKS_PER_ATB;
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+
+    // Once the search has reached the end of the heap there's no need to take
+    // the lock to find that out again.
+    if (__atomic_load_n(&MP_STATE_MEM(gc_region_atb_index), __ATOMIC_RELAXED) >= area->gc_alloc_table_byte_len) {
+        return NULL;
+    }
+
+    GC_ENTER();
+
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    if (MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
+        GC_EXIT();
+        return NULL;
+    }
+    #endif
+
+    size_t i = MAX(MP_STATE_MEM(gc_region_atb_index), area->gc_last_free_atb_index);
+    byte *ptr = gc_reserve_run(area, &i, n_atb);
+    __atomic_store_n(&MP_STATE_MEM(gc_region_atb_index), i, __ATOMIC_RELAXED);
+
+    GC_EXIT();
+
+    return ptr;
+}
+
+STATIC void *gc_region_alloc(mp_state_thread_t *ts, size_t n_blocks) {
+    size_t n_bytes = n_blocks * BYTES_PER_BLOCK;
+    byte *ptr = ts->gc_region_cur;
+    if (ptr == NULL || (size_t)(ts->gc_region_end - ptr) < n_bytes) {
+        // Return what's left of the current region and reserve a new one.
+        if (ptr != NULL) {
+            ts->gc_region_cur = NULL;
+            gc_free(ptr);
+        }
+        ptr = gc_region_reserve();
+        if (ptr == NULL) {
+            return NULL;
+        }
+        memset(ptr, 0, MICROPY_GC_THREAD_REGION_BLOCKS * BYTES_PER_BLOCK);
+        ts->gc_region_end = ptr + MICROPY_GC_THREAD_REGION_BLOCKS * BYTES_PER_BLOCK;
+        ts->gc_region_cur = ptr;
+    }
+
+    return gc_region_carve(ts, &ts->gc_region_cur, ts->gc_region_end, n_bytes);
+}
+
+#endif // MICROPY_GC_THREAD_REGION
+
+#if MICROPY_GC_ARENA
+
+// While a thread is in an arena, which is meant to cover the handling of one
+// short-lived request, say, its small objects are carved off the front of a
+// run of free blocks in its own arena region, as for thread regions, moving on
+// to the next run when one is used up.  Once the whole region is used up, or
+// half of it when the outermost arena is left, the region is collected by
+// itself.  Everything outside it is taken to be alive and is scanned for
+// pointers into the region, along with the usual roots, so objects that
+// escaped the arena (by being stored into an older object, or anywhere else)
+// are kept, and the rest of the region is freed without marking or sweeping
+// the rest of the heap.  There is no write barrier to catch escapes as they
+// happen, because the C code stores heap pointers in too many places for one
+// to be complete.  Objects that escaped stay where they are, and are skipped
+// over by later runs, until the region has so little free space left, or it's
+// so broken up, that a new one is reserved and they are left to full
+// collections.
+
+// Carve objects next from the first run of free ATB bytes in the arena region
+// that starts at or after from, and is long enough for the largest object.
+// The GC lock must be held.
+STATIC void gc_arena_next_run(mp_state_thread_t *ts, byte *from) {
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    size_t i = BLOCK_FROM_PTR(area, from) / BLOCKS_PER_ATB;
+    size_t end = BLOCK_FROM_PTR(area, ts->gc_arena_end) / BLOCKS_PER_ATB;
+    ts->gc_arena_cur = NULL;
+    while (i < end) {
+        if (area->gc_alloc_table_start[i] != 0) {
+            i += 1;
+            continue;
+        }
+        size_t run = i;
+        do {
+            i += 1;
+        } while (i < end && area->gc_alloc_table_start[i] == 0);
+        if ((i - run) * BLOCKS_PER_ATB >= MICROPY_GC_ARENA_MAX_ALLOC) {
+            byte *ptr = gc_mark_run(area, run, i - run);
+            memset(ptr, 0, (i - run) * BLOCKS_PER_ATB * BYTES_PER_BLOCK);
+            ts->gc_arena_cur = ptr;
+            ts->gc_arena_limit = ptr + (i - run) * BLOCKS_PER_ATB * BYTES_PER_BLOCK;
+            break;
+        }
+    }
+}
+
+// Start carving objects from the arena region again, after it's been
+// collected, or from a new region.  The GC lock must be held.
+STATIC void gc_arena_reset(mp_state_thread_t *ts) {
+    const size_t n_atb = MICROPY_GC_ARENA_BLOCKS / BLOCKS_PER_ATB;
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    size_t n_free = 0;
+    if (ts->gc_arena_start != NULL) {
+        const byte *atb = &area->gc_alloc_table_start[BLOCK_FROM_PTR(area, ts->gc_arena_start) / BLOCKS_PER_ATB];
+        for (size_t i = 0; i < n_atb; i++) {
+            n_free += atb[i] == 0;
+        }
+    }
+    if (n_free >= n_atb / 4) {
+        // Enough is free, but it may be in runs too short to carve from.
+        gc_arena_next_run(ts, ts->gc_arena_start);
+    }
+    if (n_free < n_atb / 4 || ts->gc_arena_cur == NULL) {
+        size_t i = 0;
+        byte *ptr = gc_reserve_run(area, &i, n_atb);
+        if (ptr == NULL) {
+            // Don't search for room again until a full collection.
+            MP_STATE_MEM(gc_arena_no_room) = true;
+            ts->gc_arena_start = NULL;
+            ts->gc_arena_cur = NULL;
+            return;
+        }
+        // The new region is free, so make it look that way to gc_arena_next_run.
+        memset(&area->gc_alloc_table_start[BLOCK_FROM_PTR(area, ptr) / BLOCKS_PER_ATB], 0, n_atb);
+        ts->gc_arena_start = ptr;
+        ts->gc_arena_end = ptr + MICROPY_GC_ARENA_BLOCKS * BYTES_PER_BLOCK;
+        n_free = n_atb;
+        gc_arena_next_run(ts, ts->gc_arena_start);
+    }
+    ts->gc_arena_avail = n_free * BLOCKS_PER_ATB * BYTES_PER_BLOCK;
+    ts->gc_arena_used = 0;
+}
+
+STATIC void gc_arena_collect(mp_state_thread_t *ts) {
+    // Drop the unused part of the run so it's freed along with the garbage.
+    ts->gc_arena_cur = NULL;
+    ts->gc_arena_collecting = true;
+    gc_collect();
+    ts->gc_arena_collecting = false;
+}
+
+STATIC void *gc_arena_alloc(mp_state_thread_t *ts, size_t n_blocks) {
+    size_t n_bytes = n_blocks * BYTES_PER_BLOCK;
+    if (ts->gc_arena_cur == NULL || (size_t)(ts->gc_arena_limit - ts->gc_arena_cur) < n_bytes) {
+        if (ts->gc_arena_start == NULL) {
+            return NULL;
+        }
+        if (ts->gc_arena_cur != NULL) {
+            // Move on to the next run, leaving the rest of this one to be
+            // freed when the region is collected.
+            GC_ENTER();
+            gc_arena_next_run(ts, ts->gc_arena_limit);
+            GC_EXIT();
+        }
+        if (ts->gc_arena_cur == NULL) {
+            if (!MP_STATE_MEM(gc_auto_collect_enabled)) {
+                return NULL;
+            }
+            gc_arena_collect(ts);
+            if (ts->gc_arena_cur == NULL) {
+                return NULL;
+            }
+        }
+    }
+    ts->gc_arena_used += n_bytes;
+    return gc_region_carve(ts, &ts->gc_arena_cur, ts->gc_arena_limit, n_bytes);
+}
+
+void gc_arena_push(void) {
+    mp_state_thread_t *ts = GC_THREAD_STATE();
+    if (ts->gc_arena_depth++ == 0 && ts->gc_arena_start == NULL && ts->gc_lock_depth == 0) {
+        GC_ENTER();
+        if (!MP_STATE_MEM(gc_arena_no_room)) {
+            gc_arena_reset(ts);
+        }
+        GC_EXIT();
+    }
+}
+
+void gc_arena_pop(void) {
+    mp_state_thread_t *ts = GC_THREAD_STATE();
+    assert(ts->gc_arena_depth > 0);
+    if (--ts->gc_arena_depth == 0 && ts->gc_arena_start != NULL
+        && ts->gc_lock_depth == 0 && MP_STATE_MEM(gc_auto_collect_enabled)
+        && ts->gc_arena_used * 2 >= ts->gc_arena_avail) {
+        // Most of what was allocated in the arena is now garbage, so this is a
+        // good time to collect it.
+        gc_arena_collect(ts);
+    }
+}
+
+#endif // MICROPY_GC_ARENA
+
+#if MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+
+// The sites counted so far, followed by the last sample, which is counted
+// once it's known whether it's an object.
+MP_REGISTER_ROOT_POINTER(struct _gc_alloc_profile_site_t *gc_alloc_profile_sites);
+
+#define GC_ALLOC_PROFILE_LAST_SITE (&MP_STATE_VM(gc_alloc_profile_sites)[MICROPY_PY_MICROPYTHON_ALLOC_PROFILE_SITES])
+
+// The profiler's state is shared by all threads, so it's only accessed with
+// the GC mutex held.  The functions below that end in _locked must be called
+// that way.
+
+STATIC void gc_alloc_profile_commit_locked(qstr type_name) {
+    gc_alloc_profile_site_t *sites = MP_STATE_VM(gc_alloc_profile_sites);
+    gc_alloc_profile_site_t *last = GC_ALLOC_PROFILE_LAST_SITE;
+    size_t n_sites = MP_STATE_MEM(gc_alloc_profile_n_sites);
+    MP_STATE_MEM(gc_alloc_profile_last) = NULL;
+    last->type_name = type_name;
+    for (size_t i = 0; i < n_sites; ++i) {
+        if (sites[i].type_name == type_name && sites[i].depth == last->depth
+            && memcmp(sites[i].frame, last->frame, last->depth * sizeof(gc_alloc_profile_frame_t)) == 0) {
+            sites[i].count += 1;
+            sites[i].n_bytes += last->n_bytes;
+            return;
+        }
+    }
+    // Samples from new sites are dropped once the table is full.
+    if (n_sites < MICROPY_PY_MICROPYTHON_ALLOC_PROFILE_SITES) {
+        sites[n_sites] = *last;
+        MP_STATE_MEM(gc_alloc_profile_n_sites) = n_sites + 1;
+    }
+}
+
+void gc_alloc_profile_commit(void *ptr, qstr type_name) {
+    GC_ENTER();
+    // Another thread may have counted the sample, and made its own, since the
+    // caller checked ptr.
+    if (MP_STATE_MEM(gc_alloc_profile_last) == ptr) {
+        gc_alloc_profile_commit_locked(type_name);
+    }
+    GC_EXIT();
+}
+
+// Count down to the next sample, returning true if this allocation is it.
+STATIC bool gc_alloc_profile_tick(void) {
+    GC_ENTER();
+    size_t countdown = MP_STATE_MEM(gc_alloc_profile_countdown);
+    if (countdown == 1) {
+        // Allocate the sample without sampling, so a period of 1 doesn't
+        // recurse.  Other threads don't count allocations meanwhile.
+        MP_STATE_MEM(gc_alloc_profile_countdown) = 0;
+    } else if (countdown != 0) {
+        MP_STATE_MEM(gc_alloc_profile_countdown) = countdown - 1;
+    }
+    if (MP_STATE_MEM(gc_alloc_profile_last) != NULL) {
+        // The last sample would have been given a type by now if it was an
+        // object.
+        gc_alloc_profile_commit_locked(MP_QSTRnull);
+    }
+    GC_EXIT();
+    return countdown == 1;
+}
+
+STATIC void *gc_alloc_profile_sample(size_t n_bytes, unsigned int alloc_flags) {
+    void *ptr = gc_alloc(n_bytes, alloc_flags);
+
+    GC_ENTER();
+    if (MP_STATE_MEM(gc_alloc_profile_countdown) == 0) {
+        MP_STATE_MEM(gc_alloc_profile_countdown) = MP_STATE_MEM(gc_alloc_profile_period);
+    }
+    if (MP_STATE_MEM(gc_alloc_profile_last) != NULL) {
+        gc_alloc_profile_commit_locked(MP_QSTRnull);
+    }
+    if (ptr != NULL && MP_STATE_MEM(gc_alloc_profile_period) != 0) {
+        // Walk the frames of the bytecode running on this thread.  Native code
+        // has no frame, so its allocations are put down to the code calling it.
+        gc_alloc_profile_site_t *last = GC_ALLOC_PROFILE_LAST_SITE;
+        size_t depth = 0;
+        for (const mp_code_state_t *code_state = MP_STATE_THREAD(current_code_state);
+             code_state != NULL && depth < MICROPY_PY_MICROPYTHON_ALLOC_PROFILE_DEPTH;
+             code_state = code_state->prev_state) {
+            gc_alloc_profile_frame_t *frame = &last->frame[depth++];
+            mp_code_state_get_location(code_state, &frame->source_file, &frame->block_name, &frame->line);
+        }
+        last->count = 1;
+        last->n_bytes = n_bytes;
+        last->depth = depth;
+        MP_STATE_MEM(gc_alloc_profile_last) = ptr;
+    }
+    GC_EXIT();
+    return ptr;
+}
+
+void gc_alloc_profile_start(size_t period) {
+    // The table is allocated before taking the mutex, which gc_alloc needs.
+    gc_alloc_profile_site_t *sites = NULL;
+    if (period != 0 && MP_STATE_VM(gc_alloc_profile_sites) == NULL) {
+        sites = m_new(gc_alloc_profile_site_t, MICROPY_PY_MICROPYTHON_ALLOC_PROFILE_SITES + 1);
+    }
+    GC_ENTER();
+    if (MP_STATE_MEM(gc_alloc_profile_last) != NULL) {
+        gc_alloc_profile_commit_locked(MP_QSTRnull);
+    }
+    if (period != 0) {
+        if (MP_STATE_VM(gc_alloc_profile_sites) == NULL) {
+            MP_STATE_VM(gc_alloc_profile_sites) = sites;
+        }
+        MP_STATE_MEM(gc_alloc_profile_n_sites) = 0;
+    }
+    MP_STATE_MEM(gc_alloc_profile_countdown) = period;
+    MP_STATE_MEM(gc_alloc_profile_period) = period;
+    GC_EXIT();
+}
+
+size_t gc_alloc_profile_get(const gc_alloc_profile_site_t **sites) {
+    GC_ENTER();
+    if (MP_STATE_MEM(gc_alloc_profile_last) != NULL) {
+        gc_alloc_profile_commit_locked(MP_QSTRnull);
+    }
+    *sites = MP_STATE_VM(gc_alloc_profile_sites);
+    size_t n_sites = MP_STATE_MEM(gc_alloc_profile_n_sites);
+    GC_EXIT();
+    return n_sites;
+}
+
+#endif // MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+
 void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     bool has_finaliser = alloc_flags & GC_ALLOC_FLAG_HAS_FINALISER;
     size_t n_blocks = ((n_bytes + BYTES_PER_BLOCK - 1) & (~(BYTES_PER_BLOCK - 1))) / BYTES_PER_BLOCK;
@@ -738,6 +1394,37 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
         return NULL;
     }
 
+    #if MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+    // The countdown is checked again with the mutex held.
+    if (MP_STATE_MEM(gc_alloc_profile_countdown) != 0 && gc_alloc_profile_tick()) {
+        return gc_alloc_profile_sample(n_bytes, alloc_flags);
+    }
+    #endif
+
+    #if MICROPY_GC_ARENA || MICROPY_GC_THREAD_REGION
+    if (!has_finaliser) {
+        #if MICROPY_GC_ARENA
+        mp_state_thread_t *ts = GC_THREAD_STATE();
+        if (n_blocks <= MICROPY_GC_ARENA_MAX_ALLOC && ts->gc_arena_depth > 0) {
+            void *ptr = gc_arena_alloc(ts, n_blocks);
+            if (ptr != NULL) {
+                return ptr;
+            }
+        }
+        #else
+        mp_state_thread_t *ts = mp_thread_get_state();
+        #endif
+        #if MICROPY_GC_THREAD_REGION
+        if (n_blocks <= MICROPY_GC_THREAD_REGION_MAX_ALLOC && ts->gc_region_enabled) {
+            void *ptr = gc_region_alloc(ts, n_blocks);
+            if (ptr != NULL) {
+                return ptr;
+            }
+        }
+        #endif
+    }
+    #endif
+
     GC_ENTER();
 
     mp_state_mem_area_t *area;
@@ -746,6 +1433,9 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     size_t start_block;
     size_t n_free;
     int collected = !MP_STATE_MEM(gc_auto_collect_enabled);
+    #if MICROPY_GC_THREAD_REGION
+    bool recollected = false;
+    #endif
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     bool added = false;
     #endif
@@ -770,7 +1460,7 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
         // look for a run of n_blocks available blocks
         for (; area != NULL; area = NEXT_AREA(area), i = 0) {
             n_free = 0;
-            for (i = area->gc_last_free_atb_index; i < area->gc_alloc_table_byte_len; i++) {
+            for (i = gc_get_free_atb_index(area, n_blocks); i < area->gc_alloc_table_byte_len; i++) {
                 MICROPY_GC_HOOK_LOOP(i);
                 byte a = area->gc_alloc_table_start[i];
                 // *FORMAT-OFF*
@@ -794,6 +1484,17 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
         GC_EXIT();
         // nothing found!
         if (collected) {
+            #if MICROPY_GC_THREAD_REGION
+            // Other threads may have filled the heap with new regions since
+            // the collection, in which case it's worth having one more go.
+            if (!recollected && MP_STATE_MEM(gc_auto_collect_enabled)
+                && __atomic_load_n(&MP_STATE_MEM(gc_region_atb_index), __ATOMIC_RELAXED) != 0) {
+                gc_collect();
+                recollected = true;
+                GC_ENTER();
+                continue;
+            }
+            #endif
             #if MICROPY_GC_SPLIT_HEAP_AUTO
             if (!added && gc_try_add_heap(n_bytes)) {
                 added = true;
@@ -825,6 +1526,13 @@ found:
         #endif
         area->gc_last_free_atb_index = (i + 1) / BLOCKS_PER_ATB;
     }
+    #if MICROPY_GC_SIZE_CLASSES > 1
+    // Likewise, a search for a few free blocks always finds the first run of
+    // them, so a search for that many can carry on from here.
+    if (n_free >= 2 && n_free <= MICROPY_GC_SIZE_CLASSES) {
+        area->gc_last_free_atb_index_sized[n_free - 2] = start_block / BLOCKS_PER_ATB;
+    }
+    #endif
 
     area->gc_last_used_block = MAX(area->gc_last_used_block, end_block);
 
@@ -943,8 +1651,8 @@ void gc_free(void *ptr) {
     #endif
 
     // set the last_free pointer to this block if it's earlier in the heap
-    if (block / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
-        area->gc_last_free_atb_index = block / BLOCKS_PER_ATB;
+    if (!GC_IN_ARENA(ptr)) {
+        gc_lower_free_atb_index(area, block);
     }
 
     // free head and all of its tail blocks
@@ -1103,8 +1811,8 @@ void *gc_realloc(void *ptr_in, size_t n_bytes, bool allow_move) {
         #endif
 
         // set the last_free pointer to end of this block if it's earlier in the heap
-        if ((block + new_blocks) / BLOCKS_PER_ATB < area->gc_last_free_atb_index) {
-            area->gc_last_free_atb_index = (block + new_blocks) / BLOCKS_PER_ATB;
+        if (!GC_IN_ARENA(ptr)) {
+            gc_lower_free_atb_index(area, block + new_blocks);
         }
 
         GC_EXIT();
@@ -29,6 +29,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "py/mpprint.h"
+#include "py/qstr.h"
 
 void gc_init(void *start, void *end);
 
@@ -67,6 +68,48 @@ void gc_free(void *ptr); // does not call finaliser
 size_t gc_nbytes(const void *ptr);
 void *gc_realloc(void *ptr, size_t n_bytes, bool allow_move);
 
+#if MICROPY_GC_THREAD_REGION
+// Called by a thread when it starts and finishes to set up and release the
+// region of the heap that its small allocations are taken from.
+void gc_thread_region_init(void);
+void gc_thread_region_deinit(void);
+#endif
+
+#if MICROPY_GC_ARENA
+// Enter and leave an arena.  While in one, the current thread allocates small
+// objects from its arena region, which is reclaimed without a full collection.
+void gc_arena_push(void);
+void gc_arena_pop(void);
+#endif
+
+#if MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+// A place in Python code that sampled allocations were made from: the chain
+// of calls, innermost first, that led to it, and what was allocated there.
+typedef struct _gc_alloc_profile_frame_t {
+    qstr source_file;
+    qstr block_name;
+    size_t line;
+} gc_alloc_profile_frame_t;
+
+typedef struct _gc_alloc_profile_site_t {
+    size_t count;
+    size_t n_bytes;
+    qstr type_name; // MP_QSTRnull if the memory isn't for an object
+    size_t depth;
+    gc_alloc_profile_frame_t frame[MICROPY_PY_MICROPYTHON_ALLOC_PROFILE_DEPTH];
+} gc_alloc_profile_site_t;
+
+// Sample one in every period allocations from now on, forgetting any sites
+// already counted, or stop sampling if period is 0.
+void gc_alloc_profile_start(size_t period);
+// Get the sites counted so far, returning how many there are.
+size_t gc_alloc_profile_get(const gc_alloc_profile_site_t **sites);
+// Count the sampled allocation at ptr, if it's the last one and not yet
+// counted, as an object of the given type or (if type_name is MP_QSTRnull)
+// some other memory.
+void gc_alloc_profile_commit(void *ptr, qstr type_name);
+#endif
+
 typedef struct _gc_info_t {
     size_t total;
     size_t used;
@@ -0,0 +1,63 @@
+"""
+This pre-processor parses a single file containing the key order of all
+mp_rom_map_elem_t tables (i.e. the output of `py/makeqstrdefs.py cat rom_map`),
+one table per line given as its name followed by the qstr of each key.
+
+These are used to generate a header with a MP_MAP_ROM_HINT(qstr, position)
+entry for each qstr used as a key, giving the position where py/map.c should
+look first when searching for that qstr in a ROM map.  If a qstr is a key in
+more than one table then the position it most commonly appears at is used.
+"""
+
+from __future__ import print_function
+
+import argparse
+import io
+
+
+# Positions are stored in a uint8_t.
+MAX_POSITION = 255
+
+
+def find_rom_map_keys(filename):
+    """Find the keys of each ROM map table in the provided file.
+
+    :param str filename: path to file to check
+    :return: List[List[qstr_name]]
+    """
+    with io.open(filename, encoding="utf-8") as f:
+        lines = set(tuple(line.split()) for line in f if line.strip())
+    return [line[1:] for line in lines]
+
+
+def generate_map_hints_header(tables):
+    """Generate header with the position hint of each qstr.
+
+    :param List[List[qstr_name]] tables: keys of each ROM map table
+    :return: None
+    """
+    counts = {}
+    for keys in tables:
+        for pos, key in enumerate(keys[: MAX_POSITION + 1]):
+            if key != "-":
+                counts.setdefault(key, {})
+                counts[key][pos] = counts[key].get(pos, 0) + 1
+
+    print("// Automatically generated by make_map_hints.py.")
+    print()
+
+    for key in sorted(counts):
+        pos = min(counts[key], key=lambda p: (-counts[key][p], p))
+        print("MP_MAP_ROM_HINT({}, {})".format(key, pos))
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("file", nargs=1, help="file with ROM map tables")
+    args = parser.parse_args()
+
+    generate_map_hints_header(find_rom_map_keys(args.file[0]))
+
+
+if __name__ == "__main__":
+    main()
@@ -27,6 +27,9 @@ _MODE_MODULE = "module"
 # Extract MP_REGISTER_ROOT_POINTER(...) macros.
 _MODE_ROOT_POINTER = "root_pointer"
 
+# Extract the key order of mp_rom_map_elem_t tables.
+_MODE_ROM_MAP = "rom_map"
+
 
 class PreprocessorError(Exception):
     pass
@@ -84,7 +87,35 @@ def preprocess():
                 out_file.write(output)
 
 
+def find_rom_maps(text):
+    # Return a line for each mp_rom_map_elem_t table, consisting of the table
+    # name followed by the qstr name of each key in order ("-" if not a qstr).
+    re_table = re.compile(r"mp_rom_map_elem_t\s+(\w+)\s*\[\s*\]\s*=\s*\{")
+    re_key = re.compile(r"[^,]*?\bMP_QSTR_(\w+)")
+    output = []
+    for m in re_table.finditer(text):
+        keys = []
+        depth = 1
+        i = m.end()
+        while depth and i < len(text):
+            c = text[i]
+            if c == "{":
+                depth += 1
+                if depth == 2:
+                    start = i + 1
+            elif c == "}":
+                depth -= 1
+                if depth == 1:
+                    key = re_key.match(text, start, i)
+                    keys.append(key.group(1) if key else "-")
+            i += 1
+        output.append(" ".join([m.group(1)] + keys))
+    return output
+
+
 def write_out(fname, output):
+    if args.mode == _MODE_ROM_MAP:
+        output = find_rom_maps("".join(output))
     if output:
         for m, r in [("/", "__"), ("\\", "__"), (":", "@"), ("..", "@@")]:
             fname = fname.replace(m, r)
@@ -105,6 +136,9 @@ def process_file(f):
         )
     elif args.mode == _MODE_ROOT_POINTER:
         re_match = re.compile(r"MP_REGISTER_ROOT_POINTER\(.*?\);")
+    elif args.mode == _MODE_ROM_MAP:
+        # Tables may span many lines so are extracted by write_out.
+        re_match = None
     output = []
     last_fname = None
     for line in f:
@@ -120,6 +154,9 @@ def process_file(f):
                 output = []
                 last_fname = fname
             continue
+        if args.mode == _MODE_ROM_MAP:
+            output.append(line)
+            continue
         for match in re_match.findall(line):
             if args.mode == _MODE_QSTR:
                 name = match.replace("MP_QSTR_", "")
@@ -160,6 +197,8 @@ def cat_together():
         mode_full = "Module registrations"
     elif args.mode == _MODE_ROOT_POINTER:
         mode_full = "Root pointer registrations"
+    elif args.mode == _MODE_ROM_MAP:
+        mode_full = "ROM map tables"
     if old_hash != new_hash or not os.path.exists(args.output_file):
         print(mode_full, "updated")
 
@@ -222,7 +261,13 @@ if __name__ == "__main__":
     args.output_dir = sys.argv[4]
     args.output_file = None if len(sys.argv) == 5 else sys.argv[5]  # Unused for command=split
 
-    if args.mode not in (_MODE_QSTR, _MODE_COMPRESS, _MODE_MODULE, _MODE_ROOT_POINTER):
+    if args.mode not in (
+        _MODE_QSTR,
+        _MODE_COMPRESS,
+        _MODE_MODULE,
+        _MODE_ROOT_POINTER,
+        _MODE_ROM_MAP,
+    ):
         print("error: mode %s unrecognised" % sys.argv[2])
         sys.exit(2)
 
@@ -61,6 +61,18 @@
 #define MAP_CACHE_SET(index, pos)
 #endif
 
+#if MICROPY_OPT_MAP_LOOKUP_ROM_HINT && !defined(NO_QSTR)
+// For each static qstr, the position at which it is most commonly found in the
+// builtin ROM maps (module globals, type locals) that have it as a key, as
+// generated by py/make_map_hints.py.  The hint is verified before it is used so
+// it only needs to be right most of the time; qstrs without an entry get 0.
+STATIC const uint8_t map_rom_hint[MP_QSTRnumber_of] = {
+    #define MP_MAP_ROM_HINT(q, pos) [MP_QSTR_##q] = pos,
+    #include "genhdr/maphints.h"
+    #undef MP_MAP_ROM_HINT
+};
+#endif
+
 // This table of sizes is used to control the growth of hash tables.
 // The first set of sizes are chosen so the allocation fits exactly in a
 // 4-word GC block, and it's not so important for these small values to be
@@ -157,6 +169,19 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
     // If the map is a fixed array then we must only be called for a lookup
     assert(!map->is_fixed || lookup_kind == MP_MAP_LOOKUP);
 
+    #if MICROPY_OPT_MAP_LOOKUP_ROM_HINT && !defined(NO_QSTR)
+    // Try the position given by the build-time hint for a static qstr in a ROM map.
+    if (map->is_fixed && mp_obj_is_qstr(index)) {
+        qstr q = MP_OBJ_QSTR_VALUE(index);
+        if (q < MP_QSTRnumber_of) {
+            size_t pos = map_rom_hint[q];
+            if (pos < map->used && map->table[pos].key == index) {
+                return &map->table[pos];
+            }
+        }
+    }
+    #endif
+
     #if MICROPY_OPT_MAP_LOOKUP_CACHE
     // Try the cache for lookup or add-if-not-found.
     if (lookup_kind != MP_MAP_LOOKUP_REMOVE_IF_FOUND && map->alloc) {
@@ -14,6 +14,9 @@ set(MICROPY_MODULEDEFS "${MICROPY_GENHDR_DIR}/moduledefs.h")
 set(MICROPY_ROOT_POINTERS_SPLIT "${MICROPY_GENHDR_DIR}/root_pointers.split")
 set(MICROPY_ROOT_POINTERS_COLLECTED "${MICROPY_GENHDR_DIR}/root_pointers.collected")
 set(MICROPY_ROOT_POINTERS "${MICROPY_GENHDR_DIR}/root_pointers.h")
+set(MICROPY_MAPHINTS_SPLIT "${MICROPY_GENHDR_DIR}/maphints.split")
+set(MICROPY_MAPHINTS_COLLECTED "${MICROPY_GENHDR_DIR}/maphints.collected")
+set(MICROPY_MAPHINTS "${MICROPY_GENHDR_DIR}/maphints.h")
 
 if(NOT MICROPY_PREVIEW_VERSION_2)
     set(MICROPY_PREVIEW_VERSION_2 0)
@@ -34,6 +37,12 @@ if(MICROPY_PREVIEW_VERSION_2)
     )
 endif()
 
+if(MICROPY_OPT_MAP_LOOKUP_ROM_HINT)
+    target_compile_definitions(${MICROPY_TARGET} PUBLIC
+        MICROPY_OPT_MAP_LOOKUP_ROM_HINT=\(1\)
+    )
+endif()
+
 # Provide defaults for preprocessor flags if not already defined
 if(NOT MICROPY_CPP_FLAGS)
     get_target_property(MICROPY_CPP_INC ${MICROPY_TARGET} INCLUDE_DIRECTORIES)
@@ -62,6 +71,12 @@ target_sources(${MICROPY_TARGET} PRIVATE
     ${MICROPY_ROOT_POINTERS}
 )
 
+if(MICROPY_OPT_MAP_LOOKUP_ROM_HINT)
+    target_sources(${MICROPY_TARGET} PRIVATE
+        ${MICROPY_MAPHINTS}
+    )
+endif()
+
 # Command to force the build of another command
 
 # Generate mpversion.h
@@ -175,6 +190,32 @@ add_custom_command(
     DEPENDS ${MICROPY_ROOT_POINTERS_COLLECTED} ${MICROPY_PY_DIR}/make_root_pointers.py
 )
 
+# Generate maphints.h
+
+add_custom_command(
+    OUTPUT ${MICROPY_MAPHINTS_SPLIT}
+    COMMAND ${Python3_EXECUTABLE} ${MICROPY_PY_DIR}/makeqstrdefs.py split rom_map ${MICROPY_GENHDR_DIR}/qstr.i.last ${MICROPY_GENHDR_DIR}/rom_map _
+    COMMAND touch ${MICROPY_MAPHINTS_SPLIT}
+    DEPENDS ${MICROPY_QSTRDEFS_LAST}
+    VERBATIM
+    COMMAND_EXPAND_LISTS
+)
+
+add_custom_command(
+    OUTPUT ${MICROPY_MAPHINTS_COLLECTED}
+    COMMAND ${Python3_EXECUTABLE} ${MICROPY_PY_DIR}/makeqstrdefs.py cat rom_map _ ${MICROPY_GENHDR_DIR}/rom_map ${MICROPY_MAPHINTS_COLLECTED}
+    BYPRODUCTS "${MICROPY_MAPHINTS_COLLECTED}.hash"
+    DEPENDS ${MICROPY_MAPHINTS_SPLIT}
+    VERBATIM
+    COMMAND_EXPAND_LISTS
+)
+
+add_custom_command(
+    OUTPUT ${MICROPY_MAPHINTS}
+    COMMAND ${Python3_EXECUTABLE} ${MICROPY_PY_DIR}/make_map_hints.py ${MICROPY_MAPHINTS_COLLECTED} > ${MICROPY_MAPHINTS}
+    DEPENDS ${MICROPY_MAPHINTS_COLLECTED} ${MICROPY_PY_DIR}/make_map_hints.py
+)
+
 # Build frozen code if enabled
 
 if(MICROPY_FROZEN_MANIFEST)
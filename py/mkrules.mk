@@ -27,6 +27,13 @@ OBJ_EXTRA_ORDER_DEPS += $(HEADER_BUILD)/compressed.data.h
 CFLAGS += -DMICROPY_ROM_TEXT_COMPRESSION=1
 endif
 
+ifeq ($(MICROPY_OPT_MAP_LOOKUP_ROM_HINT),1)
+# If ROM map lookup hints are enabled, trigger the build of maphints.h...
+OBJ_EXTRA_ORDER_DEPS += $(HEADER_BUILD)/maphints.h
+# ...and enable their use in py/map.c.
+CFLAGS += -DMICROPY_OPT_MAP_LOOKUP_ROM_HINT=1
+endif
+
 # QSTR generation uses the same CFLAGS, with these modifications.
 QSTR_GEN_FLAGS = -DNO_QSTR
 # Note: := to force evaluation immediately.
@@ -150,6 +157,16 @@ $(HEADER_BUILD)/root_pointers.collected: $(HEADER_BUILD)/root_pointers.split
 	$(ECHO) "GEN $@"
 	$(Q)$(PYTHON) $(PY_SRC)/makeqstrdefs.py cat root_pointer _ $(HEADER_BUILD)/root_pointer $@
 
+# Key order of mp_rom_map_elem_t tables.
+$(HEADER_BUILD)/maphints.split: $(HEADER_BUILD)/qstr.i.last
+	$(ECHO) "GEN $@"
+	$(Q)$(PYTHON) $(PY_SRC)/makeqstrdefs.py split rom_map $< $(HEADER_BUILD)/rom_map _
+	$(Q)$(TOUCH) $@
+
+$(HEADER_BUILD)/maphints.collected: $(HEADER_BUILD)/maphints.split
+	$(ECHO) "GEN $@"
+	$(Q)$(PYTHON) $(PY_SRC)/makeqstrdefs.py cat rom_map _ $(HEADER_BUILD)/rom_map $@
+
 # Compressed error strings.
 $(HEADER_BUILD)/compressed.split: $(HEADER_BUILD)/qstr.i.last
 	$(ECHO) "GEN $@"
@@ -24,13 +24,483 @@
  * THE SOFTWARE.
  */
 
+#include <stdint.h>
+
 #include "py/builtin.h"
+#include "py/binary.h"
+#include "py/objarray.h"
+#include "py/runtime.h"
+#include "py/smallint.h"
 
 #if MICROPY_PY_ARRAY
 
+#if MICROPY_PY_ARRAY_OPS
+
+// Element-wise arithmetic on arrays, and anything else with the buffer
+// protocol.  Each operation is a plain loop over the elements in their C type
+// so that the compiler is able to vectorise it.
+
+// The C type that elements are processed as.  Bit 0 is "is_unsigned".
+enum {
+    ELEM_I8, ELEM_U8, ELEM_I16, ELEM_U16,
+    ELEM_I32, ELEM_U32, ELEM_I64, ELEM_U64,
+    #if MICROPY_PY_BUILTINS_FLOAT
+    ELEM_F32, ELEM_F64,
+    #endif
+};
+
+STATIC const uint8_t elem_size_table[] = {
+    1, 1, 2, 2, 4, 4, 8, 8,
+    #if MICROPY_PY_BUILTINS_FLOAT
+    4, 8,
+    #endif
+};
+
+typedef enum {
+    ARRAY_OP_ADD,
+    ARRAY_OP_SUB,
+    ARRAY_OP_MUL,
+    ARRAY_OP_MIN,
+    ARRAY_OP_MAX,
+} array_op_t;
+
+// Get the buffer of an array argument and return the type of its elements.
+STATIC uint array_get_elem(mp_obj_t obj, mp_buffer_info_t *bufinfo, mp_uint_t flags) {
+    mp_get_buffer_raise(obj, bufinfo, flags);
+    switch (bufinfo->typecode) {
+        case BYTEARRAY_TYPECODE:
+            bufinfo->typecode = 'B';
+            return ELEM_U8;
+        case 'b':
+        case 'B':
+        case 'h':
+        case 'H':
+        case 'i':
+        case 'I':
+        case 'l':
+        case 'L':
+        case 'q':
+        case 'Q': {
+            uint is_unsigned = bufinfo->typecode <= 'Z';
+            switch (mp_binary_get_size('@', bufinfo->typecode, NULL)) {
+                case 1:
+                    return ELEM_I8 | is_unsigned;
+                case 2:
+                    return ELEM_I16 | is_unsigned;
+                case 4:
+                    return ELEM_I32 | is_unsigned;
+                default:
+                    return ELEM_I64 | is_unsigned;
+            }
+        }
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case 'f':
+            return ELEM_F32;
+        case 'd':
+            return ELEM_F64;
+        #endif
+        default:
+            mp_raise_TypeError(MP_ERROR_TEXT("unsupported array type"));
+    }
+}
+
+// Check that an array argument matches the first argument in type and length.
+STATIC void array_get_compatible(mp_obj_t obj, mp_buffer_info_t *bufinfo, mp_uint_t flags, uint kind, size_t len) {
+    if (array_get_elem(obj, bufinfo, flags) != kind) {
+        mp_raise_TypeError(MP_ERROR_TEXT("incompatible array types"));
+    }
+    if (bufinfo->len != len) {
+        mp_raise_ValueError(MP_ERROR_TEXT("array lengths differ"));
+    }
+}
+
+// Get the destination array, either given as the optional out argument or
+// otherwise a new array of the same type as lhs.
+STATIC mp_obj_t array_get_out(size_t n_args, const mp_obj_t *args, size_t out_arg, mp_buffer_info_t *dest,
+    uint kind, const mp_buffer_info_t *lhs) {
+    mp_obj_t out;
+    if (n_args > out_arg) {
+        out = args[out_arg];
+        array_get_compatible(out, dest, MP_BUFFER_WRITE, kind, lhs->len);
+    } else {
+        // Keep bytearray as bytearray, and make everything else an array.
+        char typecode = lhs->typecode;
+        #if MICROPY_PY_BUILTINS_BYTEARRAY
+        if (typecode == 'B' && mp_obj_is_type(args[0], &mp_type_bytearray)) {
+            typecode = BYTEARRAY_TYPECODE;
+        }
+        #endif
+        out = mp_obj_new_array(typecode, lhs->len / elem_size_table[kind]);
+        mp_get_buffer_raise(out, dest, MP_BUFFER_WRITE);
+    }
+    return out;
+}
+
+// Integer add, sub and mul are done on unsigned types, which wrap on overflow.
+// W is the type to compute in, to avoid promotion to (signed) int.
+#define BINOP_ADD(W, a, b) ((W)(a) + (W)(b))
+#define BINOP_SUB(W, a, b) ((W)(a) - (W)(b))
+#define BINOP_MUL(W, a, b) ((W)(a) * (W)(b))
+#define BINOP_MIN(W, a, b) ((a) < (b) ? (a) : (b))
+#define BINOP_MAX(W, a, b) ((a) > (b) ? (a) : (b))
+
+#define BINOP_LOOP(T, W, BINOP) do { \
+        T *d = dest; \
+        const T *x = lhs; \
+        const T *y = rhs; \
+        if (rhs_is_scalar) { \
+            T b = *y; \
+            for (size_t i = 0; i < n; ++i) { \
+                d[i] = (T)BINOP(W, x[i], b); \
+            } \
+        } else { \
+            for (size_t i = 0; i < n; ++i) { \
+                d[i] = (T)BINOP(W, x[i], y[i]); \
+            } \
+        } \
+} while (0)
+
+#if MICROPY_PY_BUILTINS_FLOAT
+#define BINOP_FLOAT_CASES(BINOP) \
+    case ELEM_F32: \
+        BINOP_LOOP(float, float, BINOP); \
+        break; \
+    case ELEM_F64: \
+        BINOP_LOOP(double, double, BINOP); \
+        break;
+#else
+#define BINOP_FLOAT_CASES(BINOP)
+#endif
+
+// For add, sub and mul the signedness of elements doesn't matter.
+#define BINOP_ARITH(BINOP) \
+    switch (kind | 1) { \
+        case ELEM_U8: \
+            BINOP_LOOP(uint8_t, uint32_t, BINOP); \
+            break; \
+        case ELEM_U16: \
+            BINOP_LOOP(uint16_t, uint32_t, BINOP); \
+            break; \
+        case ELEM_U32: \
+            BINOP_LOOP(uint32_t, uint32_t, BINOP); \
+            break; \
+        case ELEM_U64: \
+            BINOP_LOOP(uint64_t, uint64_t, BINOP); \
+            break; \
+        default: \
+            switch (kind) { \
+                BINOP_FLOAT_CASES(BINOP) \
+            } \
+            break; \
+    }
+
+#define BINOP_COMPARE(BINOP) \
+    switch (kind) { \
+        case ELEM_I8: \
+            BINOP_LOOP(int8_t, int8_t, BINOP); \
+            break; \
+        case ELEM_U8: \
+            BINOP_LOOP(uint8_t, uint8_t, BINOP); \
+            break; \
+        case ELEM_I16: \
+            BINOP_LOOP(int16_t, int16_t, BINOP); \
+            break; \
+        case ELEM_U16: \
+            BINOP_LOOP(uint16_t, uint16_t, BINOP); \
+            break; \
+        case ELEM_I32: \
+            BINOP_LOOP(int32_t, int32_t, BINOP); \
+            break; \
+        case ELEM_U32: \
+            BINOP_LOOP(uint32_t, uint32_t, BINOP); \
+            break; \
+        case ELEM_I64: \
+            BINOP_LOOP(int64_t, int64_t, BINOP); \
+            break; \
+        case ELEM_U64: \
+            BINOP_LOOP(uint64_t, uint64_t, BINOP); \
+            break; \
+            BINOP_FLOAT_CASES(BINOP) \
+    }
+
+STATIC void array_binop_loop(array_op_t op, uint kind, void *dest, const void *lhs, const void *rhs, bool rhs_is_scalar, size_t n) {
+    switch (op) {
+        case ARRAY_OP_ADD:
+            BINOP_ARITH(BINOP_ADD);
+            break;
+        case ARRAY_OP_SUB:
+            BINOP_ARITH(BINOP_SUB);
+            break;
+        case ARRAY_OP_MUL:
+            BINOP_ARITH(BINOP_MUL);
+            break;
+        case ARRAY_OP_MIN:
+            BINOP_COMPARE(BINOP_MIN);
+            break;
+        default:
+            BINOP_COMPARE(BINOP_MAX);
+            break;
+    }
+}
+
+STATIC mp_obj_t array_binop(array_op_t op, size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t lhs;
+    uint kind = array_get_elem(args[0], &lhs, MP_BUFFER_READ);
+
+    // The rhs is either an array of the same type and length, or a scalar
+    // which is converted the same way as when it's stored in the lhs array.
+    mp_buffer_info_t rhs;
+    union {
+        uint64_t u;
+        #if MICROPY_PY_BUILTINS_FLOAT
+        double d;
+        #endif
+    } scalar;
+    bool rhs_is_scalar = mp_obj_is_int(args[1]) || mp_obj_is_float(args[1]);
+    if (rhs_is_scalar) {
+        mp_binary_set_val_array(lhs.typecode, &scalar, 0, args[1]);
+        rhs.buf = &scalar;
+    } else {
+        array_get_compatible(args[1], &rhs, MP_BUFFER_READ, kind, lhs.len);
+    }
+
+    mp_buffer_info_t dest;
+    mp_obj_t out = array_get_out(n_args, args, 2, &dest, kind, &lhs);
+    array_binop_loop(op, kind, dest.buf, lhs.buf, rhs.buf, rhs_is_scalar, lhs.len / elem_size_table[kind]);
+    return out;
+}
+
+STATIC mp_obj_t array_add(size_t n_args, const mp_obj_t *args) {
+    return array_binop(ARRAY_OP_ADD, n_args, args);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(array_add_obj, 2, 3, array_add);
+
+STATIC mp_obj_t array_sub(size_t n_args, const mp_obj_t *args) {
+    return array_binop(ARRAY_OP_SUB, n_args, args);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(array_sub_obj, 2, 3, array_sub);
+
+STATIC mp_obj_t array_mul(size_t n_args, const mp_obj_t *args) {
+    return array_binop(ARRAY_OP_MUL, n_args, args);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(array_mul_obj, 2, 3, array_mul);
+
+STATIC mp_obj_t array_minimum(size_t n_args, const mp_obj_t *args) {
+    return array_binop(ARRAY_OP_MIN, n_args, args);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(array_minimum_obj, 2, 3, array_minimum);
+
+STATIC mp_obj_t array_maximum(size_t n_args, const mp_obj_t *args) {
+    return array_binop(ARRAY_OP_MAX, n_args, args);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(array_maximum_obj, 2, 3, array_maximum);
+
+#if MICROPY_PY_BUILTINS_FLOAT
+
+// Multiply by a float factor; integer results are truncated, and saturate at
+// the limits of the element type.
+#define SCALE_LOOP_INT(T, MIN, MAX) do { \
+        T *d = dest; \
+        const T *x = lhs; \
+        for (size_t i = 0; i < n; ++i) { \
+            mp_float_t v = (mp_float_t)x[i] * f; \
+            d[i] = v >= (mp_float_t)MAX ? MAX : v > (mp_float_t)MIN ? (T)v : MIN; \
+        } \
+} while (0)
+
+#define SCALE_LOOP_FLOAT(T) do { \
+        T *d = dest; \
+        const T *x = lhs; \
+        for (size_t i = 0; i < n; ++i) { \
+            d[i] = (T)((mp_float_t)x[i] * f); \
+        } \
+} while (0)
+
+STATIC void array_scale_loop(uint kind, void *dest, const void *lhs, mp_float_t f, size_t n) {
+    switch (kind) {
+        case ELEM_I8:
+            SCALE_LOOP_INT(int8_t, INT8_MIN, INT8_MAX);
+            break;
+        case ELEM_U8:
+            SCALE_LOOP_INT(uint8_t, 0, UINT8_MAX);
+            break;
+        case ELEM_I16:
+            SCALE_LOOP_INT(int16_t, INT16_MIN, INT16_MAX);
+            break;
+        case ELEM_U16:
+            SCALE_LOOP_INT(uint16_t, 0, UINT16_MAX);
+            break;
+        case ELEM_I32:
+            SCALE_LOOP_INT(int32_t, INT32_MIN, INT32_MAX);
+            break;
+        case ELEM_U32:
+            SCALE_LOOP_INT(uint32_t, 0, UINT32_MAX);
+            break;
+        case ELEM_I64:
+            SCALE_LOOP_INT(int64_t, INT64_MIN, INT64_MAX);
+            break;
+        case ELEM_U64:
+            SCALE_LOOP_INT(uint64_t, 0, UINT64_MAX);
+            break;
+        case ELEM_F32:
+            SCALE_LOOP_FLOAT(float);
+            break;
+        default:
+            SCALE_LOOP_FLOAT(double);
+            break;
+    }
+}
+
+STATIC mp_obj_t array_scale(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t lhs;
+    uint kind = array_get_elem(args[0], &lhs, MP_BUFFER_READ);
+    mp_float_t f = mp_obj_get_float(args[1]);
+    mp_buffer_info_t dest;
+    mp_obj_t out = array_get_out(n_args, args, 2, &dest, kind, &lhs);
+    array_scale_loop(kind, dest.buf, lhs.buf, f, lhs.len / elem_size_table[kind]);
+    return out;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(array_scale_obj, 2, 3, array_scale);
+
+#endif // MICROPY_PY_BUILTINS_FLOAT
+
+// Integer sums are accumulated in 64 bits, which wrap on overflow.
+#define SUM_LOOP_INT(T) do { \
+        const T *x = lhs; \
+        for (size_t i = 0; i < n; ++i) { \
+            acc += (uint64_t)x[i]; \
+        } \
+} while (0)
+
+#define DOT_LOOP_INT(T) do { \
+        const T *x = lhs; \
+        const T *y = rhs; \
+        for (size_t i = 0; i < n; ++i) { \
+            acc += (uint64_t)x[i] * (uint64_t)y[i]; \
+        } \
+} while (0)
+
+#define SUM_LOOP_FLOAT(T) do { \
+        const T *x = lhs; \
+        for (size_t i = 0; i < n; ++i) { \
+            facc += (mp_float_t)x[i]; \
+        } \
+} while (0)
+
+#define DOT_LOOP_FLOAT(T) do { \
+        const T *x = lhs; \
+        const T *y = rhs; \
+        for (size_t i = 0; i < n; ++i) { \
+            facc += (mp_float_t)x[i] * (mp_float_t)y[i]; \
+        } \
+} while (0)
+
+#if MICROPY_PY_BUILTINS_FLOAT
+#define REDUCE_FLOAT_CASES(LOOP) \
+    case ELEM_F32: \
+        LOOP(float); \
+        return mp_obj_new_float(facc); \
+    case ELEM_F64: \
+        LOOP(double); \
+        return mp_obj_new_float(facc);
+#else
+#define REDUCE_FLOAT_CASES(LOOP)
+#endif
+
+#define REDUCE(INT_LOOP, FLOAT_LOOP) \
+    switch (kind) { \
+        case ELEM_I8: \
+            INT_LOOP(int8_t); \
+            break; \
+        case ELEM_U8: \
+            INT_LOOP(uint8_t); \
+            break; \
+        case ELEM_I16: \
+            INT_LOOP(int16_t); \
+            break; \
+        case ELEM_U16: \
+            INT_LOOP(uint16_t); \
+            break; \
+        case ELEM_I32: \
+            INT_LOOP(int32_t); \
+            break; \
+        case ELEM_U32: \
+            INT_LOOP(uint32_t); \
+            break; \
+        case ELEM_I64: \
+            INT_LOOP(int64_t); \
+            break; \
+        case ELEM_U64: \
+            INT_LOOP(uint64_t); \
+            break; \
+            REDUCE_FLOAT_CASES(FLOAT_LOOP) \
+    }
+
+// Convert an integer accumulator to an int object, signed or unsigned
+// according to the element type.
+STATIC mp_obj_t array_acc_to_int(uint kind, uint64_t acc) {
+    if (kind & 1) {
+        if (acc <= (uint64_t)MP_SMALL_INT_MAX) {
+            return MP_OBJ_NEW_SMALL_INT((mp_int_t)acc);
+        }
+        return mp_obj_new_int_from_ull(acc);
+    } else {
+        long long val = (long long)acc;
+        if ((long long)MP_SMALL_INT_MIN <= val && val <= (long long)MP_SMALL_INT_MAX) {
+            return MP_OBJ_NEW_SMALL_INT((mp_int_t)val);
+        }
+        return mp_obj_new_int_from_ll(val);
+    }
+}
+
+STATIC mp_obj_t array_sum(mp_obj_t lhs_in) {
+    mp_buffer_info_t bufinfo;
+    uint kind = array_get_elem(lhs_in, &bufinfo, MP_BUFFER_READ);
+    const void *lhs = bufinfo.buf;
+    size_t n = bufinfo.len / elem_size_table[kind];
+    uint64_t acc = 0;
+    #if MICROPY_PY_BUILTINS_FLOAT
+    mp_float_t facc = 0;
+    #endif
+    REDUCE(SUM_LOOP_INT, SUM_LOOP_FLOAT);
+    return array_acc_to_int(kind, acc);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(array_sum_obj, array_sum);
+
+STATIC mp_obj_t array_dot(mp_obj_t lhs_in, mp_obj_t rhs_in) {
+    mp_buffer_info_t bufinfo;
+    uint kind = array_get_elem(lhs_in, &bufinfo, MP_BUFFER_READ);
+    mp_buffer_info_t rhsinfo;
+    array_get_compatible(rhs_in, &rhsinfo, MP_BUFFER_READ, kind, bufinfo.len);
+    const void *lhs = bufinfo.buf;
+    const void *rhs = rhsinfo.buf;
+    size_t n = bufinfo.len / elem_size_table[kind];
+    uint64_t acc = 0;
+    #if MICROPY_PY_BUILTINS_FLOAT
+    mp_float_t facc = 0;
+    #endif
+    REDUCE(DOT_LOOP_INT, DOT_LOOP_FLOAT);
+    return array_acc_to_int(kind, acc);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(array_dot_obj, array_dot);
+
+#endif // MICROPY_PY_ARRAY_OPS
+
 STATIC const mp_rom_map_elem_t mp_module_array_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_array) },
     { MP_ROM_QSTR(MP_QSTR_array), MP_ROM_PTR(&mp_type_array) },
+    #if MICROPY_PY_ARRAY_OPS
+    { MP_ROM_QSTR(MP_QSTR_add), MP_ROM_PTR(&array_add_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sub), MP_ROM_PTR(&array_sub_obj) },
+    { MP_ROM_QSTR(MP_QSTR_mul), MP_ROM_PTR(&array_mul_obj) },
+    #if MICROPY_PY_BUILTINS_FLOAT
+    { MP_ROM_QSTR(MP_QSTR_scale), MP_ROM_PTR(&array_scale_obj) },
+    #endif
+    { MP_ROM_QSTR(MP_QSTR_minimum), MP_ROM_PTR(&array_minimum_obj) },
+    { MP_ROM_QSTR(MP_QSTR_maximum), MP_ROM_PTR(&array_maximum_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sum), MP_ROM_PTR(&array_sum_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dot), MP_ROM_PTR(&array_dot_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_array_globals, mp_module_array_globals_table);
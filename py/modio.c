@@ -202,6 +202,109 @@ STATIC MP_DEFINE_CONST_OBJ_TYPE(
     );
 #endif // MICROPY_PY_IO_BUFFEREDWRITER
 
+#if MICROPY_PY_IO_BUFFEREDREADER
+typedef struct _mp_obj_bufreader_t {
+    mp_obj_base_t base;
+    mp_obj_t stream;
+    mp_stream_rbuf_t rbuf;
+} mp_obj_bufreader_t;
+
+STATIC mp_uint_t bufreader_read_raw(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_get_stream(self->stream)->read(self->stream, buf, size, errcode);
+}
+
+STATIC mp_obj_t bufreader_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 2, false);
+    mp_get_stream_raise(args[0], MP_STREAM_OP_READ | MP_STREAM_OP_IOCTL);
+    mp_int_t alloc = MICROPY_STREAMS_READ_BUFFER_SIZE;
+    if (n_args > 1) {
+        alloc = mp_obj_get_int(args[1]);
+        if (alloc <= 0) {
+            mp_raise_ValueError(NULL);
+        }
+    }
+    mp_obj_bufreader_t *o = mp_obj_malloc(mp_obj_bufreader_t, type);
+    o->stream = args[0];
+    mp_stream_rbuf_init(&o->rbuf, bufreader_read_raw, alloc);
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC mp_uint_t bufreader_read(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_stream_rbuf_read(&self->rbuf, self_in, buf, size, errcode);
+}
+
+STATIC mp_uint_t bufreader_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(self_in);
+    const mp_stream_p_t *stream_p = mp_get_stream(self->stream);
+    mp_uint_t unread = mp_stream_rbuf_unread(&self->rbuf);
+
+    switch (request) {
+        case MP_STREAM_SEEK: {
+            struct mp_stream_seek_t *s = (struct mp_stream_seek_t *)arg;
+            if (s->whence == MP_SEEK_CUR) {
+                // The underlying stream is ahead of us by the unread data.
+                s->offset -= unread;
+            }
+            mp_uint_t ret = stream_p->ioctl(self->stream, request, arg, errcode);
+            if (ret != MP_STREAM_ERROR) {
+                mp_stream_rbuf_discard(&self->rbuf);
+            } else if (s->whence == MP_SEEK_CUR) {
+                s->offset += unread;
+            }
+            return ret;
+        }
+        case MP_STREAM_POLL:
+            if ((arg & MP_STREAM_POLL_RD) && unread != 0) {
+                // Buffered data can be read without blocking.
+                mp_uint_t ret = MP_STREAM_POLL_RD;
+                if (arg & ~MP_STREAM_POLL_RD) {
+                    mp_uint_t res = stream_p->ioctl(self->stream, request, arg & ~MP_STREAM_POLL_RD, errcode);
+                    if (res != MP_STREAM_ERROR) {
+                        ret |= res;
+                    }
+                }
+                return ret;
+            }
+            break;
+        case MP_STREAM_CLOSE:
+            mp_stream_rbuf_discard(&self->rbuf);
+            self->rbuf.buf = NULL;
+            break;
+    }
+    return stream_p->ioctl(self->stream, request, arg, errcode);
+}
+
+STATIC const mp_rom_map_elem_t bufreader_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&mp_stream_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&mp_stream_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readline), MP_ROM_PTR(&mp_stream_unbuffered_readline_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readlines), MP_ROM_PTR(&mp_stream_unbuffered_readlines_obj) },
+    { MP_ROM_QSTR(MP_QSTR_seek), MP_ROM_PTR(&mp_stream_seek_obj) },
+    { MP_ROM_QSTR(MP_QSTR_tell), MP_ROM_PTR(&mp_stream_tell_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&mp_stream_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_identity_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&mp_stream___exit___obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(bufreader_locals_dict, bufreader_locals_dict_table);
+
+STATIC const mp_stream_p_t bufreader_stream_p = {
+    .read = bufreader_read,
+    .ioctl = bufreader_ioctl,
+    .rbuf_offset = offsetof(mp_obj_bufreader_t, rbuf),
+};
+
+STATIC MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_bufreader,
+    MP_QSTR_BufferedReader,
+    MP_TYPE_FLAG_ITER_IS_STREAM,
+    make_new, bufreader_make_new,
+    protocol, &bufreader_stream_p,
+    locals_dict, &bufreader_locals_dict
+    );
+#endif // MICROPY_PY_IO_BUFFEREDREADER
+
 STATIC const mp_rom_map_elem_t mp_module_io_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_io) },
     // Note: mp_builtin_open_obj should be defined by port, it's not
@@ -217,6 +320,9 @@ STATIC const mp_rom_map_elem_t mp_module_io_globals_table[] = {
     #if MICROPY_PY_IO_BUFFEREDWRITER
     { MP_ROM_QSTR(MP_QSTR_BufferedWriter), MP_ROM_PTR(&mp_type_bufwriter) },
     #endif
+    #if MICROPY_PY_IO_BUFFEREDREADER
+    { MP_ROM_QSTR(MP_QSTR_BufferedReader), MP_ROM_PTR(&mp_type_bufreader) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_io_globals, mp_module_io_globals_table);
@@ -25,7 +25,9 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
+#include "py/bc.h"
 #include "py/builtin.h"
 #include "py/stackctrl.h"
 #include "py/runtime.h"
@@ -142,6 +144,159 @@ STATIC mp_obj_t mp_micropython_heap_locked(void) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_heap_locked_obj, mp_micropython_heap_locked);
 #endif
+
+#if MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+STATIC mp_obj_t mp_micropython_alloc_profile(size_t n_args, const mp_obj_t *args) {
+    if (n_args == 1) {
+        mp_int_t period = mp_obj_get_int(args[0]);
+        if (period < 0) {
+            mp_raise_ValueError(NULL);
+        }
+        gc_alloc_profile_start(period);
+        return mp_const_none;
+    }
+
+    // Return a list of (stack, type, count, bytes) for the sites counted so
+    // far, where stack is a tuple of (file, line, function), outermost first.
+    const gc_alloc_profile_site_t *sites;
+    size_t n_sites = gc_alloc_profile_get(&sites);
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    for (size_t i = 0; i < n_sites; ++i) {
+        const gc_alloc_profile_site_t *site = &sites[i];
+        mp_obj_tuple_t *stack = MP_OBJ_TO_PTR(mp_obj_new_tuple(site->depth, NULL));
+        for (size_t j = 0; j < site->depth; ++j) {
+            const gc_alloc_profile_frame_t *frame = &site->frame[site->depth - 1 - j];
+            mp_obj_t items[3] = {
+                MP_OBJ_NEW_QSTR(frame->source_file),
+                MP_OBJ_NEW_SMALL_INT(frame->line),
+                MP_OBJ_NEW_QSTR(frame->block_name),
+            };
+            stack->items[j] = mp_obj_new_tuple(3, items);
+        }
+        mp_obj_t items[4] = {
+            MP_OBJ_FROM_PTR(stack),
+            site->type_name == MP_QSTRnull ? mp_const_none : MP_OBJ_NEW_QSTR(site->type_name),
+            mp_obj_new_int_from_uint(site->count),
+            mp_obj_new_int_from_uint(site->n_bytes),
+        };
+        mp_obj_list_append(list, mp_obj_new_tuple(4, items));
+    }
+    return list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_alloc_profile_obj, 0, 1, mp_micropython_alloc_profile);
+
+STATIC mp_obj_t mp_micropython_alloc_profile_dump(void) {
+    // Print the sites in the "folded" format taken by flame graph tools: the
+    // frames of each stack, outermost first, then the type allocated, all
+    // separated by semicolons, followed by the number of bytes.
+    const gc_alloc_profile_site_t *sites;
+    size_t n_sites = gc_alloc_profile_get(&sites);
+    for (size_t i = 0; i < n_sites; ++i) {
+        const gc_alloc_profile_site_t *site = &sites[i];
+        const char *sep = "";
+        if (site->depth == 0) {
+            mp_print_str(&mp_plat_print, "[unknown]");
+            sep = ";";
+        }
+        for (size_t j = site->depth; j-- > 0;) {
+            const gc_alloc_profile_frame_t *frame = &site->frame[j];
+            mp_printf(&mp_plat_print, "%s%q:%q:%u", sep, frame->source_file, frame->block_name, (uint)frame->line);
+            sep = ";";
+        }
+        if (site->type_name != MP_QSTRnull) {
+            mp_printf(&mp_plat_print, ";%q", site->type_name);
+        }
+        mp_printf(&mp_plat_print, " %u\n", (uint)site->n_bytes);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_alloc_profile_dump_obj, mp_micropython_alloc_profile_dump);
+#endif
+#endif
+
+#if MICROPY_GC_ARENA
+// micropython.arena() returns a context manager, so requests can be handled
+// with "with micropython.arena(): ...".
+STATIC mp_obj_t mp_micropython_arena_enter(mp_obj_t self_in) {
+    gc_arena_push();
+    return self_in;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mp_micropython_arena_enter_obj, mp_micropython_arena_enter);
+
+STATIC mp_obj_t mp_micropython_arena_exit(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    (void)args;
+    gc_arena_pop();
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_arena_exit_obj, 4, 4, mp_micropython_arena_exit);
+
+STATIC const mp_rom_map_elem_t mp_micropython_arena_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_micropython_arena_enter_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&mp_micropython_arena_exit_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(mp_micropython_arena_locals_dict, mp_micropython_arena_locals_dict_table);
+
+STATIC MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_micropython_arena,
+    MP_QSTR_arena,
+    MP_TYPE_FLAG_NONE,
+    locals_dict, &mp_micropython_arena_locals_dict
+    );
+
+STATIC const mp_obj_base_t mp_micropython_arena_ctx = { &mp_type_micropython_arena };
+
+STATIC mp_obj_t mp_micropython_arena(void) {
+    return MP_OBJ_FROM_PTR(&mp_micropython_arena_ctx);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_arena_obj, mp_micropython_arena);
+#endif
+
+#if MICROPY_PY_MICROPYTHON_VM_STATS
+STATIC mp_obj_t mp_micropython_vm_stats(size_t n_args, const mp_obj_t *args) {
+    // Return a dict mapping each opcode executed to its count, a dict mapping
+    // each pair of consecutive opcodes to its count, and a list of
+    // (file, function, calls, ticks) for each bytecode function called.
+    mp_obj_t opcodes = mp_obj_new_dict(0);
+    mp_obj_t pairs = mp_obj_new_dict(0);
+    for (size_t op = 1; op < 256; ++op) {
+        if (mp_vm_stats.opcode[op] != 0) {
+            mp_obj_dict_store(opcodes, MP_OBJ_NEW_SMALL_INT(op), mp_obj_new_int_from_uint(mp_vm_stats.opcode[op]));
+        }
+        for (size_t next = 1; next < 256; ++next) {
+            if (mp_vm_stats.opcode_pair[op][next] != 0) {
+                mp_obj_t pair[2] = { MP_OBJ_NEW_SMALL_INT(op), MP_OBJ_NEW_SMALL_INT(next) };
+                mp_obj_dict_store(pairs, mp_obj_new_tuple(2, pair), mp_obj_new_int_from_uint(mp_vm_stats.opcode_pair[op][next]));
+            }
+        }
+    }
+    mp_obj_t funs = mp_obj_new_list(0, NULL);
+    for (size_t i = 0; i < MICROPY_PY_MICROPYTHON_VM_STATS_FUNCS; ++i) {
+        const mp_vm_stats_fun_t *fun = &mp_vm_stats.fun[i];
+        if (fun->bytecode != NULL) {
+            mp_obj_t items[4] = {
+                MP_OBJ_NEW_QSTR(fun->source_file),
+                MP_OBJ_NEW_QSTR(fun->block_name),
+                mp_obj_new_int_from_uint(fun->calls),
+                mp_obj_new_int_from_ull(fun->ticks),
+            };
+            mp_obj_list_append(funs, mp_obj_new_tuple(4, items));
+        }
+    }
+    if (mp_vm_stats.fun_other_calls != 0) {
+        // Calls to functions that there was no room to count separately.
+        mp_obj_t items[4] = { mp_const_none, mp_const_none, mp_obj_new_int_from_uint(mp_vm_stats.fun_other_calls), MP_OBJ_NEW_SMALL_INT(0) };
+        mp_obj_list_append(funs, mp_obj_new_tuple(4, items));
+    }
+
+    if (n_args == 1 && mp_obj_is_true(args[0])) {
+        memset(&mp_vm_stats, 0, sizeof(mp_vm_stats));
+    }
+
+    mp_obj_t tuple[3] = { opcodes, pairs, funs };
+    return mp_obj_new_tuple(3, tuple);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_vm_stats_obj, 0, 1, mp_micropython_vm_stats);
 #endif
 
 #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF && (MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE == 0)
@@ -184,6 +339,9 @@ STATIC const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #if MICROPY_PY_MICROPYTHON_STACK_USE
     { MP_ROM_QSTR(MP_QSTR_stack_use), MP_ROM_PTR(&mp_micropython_stack_use_obj) },
     #endif
+    #if MICROPY_PY_MICROPYTHON_VM_STATS
+    { MP_ROM_QSTR(MP_QSTR_vm_stats), MP_ROM_PTR(&mp_micropython_vm_stats_obj) },
+    #endif
     #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF && (MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE == 0)
     { MP_ROM_QSTR(MP_QSTR_alloc_emergency_exception_buf), MP_ROM_PTR(&mp_alloc_emergency_exception_buf_obj) },
     #endif
@@ -196,6 +354,13 @@ STATIC const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #if MICROPY_PY_MICROPYTHON_HEAP_LOCKED
     { MP_ROM_QSTR(MP_QSTR_heap_locked), MP_ROM_PTR(&mp_micropython_heap_locked_obj) },
     #endif
+    #if MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+    { MP_ROM_QSTR(MP_QSTR_alloc_profile), MP_ROM_PTR(&mp_micropython_alloc_profile_obj) },
+    { MP_ROM_QSTR(MP_QSTR_alloc_profile_dump), MP_ROM_PTR(&mp_micropython_alloc_profile_dump_obj) },
+    #endif
+    #endif
+    #if MICROPY_GC_ARENA
+    { MP_ROM_QSTR(MP_QSTR_arena), MP_ROM_PTR(&mp_micropython_arena_obj) },
     #endif
     #if MICROPY_KBD_EXCEPTION
     { MP_ROM_QSTR(MP_QSTR_kbd_intr), MP_ROM_PTR(&mp_micropython_kbd_intr_obj) },
@@ -257,6 +257,253 @@ STATIC mp_obj_t struct_pack_into(size_t n_args, const mp_obj_t *args) {
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_pack_into);
 
+#if MICROPY_PY_STRUCT_STRUCT
+
+// A Struct object holds its format compiled to a list of ops, one for each
+// type code (and count) in the format, apart from padding, so the format
+// string is only parsed once.
+
+typedef struct _struct_op_t {
+    char val_type;
+    size_t count; // number of values, or number of bytes for 's'
+    size_t offset; // of the first value from the start of the packed data
+} struct_op_t;
+
+typedef struct _mp_obj_struct_t {
+    mp_obj_base_t base;
+    mp_obj_t format;
+    char fmt_type;
+    size_t size;
+    size_t n_items;
+    size_t n_ops;
+    struct_op_t ops[];
+} mp_obj_struct_t;
+
+typedef struct _mp_obj_struct_iter_t {
+    mp_obj_base_t base;
+    mp_fun_1_t iternext;
+    mp_obj_struct_t *st;
+    mp_obj_t buffer;
+    size_t offset;
+} mp_obj_struct_iter_t;
+
+// Fills in ops, if not NULL, and returns the number of ops in the format.
+STATIC size_t struct_compile(const char *fmt, struct_op_t *ops) {
+    char fmt_type = get_fmt_type(&fmt);
+    size_t n_ops = 0;
+    size_t size = 0;
+    for (; *fmt; fmt++) {
+        mp_uint_t cnt = 1;
+        if (unichar_isdigit(*fmt)) {
+            cnt = get_fmt_num(&fmt);
+        }
+        if (*fmt == 'x') {
+            size += cnt;
+            continue;
+        }
+        if (*fmt != 's') {
+            if (cnt == 0) {
+                continue;
+            }
+            // The size of a type is a multiple of its alignment, so only the
+            // first value needs to be aligned.
+            size_t align;
+            size_t sz = mp_binary_get_size(fmt_type, *fmt, &align);
+            size = (size + align - 1) & ~(align - 1);
+            if (ops != NULL) {
+                ops[n_ops] = (struct_op_t) {*fmt, cnt, size};
+            }
+            size += sz * cnt;
+        } else {
+            if (ops != NULL) {
+                ops[n_ops] = (struct_op_t) {*fmt, cnt, size};
+            }
+            size += cnt;
+        }
+        ++n_ops;
+    }
+    return n_ops;
+}
+
+STATIC mp_obj_t struct_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    const char *fmt = mp_obj_str_get_str(args[0]);
+    size_t size;
+    size_t n_items = calc_size_items(fmt, &size);
+    size_t n_ops = struct_compile(fmt, NULL);
+    mp_obj_struct_t *self = mp_obj_malloc_var(mp_obj_struct_t, struct_op_t, n_ops, type);
+    self->format = args[0];
+    self->size = size;
+    self->n_items = n_items;
+    self->n_ops = n_ops;
+    struct_compile(fmt, self->ops);
+    self->fmt_type = get_fmt_type(&fmt);
+    return MP_OBJ_FROM_PTR(self);
+}
+
+// Returns a pointer to size bytes at offset in the buffer, where a negative
+// offset counts from the end of the buffer.
+STATIC byte *struct_get_data(mp_obj_t buf_in, mp_int_t offset, size_t size, mp_uint_t flags) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, flags);
+    if (offset < 0) {
+        offset += bufinfo.len;
+    }
+    if (offset < 0 || (size_t)offset + size > bufinfo.len) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
+    return (byte *)bufinfo.buf + offset;
+}
+
+STATIC void struct_unpack_items(mp_obj_struct_t *self, byte *p, mp_obj_t *items) {
+    for (size_t i = 0; i < self->n_ops; ++i) {
+        const struct_op_t *op = &self->ops[i];
+        byte *q = p + op->offset;
+        if (op->val_type == 's') {
+            *items++ = mp_obj_new_bytes(q, op->count);
+        } else {
+            for (size_t j = op->count; j > 0; --j) {
+                *items++ = mp_binary_get_val(self->fmt_type, op->val_type, p, &q);
+            }
+        }
+    }
+}
+
+// As for the module's pack functions, extra values are ignored, and missing
+// ones leave zeros.
+STATIC void struct_pack_items(mp_obj_struct_t *self, byte *p, size_t n_args, const mp_obj_t *args) {
+    memset(p, 0, self->size);
+    for (size_t i = 0; i < self->n_ops && n_args > 0; ++i) {
+        const struct_op_t *op = &self->ops[i];
+        byte *q = p + op->offset;
+        if (op->val_type == 's') {
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(*args++, &bufinfo, MP_BUFFER_READ);
+            --n_args;
+            memcpy(q, bufinfo.buf, MIN(bufinfo.len, op->count));
+        } else {
+            for (size_t j = op->count; j > 0 && n_args > 0; --j, --n_args) {
+                mp_binary_set_val(self->fmt_type, op->val_type, *args++, p, &q);
+            }
+        }
+    }
+}
+
+STATIC mp_obj_t struct_obj_pack(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    vstr_t vstr;
+    vstr_init_len(&vstr, self->size);
+    struct_pack_items(self, (byte *)vstr.buf, n_args - 1, args + 1);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_pack_obj, 1, MP_OBJ_FUN_ARGS_MAX, struct_obj_pack);
+
+STATIC mp_obj_t struct_obj_pack_into(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    byte *p = struct_get_data(args[1], mp_obj_get_int(args[2]), self->size, MP_BUFFER_WRITE);
+    struct_pack_items(self, p, n_args - 3, args + 3);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_obj_pack_into);
+
+// unpack_from(buffer, offset=0, out=None, /)
+// As a MicroPython extension the values can be stored into an existing list,
+// given as out, which must have the same length as the number of values.
+STATIC mp_obj_t struct_obj_unpack_from(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t offset = n_args > 2 ? mp_obj_get_int(args[2]) : 0;
+    byte *p = struct_get_data(args[1], offset, self->size, MP_BUFFER_READ);
+    if (n_args > 3 && args[3] != mp_const_none) {
+        if (!mp_obj_is_type(args[3], &mp_type_list)) {
+            mp_raise_TypeError(NULL);
+        }
+        mp_obj_t *items;
+        mp_obj_get_array_fixed_n(args[3], self->n_items, &items);
+        struct_unpack_items(self, p, items);
+        return args[3];
+    }
+    mp_obj_tuple_t *res = MP_OBJ_TO_PTR(mp_obj_new_tuple(self->n_items, NULL));
+    struct_unpack_items(self, p, res->items);
+    return MP_OBJ_FROM_PTR(res);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_unpack_from_obj, 2, 4, struct_obj_unpack_from);
+
+STATIC mp_obj_t struct_obj_unpack(mp_obj_t self_in, mp_obj_t buf_in) {
+    mp_obj_t args[2] = {self_in, buf_in};
+    return struct_obj_unpack_from(2, args);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(struct_obj_unpack_obj, struct_obj_unpack);
+
+STATIC mp_obj_t struct_iter_iternext(mp_obj_t self_in) {
+    mp_obj_struct_iter_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(self->buffer, &bufinfo, MP_BUFFER_READ);
+    if (self->offset + self->st->size > bufinfo.len) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    mp_obj_tuple_t *res = MP_OBJ_TO_PTR(mp_obj_new_tuple(self->st->n_items, NULL));
+    struct_unpack_items(self->st, (byte *)bufinfo.buf + self->offset, res->items);
+    self->offset += self->st->size;
+    return MP_OBJ_FROM_PTR(res);
+}
+
+STATIC mp_obj_t struct_obj_iter_unpack(mp_obj_t self_in, mp_obj_t buf_in) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_READ);
+    if (self->size == 0 || bufinfo.len % self->size != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer size not a multiple of struct size"));
+    }
+    mp_obj_struct_iter_t *iter = mp_obj_malloc(mp_obj_struct_iter_t, &mp_type_polymorph_iter);
+    iter->iternext = struct_iter_iternext;
+    iter->st = self;
+    iter->buffer = buf_in;
+    iter->offset = 0;
+    return MP_OBJ_FROM_PTR(iter);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(struct_obj_iter_unpack_obj, struct_obj_iter_unpack);
+
+STATIC void struct_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    if (dest[0] != MP_OBJ_NULL) {
+        // not load attribute
+        return;
+    }
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    if (attr == MP_QSTR_format) {
+        dest[0] = self->format;
+    } else if (attr == MP_QSTR_size) {
+        dest[0] = MP_OBJ_NEW_SMALL_INT(self->size);
+    } else {
+        // continue lookup in locals_dict
+        dest[1] = MP_OBJ_SENTINEL;
+    }
+}
+
+STATIC const mp_rom_map_elem_t struct_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_pack), MP_ROM_PTR(&struct_obj_pack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_obj_pack_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_obj_unpack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_obj_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_iter_unpack), MP_ROM_PTR(&struct_obj_iter_unpack_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(struct_locals_dict, struct_locals_dict_table);
+
+STATIC MP_DEFINE_CONST_OBJ_TYPE(
+    struct_type,
+    MP_QSTR_Struct,
+    MP_TYPE_FLAG_NONE,
+    make_new, struct_make_new,
+    attr, struct_attr,
+    locals_dict, &struct_locals_dict
+    );
+
+STATIC mp_obj_t struct_iter_unpack(mp_obj_t fmt_in, mp_obj_t buf_in) {
+    return struct_obj_iter_unpack(struct_make_new(&struct_type, 1, 0, &fmt_in), buf_in);
+}
+MP_DEFINE_CONST_FUN_OBJ_2(struct_iter_unpack_obj, struct_iter_unpack);
+
+#endif // MICROPY_PY_STRUCT_STRUCT
+
 STATIC const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_struct) },
     { MP_ROM_QSTR(MP_QSTR_calcsize), MP_ROM_PTR(&struct_calcsize_obj) },
@@ -264,6 +511,10 @@ STATIC const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_pack_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_unpack_from_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_unpack_from_obj) },
+    #if MICROPY_PY_STRUCT_STRUCT
+    { MP_ROM_QSTR(MP_QSTR_iter_unpack), MP_ROM_PTR(&struct_iter_unpack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_Struct), MP_ROM_PTR(&struct_type) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_struct_globals, mp_module_struct_globals_table);
@@ -32,6 +32,7 @@
 
 #if MICROPY_PY_THREAD
 
+#include "py/gc.h"
 #include "py/mpthread.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
@@ -177,6 +178,24 @@ STATIC void *thread_entry(void *args_in) {
     ts.nlr_jump_callback_top = NULL;
     ts.mp_pending_exception = MP_OBJ_NULL;
 
+    #if MICROPY_TRACK_FRAMES
+    // No Python code is running on this thread yet.
+    ts.current_code_state = NULL;
+    #endif
+
+    #if MICROPY_GC_ARENA
+    // The arena region is reserved when the thread first enters an arena.
+    ts.gc_arena_start = NULL;
+    ts.gc_arena_cur = NULL;
+    ts.gc_arena_depth = 0;
+    ts.gc_arena_collecting = false;
+    #endif
+
+    #if MICROPY_GC_THREAD_REGION
+    // Small objects created by this thread come from its own part of the heap.
+    gc_thread_region_init();
+    #endif
+
     // set locals and globals from the calling context
     mp_locals_set(args->dict_locals);
     mp_globals_set(args->dict_globals);
@@ -212,6 +231,10 @@ STATIC void *thread_entry(void *args_in) {
 
     DEBUG_printf("[thread] finish ts=%p\n", &ts);
 
+    #if MICROPY_GC_THREAD_REGION
+    gc_thread_region_deinit();
+    #endif
+
     // signal that we are finished
     mp_thread_finish();
 
@@ -144,8 +144,10 @@
 //  - 01111111 11111110 00000000 00000000 qqqqqqqq qqqqqqqq qqqqqqqq qqqqqqq1 str
 //  - 01111111 11111111 ss000000 00000000 00000000 00000000 00000000 00000000 immediate object
 //  - 01111111 11111100 00000000 00000000 pppppppp pppppppp pppppppp pppppp00 ptr (4 byte alignment)
+//  - 01111111 11111100 pppppppp pppppppp pppppppp pppppppp pppppppp pppppp00 ptr on a 64-bit machine
 // Stored as O = R + 0x8004000000000000, retrieved as R = O - 0x8004000000000000.
-// This makes pointers have all zeros in the top 32 bits.
+// This makes pointers have all zeros in the top 32 bits, or in the top 16 bits
+// on a 64-bit machine, where this scheme requires pointers to fit in 48 bits.
 // Small-ints and strs have 1 as LSB to make sure they don't look like pointers
 // to the garbage collector.
 #define MICROPY_OBJ_REPR_D (3)
@@ -200,6 +202,14 @@
 #define MICROPY_GC_ALLOC_THRESHOLD (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
 #endif
 
+// Number of allocation sizes, from one block up, that each remember where to
+// start searching for free blocks.  Sizes above this search from the first
+// free block, so a run of allocations of that size is quadratic in the amount
+// of the heap in use.
+#ifndef MICROPY_GC_SIZE_CLASSES
+#define MICROPY_GC_SIZE_CLASSES (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES ? 4 : 1)
+#endif
+
 // Number of bytes to allocate initially when creating new chunks to store
 // interned string data.  Smaller numbers lead to more chunks being needed
 // and more wastage at the end of the chunk.  Larger numbers lead to wasted
@@ -223,7 +233,7 @@
 #define MICROPY_ALLOC_PARSE_RULE_INIT (64)
 #endif
 
-// Increment for parse rule stack
+// Minimum increment for parse rule stack (it grows by half its size)
 #ifndef MICROPY_ALLOC_PARSE_RULE_INC
 #define MICROPY_ALLOC_PARSE_RULE_INC (16)
 #endif
@@ -233,7 +243,7 @@
 #define MICROPY_ALLOC_PARSE_RESULT_INIT (32)
 #endif
 
-// Increment for parse result stack
+// Minimum increment for parse result stack (it grows by half its size)
 #ifndef MICROPY_ALLOC_PARSE_RESULT_INC
 #define MICROPY_ALLOC_PARSE_RESULT_INC (16)
 #endif
@@ -243,8 +253,9 @@
 #define MICROPY_ALLOC_PARSE_INTERN_STRING_LEN (10)
 #endif
 
-// Number of bytes to allocate initially when creating new chunks to store
-// parse nodes.  Small leads to fragmentation, large leads to excess use.
+// Number of bytes to allocate for the first chunk to store parse nodes, each
+// chunk after that is twice as big as the previous one.  Small leads to
+// fragmentation, large leads to excess use.
 #ifndef MICROPY_ALLOC_PARSE_CHUNK_INIT
 #define MICROPY_ALLOC_PARSE_CHUNK_INIT (128)
 #endif
@@ -332,7 +343,7 @@
 // generate .mpy files. Enabling this enables additional metadata on raw code
 // objects which is also required for sys.settrace.
 #ifndef MICROPY_PERSISTENT_CODE_SAVE
-#define MICROPY_PERSISTENT_CODE_SAVE (MICROPY_PY_SYS_SETTRACE)
+#define MICROPY_PERSISTENT_CODE_SAVE (MICROPY_PY_SYS_SETTRACE || MICROPY_MODULE_CACHE)
 #endif
 
 // Whether to support saving persistent code to a file via mp_raw_code_save_file
@@ -488,6 +499,14 @@
 #define MICROPY_COMP_RETURN_IF_EXPR (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Whether to enable peephole optimisation of bytecode when the optimisation
+// level is 1 or more: jumps to jumps go straight to the final destination, a
+// jump to "return None" is replaced by "return None", and code that can't be
+// reached because nothing jumps to it is removed
+#ifndef MICROPY_COMP_PEEPHOLE
+#define MICROPY_COMP_PEEPHOLE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 /*****************************************************************************/
 /* Internal debugging stuff                                                  */
 
@@ -565,6 +584,16 @@
 #define MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE (128)
 #endif
 
+// Use a table generated at build time (genhdr/maphints.h) of the position
+// of each static qstr in the builtin ROM maps, so that lookups in module
+// globals and type locals dicts usually find their key at the first probe
+// instead of relying on the shared map lookup cache or a linear search.
+// Costs one byte of ROM per static qstr. This is normally enabled from the
+// port's Makefile (or CMake) because the build must generate the header.
+#ifndef MICROPY_OPT_MAP_LOOKUP_ROM_HINT
+#define MICROPY_OPT_MAP_LOOKUP_ROM_HINT (0)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
@@ -862,6 +891,24 @@ typedef double mp_float_t;
 #define MICROPY_STREAMS_POSIX_API (0)
 #endif
 
+// Whether file (and other) stream objects can keep a read-ahead buffer, so
+// that small reads and readline() don't go to the device for each byte
+#ifndef MICROPY_STREAMS_READ_BUFFER
+#define MICROPY_STREAMS_READ_BUFFER (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// Size in bytes of the read-ahead buffer, allocated on the first small read
+// (also the chunk size used by mp_stream_copy)
+#ifndef MICROPY_STREAMS_READ_BUFFER_SIZE
+#define MICROPY_STREAMS_READ_BUFFER_SIZE (512)
+#endif
+
+// Whether the port provides mp_hal_stream_copy_fd(), which mp_stream_copy uses
+// to copy between streams with a file descriptor without a user-space buffer
+#ifndef MICROPY_STREAMS_COPY_FD
+#define MICROPY_STREAMS_COPY_FD (0)
+#endif
+
 // Whether modules can use MP_REGISTER_MODULE_DELEGATION() to delegate failed
 // attribute lookups to a custom handler function.
 #ifndef MICROPY_MODULE_ATTR_DELEGATION
@@ -900,6 +947,14 @@ typedef double mp_float_t;
 #define MICROPY_MODULE_OVERRIDE_MAIN_IMPORT (0)
 #endif
 
+// Whether to cache the bytecode of imported .py files in a __pycache__
+// directory next to them (if that directory exists), and load it from there
+// instead of compiling the .py file again while its contents are unchanged.
+// Requires MICROPY_PERSISTENT_CODE_LOAD and a port with a writable filesystem.
+#ifndef MICROPY_MODULE_CACHE
+#define MICROPY_MODULE_CACHE (0)
+#endif
+
 // Whether frozen modules are supported in the form of strings
 #ifndef MICROPY_MODULE_FROZEN_STR
 #define MICROPY_MODULE_FROZEN_STR (0)
@@ -910,6 +965,14 @@ typedef double mp_float_t;
 #define MICROPY_MODULE_FROZEN_MPY (0)
 #endif
 
+// Whether frozen .mpy modules that only define functions and constants can
+// have their globals pre-evaluated by mpy-tool into a ROM dict, so importing
+// them doesn't execute any code or allocate a module.  The globals of such a
+// module are read-only, like those of a built-in module.
+#ifndef MICROPY_MODULE_FROZEN_ROM_GLOBALS
+#define MICROPY_MODULE_FROZEN_ROM_GLOBALS (0)
+#endif
+
 // Convenience macro for whether frozen modules are supported
 #ifndef MICROPY_MODULE_FROZEN
 #define MICROPY_MODULE_FROZEN (MICROPY_MODULE_FROZEN_STR || MICROPY_MODULE_FROZEN_MPY)
@@ -1077,6 +1140,13 @@ typedef double mp_float_t;
 #define MICROPY_PY_BUILTINS_STR_OP_MODULO (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
 #endif
 
+// Number of parsed format strings cached for str.format and % formatting, so
+// that formatting again with the same string object only does the conversions
+// (0 to disable the cache)
+#ifndef MICROPY_PY_BUILTINS_STR_FORMAT_CACHE_SIZE
+#define MICROPY_PY_BUILTINS_STR_FORMAT_CACHE_SIZE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES ? 8 : 0)
+#endif
+
 // Whether str.partition()/str.rpartition() method provided
 #ifndef MICROPY_PY_BUILTINS_STR_PARTITION
 #define MICROPY_PY_BUILTINS_STR_PARTITION (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
@@ -1107,6 +1177,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_BUILTINS_MEMORYVIEW_ITEMSIZE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
 #endif
 
+// Whether to support memoryview.cast(), 2-dimensional and strided memoryviews,
+// and the memoryview.tobytes() and memoryview.tolist() methods
+#ifndef MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+#define MICROPY_PY_BUILTINS_MEMORYVIEW_ND (MICROPY_PY_BUILTINS_MEMORYVIEW && MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 // Whether to support set object
 #ifndef MICROPY_PY_BUILTINS_SET
 #define MICROPY_PY_BUILTINS_SET (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
@@ -1272,6 +1348,41 @@ typedef double mp_float_t;
 #define MICROPY_PY_MICROPYTHON_HEAP_LOCKED (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
 #endif
 
+// Whether to provide the "micropython.alloc_profile" function, which samples
+// heap allocations and counts them by the Python code that made them.  This
+// needs the GC, and makes the VM keep track of the running frames, which adds
+// to the cost of each call.
+#ifndef MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+#define MICROPY_PY_MICROPYTHON_ALLOC_PROFILE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
+#endif
+
+// Number of distinct call stacks the allocation profiler can count, and the
+// number of frames, innermost first, that it keeps of each one
+#ifndef MICROPY_PY_MICROPYTHON_ALLOC_PROFILE_SITES
+#define MICROPY_PY_MICROPYTHON_ALLOC_PROFILE_SITES (64)
+#endif
+#ifndef MICROPY_PY_MICROPYTHON_ALLOC_PROFILE_DEPTH
+#define MICROPY_PY_MICROPYTHON_ALLOC_PROFILE_DEPTH (6)
+#endif
+
+// Whether to count the opcodes, and pairs of consecutive opcodes, executed by
+// the VM, and the calls and time spent in each bytecode function, and provide
+// them with "micropython.vm_stats".  This slows down the VM and takes a lot of
+// RAM, so is only for finding out where time goes in real workloads.
+#ifndef MICROPY_PY_MICROPYTHON_VM_STATS
+#define MICROPY_PY_MICROPYTHON_VM_STATS (0)
+#endif
+
+// Number of bytecode functions that micropython.vm_stats can count calls to
+#ifndef MICROPY_PY_MICROPYTHON_VM_STATS_FUNCS
+#define MICROPY_PY_MICROPYTHON_VM_STATS_FUNCS (256)
+#endif
+
+// Fine-grained timestamp that calls are timed with for micropython.vm_stats
+#ifndef MICROPY_PY_MICROPYTHON_VM_STATS_TICKS
+#define MICROPY_PY_MICROPYTHON_VM_STATS_TICKS() mp_hal_ticks_cpu()
+#endif
+
 // Whether to provide "array" module. Note that large chunk of the
 // underlying code is shared with "bytearray" builtin type, so to
 // get real savings, it should be disabled too.
@@ -1285,6 +1396,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_ARRAY_SLICE_ASSIGN (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Whether to provide element-wise arithmetic functions (add, sub, mul, scale,
+// minimum, maximum, sum, dot) in the array module
+#ifndef MICROPY_PY_ARRAY_OPS
+#define MICROPY_PY_ARRAY_OPS (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 // Whether to support attrtuple type (MicroPython extension)
 // It provides space-efficient tuples with attribute access
 #ifndef MICROPY_PY_ATTRTUPLE
@@ -1396,11 +1513,21 @@ typedef double mp_float_t;
 #define MICROPY_PY_IO_BUFFEREDWRITER (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
 #endif
 
+// Whether to provide "io.BufferedReader" class
+#ifndef MICROPY_PY_IO_BUFFEREDREADER
+#define MICROPY_PY_IO_BUFFEREDREADER (MICROPY_STREAMS_READ_BUFFER && MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
+#endif
+
 // Whether to provide "struct" module
 #ifndef MICROPY_PY_STRUCT
 #define MICROPY_PY_STRUCT (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
 #endif
 
+// Whether to provide "struct.Struct" type and "struct.iter_unpack" function
+#ifndef MICROPY_PY_STRUCT_STRUCT
+#define MICROPY_PY_STRUCT_STRUCT (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 // Whether to provide "sys" module
 #ifndef MICROPY_PY_SYS
 #define MICROPY_PY_SYS (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
@@ -1476,6 +1603,13 @@ typedef double mp_float_t;
 #define MICROPY_PY_SYS_SETTRACE (0)
 #endif
 
+// Whether the VM keeps the chain of running bytecode frames, from
+// MP_STATE_THREAD(current_code_state) through each frame's prev_state, so
+// that profilers can see where the running code is
+#ifndef MICROPY_TRACK_FRAMES
+#define MICROPY_TRACK_FRAMES (MICROPY_PY_SYS_SETTRACE || MICROPY_PY_MICROPYTHON_ALLOC_PROFILE)
+#endif
+
 // Whether to provide "sys.getsizeof" function
 #ifndef MICROPY_PY_SYS_GETSIZEOF
 #define MICROPY_PY_SYS_GETSIZEOF (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EVERYTHING)
@@ -1572,6 +1706,50 @@ typedef double mp_float_t;
 #define MICROPY_PY_THREAD_GIL_VM_DIVISOR (32)
 #endif
 
+// Whether threads created by the _thread module allocate small objects from
+// their own region of the GC heap, without taking the GC mutex.  Requires a
+// build without the GIL and a compiler providing the __atomic builtins.
+#ifndef MICROPY_GC_THREAD_REGION
+#define MICROPY_GC_THREAD_REGION (0)
+#endif
+
+// Number of GC blocks reserved at a time for a thread's allocation region.
+// Must be a multiple of 4 (the number of blocks per allocation table byte).
+#ifndef MICROPY_GC_THREAD_REGION_BLOCKS
+#define MICROPY_GC_THREAD_REGION_BLOCKS (64)
+#endif
+
+// Largest allocation, in GC blocks, that is served from a thread's region.
+#ifndef MICROPY_GC_THREAD_REGION_MAX_ALLOC
+#define MICROPY_GC_THREAD_REGION_MAX_ALLOC (4)
+#endif
+
+// Called repeatedly while a collection waits for another thread to finish
+// allocating from its region, e.g. to give up the CPU to that thread.
+#ifndef MICROPY_GC_THREAD_REGION_WAIT
+#define MICROPY_GC_THREAD_REGION_WAIT()
+#endif
+
+// Whether to provide gc_arena_push/gc_arena_pop and micropython.arena(), which
+// make a thread allocate small objects from its own region of the heap while
+// an arena is active.  That region is then collected by itself, by tracing
+// from the rest of the heap instead of marking and sweeping all of it.
+// Requires a single heap, and MICROPY_GC_THREAD_REGION if threads run without
+// the GIL.
+#ifndef MICROPY_GC_ARENA
+#define MICROPY_GC_ARENA (0)
+#endif
+
+// Number of GC blocks in a thread's arena region.  Must be a multiple of 4.
+#ifndef MICROPY_GC_ARENA_BLOCKS
+#define MICROPY_GC_ARENA_BLOCKS (1024)
+#endif
+
+// Largest allocation, in GC blocks, that is served from an arena region.
+#ifndef MICROPY_GC_ARENA_MAX_ALLOC
+#define MICROPY_GC_ARENA_MAX_ALLOC (8)
+#endif
+
 // Extended modules
 
 #ifndef MICROPY_PY_ASYNCIO
@@ -1588,6 +1766,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_UCTYPES_NATIVE_C_TYPES (1)
 #endif
 
+// Whether to provide uctypes.compile, which pre-decodes a descriptor so
+// field access on structs created with it is faster
+#ifndef MICROPY_PY_UCTYPES_COMPILE
+#define MICROPY_PY_UCTYPES_COMPILE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 // Whether to provide "deflate" module (decompression-only by default)
 #ifndef MICROPY_PY_DEFLATE
 #define MICROPY_PY_DEFLATE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
@@ -1635,6 +1819,18 @@ typedef double mp_float_t;
 #define MICROPY_PY_RE_SUB (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Number of compiled patterns cached for module-level re.match/search/sub
+// calls that are passed a string pattern (0 to disable the cache)
+#ifndef MICROPY_PY_RE_CACHE_SIZE
+#define MICROPY_PY_RE_CACHE_SIZE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES ? 8 : 0)
+#endif
+
+// Whether to extract a literal prefix from each pattern at compile time and
+// use it to skip to candidate positions with memchr in search/split/sub
+#ifndef MICROPY_PY_RE_PREFILTER
+#define MICROPY_PY_RE_PREFILTER (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 #ifndef MICROPY_PY_HEAPQ
 #define MICROPY_PY_HEAPQ (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
@@ -1655,6 +1851,17 @@ typedef double mp_float_t;
 #define MICROPY_PY_HASHLIB_SHA256 (1)
 #endif
 
+// Whether to use the x86-64 SHA extensions for sha256 when the CPU supports
+// them (detected at runtime), falling back to portable C otherwise
+#ifndef MICROPY_PY_HASHLIB_SHA256_X64
+#define MICROPY_PY_HASHLIB_SHA256_X64 (0)
+#endif
+
+// Whether to provide hashlib.file_digest (requires bytearray)
+#ifndef MICROPY_PY_HASHLIB_FILE_DIGEST
+#define MICROPY_PY_HASHLIB_FILE_DIGEST (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES && MICROPY_PY_BUILTINS_BYTEARRAY)
+#endif
+
 #ifndef MICROPY_PY_CRYPTOLIB
 #define MICROPY_PY_CRYPTOLIB (0)
 #endif
@@ -1664,10 +1871,21 @@ typedef double mp_float_t;
 #define MICROPY_PY_CRYPTOLIB_CTR (0)
 #endif
 
+// Depends on MICROPY_PY_CRYPTOLIB
+#ifndef MICROPY_PY_CRYPTOLIB_GCM
+#define MICROPY_PY_CRYPTOLIB_GCM (0)
+#endif
+
 #ifndef MICROPY_PY_CRYPTOLIB_CONSTS
 #define MICROPY_PY_CRYPTOLIB_CONSTS (0)
 #endif
 
+// Whether to use x86-64 AES-NI and carry-less multiply for cryptolib when the
+// CPU supports them (detected at runtime), instead of the SSL library's AES
+#ifndef MICROPY_PY_CRYPTOLIB_X64
+#define MICROPY_PY_CRYPTOLIB_X64 (0)
+#endif
+
 #ifndef MICROPY_PY_BINASCII
 #define MICROPY_PY_BINASCII (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
@@ -1677,6 +1895,13 @@ typedef double mp_float_t;
 #define MICROPY_PY_BINASCII_CRC32 (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Whether to use x86-64 SSSE3 for the base64 and hex codecs, and carry-less
+// multiply (PCLMULQDQ) for crc32, when the CPU supports them (detected at
+// runtime), falling back to portable C otherwise
+#ifndef MICROPY_PY_BINASCII_X64
+#define MICROPY_PY_BINASCII_X64 (0)
+#endif
+
 #ifndef MICROPY_PY_RANDOM
 #define MICROPY_PY_RANDOM (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
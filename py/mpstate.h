@@ -93,6 +93,11 @@ typedef struct _mp_state_mem_area_t {
     byte *gc_pool_end;
 
     size_t gc_last_free_atb_index;
+    #if MICROPY_GC_SIZE_CLASSES > 1
+    // For allocations of 2, 3, ... blocks, the ATB index before which there is
+    // no run of free blocks long enough for them.
+    size_t gc_last_free_atb_index_sized[MICROPY_GC_SIZE_CLASSES - 1];
+    #endif
     size_t gc_last_used_block; // The block ID of the highest block allocated in the area
 } mp_state_mem_area_t;
 
@@ -135,6 +140,35 @@ typedef struct _mp_state_mem_t {
     // This is a global mutex used to make the GC thread-safe.
     mp_thread_mutex_t gc_mutex;
     #endif
+
+    #if MICROPY_GC_THREAD_REGION
+    // Threads that allocate from their own region, where to search for the
+    // next region, and whether a collection is in progress (in which case the
+    // regions must not be touched).
+    struct _mp_state_thread_t *gc_region_threads;
+    size_t gc_region_atb_index;
+    uint8_t gc_region_collecting;
+    #endif
+
+    #if MICROPY_GC_ARENA
+    // Blocks that a collection traces and sweeps: the whole heap, or just the
+    // arena region of the thread that is collecting it.
+    uint8_t *gc_trace_start;
+    uint8_t *gc_trace_end;
+    // Set when there's no room for an arena region, until a full collection.
+    bool gc_arena_no_room;
+    #endif
+
+    #if MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+    // Allocations left until the next one is sampled (0 when not profiling),
+    // the sampling period, the last sampled allocation if it's yet to be
+    // counted, and the number of sites counted so far.  These are accessed
+    // with gc_mutex held.
+    size_t gc_alloc_profile_countdown;
+    size_t gc_alloc_profile_period;
+    void *gc_alloc_profile_last;
+    size_t gc_alloc_profile_n_sites;
+    #endif
 } mp_state_mem_t;
 
 // This structure hold runtime and VM information.  It includes a section
@@ -270,6 +304,28 @@ typedef struct _mp_state_thread_t {
     // Locking of the GC is done per thread.
     uint16_t gc_lock_depth;
 
+    #if MICROPY_GC_THREAD_REGION
+    // State of this thread's allocation region, see gc_thread_region_init.
+    struct _mp_state_thread_t *gc_region_next;
+    uint8_t *gc_region_end;
+    uint8_t gc_region_busy;
+    bool gc_region_enabled;
+    #endif
+
+    #if MICROPY_GC_ARENA
+    // This thread's arena region, the end of the run of free blocks in it
+    // that objects are currently carved from, the number of bytes that were
+    // free in it after it was last collected and that have been used since,
+    // and the nesting depth of gc_arena_push.
+    uint8_t *gc_arena_start;
+    uint8_t *gc_arena_end;
+    uint8_t *gc_arena_limit;
+    size_t gc_arena_avail;
+    size_t gc_arena_used;
+    uint16_t gc_arena_depth;
+    bool gc_arena_collecting;
+    #endif
+
     ////////////////////////////////////////////////////////////
     // START ROOT POINTER SECTION
     // Everything that needs GC scanning must start here, and
@@ -282,6 +338,16 @@ typedef struct _mp_state_thread_t {
     nlr_buf_t *nlr_top;
     nlr_jump_callback_node_t *nlr_jump_callback_top;
 
+    #if MICROPY_GC_THREAD_REGION
+    // Head block of the unused part of this thread's allocation region.
+    uint8_t *gc_region_cur;
+    #endif
+
+    #if MICROPY_GC_ARENA
+    // Head block of the part of this thread's arena not yet carved up.
+    uint8_t *gc_arena_cur;
+    #endif
+
     // pending exception object (MP_OBJ_NULL if not pending)
     volatile mp_obj_t mp_pending_exception;
 
@@ -291,6 +357,8 @@ typedef struct _mp_state_thread_t {
     #if MICROPY_PY_SYS_SETTRACE
     mp_obj_t prof_trace_callback;
     bool prof_callback_is_executing;
+    #endif
+    #if MICROPY_TRACK_FRAMES
     struct _mp_code_state_t *current_code_state;
     #endif
 } mp_state_thread_t;
@@ -34,6 +34,7 @@
 #include "py/objint.h"
 #include "py/objstr.h"
 #include "py/runtime.h"
+#include "py/gc.h"
 #include "py/stackctrl.h"
 #include "py/stream.h" // for mp_obj_print
 
@@ -41,6 +42,11 @@
 MP_NOINLINE void *mp_obj_malloc_helper(size_t num_bytes, const mp_obj_type_t *type) {
     mp_obj_base_t *base = (mp_obj_base_t *)m_malloc(num_bytes);
     base->type = type;
+    #if MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+    if (base == MP_STATE_MEM(gc_alloc_profile_last)) {
+        gc_alloc_profile_commit(base, type->name);
+    }
+    #endif
     return base;
 }
 
@@ -256,12 +256,18 @@ static inline bool mp_obj_is_immediate_obj(mp_const_obj_t o) {
 #error MICROPY_OBJ_REPR_D requires MICROPY_FLOAT_IMPL_DOUBLE
 #endif
 
-#define mp_const_float_e {((mp_obj_t)((uint64_t)0x4005bf0a8b145769 + 0x8004000000000000))}
-#define mp_const_float_pi {((mp_obj_t)((uint64_t)0x400921fb54442d18 + 0x8004000000000000))}
+// rom float constants take the same form as other rom objects, see below
+#if UINTPTR_MAX == UINT64_MAX
+#define MP_ROM_FLOAT_BITS(r) ((mp_obj_t)((uint64_t)(r) + 0x8004000000000000))
+#else
+#define MP_ROM_FLOAT_BITS(r) {((mp_obj_t)((uint64_t)(r) + 0x8004000000000000))}
+#endif
+#define mp_const_float_e MP_ROM_FLOAT_BITS(0x4005bf0a8b145769)
+#define mp_const_float_pi MP_ROM_FLOAT_BITS(0x400921fb54442d18)
 #if MICROPY_PY_MATH_CONSTANTS
-#define mp_const_float_tau {((mp_obj_t)((uint64_t)0x401921fb54442d18 + 0x8004000000000000))}
-#define mp_const_float_inf {((mp_obj_t)((uint64_t)0x7ff0000000000000 + 0x8004000000000000))}
-#define mp_const_float_nan {((mp_obj_t)((uint64_t)0xfff8000000000000 + 0x8004000000000000))}
+#define mp_const_float_tau MP_ROM_FLOAT_BITS(0x401921fb54442d18)
+#define mp_const_float_inf MP_ROM_FLOAT_BITS(0x7ff0000000000000)
+#define mp_const_float_nan MP_ROM_FLOAT_BITS(0xfff8000000000000)
 #endif
 
 static inline bool mp_obj_is_float(mp_const_obj_t o) {
@@ -289,6 +295,13 @@ static inline bool mp_obj_is_obj(mp_const_obj_t o) {
 #define MP_OBJ_TO_PTR(o) ((void *)(uintptr_t)(o))
 #define MP_OBJ_FROM_PTR(p) ((mp_obj_t)((uintptr_t)(p)))
 
+#if UINTPTR_MAX == UINT64_MAX
+// on a 64-bit machine pointers are stored as they are, and must fit in 48 bits
+typedef mp_const_obj_t mp_rom_obj_t;
+#define MP_ROM_INT(i) MP_OBJ_NEW_SMALL_INT(i)
+#define MP_ROM_QSTR(q) MP_OBJ_NEW_QSTR(q)
+#define MP_ROM_PTR(p) ((mp_rom_obj_t)(uintptr_t)(p))
+#else
 // rom object storage needs special handling to widen 32-bit pointer to 64-bits
 typedef union _mp_rom_obj_t {
     uint64_t u64;
@@ -303,6 +316,7 @@ typedef union _mp_rom_obj_t {
 #else
 #define MP_ROM_PTR(p) {.u32 = {.lo = NULL, .hi = (p)}}
 #endif
+#endif
 
 #endif
 
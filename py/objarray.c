@@ -49,6 +49,10 @@
 //  - items points to the start of the original buffer
 // Note that we don't handle the case where the original buffer might change
 // size due to a resize of the original parent object.
+// A memoryview that is 2-dimensional or has a step other than 1 doesn't fit in
+// 4 words, and is instead a larger mp_obj_memoryview_nd_t with its own type
+// (see objarray.h).  Only memoryviews created by slicing or by cast() are like
+// this, so the common case still uses a single GC block.
 
 #if MICROPY_PY_BUILTINS_MEMORYVIEW
 #define TYPECODE_MASK (0x7f)
@@ -65,6 +69,13 @@ STATIC mp_obj_t array_iterator_new(mp_obj_t array_in, mp_obj_iter_buf_t *iter_bu
 STATIC mp_obj_t array_append(mp_obj_t self_in, mp_obj_t arg);
 STATIC mp_obj_t array_extend(mp_obj_t self_in, mp_obj_t arg_in);
 STATIC mp_int_t array_get_buffer(mp_obj_t o_in, mp_buffer_info_t *bufinfo, mp_uint_t flags);
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+STATIC const mp_obj_type_t mp_type_memoryview_nd;
+STATIC mp_obj_t memoryview_nd_iterator_new(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf);
+#define memview_is_nd(o) ((o)->base.type == &mp_type_memoryview_nd)
+#else
+#define array_get_read_buffer(o, bufinfo) mp_get_buffer((o), (bufinfo), MP_BUFFER_READ)
+#endif
 
 /******************************************************************************/
 // array
@@ -222,6 +233,15 @@ STATIC mp_obj_t memoryview_make_new(const mp_obj_type_t *type_in, size_t n_args,
 
     mp_arg_check_num(n_args, n_kw, 1, 1, false);
 
+    #if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+    if (mp_obj_is_type(args[0], &mp_type_memoryview_nd)) {
+        // copy the shape and strides as well, the buffer may not be contiguous
+        mp_obj_memoryview_nd_t *self = m_new_obj(mp_obj_memoryview_nd_t);
+        *self = *(mp_obj_memoryview_nd_t *)MP_OBJ_TO_PTR(args[0]);
+        return MP_OBJ_FROM_PTR(self);
+    }
+    #endif
+
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
 
@@ -245,24 +265,383 @@ STATIC mp_obj_t memoryview_make_new(const mp_obj_type_t *type_in, size_t n_args,
     return MP_OBJ_FROM_PTR(self);
 }
 
-#if MICROPY_PY_BUILTINS_MEMORYVIEW_ITEMSIZE
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+
+// Get the offset of the first element, and the shape and strides (in elements)
+// of a memoryview, returning the number of dimensions.  A 1-dimensional view
+// is described as a 2-dimensional one with rows of a single element, so
+// callers can always loop over both.
+STATIC size_t memoryview_get_layout(mp_obj_array_t *o, mp_int_t *offset, size_t *shape, mp_int_t *strides) {
+    *offset = o->memview_offset;
+    if (memview_is_nd(o)) {
+        mp_obj_memoryview_nd_t *nd = (mp_obj_memoryview_nd_t *)o;
+        shape[0] = nd->shape[0];
+        shape[1] = nd->shape[1];
+        strides[0] = nd->strides[0];
+        strides[1] = nd->strides[1];
+        return nd->ndim;
+    }
+    shape[0] = o->len;
+    shape[1] = 1;
+    strides[0] = 1;
+    strides[1] = 1;
+    return 1;
+}
+
+STATIC bool memoryview_is_contiguous(size_t ndim, const size_t *shape, const mp_int_t *strides) {
+    mp_int_t expected = 1;
+    for (size_t i = ndim; i-- > 0;) {
+        if (shape[i] > 1 && strides[i] != expected) {
+            return false;
+        }
+        expected *= shape[i];
+    }
+    return true;
+}
+
+// Create a view of the buffer of o, with the given typecode (including the
+// read-write flag), offset of the first element, shape and strides.
+STATIC mp_obj_t memoryview_new_view(mp_obj_array_t *o, size_t typecode, mp_int_t offset,
+    size_t ndim, const size_t *shape, const mp_int_t *strides) {
+    if (offset > memview_offset_max) {
+        mp_raise_msg(&mp_type_OverflowError, MP_ERROR_TEXT("memoryview offset too large"));
+    }
+    if (ndim == 1 && (strides[0] == 1 || shape[0] <= 1)) {
+        // Use a plain memoryview, which fits in a single GC block
+        mp_obj_array_t *res = m_new_obj(mp_obj_array_t);
+        mp_obj_memoryview_init(res, typecode, offset, shape[0], o->items);
+        return MP_OBJ_FROM_PTR(res);
+    }
+    mp_obj_memoryview_nd_t *res = m_new_obj(mp_obj_memoryview_nd_t);
+    mp_obj_memoryview_init(&res->base, typecode, offset, shape[0], o->items);
+    res->base.base.type = &mp_type_memoryview_nd;
+    res->ndim = ndim;
+    res->shape[0] = shape[0];
+    res->shape[1] = ndim == 2 ? shape[1] : 1;
+    res->strides[0] = strides[0];
+    res->strides[1] = ndim == 2 ? strides[1] : 1;
+    return MP_OBJ_FROM_PTR(res);
+}
+
+// Copy the elements of a memoryview, in row-major order, to the contiguous
+// buffer buf (if store is false) or from it (if store is true).
+STATIC void memoryview_copy(mp_obj_array_t *o, byte *buf, bool store) {
+    mp_int_t offset;
+    size_t shape[2];
+    mp_int_t strides[2];
+    memoryview_get_layout(o, &offset, shape, strides);
+    size_t sz = mp_binary_get_size('@', o->typecode & TYPECODE_MASK, NULL);
+    size_t row_len = shape[1] * sz;
+    for (size_t i = 0; i < shape[0]; ++i) {
+        byte *p = (byte *)o->items + (offset + (mp_int_t)i * strides[0]) * sz;
+        if (strides[1] == 1) {
+            // elements of a row are contiguous, so copy it in one go
+            if (store) {
+                memcpy(p, buf, row_len);
+            } else {
+                memcpy(buf, p, row_len);
+            }
+            buf += row_len;
+        } else {
+            for (size_t j = 0; j < shape[1]; ++j) {
+                if (store) {
+                    memcpy(p, buf, sz);
+                } else {
+                    memcpy(buf, p, sz);
+                }
+                p += strides[1] * (mp_int_t)sz;
+                buf += sz;
+            }
+        }
+    }
+}
+
+// Get the buffer of an object for reading, copying the elements of a
+// non-contiguous memoryview into a new contiguous buffer if needed.
+STATIC bool array_get_read_buffer(mp_obj_t o_in, mp_buffer_info_t *bufinfo) {
+    if (mp_get_buffer(o_in, bufinfo, MP_BUFFER_READ)) {
+        return true;
+    }
+    if (!mp_obj_is_type(o_in, &mp_type_memoryview_nd)) {
+        return false;
+    }
+    mp_obj_array_t *o = MP_OBJ_TO_PTR(o_in);
+    mp_obj_memoryview_nd_t *nd = MP_OBJ_TO_PTR(o_in);
+    bufinfo->typecode = o->typecode & TYPECODE_MASK;
+    bufinfo->len = nd->shape[0] * nd->shape[1] * mp_binary_get_size('@', bufinfo->typecode, NULL);
+    bufinfo->buf = m_new(byte, bufinfo->len);
+    memoryview_copy(o, bufinfo->buf, false);
+    return true;
+}
+
+// Store value into the elements of the memoryview o.
+STATIC void memoryview_assign(mp_obj_array_t *o, mp_obj_t value) {
+    mp_int_t lo;
+    size_t shape[2];
+    mp_int_t strides[2];
+    size_t ndim = memoryview_get_layout(o, &lo, shape, strides);
+    size_t sz = mp_binary_get_size('@', o->typecode & TYPECODE_MASK, NULL);
+    mp_buffer_info_t bufinfo;
+    if (!array_get_read_buffer(value, &bufinfo)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("object with buffer protocol required"));
+    }
+    if (bufinfo.len != shape[0] * shape[1] * sz
+        || mp_binary_get_size('@', bufinfo.typecode, NULL) != sz) {
+        mp_raise_ValueError(MP_ERROR_TEXT("lhs and rhs should be compatible"));
+    }
+
+    // If the source overlaps the destination then copy it first, because
+    // the elements are not necessarily stored in the same order.
+    mp_int_t hi = lo;
+    for (size_t i = 0; i < ndim; ++i) {
+        mp_int_t extent = (mp_int_t)(shape[i] - 1) * strides[i];
+        if (extent < 0) {
+            lo += extent;
+        } else {
+            hi += extent;
+        }
+    }
+    const byte *dest = o->items;
+    const byte *src = bufinfo.buf;
+    if (src < dest + (hi + 1) * (mp_int_t)sz && src + bufinfo.len > dest + lo * (mp_int_t)sz) {
+        byte *tmp = m_new(byte, bufinfo.len);
+        memcpy(tmp, src, bufinfo.len);
+        memoryview_copy(o, tmp, true);
+        m_del(byte, tmp, bufinfo.len);
+    } else {
+        memoryview_copy(o, bufinfo.buf, true);
+    }
+}
+
+// Subscript a memoryview which is non-contiguous or 2-dimensional, or with an
+// index that is a slice with a step or a tuple of indices and slices.
+STATIC mp_obj_t memoryview_nd_subscr(mp_obj_array_t *o, mp_obj_t index_in, mp_obj_t value) {
+    mp_int_t offset;
+    size_t shape[2];
+    mp_int_t strides[2];
+    size_t ndim = memoryview_get_layout(o, &offset, shape, strides);
+
+    const mp_obj_t *index = &index_in;
+    size_t n_index = 1;
+    if (mp_obj_is_type(index_in, &mp_type_tuple)) {
+        mp_obj_tuple_get(index_in, &n_index, (mp_obj_t **)&index);
+        if (n_index > ndim) {
+            mp_raise_TypeError(MP_ERROR_TEXT("too many indices"));
+        }
+    }
+
+    // Apply each index to its dimension, keeping the dimensions that are
+    // sliced or not indexed at all.
+    size_t new_ndim = 0;
+    size_t new_shape[2];
+    mp_int_t new_strides[2];
+    for (size_t i = 0; i < ndim; ++i) {
+        if (i >= n_index) {
+            new_shape[new_ndim] = shape[i];
+            new_strides[new_ndim++] = strides[i];
+        #if MICROPY_PY_BUILTINS_SLICE
+        } else if (mp_obj_is_type(index[i], &mp_type_slice)) {
+            mp_bound_slice_t slice;
+            mp_obj_slice_indices(index[i], shape[i], &slice);
+            mp_int_t len = 0;
+            if (slice.step > 0 && slice.stop > slice.start) {
+                len = (slice.stop - slice.start + slice.step - 1) / slice.step;
+            } else if (slice.step < 0 && slice.start > slice.stop) {
+                len = (slice.start - slice.stop - slice.step - 1) / -slice.step;
+            }
+            if (len > 0) {
+                offset += slice.start * strides[i];
+            }
+            new_shape[new_ndim] = len;
+            new_strides[new_ndim++] = slice.step * strides[i];
+        #endif
+        } else {
+            offset += mp_get_index(o->base.type, shape[i], index[i], false) * strides[i];
+        }
+    }
+
+    if (value != MP_OBJ_SENTINEL && !(o->typecode & MP_OBJ_ARRAY_TYPECODE_FLAG_RW)) {
+        // store to read-only memoryview
+        return MP_OBJ_NULL;
+    }
+
+    if (new_ndim == 0) {
+        // a single element
+        if (value == MP_OBJ_SENTINEL) {
+            return mp_binary_get_val_array(o->typecode & TYPECODE_MASK, o->items, offset);
+        }
+        mp_binary_set_val_array(o->typecode & TYPECODE_MASK, o->items, offset, value);
+        return mp_const_none;
+    }
+
+    mp_obj_t view = memoryview_new_view(o, o->typecode, offset, new_ndim, new_shape, new_strides);
+    if (value == MP_OBJ_SENTINEL) {
+        return view;
+    }
+    memoryview_assign(MP_OBJ_TO_PTR(view), value);
+    return mp_const_none;
+}
+
+STATIC mp_obj_t memoryview_cast(size_t n_args, const mp_obj_t *args) {
+    mp_obj_array_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    if (!mp_get_buffer(args[0], &bufinfo, MP_BUFFER_READ)) {
+        mp_raise_TypeError(MP_ERROR_TEXT("memoryview not contiguous"));
+    }
+
+    // get the new typecode, allowing the native size prefix
+    const char *fmt = mp_obj_str_get_str(args[1]);
+    if (*fmt == '@') {
+        ++fmt;
+    }
+    #if MICROPY_PY_BUILTINS_FLOAT
+    static const char typecodes[] = "bBhHiIlLqQfd";
+    #else
+    static const char typecodes[] = "bBhHiIlLqQ";
+    #endif
+    if (fmt[0] == '\0' || fmt[1] != '\0' || strchr(typecodes, fmt[0]) == NULL) {
+        mp_raise_ValueError(MP_ERROR_TEXT("bad typecode"));
+    }
+    size_t sz = mp_binary_get_size('@', fmt[0], NULL);
+    size_t byte_offset = (byte *)bufinfo.buf - (byte *)self->items;
+    if (bufinfo.len % sz != 0) {
+        mp_raise_TypeError(MP_ERROR_TEXT("memoryview: length is not a multiple of itemsize"));
+    }
+    if (((uintptr_t)self->items | byte_offset) % sz != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("memoryview not aligned"));
+    }
+
+    size_t ndim = 1;
+    size_t shape[2] = { bufinfo.len / sz, 1 };
+    mp_int_t strides[2] = { 1, 1 };
+    if (n_args > 2) {
+        size_t n_shape;
+        mp_obj_t *shape_items;
+        mp_obj_get_array(args[2], &n_shape, &shape_items);
+        if (n_shape < 1 || n_shape > 2) {
+            mp_raise_ValueError(MP_ERROR_TEXT("memoryview: number of dimensions must be 1 or 2"));
+        }
+        size_t n = 1;
+        for (size_t i = 0; i < n_shape; ++i) {
+            mp_int_t dim = mp_obj_get_int(shape_items[i]);
+            if (dim <= 0) {
+                n = 0;
+                break;
+            }
+            if (n > MP_SSIZE_MAX / (size_t)dim) {
+                mp_raise_ValueError(MP_ERROR_TEXT("memoryview: product(shape) too large"));
+            }
+            shape[i] = dim;
+            n *= dim;
+        }
+        if (n != bufinfo.len / sz) {
+            mp_raise_TypeError(MP_ERROR_TEXT("memoryview: product(shape) * itemsize != buffer size"));
+        }
+        ndim = n_shape;
+        if (ndim == 2) {
+            strides[0] = shape[1];
+        }
+    }
+
+    size_t typecode = fmt[0] | (self->typecode & MP_OBJ_ARRAY_TYPECODE_FLAG_RW);
+    return memoryview_new_view(self, typecode, byte_offset / sz, ndim, shape, strides);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(memoryview_cast_obj, 2, 3, memoryview_cast);
+
+STATIC mp_obj_t memoryview_tobytes(mp_obj_t self_in) {
+    mp_buffer_info_t bufinfo;
+    if (mp_get_buffer(self_in, &bufinfo, MP_BUFFER_READ)) {
+        // contiguous, so can copy directly from the buffer
+        return mp_obj_new_bytes(bufinfo.buf, bufinfo.len);
+    }
+    mp_obj_memoryview_nd_t *self = MP_OBJ_TO_PTR(self_in);
+    size_t sz = mp_binary_get_size('@', self->base.typecode & TYPECODE_MASK, NULL);
+    vstr_t vstr;
+    vstr_init_len(&vstr, self->shape[0] * self->shape[1] * sz);
+    memoryview_copy(&self->base, (byte *)vstr.buf, false);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(memoryview_tobytes_obj, memoryview_tobytes);
+
+STATIC mp_obj_t memoryview_tolist(mp_obj_t self_in) {
+    mp_obj_array_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_int_t offset;
+    size_t shape[2];
+    mp_int_t strides[2];
+    size_t ndim = memoryview_get_layout(self, &offset, shape, strides);
+    size_t typecode = self->typecode & TYPECODE_MASK;
+    mp_obj_t list = mp_obj_new_list(shape[0], NULL);
+    size_t len;
+    mp_obj_t *items;
+    mp_obj_list_get(list, &len, &items);
+    for (size_t i = 0; i < shape[0]; ++i) {
+        mp_int_t row = offset + (mp_int_t)i * strides[0];
+        if (ndim == 1) {
+            items[i] = mp_binary_get_val_array(typecode, self->items, row);
+        } else {
+            mp_obj_t row_list = mp_obj_new_list(shape[1], NULL);
+            mp_obj_t *row_items;
+            mp_obj_list_get(row_list, &len, &row_items);
+            for (size_t j = 0; j < shape[1]; ++j) {
+                row_items[j] = mp_binary_get_val_array(typecode, self->items, row + (mp_int_t)j * strides[1]);
+            }
+            items[i] = row_list;
+        }
+    }
+    return list;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(memoryview_tolist_obj, memoryview_tolist);
+
+STATIC const mp_rom_map_elem_t memoryview_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_cast), MP_ROM_PTR(&memoryview_cast_obj) },
+    #if MICROPY_PY_BUILTINS_BYTES_HEX
+    { MP_ROM_QSTR(MP_QSTR_hex), MP_ROM_PTR(&mp_obj_bytes_hex_as_str_obj) },
+    #endif
+    { MP_ROM_QSTR(MP_QSTR_tobytes), MP_ROM_PTR(&memoryview_tobytes_obj) },
+    { MP_ROM_QSTR(MP_QSTR_tolist), MP_ROM_PTR(&memoryview_tolist_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(memoryview_locals_dict, memoryview_locals_dict_table);
+
+#endif // MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_ITEMSIZE || MICROPY_PY_BUILTINS_MEMORYVIEW_ND
 STATIC void memoryview_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
     if (dest[0] != MP_OBJ_NULL) {
         return;
     }
+    mp_obj_array_t *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_PY_BUILTINS_MEMORYVIEW_ITEMSIZE
     if (attr == MP_QSTR_itemsize) {
-        mp_obj_array_t *self = MP_OBJ_TO_PTR(self_in);
         dest[0] = MP_OBJ_NEW_SMALL_INT(mp_binary_get_size('@', self->typecode & TYPECODE_MASK, NULL));
+        return;
     }
-    #if MICROPY_PY_BUILTINS_BYTES_HEX
-    else {
+    #endif
+    #if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+    mp_int_t offset;
+    size_t shape[2];
+    mp_int_t strides[2];
+    size_t ndim = memoryview_get_layout(self, &offset, shape, strides);
+    if (attr == MP_QSTR_ndim) {
+        dest[0] = MP_OBJ_NEW_SMALL_INT(ndim);
+    } else if (attr == MP_QSTR_shape || attr == MP_QSTR_strides) {
+        // strides are in bytes, as in CPython
+        size_t sz = mp_binary_get_size('@', self->typecode & TYPECODE_MASK, NULL);
+        mp_obj_t items[2];
+        for (size_t i = 0; i < ndim; ++i) {
+            items[i] = mp_obj_new_int(attr == MP_QSTR_shape ? (mp_int_t)shape[i] : strides[i] * (mp_int_t)sz);
+        }
+        dest[0] = mp_obj_new_tuple(ndim, items);
+    } else {
         // Need to forward to locals dict.
         dest[1] = MP_OBJ_SENTINEL;
     }
+    #elif MICROPY_PY_BUILTINS_BYTES_HEX
+    // Need to forward to locals dict.
+    dest[1] = MP_OBJ_SENTINEL;
     #endif
 }
 #endif
-
 #endif
 
 STATIC mp_obj_t array_unary_op(mp_unary_op_t op, mp_obj_t o_in) {
@@ -355,8 +734,8 @@ STATIC mp_obj_t array_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs
         case MP_BINARY_OP_MORE_EQUAL: {
             mp_buffer_info_t lhs_bufinfo;
             mp_buffer_info_t rhs_bufinfo;
-            array_get_buffer(lhs_in, &lhs_bufinfo, MP_BUFFER_READ);
-            if (!mp_get_buffer(rhs_in, &rhs_bufinfo, MP_BUFFER_READ)) {
+            array_get_read_buffer(lhs_in, &lhs_bufinfo);
+            if (!array_get_read_buffer(rhs_in, &rhs_bufinfo)) {
                 return mp_const_false;
             }
             // mp_seq_cmp_bytes is used so only compatible representations can be correctly compared.
@@ -446,10 +825,20 @@ STATIC mp_obj_t array_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_obj_t value
         return MP_OBJ_NULL; // op not supported
     } else {
         mp_obj_array_t *o = MP_OBJ_TO_PTR(self_in);
+        #if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+        if (memview_is_nd(o) || (o->base.type == &mp_type_memoryview && mp_obj_is_type(index_in, &mp_type_tuple))) {
+            return memoryview_nd_subscr(o, index_in, value);
+        }
+        #endif
         #if MICROPY_PY_BUILTINS_SLICE
         if (mp_obj_is_type(index_in, &mp_type_slice)) {
             mp_bound_slice_t slice;
             if (!mp_seq_get_fast_slice_indexes(o->len, index_in, &slice)) {
+                #if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+                if (o->base.type == &mp_type_memoryview) {
+                    return memoryview_nd_subscr(o, index_in, value);
+                }
+                #endif
                 mp_raise_NotImplementedError(MP_ERROR_TEXT("only slices with step=1 (aka None) are supported"));
             }
             if (value != MP_OBJ_SENTINEL) {
@@ -471,6 +860,14 @@ STATIC mp_obj_t array_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_obj_t value
                     if (mp_obj_is_type(value, &mp_type_memoryview)) {
                         src_items = (uint8_t *)src_items + (src_slice->memview_offset * item_sz);
                     }
+                    #if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+                    if (memview_is_nd(src_slice)) {
+                        mp_buffer_info_t bufinfo;
+                        array_get_read_buffer(value, &bufinfo);
+                        src_len = bufinfo.len / item_sz;
+                        src_items = bufinfo.buf;
+                    }
+                    #endif
                     #endif
                 } else if (mp_obj_is_type(value, &mp_type_bytes)) {
                     if (item_sz != 1) {
@@ -621,13 +1018,15 @@ MP_DEFINE_CONST_OBJ_TYPE(
 #endif
 
 #if MICROPY_PY_BUILTINS_MEMORYVIEW
-#if MICROPY_PY_BUILTINS_MEMORYVIEW_ITEMSIZE
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_ITEMSIZE || MICROPY_PY_BUILTINS_MEMORYVIEW_ND
 #define MEMORYVIEW_TYPE_ATTR attr, memoryview_attr,
 #else
 #define MEMORYVIEW_TYPE_ATTR
 #endif
 
-#if MICROPY_PY_BUILTINS_BYTES_HEX
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+#define MEMORYVIEW_TYPE_LOCALS_DICT locals_dict, &memoryview_locals_dict,
+#elif MICROPY_PY_BUILTINS_BYTES_HEX
 #define MEMORYVIEW_TYPE_LOCALS_DICT locals_dict, &mp_obj_memoryview_locals_dict,
 #else
 #define MEMORYVIEW_TYPE_LOCALS_DICT
@@ -646,6 +1045,44 @@ MP_DEFINE_CONST_OBJ_TYPE(
     subscr, array_subscr,
     buffer, array_get_buffer
     );
+
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+STATIC mp_obj_t memoryview_nd_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs_in) {
+    if (op == MP_BINARY_OP_ADD || op == MP_BINARY_OP_INPLACE_ADD) {
+        return MP_OBJ_NULL; // op not supported
+    }
+    return array_binary_op(op, lhs_in, rhs_in);
+}
+
+// Only a view whose elements are in order and contiguous can export a buffer.
+STATIC mp_int_t memoryview_nd_get_buffer(mp_obj_t o_in, mp_buffer_info_t *bufinfo, mp_uint_t flags) {
+    mp_obj_memoryview_nd_t *o = MP_OBJ_TO_PTR(o_in);
+    if ((!(o->base.typecode & MP_OBJ_ARRAY_TYPECODE_FLAG_RW) && (flags & MP_BUFFER_WRITE))
+        || !memoryview_is_contiguous(o->ndim, o->shape, o->strides)) {
+        return 1;
+    }
+    size_t sz = mp_binary_get_size('@', o->base.typecode & TYPECODE_MASK, NULL);
+    bufinfo->buf = (uint8_t *)o->base.items + (size_t)o->base.memview_offset * sz;
+    bufinfo->len = o->shape[0] * o->shape[1] * sz;
+    bufinfo->typecode = o->base.typecode & TYPECODE_MASK;
+    return 0;
+}
+
+STATIC MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_memoryview_nd,
+    MP_QSTR_memoryview,
+    MP_TYPE_FLAG_EQ_CHECKS_OTHER_TYPE | MP_TYPE_FLAG_ITER_IS_GETITER,
+    make_new, memoryview_make_new,
+    iter, memoryview_nd_iterator_new,
+    unary_op, array_unary_op,
+    binary_op, memoryview_nd_binary_op,
+    locals_dict, &memoryview_locals_dict,
+    attr, memoryview_attr,
+    subscr, array_subscr,
+    buffer, memoryview_nd_get_buffer,
+    parent, &mp_type_memoryview
+    );
+#endif
 #endif // MICROPY_PY_BUILTINS_MEMORYVIEW
 
 /* unused
@@ -654,6 +1091,13 @@ size_t mp_obj_array_len(mp_obj_t self_in) {
 }
 */
 
+#if MICROPY_PY_ARRAY
+// Create array with given typecode and n uninitialised elements
+mp_obj_t mp_obj_new_array(char typecode, size_t n) {
+    return MP_OBJ_FROM_PTR(array_new(typecode, n));
+}
+#endif
+
 #if MICROPY_PY_BUILTINS_BYTEARRAY
 mp_obj_t mp_obj_new_bytearray(size_t n, const void *items) {
     mp_obj_array_t *o = array_new(BYTEARRAY_TYPECODE, n);
@@ -698,6 +1142,26 @@ STATIC MP_DEFINE_CONST_OBJ_TYPE(
     iter, array_it_iternext
     );
 
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+// Iterate a non-contiguous or 2-dimensional memoryview, yielding its elements
+// or rows.
+STATIC mp_obj_t memoryview_nd_it_iternext(mp_obj_t self_in) {
+    mp_obj_array_it_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->cur < self->array->len) {
+        return memoryview_nd_subscr(self->array, MP_OBJ_NEW_SMALL_INT(self->cur++), MP_OBJ_SENTINEL);
+    } else {
+        return MP_OBJ_STOP_ITERATION;
+    }
+}
+
+STATIC MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_memoryview_nd_it,
+    MP_QSTR_iterator,
+    MP_TYPE_FLAG_ITER_IS_ITERNEXT,
+    iter, memoryview_nd_it_iternext
+    );
+#endif
+
 STATIC mp_obj_t array_iterator_new(mp_obj_t array_in, mp_obj_iter_buf_t *iter_buf) {
     assert(sizeof(mp_obj_array_t) <= sizeof(mp_obj_iter_buf_t));
     mp_obj_array_t *array = MP_OBJ_TO_PTR(array_in);
@@ -714,4 +1178,12 @@ STATIC mp_obj_t array_iterator_new(mp_obj_t array_in, mp_obj_iter_buf_t *iter_bu
     return MP_OBJ_FROM_PTR(o);
 }
 
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+STATIC mp_obj_t memoryview_nd_iterator_new(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf) {
+    mp_obj_array_it_t *o = MP_OBJ_TO_PTR(array_iterator_new(self_in, iter_buf));
+    o->base.type = &mp_type_memoryview_nd_it;
+    return MP_OBJ_FROM_PTR(o);
+}
+#endif
+
 #endif // MICROPY_PY_ARRAY || MICROPY_PY_BUILTINS_BYTEARRAY || MICROPY_PY_BUILTINS_MEMORYVIEW
@@ -52,6 +52,19 @@ typedef struct _mp_obj_array_t {
     void *items;
 } mp_obj_array_t;
 
+#if MICROPY_PY_BUILTINS_MEMORYVIEW_ND
+// A memoryview which is 2-dimensional, or whose elements are not contiguous.
+// Its type is a subclass of memoryview, the free member of base is the offset
+// (in elements) of its first element, and len is the same as shape[0].  The
+// strides are in elements and may be negative.
+typedef struct _mp_obj_memoryview_nd_t {
+    mp_obj_array_t base;
+    size_t ndim;
+    size_t shape[2];
+    mp_int_t strides[2];
+} mp_obj_memoryview_nd_t;
+#endif
+
 #if MICROPY_PY_BUILTINS_MEMORYVIEW
 static inline void mp_obj_memoryview_init(mp_obj_array_t *self, size_t typecode, size_t offset, size_t len, void *items) {
     self->base.type = &mp_type_memoryview;
@@ -62,6 +75,10 @@ static inline void mp_obj_memoryview_init(mp_obj_array_t *self, size_t typecode,
 }
 #endif
 
+#if MICROPY_PY_ARRAY
+mp_obj_t mp_obj_new_array(char typecode, size_t n);
+#endif
+
 #if MICROPY_PY_ARRAY || MICROPY_PY_BUILTINS_BYTEARRAY
 MP_DECLARE_CONST_FUN_OBJ_2(mp_obj_array_append_obj);
 MP_DECLARE_CONST_FUN_OBJ_2(mp_obj_array_extend_obj);
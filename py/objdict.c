@@ -646,7 +646,7 @@ void mp_obj_dict_init(mp_obj_dict_t *dict, size_t n_args) {
 }
 
 mp_obj_t mp_obj_new_dict(size_t n_args) {
-    mp_obj_dict_t *o = m_new_obj(mp_obj_dict_t);
+    mp_obj_dict_t *o = mp_obj_malloc(mp_obj_dict_t, &mp_type_dict);
     mp_obj_dict_init(o, n_args);
     return MP_OBJ_FROM_PTR(o);
 }
@@ -31,6 +31,7 @@
 
 #include "py/parsenum.h"
 #include "py/runtime.h"
+#include "py/gc.h"
 
 #if MICROPY_PY_BUILTINS_FLOAT
 
@@ -196,6 +197,11 @@ mp_obj_t mp_obj_new_float(mp_float_t value) {
     // Don't use mp_obj_malloc here to avoid extra function call overhead.
     mp_obj_float_t *o = m_new_obj(mp_obj_float_t);
     o->base.type = &mp_type_float;
+    #if MICROPY_PY_MICROPYTHON_ALLOC_PROFILE
+    if (o == MP_STATE_MEM(gc_alloc_profile_last)) {
+        gc_alloc_profile_commit(o, MP_QSTR_float);
+    }
+    #endif
     o->value = value;
     return MP_OBJ_FROM_PTR(o);
 }
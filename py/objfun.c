@@ -270,7 +270,13 @@ STATIC mp_obj_t fun_bc_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const
 
     // execute the byte code with the correct globals context
     mp_globals_set(self->context->module.globals);
+    #if MICROPY_PY_MICROPYTHON_VM_STATS
+    uint64_t vm_stats_start = mp_vm_stats_ticks();
+    #endif
     mp_vm_return_kind_t vm_return_kind = mp_execute_bytecode(code_state, MP_OBJ_NULL);
+    #if MICROPY_PY_MICROPYTHON_VM_STATS
+    mp_vm_stats_call(self, vm_stats_start);
+    #endif
     mp_globals_set(code_state->old_globals);
 
     #if MICROPY_DEBUG_VM_STACK_OVERFLOW
@@ -43,6 +43,21 @@ typedef struct _mp_obj_fun_bc_t {
     mp_obj_t extra_args[];
 } mp_obj_fun_bc_t;
 
+#if MICROPY_MODULE_FROZEN_ROM_GLOBALS
+// Same layout as mp_obj_fun_bc_t, for functions of frozen modules that are
+// created by mpy-tool in ROM.
+typedef struct _mp_rom_obj_fun_bc_t {
+    mp_obj_base_t base;
+    const mp_module_context_t *context;
+    struct _mp_raw_code_t *const *child_table;
+    const byte *bytecode;
+    #if MICROPY_PY_SYS_SETTRACE
+    const struct _mp_raw_code_t *rc;
+    #endif
+    mp_rom_obj_t extra_args[];
+} mp_rom_obj_fun_bc_t;
+#endif
+
 mp_obj_t mp_obj_new_fun_bc(const mp_obj_t *def_args, const byte *code, const mp_module_context_t *cm, struct _mp_raw_code_t *const *raw_code_table);
 mp_obj_t mp_obj_new_fun_native(const mp_obj_t *def_args, const void *fun_data, const mp_module_context_t *cm, struct _mp_raw_code_t *const *raw_code_table);
 mp_obj_t mp_obj_new_fun_asm(size_t n_args, const void *fun_data, mp_uint_t type_sig);
@@ -216,7 +216,13 @@ mp_vm_return_kind_t mp_obj_gen_resume(mp_obj_t self_in, mp_obj_t send_value, mp_
     #endif
     {
         // A bytecode generator
+        #if MICROPY_PY_MICROPYTHON_VM_STATS
+        uint64_t vm_stats_start = mp_vm_stats_ticks();
+        #endif
         ret_kind = mp_execute_bytecode(&self->code_state, throw_value);
+        #if MICROPY_PY_MICROPYTHON_VM_STATS
+        mp_vm_stats_call(self->code_state.fun_bc, vm_stats_start);
+        #endif
     }
 
     mp_globals_set(self->code_state.old_globals);
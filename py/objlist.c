@@ -475,7 +475,7 @@ void mp_obj_list_init(mp_obj_list_t *o, size_t n) {
 }
 
 STATIC mp_obj_list_t *list_new(size_t n) {
-    mp_obj_list_t *o = m_new_obj(mp_obj_list_t);
+    mp_obj_list_t *o = mp_obj_malloc(mp_obj_list_t, &mp_type_list);
     mp_obj_list_init(o, n);
     return o;
 }
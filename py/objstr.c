@@ -992,16 +992,450 @@ STATIC NORETURN void terse_str_format_value_error(void) {
 #define terse_str_format_value_error()
 #endif
 
-STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *arg_i, size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
+#define STR_FORMAT_USE_CACHE (MICROPY_PY_BUILTINS_STR_FORMAT_CACHE_SIZE > 0)
+
+// Marks a % width or precision that is taken from the arguments.
+#define STR_MODULO_STAR (-2)
+
+// A parsed format specifier, for both str.format and % formatting.
+typedef struct _str_format_spec_t {
+    int flags;
+    int width;
+    int precision;
+    char fill;
+    char align;
+    char type;
+    bool zero; // str.format: '0' given without an alignment
+    bool alt; // %: '#' given
+} str_format_spec_t;
+
+// A format string is parsed into a sequence of literal runs, each followed by
+// an optional field, so that formatting again with the same string object only
+// needs to look up and convert the arguments.
+typedef struct _str_format_field_t {
+    const char *lit;
+    size_t lit_len;
+    bool has_field;
+    bool has_spec; // str.format: whether a format specifier was given
+    char conversion; // str.format: 's', 'r' or '\0'
+    int index; // str.format: index of the positional argument
+    mp_obj_t key; // keyword or dict key of the argument, else MP_OBJ_NULL
+    str_format_spec_t spec;
+} str_format_field_t;
+
+typedef struct _str_format_t {
+    mp_obj_t fmt;
+    bool is_modulo;
+    size_t out_len; // length of the last output, used to size the next one
+    size_t n_fields;
+    str_format_field_t fields[];
+} str_format_t;
+
+#if STR_FORMAT_USE_CACHE
+
+// Look up a parsed format string in the cache, moving it to the front if found.
+STATIC str_format_t *str_format_cache_lookup(mp_obj_t fmt, bool is_modulo) {
+    str_format_t **cache = MP_STATE_VM(str_format_cache);
+    for (size_t i = 0; i < MICROPY_PY_BUILTINS_STR_FORMAT_CACHE_SIZE; ++i) {
+        str_format_t *t = cache[i];
+        if (t == NULL) {
+            break;
+        }
+        if (t->fmt == fmt && t->is_modulo == is_modulo) {
+            // Entries are single pointers and never modified once inserted
+            // (apart from the out_len hint), so a concurrent update can only
+            // lose or duplicate an entry.
+            memmove(&cache[1], &cache[0], i * sizeof(*cache));
+            cache[0] = t;
+            return t;
+        }
+    }
+    return NULL;
+}
+
+// Insert a parsed format string at the front of the cache, evicting the least
+// recently used entry if the cache is full.
+STATIC void str_format_cache_insert(str_format_t *t) {
+    str_format_t **cache = MP_STATE_VM(str_format_cache);
+    memmove(&cache[1], &cache[0], (MICROPY_PY_BUILTINS_STR_FORMAT_CACHE_SIZE - 1) * sizeof(*cache));
+    cache[0] = t;
+}
+
+// Allocate a parsed format string to be recorded while formatting with fmt for
+// the first time.  The number of fields is at most one more than the number of
+// occurrences of c1 or c2, because each field ends with one of them.  Returns
+// NULL if there's not enough memory, in which case the string isn't cached.
+STATIC str_format_t *str_format_new(mp_obj_t fmt, bool is_modulo, const byte *str, size_t len, byte c1, byte c2) {
+    size_t max_fields = 1;
+    for (const byte *top = str + len; str < top; ++str) {
+        if (*str == c1 || *str == c2) {
+            ++max_fields;
+        }
+    }
+    str_format_t *rec = m_new_obj_var_maybe(str_format_t, fields, str_format_field_t, max_fields);
+    if (rec != NULL) {
+        rec->fmt = fmt;
+        rec->is_modulo = is_modulo;
+        rec->n_fields = 0;
+    }
+    return rec;
+}
+
+// Append a field (if recording) whose literal run goes from lit to str.
+STATIC str_format_field_t *str_format_record(str_format_t *rec, const char *lit, const char *str) {
+    if (rec == NULL) {
+        return NULL;
+    }
+    str_format_field_t *f = &rec->fields[rec->n_fields++];
+    f->lit = lit;
+    f->lit_len = str - lit;
+    f->has_field = false;
+    f->key = MP_OBJ_NULL;
+    return f;
+}
+
+#else
+
+static inline str_format_field_t *str_format_record(str_format_t *rec, const char *lit, const char *str) {
+    (void)rec;
+    (void)lit;
+    (void)str;
+    return NULL;
+}
+
+#endif
+
+// Parse a str.format format specifier, which must be null terminated, returning
+// false if it's invalid.  The format specifier (from
+// http://docs.python.org/2/library/string.html#formatspec) is:
+//
+// [[fill]align][sign][#][0][width][,][.precision][type]
+// fill        ::=  <any character>
+// align       ::=  "<" | ">" | "=" | "^"
+// sign        ::=  "+" | "-" | " "
+// width       ::=  integer
+// precision   ::=  integer
+// type        ::=  "b" | "c" | "d" | "e" | "E" | "f" | "F" | "g" | "G" | "n" | "o" | "s" | "x" | "X" | "%"
+STATIC bool str_format_parse_spec(const char *s, const char *stop, str_format_spec_t *spec) {
+    spec->fill = '\0';
+    spec->align = '\0';
+    spec->width = -1;
+    spec->precision = -1;
+    spec->type = '\0';
+    spec->flags = 0;
+    spec->zero = false;
+    if (isalignment(*s)) {
+        spec->align = *s++;
+    } else if (*s && isalignment(s[1])) {
+        spec->fill = *s++;
+        spec->align = *s++;
+    }
+    if (*s == '+' || *s == '-' || *s == ' ') {
+        if (*s == '+') {
+            spec->flags |= PF_FLAG_SHOW_SIGN;
+        } else if (*s == ' ') {
+            spec->flags |= PF_FLAG_SPACE_SIGN;
+        }
+        s++;
+    }
+    if (*s == '#') {
+        spec->flags |= PF_FLAG_SHOW_PREFIX;
+        s++;
+    }
+    if (*s == '0') {
+        // A numeric argument gets '=' alignment if none was given.
+        spec->zero = !spec->align;
+        if (!spec->fill) {
+            spec->fill = '0';
+        }
+    }
+    s = str_to_int(s, stop, &spec->width);
+    if (*s == ',') {
+        spec->flags |= PF_FLAG_SHOW_COMMA;
+        s++;
+    }
+    if (*s == '.') {
+        s++;
+        s = str_to_int(s, stop, &spec->precision);
+    }
+    if (istype(*s)) {
+        spec->type = *s++;
+    }
+    return *s == '\0';
+}
+
+// Output a single str.format replacement field for the given argument, with a
+// conversion of 's', 'r' or '\0' and a format specifier (NULL if none given).
+STATIC void str_format_field(const mp_print_t *print, mp_obj_t arg, char conversion, const str_format_spec_t *spec) {
+    if (spec == NULL) {
+        // {} is the same as {!s}, and without a format specifier the converted
+        // argument is output as is.
+        // This makes a difference when passing in a True or False
+        // '{}'.format(True) returns 'True'
+        // '{:d}'.format(True) returns '1'
+        mp_obj_print_helper(print, arg, conversion == 'r' ? PRINT_REPR : PRINT_STR);
+        return;
+    }
+
+    if (conversion) {
+        mp_print_kind_t print_kind;
+        if (conversion == 's') {
+            print_kind = PRINT_STR;
+        } else {
+            assert(conversion == 'r');
+            print_kind = PRINT_REPR;
+        }
+        vstr_t arg_vstr;
+        mp_print_t arg_print;
+        vstr_init_print(&arg_vstr, 16, &arg_print);
+        mp_obj_print_helper(&arg_print, arg, print_kind);
+        arg = mp_obj_new_str_type_from_vstr(&mp_type_str, &arg_vstr);
+    }
+
+    char fill = spec->fill;
+    char align = spec->align;
+    int width = spec->width;
+    int precision = spec->precision;
+    char type = spec->type;
+    int flags = spec->flags;
+
+    if (spec->zero && arg_looks_numeric(arg)) {
+        align = '=';
+    }
+    if (!align) {
+        if (arg_looks_numeric(arg)) {
+            align = '>';
+        } else {
+            align = '<';
+        }
+    }
+    if (!fill) {
+        fill = ' ';
+    }
+
+    if (flags & (PF_FLAG_SHOW_SIGN | PF_FLAG_SPACE_SIGN)) {
+        if (type == 's') {
+            #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
+            terse_str_format_value_error();
+            #else
+            mp_raise_ValueError(MP_ERROR_TEXT("sign not allowed in string format specifier"));
+            #endif
+        }
+        if (type == 'c') {
+            #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
+            terse_str_format_value_error();
+            #else
+            mp_raise_ValueError(
+                MP_ERROR_TEXT("sign not allowed with integer format specifier 'c'"));
+            #endif
+        }
+    }
+
+    switch (align) {
+        case '<':
+            flags |= PF_FLAG_LEFT_ADJUST;
+            break;
+        case '=':
+            flags |= PF_FLAG_PAD_AFTER_SIGN;
+            break;
+        case '^':
+            flags |= PF_FLAG_CENTER_ADJUST;
+            break;
+    }
+
+    if (arg_looks_integer(arg)) {
+        switch (type) {
+            case 'b':
+                mp_print_mp_int(print, arg, 2, 'a', flags, fill, width, 0);
+                return;
+
+            case 'c': {
+                char ch = mp_obj_get_int(arg);
+                mp_print_strn(print, &ch, 1, flags, fill, width);
+                return;
+            }
+
+            case '\0':  // No explicit format type implies 'd'
+            case 'n':   // I don't think we support locales in uPy so use 'd'
+            case 'd':
+                mp_print_mp_int(print, arg, 10, 'a', flags, fill, width, 0);
+                return;
+
+            case 'o':
+                if (flags & PF_FLAG_SHOW_PREFIX) {
+                    flags |= PF_FLAG_SHOW_OCTAL_LETTER;
+                }
+
+                mp_print_mp_int(print, arg, 8, 'a', flags, fill, width, 0);
+                return;
+
+            case 'X':
+            case 'x':
+                mp_print_mp_int(print, arg, 16, type - ('X' - 'A'), flags, fill, width, 0);
+                return;
+
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case '%':
+                // The floating point formatters all work with anything that
+                // looks like an integer
+                break;
+
+            default:
+                #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
+                terse_str_format_value_error();
+                #else
+                mp_raise_msg_varg(&mp_type_ValueError,
+                    MP_ERROR_TEXT("unknown format code '%c' for object of type '%s'"),
+                    type, mp_obj_get_type_str(arg));
+                #endif
+        }
+    }
+
+    // NOTE: no else here. We need the e, f, g etc formats for integer
+    //       arguments (from above if) to take this if.
+    if (arg_looks_numeric(arg)) {
+        if (!type) {
+
+            // Even though the docs say that an unspecified type is the same
+            // as 'g', there is one subtle difference, when the exponent
+            // is one less than the precision.
+            //
+            // '{:10.1}'.format(0.0) ==> '0e+00'
+            // '{:10.1g}'.format(0.0) ==> '0'
+            //
+            // TODO: Figure out how to deal with this.
+            //
+            // A proper solution would involve adding a special flag
+            // or something to format_float, and create a format_double
+            // to deal with doubles. In order to fix this when using
+            // sprintf, we'd need to use the e format and tweak the
+            // returned result to strip trailing zeros like the g format
+            // does.
+            //
+            // {:10.3} and {:10.2e} with 1.23e2 both produce 1.23e+02
+            // but with 1.e2 you get 1e+02 and 1.00e+02
+            //
+            // Stripping the trailing 0's (like g) does would make the
+            // e format give us the right format.
+            //
+            // CPython sources say:
+            //   Omitted type specifier.  Behaves in the same way as repr(x)
+            //   and str(x) if no precision is given, else like 'g', but with
+            //   at least one digit after the decimal point. */
+
+            type = 'g';
+        }
+        if (type == 'n') {
+            type = 'g';
+        }
+
+        switch (type) {
+            #if MICROPY_PY_BUILTINS_FLOAT
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+                mp_print_float(print, mp_obj_get_float(arg), type, flags, fill, width, precision);
+                break;
+
+            case '%':
+                flags |= PF_FLAG_ADD_PERCENT;
+                #if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_FLOAT
+                #define F100 100.0F
+                #else
+                #define F100 100.0
+                #endif
+                mp_print_float(print, mp_obj_get_float(arg) * F100, 'f', flags, fill, width, precision);
+#undef F100
+                break;
+            #endif
+
+            default:
+                #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
+                terse_str_format_value_error();
+                #else
+                mp_raise_msg_varg(&mp_type_ValueError,
+                    MP_ERROR_TEXT("unknown format code '%c' for object of type '%s'"),
+                    type, mp_obj_get_type_str(arg));
+                #endif
+        }
+    } else {
+        // arg doesn't look like a number
+
+        if (align == '=') {
+            #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
+            terse_str_format_value_error();
+            #else
+            mp_raise_ValueError(
+                MP_ERROR_TEXT("'=' alignment not allowed in string format specifier"));
+            #endif
+        }
+
+        switch (type) {
+            case '\0': // no explicit format type implies 's'
+            case 's': {
+                size_t slen;
+                const char *s = mp_obj_str_get_data(arg, &slen);
+                if (precision < 0) {
+                    precision = slen;
+                }
+                if (slen > (size_t)precision) {
+                    slen = precision;
+                }
+                mp_print_strn(print, s, slen, flags, fill, width);
+                break;
+            }
+
+            default:
+                #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
+                terse_str_format_value_error();
+                #else
+                mp_raise_msg_varg(&mp_type_ValueError,
+                    MP_ERROR_TEXT("unknown format code '%c' for object of type '%s'"),
+                    type, mp_obj_get_type_str(arg));
+                #endif
+        }
+    }
+}
+
+STATIC mp_obj_t str_format_get_kwarg(mp_map_t *kwargs, mp_obj_t key) {
+    mp_map_elem_t *key_elem = mp_map_lookup(kwargs, key, MP_MAP_LOOKUP);
+    if (key_elem == NULL) {
+        mp_raise_type_arg(&mp_type_KeyError, key);
+    }
+    return key_elem->value;
+}
+
+STATIC mp_obj_t str_format_get_arg(size_t n_args, const mp_obj_t *args, int index) {
+    if ((uint)index >= n_args - 1) {
+        mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("tuple index out of range"));
+    }
+    return args[index + 1];
+}
+
+// If rec is not NULL then the parsed form of the format string is recorded in
+// it, unless the format string has nested replacement fields in which case
+// rec->n_fields is set to 0.
+STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *arg_i, size_t n_args, const mp_obj_t *args, mp_map_t *kwargs, str_format_t *rec) {
     vstr_t vstr;
     mp_print_t print;
     vstr_init_print(&vstr, 16, &print);
+    const char *lit = str;
 
     for (; str < top; str++) {
         if (*str == '}') {
             str++;
             if (str < top && *str == '}') {
                 vstr_add_byte(&vstr, '}');
+                str_format_record(rec, lit, str);
+                lit = str + 1;
                 continue;
             }
             #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
@@ -1015,9 +1449,11 @@ STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *ar
             continue;
         }
 
-        str++;
+        const char *field_start = str++;
         if (str < top && *str == '{') {
             vstr_add_byte(&vstr, '{');
+            str_format_record(rec, lit, str);
+            lit = str + 1;
             continue;
         }
 
@@ -1062,9 +1498,6 @@ STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *ar
         if (str < top && *str == ':') {
             str++;
             // {:} is the same as {}, which is the same as {!s}
-            // This makes a difference when passing in a True or False
-            // '{}'.format(True) returns 'True'
-            // '{:d}'.format(True) returns '1'
             // So we treat {:} as {} and this later gets treated to be {!s}
             if (*str != '}') {
                 format_spec = str;
@@ -1095,10 +1528,11 @@ STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *ar
             #endif
         }
 
-        mp_obj_t arg = mp_const_none;
+        mp_obj_t arg;
+        int index = 0;
+        mp_obj_t key = MP_OBJ_NULL;
 
         if (field_name) {
-            int index = 0;
             if (MP_LIKELY(unichar_isdigit(*field_name))) {
                 if (*arg_i > 0) {
                     #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
@@ -1109,22 +1543,15 @@ STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *ar
                     #endif
                 }
                 field_name = str_to_int(field_name, field_name_top, &index);
-                if ((uint)index >= n_args - 1) {
-                    mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("tuple index out of range"));
-                }
-                arg = args[index + 1];
+                arg = str_format_get_arg(n_args, args, index);
                 *arg_i = -1;
             } else {
                 const char *lookup;
                 for (lookup = field_name; lookup < field_name_top && *lookup != '.' && *lookup != '['; lookup++) {;
                 }
-                mp_obj_t field_q = mp_obj_new_str_via_qstr(field_name, lookup - field_name); // should it be via qstr?
+                key = mp_obj_new_str_via_qstr(field_name, lookup - field_name); // should it be via qstr?
                 field_name = lookup;
-                mp_map_elem_t *key_elem = mp_map_lookup(kwargs, field_q, MP_MAP_LOOKUP);
-                if (key_elem == NULL) {
-                    mp_raise_type_arg(&mp_type_KeyError, field_q);
-                }
-                arg = key_elem->value;
+                arg = str_format_get_kwarg(kwargs, key);
             }
             if (field_name < field_name_top) {
                 mp_raise_NotImplementedError(MP_ERROR_TEXT("attributes not supported"));
@@ -1138,92 +1565,23 @@ STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *ar
                     MP_ERROR_TEXT("can't switch from manual field specification to automatic field numbering"));
                 #endif
             }
-            if ((uint)*arg_i >= n_args - 1) {
-                mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("tuple index out of range"));
-            }
-            arg = args[(*arg_i) + 1];
+            index = *arg_i;
+            arg = str_format_get_arg(n_args, args, index);
             (*arg_i)++;
         }
-        if (!format_spec && !conversion) {
-            conversion = 's';
-        }
-        if (conversion) {
-            mp_print_kind_t print_kind;
-            if (conversion == 's') {
-                print_kind = PRINT_STR;
-            } else {
-                assert(conversion == 'r');
-                print_kind = PRINT_REPR;
-            }
-            vstr_t arg_vstr;
-            mp_print_t arg_print;
-            vstr_init_print(&arg_vstr, 16, &arg_print);
-            mp_obj_print_helper(&arg_print, arg, print_kind);
-            arg = mp_obj_new_str_type_from_vstr(&mp_type_str, &arg_vstr);
-        }
-
-        char fill = '\0';
-        char align = '\0';
-        int width = -1;
-        int precision = -1;
-        char type = '\0';
-        int flags = 0;
 
+        str_format_spec_t spec;
         if (format_spec) {
-            // The format specifier (from http://docs.python.org/2/library/string.html#formatspec)
-            //
-            // [[fill]align][sign][#][0][width][,][.precision][type]
-            // fill        ::=  <any character>
-            // align       ::=  "<" | ">" | "=" | "^"
-            // sign        ::=  "+" | "-" | " "
-            // width       ::=  integer
-            // precision   ::=  integer
-            // type        ::=  "b" | "c" | "d" | "e" | "E" | "f" | "F" | "g" | "G" | "n" | "o" | "s" | "x" | "X" | "%"
-
             // recursively call the formatter to format any nested specifiers
             MP_STACK_CHECK();
-            vstr_t format_spec_vstr = mp_obj_str_format_helper(format_spec, str, arg_i, n_args, args, kwargs);
-            const char *s = vstr_null_terminated_str(&format_spec_vstr);
-            const char *stop = s + format_spec_vstr.len;
-            if (isalignment(*s)) {
-                align = *s++;
-            } else if (*s && isalignment(s[1])) {
-                fill = *s++;
-                align = *s++;
-            }
-            if (*s == '+' || *s == '-' || *s == ' ') {
-                if (*s == '+') {
-                    flags |= PF_FLAG_SHOW_SIGN;
-                } else if (*s == ' ') {
-                    flags |= PF_FLAG_SPACE_SIGN;
-                }
-                s++;
-            }
-            if (*s == '#') {
-                flags |= PF_FLAG_SHOW_PREFIX;
-                s++;
-            }
-            if (*s == '0') {
-                if (!align && arg_looks_numeric(arg)) {
-                    align = '=';
-                }
-                if (!fill) {
-                    fill = '0';
-                }
+            if (rec != NULL && memchr(format_spec, '{', str - format_spec) != NULL) {
+                // The format specifier depends on the arguments so can't be recorded.
+                rec->n_fields = 0;
+                rec = NULL;
             }
-            s = str_to_int(s, stop, &width);
-            if (*s == ',') {
-                flags |= PF_FLAG_SHOW_COMMA;
-                s++;
-            }
-            if (*s == '.') {
-                s++;
-                s = str_to_int(s, stop, &precision);
-            }
-            if (istype(*s)) {
-                type = *s++;
-            }
-            if (*s) {
+            vstr_t format_spec_vstr = mp_obj_str_format_helper(format_spec, str, arg_i, n_args, args, kwargs, NULL);
+            const char *s = vstr_null_terminated_str(&format_spec_vstr);
+            if (!str_format_parse_spec(s, s + format_spec_vstr.len, &spec)) {
                 #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
                 terse_str_format_value_error();
                 #else
@@ -1232,223 +1590,218 @@ STATIC vstr_t mp_obj_str_format_helper(const char *str, const char *top, int *ar
             }
             vstr_clear(&format_spec_vstr);
         }
-        if (!align) {
-            if (arg_looks_numeric(arg)) {
-                align = '>';
-            } else {
-                align = '<';
+
+        str_format_field_t *f = str_format_record(rec, lit, field_start);
+        if (f != NULL) {
+            f->has_field = true;
+            f->has_spec = format_spec != NULL;
+            f->conversion = conversion;
+            f->index = index;
+            f->key = key;
+            if (format_spec) {
+                f->spec = spec;
             }
         }
-        if (!fill) {
-            fill = ' ';
-        }
+        lit = str + 1;
 
-        if (flags & (PF_FLAG_SHOW_SIGN | PF_FLAG_SPACE_SIGN)) {
-            if (type == 's') {
-                #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
-                terse_str_format_value_error();
-                #else
-                mp_raise_ValueError(MP_ERROR_TEXT("sign not allowed in string format specifier"));
-                #endif
-            }
-            if (type == 'c') {
-                #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
-                terse_str_format_value_error();
-                #else
-                mp_raise_ValueError(
-                    MP_ERROR_TEXT("sign not allowed with integer format specifier 'c'"));
-                #endif
+        str_format_field(&print, arg, conversion, format_spec ? &spec : NULL);
+    }
+
+    if (lit < top) {
+        str_format_record(rec, lit, top);
+    }
+
+    return vstr;
+}
+
+#if STR_FORMAT_USE_CACHE
+STATIC mp_obj_t str_format_run(str_format_t *t, size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
+    vstr_t vstr;
+    mp_print_t print;
+    vstr_init_print(&vstr, t->out_len + 1, &print);
+    for (const str_format_field_t *f = t->fields, *top = f + t->n_fields; f < top; ++f) {
+        vstr_add_strn(&vstr, f->lit, f->lit_len);
+        if (f->has_field) {
+            mp_obj_t arg;
+            if (f->key != MP_OBJ_NULL) {
+                arg = str_format_get_kwarg(kwargs, f->key);
+            } else {
+                arg = str_format_get_arg(n_args, args, f->index);
             }
+            str_format_field(&print, arg, f->conversion, f->has_spec ? &f->spec : NULL);
         }
+    }
+    t->out_len = vstr.len;
+    return mp_obj_new_str_type_from_vstr(mp_obj_get_type(args[0]), &vstr);
+}
+#endif
 
-        switch (align) {
-            case '<':
-                flags |= PF_FLAG_LEFT_ADJUST;
-                break;
-            case '=':
-                flags |= PF_FLAG_PAD_AFTER_SIGN;
-                break;
-            case '^':
-                flags |= PF_FLAG_CENTER_ADJUST;
-                break;
-        }
+mp_obj_t mp_obj_str_format(size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
+    check_is_str_or_bytes(args[0]);
 
-        if (arg_looks_integer(arg)) {
-            switch (type) {
-                case 'b':
-                    mp_print_mp_int(&print, arg, 2, 'a', flags, fill, width, 0);
-                    continue;
+    GET_STR_DATA_LEN(args[0], str, len);
+    str_format_t *rec = NULL;
+    #if STR_FORMAT_USE_CACHE
+    str_format_t *t = str_format_cache_lookup(args[0], false);
+    if (t != NULL) {
+        return str_format_run(t, n_args, args, kwargs);
+    }
+    rec = str_format_new(args[0], false, str, len, '{', '}');
+    #endif
+    int arg_i = 0;
+    vstr_t vstr = mp_obj_str_format_helper((const char *)str, (const char *)str + len, &arg_i, n_args, args, kwargs, rec);
+    #if STR_FORMAT_USE_CACHE
+    if (rec != NULL && rec->n_fields > 0) {
+        rec->out_len = vstr.len;
+        str_format_cache_insert(rec);
+    }
+    #endif
+    return mp_obj_new_str_type_from_vstr(mp_obj_get_type(args[0]), &vstr);
+}
+MP_DEFINE_CONST_FUN_OBJ_KW(str_format_obj, 1, mp_obj_str_format);
 
-                case 'c': {
-                    char ch = mp_obj_get_int(arg);
-                    mp_print_strn(&print, &ch, 1, flags, fill, width);
-                    continue;
+#if MICROPY_PY_BUILTINS_STR_OP_MODULO
+// Output a single % conversion for the given argument, with the width and
+// precision resolved.  Returns false if the conversion type isn't supported.
+STATIC bool str_modulo_field(const mp_print_t *print, mp_obj_t arg, const str_format_spec_t *spec, bool is_bytes) {
+    int flags = spec->flags;
+    int width = spec->width;
+    int prec = spec->precision;
+    switch (spec->type) {
+        case 'c':
+            if (mp_obj_is_str(arg)) {
+                size_t slen;
+                const char *s = mp_obj_str_get_data(arg, &slen);
+                if (slen != 1) {
+                    mp_raise_TypeError(MP_ERROR_TEXT("%c needs int or char"));
                 }
+                mp_print_strn(print, s, 1, flags, ' ', width);
+            } else if (arg_looks_integer(arg)) {
+                char ch = mp_obj_get_int(arg);
+                mp_print_strn(print, &ch, 1, flags, ' ', width);
+            } else {
+                mp_raise_TypeError(MP_ERROR_TEXT("integer needed"));
+            }
+            break;
 
-                case '\0':  // No explicit format type implies 'd'
-                case 'n':   // I don't think we support locales in uPy so use 'd'
-                case 'd':
-                    mp_print_mp_int(&print, arg, 10, 'a', flags, fill, width, 0);
-                    continue;
-
-                case 'o':
-                    if (flags & PF_FLAG_SHOW_PREFIX) {
-                        flags |= PF_FLAG_SHOW_OCTAL_LETTER;
-                    }
+        case 'd':
+        case 'i':
+        case 'u':
+            mp_print_mp_int(print, arg_as_int(arg), 10, 'a', flags, spec->fill, width, prec);
+            break;
 
-                    mp_print_mp_int(&print, arg, 8, 'a', flags, fill, width, 0);
-                    continue;
-
-                case 'X':
-                case 'x':
-                    mp_print_mp_int(&print, arg, 16, type - ('X' - 'A'), flags, fill, width, 0);
-                    continue;
-
-                case 'e':
-                case 'E':
-                case 'f':
-                case 'F':
-                case 'g':
-                case 'G':
-                case '%':
-                    // The floating point formatters all work with anything that
-                    // looks like an integer
-                    break;
+        #if MICROPY_PY_BUILTINS_FLOAT
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+            mp_print_float(print, mp_obj_get_float(arg), spec->type, flags, spec->fill, width, prec);
+            break;
+        #endif
 
-                default:
-                    #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
-                    terse_str_format_value_error();
-                    #else
-                    mp_raise_msg_varg(&mp_type_ValueError,
-                        MP_ERROR_TEXT("unknown format code '%c' for object of type '%s'"),
-                        type, mp_obj_get_type_str(arg));
-                    #endif
+        case 'o':
+            if (spec->alt) {
+                flags |= (PF_FLAG_SHOW_PREFIX | PF_FLAG_SHOW_OCTAL_LETTER);
             }
-        }
+            mp_print_mp_int(print, arg, 8, 'a', flags, spec->fill, width, prec);
+            break;
 
-        // NOTE: no else here. We need the e, f, g etc formats for integer
-        //       arguments (from above if) to take this if.
-        if (arg_looks_numeric(arg)) {
-            if (!type) {
-
-                // Even though the docs say that an unspecified type is the same
-                // as 'g', there is one subtle difference, when the exponent
-                // is one less than the precision.
-                //
-                // '{:10.1}'.format(0.0) ==> '0e+00'
-                // '{:10.1g}'.format(0.0) ==> '0'
-                //
-                // TODO: Figure out how to deal with this.
-                //
-                // A proper solution would involve adding a special flag
-                // or something to format_float, and create a format_double
-                // to deal with doubles. In order to fix this when using
-                // sprintf, we'd need to use the e format and tweak the
-                // returned result to strip trailing zeros like the g format
-                // does.
-                //
-                // {:10.3} and {:10.2e} with 1.23e2 both produce 1.23e+02
-                // but with 1.e2 you get 1e+02 and 1.00e+02
-                //
-                // Stripping the trailing 0's (like g) does would make the
-                // e format give us the right format.
-                //
-                // CPython sources say:
-                //   Omitted type specifier.  Behaves in the same way as repr(x)
-                //   and str(x) if no precision is given, else like 'g', but with
-                //   at least one digit after the decimal point. */
-
-                type = 'g';
+        case 'r':
+        case 's': {
+            mp_print_kind_t print_kind = (spec->type == 'r' ? PRINT_REPR : PRINT_STR);
+            if (print_kind == PRINT_STR && is_bytes && mp_obj_is_type(arg, &mp_type_bytes)) {
+                // If we have something like b"%s" % b"1", bytes arg should be
+                // printed undecorated.
+                print_kind = PRINT_RAW;
             }
-            if (type == 'n') {
-                type = 'g';
+            if (width == 0 && prec < 0) {
+                // No padding or truncation so output the argument as is.
+                mp_obj_print_helper(print, arg, print_kind);
+                break;
             }
-
-            switch (type) {
-                #if MICROPY_PY_BUILTINS_FLOAT
-                case 'e':
-                case 'E':
-                case 'f':
-                case 'F':
-                case 'g':
-                case 'G':
-                    mp_print_float(&print, mp_obj_get_float(arg), type, flags, fill, width, precision);
-                    break;
-
-                case '%':
-                    flags |= PF_FLAG_ADD_PERCENT;
-                    #if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_FLOAT
-                    #define F100 100.0F
-                    #else
-                    #define F100 100.0
-                    #endif
-                    mp_print_float(&print, mp_obj_get_float(arg) * F100, 'f', flags, fill, width, precision);
-#undef F100
-                    break;
-                #endif
-
-                default:
-                    #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
-                    terse_str_format_value_error();
-                    #else
-                    mp_raise_msg_varg(&mp_type_ValueError,
-                        MP_ERROR_TEXT("unknown format code '%c' for object of type '%s'"),
-                        type, mp_obj_get_type_str(arg));
-                    #endif
+            vstr_t arg_vstr;
+            mp_print_t arg_print;
+            vstr_init_print(&arg_vstr, 16, &arg_print);
+            mp_obj_print_helper(&arg_print, arg, print_kind);
+            uint vlen = arg_vstr.len;
+            if (prec < 0) {
+                prec = vlen;
             }
-        } else {
-            // arg doesn't look like a number
+            if (vlen > (uint)prec) {
+                vlen = prec;
+            }
+            mp_print_strn(print, arg_vstr.buf, vlen, flags, ' ', width);
+            vstr_clear(&arg_vstr);
+            break;
+        }
 
-            if (align == '=') {
-                #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
-                terse_str_format_value_error();
-                #else
-                mp_raise_ValueError(
-                    MP_ERROR_TEXT("'=' alignment not allowed in string format specifier"));
-                #endif
+        case 'X':
+        case 'x':
+            if (spec->alt) {
+                flags |= PF_FLAG_SHOW_PREFIX;
             }
+            mp_print_mp_int(print, arg, 16, spec->type - ('X' - 'A'), flags, spec->fill, width, prec);
+            break;
 
-            switch (type) {
-                case '\0': // no explicit format type implies 's'
-                case 's': {
-                    size_t slen;
-                    const char *s = mp_obj_str_get_data(arg, &slen);
-                    if (precision < 0) {
-                        precision = slen;
-                    }
-                    if (slen > (size_t)precision) {
-                        slen = precision;
-                    }
-                    mp_print_strn(&print, s, slen, flags, fill, width);
-                    break;
-                }
+        default:
+            return false;
+    }
+    return true;
+}
 
-                default:
-                    #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
-                    terse_str_format_value_error();
-                    #else
-                    mp_raise_msg_varg(&mp_type_ValueError,
-                        MP_ERROR_TEXT("unknown format code '%c' for object of type '%s'"),
-                        type, mp_obj_get_type_str(arg));
-                    #endif
+#if STR_FORMAT_USE_CACHE
+STATIC mp_obj_t str_modulo_run(str_format_t *t, size_t n_args, const mp_obj_t *args, mp_obj_t dict, bool is_bytes) {
+    size_t arg_i = 0;
+    vstr_t vstr;
+    mp_print_t print;
+    vstr_init_print(&vstr, t->out_len + 1, &print);
+    for (const str_format_field_t *f = t->fields, *top = f + t->n_fields; f < top; ++f) {
+        vstr_add_strn(&vstr, f->lit, f->lit_len);
+        if (!f->has_field) {
+            continue;
+        }
+        mp_obj_t arg = MP_OBJ_NULL;
+        if (f->key != MP_OBJ_NULL) {
+            if (dict == MP_OBJ_NULL) {
+                mp_raise_TypeError(MP_ERROR_TEXT("format needs a dict"));
+            }
+            arg_i = 1; // we used up the single dict argument
+            arg = mp_obj_dict_get(dict, f->key);
+        }
+        str_format_spec_t spec = f->spec;
+        if (spec.width == STR_MODULO_STAR) {
+            if (arg_i >= n_args) {
+                goto not_enough_args;
+            }
+            spec.width = mp_obj_get_int(args[arg_i++]);
+        }
+        if (spec.precision == STR_MODULO_STAR) {
+            if (arg_i >= n_args) {
+                goto not_enough_args;
+            }
+            spec.precision = mp_obj_get_int(args[arg_i++]);
+        }
+        if (arg == MP_OBJ_NULL) {
+            if (arg_i >= n_args) {
+            not_enough_args:
+                mp_raise_TypeError(MP_ERROR_TEXT("format string needs more arguments"));
             }
+            arg = args[arg_i++];
         }
+        str_modulo_field(&print, arg, &spec, is_bytes);
     }
 
-    return vstr;
-}
-
-mp_obj_t mp_obj_str_format(size_t n_args, const mp_obj_t *args, mp_map_t *kwargs) {
-    check_is_str_or_bytes(args[0]);
+    if (dict == MP_OBJ_NULL && arg_i != n_args) {
+        mp_raise_TypeError(MP_ERROR_TEXT("format string didn't convert all arguments"));
+    }
 
-    GET_STR_DATA_LEN(args[0], str, len);
-    int arg_i = 0;
-    vstr_t vstr = mp_obj_str_format_helper((const char *)str, (const char *)str + len, &arg_i, n_args, args, kwargs);
-    return mp_obj_new_str_type_from_vstr(mp_obj_get_type(args[0]), &vstr);
+    t->out_len = vstr.len;
+    return mp_obj_new_str_type_from_vstr(is_bytes ? &mp_type_bytes : &mp_type_str, &vstr);
 }
-MP_DEFINE_CONST_FUN_OBJ_KW(str_format_obj, 1, mp_obj_str_format);
+#endif
 
-#if MICROPY_PY_BUILTINS_STR_OP_MODULO
 STATIC mp_obj_t str_modulo_format(mp_obj_t pattern, size_t n_args, const mp_obj_t *args, mp_obj_t dict) {
     check_is_str_or_bytes(pattern);
 
@@ -1457,6 +1810,15 @@ STATIC mp_obj_t str_modulo_format(mp_obj_t pattern, size_t n_args, const mp_obj_
     const byte *start_str = str;
     #endif
     bool is_bytes = mp_obj_is_type(pattern, &mp_type_bytes);
+    str_format_t *rec = NULL;
+    #if STR_FORMAT_USE_CACHE
+    str_format_t *t = str_format_cache_lookup(pattern, true);
+    if (t != NULL) {
+        return str_modulo_run(t, n_args, args, dict, is_bytes);
+    }
+    rec = str_format_new(pattern, true, str, len, '%', '%');
+    #endif
+    const byte *lit = str;
     size_t arg_i = 0;
     vstr_t vstr;
     mp_print_t print;
@@ -1468,21 +1830,25 @@ STATIC mp_obj_t str_modulo_format(mp_obj_t pattern, size_t n_args, const mp_obj_
             vstr_add_byte(&vstr, *str);
             continue;
         }
+        const byte *field_start = str;
         if (++str >= top) {
             goto incomplete_format;
         }
         if (*str == '%') {
             vstr_add_byte(&vstr, '%');
+            str_format_record(rec, (const char *)lit, (const char *)str);
+            lit = str + 1;
             continue;
         }
 
         // Dictionary value lookup
+        mp_obj_t key = MP_OBJ_NULL;
         if (*str == '(') {
             if (dict == MP_OBJ_NULL) {
                 mp_raise_TypeError(MP_ERROR_TEXT("format needs a dict"));
             }
             arg_i = 1; // we used up the single dict argument
-            const byte *key = ++str;
+            const byte *key_str = ++str;
             while (*str != ')') {
                 if (str >= top) {
                     #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
@@ -1493,56 +1859,61 @@ STATIC mp_obj_t str_modulo_format(mp_obj_t pattern, size_t n_args, const mp_obj_
                 }
                 ++str;
             }
-            mp_obj_t k_obj = mp_obj_new_str_via_qstr((const char *)key, str - key);
-            arg = mp_obj_dict_get(dict, k_obj);
+            key = mp_obj_new_str_via_qstr((const char *)key_str, str - key_str);
+            arg = mp_obj_dict_get(dict, key);
             str++;
         }
 
-        int flags = 0;
-        char fill = ' ';
-        int alt = 0;
+        str_format_spec_t spec;
+        spec.flags = 0;
+        spec.fill = ' ';
+        spec.alt = false;
         while (str < top) {
             if (*str == '-') {
-                flags |= PF_FLAG_LEFT_ADJUST;
+                spec.flags |= PF_FLAG_LEFT_ADJUST;
             } else if (*str == '+') {
-                flags |= PF_FLAG_SHOW_SIGN;
+                spec.flags |= PF_FLAG_SHOW_SIGN;
             } else if (*str == ' ') {
-                flags |= PF_FLAG_SPACE_SIGN;
+                spec.flags |= PF_FLAG_SPACE_SIGN;
             } else if (*str == '#') {
-                alt = PF_FLAG_SHOW_PREFIX;
+                spec.alt = true;
             } else if (*str == '0') {
-                flags |= PF_FLAG_PAD_AFTER_SIGN;
-                fill = '0';
+                spec.flags |= PF_FLAG_PAD_AFTER_SIGN;
+                spec.fill = '0';
             } else {
                 break;
             }
             str++;
         }
         // parse width, if it exists
-        int width = 0;
+        spec.width = 0;
+        bool width_star = false;
         if (str < top) {
             if (*str == '*') {
                 if (arg_i >= n_args) {
                     goto not_enough_args;
                 }
-                width = mp_obj_get_int(args[arg_i++]);
+                spec.width = mp_obj_get_int(args[arg_i++]);
+                width_star = true;
                 str++;
             } else {
-                str = (const byte *)str_to_int((const char *)str, (const char *)top, &width);
+                str = (const byte *)str_to_int((const char *)str, (const char *)top, &spec.width);
             }
         }
-        int prec = -1;
+        spec.precision = -1;
+        bool prec_star = false;
         if (str < top && *str == '.') {
             if (++str < top) {
                 if (*str == '*') {
                     if (arg_i >= n_args) {
                         goto not_enough_args;
                     }
-                    prec = mp_obj_get_int(args[arg_i++]);
+                    spec.precision = mp_obj_get_int(args[arg_i++]);
+                    prec_star = true;
                     str++;
                 } else {
-                    prec = 0;
-                    str = (const byte *)str_to_int((const char *)str, (const char *)top, &prec);
+                    spec.precision = 0;
+                    str = (const byte *)str_to_int((const char *)str, (const char *)top, &spec.precision);
                 }
             }
         }
@@ -1564,85 +1935,31 @@ STATIC mp_obj_t str_modulo_format(mp_obj_t pattern, size_t n_args, const mp_obj_
             }
             arg = args[arg_i++];
         }
-        switch (*str) {
-            case 'c':
-                if (mp_obj_is_str(arg)) {
-                    size_t slen;
-                    const char *s = mp_obj_str_get_data(arg, &slen);
-                    if (slen != 1) {
-                        mp_raise_TypeError(MP_ERROR_TEXT("%c needs int or char"));
-                    }
-                    mp_print_strn(&print, s, 1, flags, ' ', width);
-                } else if (arg_looks_integer(arg)) {
-                    char ch = mp_obj_get_int(arg);
-                    mp_print_strn(&print, &ch, 1, flags, ' ', width);
-                } else {
-                    mp_raise_TypeError(MP_ERROR_TEXT("integer needed"));
-                }
-                break;
-
-            case 'd':
-            case 'i':
-            case 'u':
-                mp_print_mp_int(&print, arg_as_int(arg), 10, 'a', flags, fill, width, prec);
-                break;
 
-            #if MICROPY_PY_BUILTINS_FLOAT
-            case 'e':
-            case 'E':
-            case 'f':
-            case 'F':
-            case 'g':
-            case 'G':
-                mp_print_float(&print, mp_obj_get_float(arg), *str, flags, fill, width, prec);
-                break;
+        spec.type = *str;
+        if (!str_modulo_field(&print, arg, &spec, is_bytes)) {
+            #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
+            terse_str_format_value_error();
+            #else
+            mp_raise_msg_varg(&mp_type_ValueError,
+                MP_ERROR_TEXT("unsupported format character '%c' (0x%x) at index %d"),
+                *str, *str, str - start_str);
             #endif
+        }
 
-            case 'o':
-                if (alt) {
-                    flags |= (PF_FLAG_SHOW_PREFIX | PF_FLAG_SHOW_OCTAL_LETTER);
-                }
-                mp_print_mp_int(&print, arg, 8, 'a', flags, fill, width, prec);
-                break;
-
-            case 'r':
-            case 's': {
-                vstr_t arg_vstr;
-                mp_print_t arg_print;
-                vstr_init_print(&arg_vstr, 16, &arg_print);
-                mp_print_kind_t print_kind = (*str == 'r' ? PRINT_REPR : PRINT_STR);
-                if (print_kind == PRINT_STR && is_bytes && mp_obj_is_type(arg, &mp_type_bytes)) {
-                    // If we have something like b"%s" % b"1", bytes arg should be
-                    // printed undecorated.
-                    print_kind = PRINT_RAW;
-                }
-                mp_obj_print_helper(&arg_print, arg, print_kind);
-                uint vlen = arg_vstr.len;
-                if (prec < 0) {
-                    prec = vlen;
-                }
-                if (vlen > (uint)prec) {
-                    vlen = prec;
-                }
-                mp_print_strn(&print, arg_vstr.buf, vlen, flags, ' ', width);
-                vstr_clear(&arg_vstr);
-                break;
+        str_format_field_t *f = str_format_record(rec, (const char *)lit, (const char *)field_start);
+        if (f != NULL) {
+            f->has_field = true;
+            f->key = key;
+            f->spec = spec;
+            if (width_star) {
+                f->spec.width = STR_MODULO_STAR;
+            }
+            if (prec_star) {
+                f->spec.precision = STR_MODULO_STAR;
             }
-
-            case 'X':
-            case 'x':
-                mp_print_mp_int(&print, arg, 16, *str - ('X' - 'A'), flags | alt, fill, width, prec);
-                break;
-
-            default:
-                #if MICROPY_ERROR_REPORTING <= MICROPY_ERROR_REPORTING_TERSE
-                terse_str_format_value_error();
-                #else
-                mp_raise_msg_varg(&mp_type_ValueError,
-                    MP_ERROR_TEXT("unsupported format character '%c' (0x%x) at index %d"),
-                    *str, *str, str - start_str);
-                #endif
         }
+        lit = str + 1;
     }
 
     if (dict == MP_OBJ_NULL && arg_i != n_args) {
@@ -1651,6 +1968,16 @@ STATIC mp_obj_t str_modulo_format(mp_obj_t pattern, size_t n_args, const mp_obj_
         mp_raise_TypeError(MP_ERROR_TEXT("format string didn't convert all arguments"));
     }
 
+    #if STR_FORMAT_USE_CACHE
+    if (rec != NULL && (lit < str || rec->n_fields > 0)) {
+        if (lit < str) {
+            str_format_record(rec, (const char *)lit, (const char *)str);
+        }
+        rec->out_len = vstr.len;
+        str_format_cache_insert(rec);
+    }
+    #endif
+
     return mp_obj_new_str_type_from_vstr(is_bytes ? &mp_type_bytes : &mp_type_str, &vstr);
 }
 #endif
@@ -2041,7 +2368,7 @@ mp_obj_t mp_obj_bytes_fromhex(mp_obj_t type_in, mp_obj_t data) {
 STATIC mp_obj_t bytes_hex_as_str(size_t n_args, const mp_obj_t *args) {
     return mp_obj_bytes_hex(n_args, args, &mp_type_str);
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(bytes_hex_as_str_obj, 1, 2, bytes_hex_as_str);
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_obj_bytes_hex_as_str_obj, 1, 2, bytes_hex_as_str);
 
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(bytes_fromhex_obj, mp_obj_bytes_fromhex);
 STATIC MP_DEFINE_CONST_CLASSMETHOD_OBJ(bytes_fromhex_classmethod_obj, MP_ROM_PTR(&bytes_fromhex_obj));
@@ -2074,7 +2401,7 @@ STATIC const mp_rom_map_elem_t array_bytearray_str_bytes_locals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_extend), MP_ROM_PTR(&mp_obj_array_extend_obj) },
     #endif
     #if MICROPY_PY_BUILTINS_BYTES_HEX
-    { MP_ROM_QSTR(MP_QSTR_hex), MP_ROM_PTR(&bytes_hex_as_str_obj) },
+    { MP_ROM_QSTR(MP_QSTR_hex), MP_ROM_PTR(&mp_obj_bytes_hex_as_str_obj) },
     { MP_ROM_QSTR(MP_QSTR_fromhex), MP_ROM_PTR(&bytes_fromhex_classmethod_obj) },
     #endif
     #if MICROPY_CPYTHON_COMPAT
@@ -2161,7 +2488,7 @@ MP_DEFINE_CONST_DICT_WITH_SIZE(mp_obj_array_locals_dict,
     TABLE_ENTRIES_ARRAY);
 #endif
 
-#if MICROPY_PY_BUILTINS_MEMORYVIEW && MICROPY_PY_BUILTINS_BYTES_HEX
+#if MICROPY_PY_BUILTINS_MEMORYVIEW && MICROPY_PY_BUILTINS_BYTES_HEX && !MICROPY_PY_BUILTINS_MEMORYVIEW_ND
 MP_DEFINE_CONST_DICT_WITH_SIZE(mp_obj_memoryview_locals_dict,
     array_bytearray_str_bytes_locals_table + TABLE_ENTRIES_ARRAY,
     1); // Just the "hex" entry.
@@ -2455,3 +2782,7 @@ mp_obj_t mp_obj_new_bytes_iterator(mp_obj_t str, mp_obj_iter_buf_t *iter_buf) {
     o->cur = 0;
     return MP_OBJ_FROM_PTR(o);
 }
+
+#if STR_FORMAT_USE_CACHE
+MP_REGISTER_ROOT_POINTER(struct _str_format_t *str_format_cache[MICROPY_PY_BUILTINS_STR_FORMAT_CACHE_SIZE]);
+#endif
@@ -105,7 +105,11 @@ mp_obj_t mp_obj_bytes_fromhex(mp_obj_t type_in, mp_obj_t data);
 
 extern const mp_obj_dict_t mp_obj_str_locals_dict;
 
-#if MICROPY_PY_BUILTINS_MEMORYVIEW && MICROPY_PY_BUILTINS_BYTES_HEX
+#if MICROPY_PY_BUILTINS_BYTES_HEX
+MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mp_obj_bytes_hex_as_str_obj);
+#endif
+
+#if MICROPY_PY_BUILTINS_MEMORYVIEW && MICROPY_PY_BUILTINS_BYTES_HEX && !MICROPY_PY_BUILTINS_MEMORYVIEW_ND
 extern const mp_obj_dict_t mp_obj_memoryview_locals_dict;
 #endif
 
@@ -258,31 +258,31 @@ STATIC void *parser_alloc(parser_t *parser, size_t num_bytes) {
     mp_parse_chunk_t *chunk = parser->cur_chunk;
 
     if (chunk != NULL && chunk->union_.used + num_bytes > chunk->alloc) {
-        // not enough room at end of previously allocated chunk so try to grow
-        mp_parse_chunk_t *new_data = (mp_parse_chunk_t *)m_renew_maybe(byte, chunk,
-            sizeof(mp_parse_chunk_t) + chunk->alloc,
-            sizeof(mp_parse_chunk_t) + chunk->alloc + num_bytes, false);
-        if (new_data == NULL) {
-            // could not grow existing memory; shrink it to fit previous
-            (void)m_renew_maybe(byte, chunk, sizeof(mp_parse_chunk_t) + chunk->alloc,
-                sizeof(mp_parse_chunk_t) + chunk->union_.used, false);
-            chunk->alloc = chunk->union_.used;
-            chunk->union_.next = parser->tree.chunk;
-            parser->tree.chunk = chunk;
-            chunk = NULL;
-        } else {
-            // could grow existing memory
-            chunk->alloc += num_bytes;
-        }
+        // not enough room at end of previously allocated chunk; shrink it to fit
+        // what is used and link it into the chain of chunks
+        (void)m_renew_maybe(byte, chunk, sizeof(mp_parse_chunk_t) + chunk->alloc,
+            sizeof(mp_parse_chunk_t) + chunk->union_.used, false);
+        chunk->alloc = chunk->union_.used;
+        chunk->union_.next = parser->tree.chunk;
+        parser->tree.chunk = chunk;
+        chunk = NULL;
     }
 
     if (chunk == NULL) {
         // no previous chunk, allocate a new chunk
         size_t alloc = MICROPY_ALLOC_PARSE_CHUNK_INIT;
-        if (alloc < num_bytes) {
-            alloc = num_bytes;
+        if (parser->tree.chunk != NULL) {
+            // make it twice as big as the last one, so large parse trees only
+            // need a few chunks (growing a chunk in place gets slow as it grows)
+            alloc = MAX(alloc, 2 * parser->tree.chunk->alloc);
+        }
+        alloc = MAX(alloc, num_bytes);
+        chunk = (mp_parse_chunk_t *)m_new_maybe(byte, sizeof(mp_parse_chunk_t) + alloc);
+        if (chunk == NULL) {
+            // not enough contiguous memory for that, so use a small chunk
+            alloc = MAX(MICROPY_ALLOC_PARSE_CHUNK_INIT, num_bytes);
+            chunk = (mp_parse_chunk_t *)m_new(byte, sizeof(mp_parse_chunk_t) + alloc);
         }
-        chunk = (mp_parse_chunk_t *)m_new(byte, sizeof(mp_parse_chunk_t) + alloc);
         chunk->alloc = alloc;
         chunk->union_.used = 0;
         parser->cur_chunk = chunk;
@@ -305,9 +305,10 @@ STATIC void parser_free_parse_node_struct(parser_t *parser, mp_parse_node_struct
 
 STATIC void push_rule(parser_t *parser, size_t src_line, uint8_t rule_id, size_t arg_i) {
     if (parser->rule_stack_top >= parser->rule_stack_alloc) {
-        rule_stack_t *rs = m_renew(rule_stack_t, parser->rule_stack, parser->rule_stack_alloc, parser->rule_stack_alloc + MICROPY_ALLOC_PARSE_RULE_INC);
+        size_t new_alloc = parser->rule_stack_alloc + MAX(MICROPY_ALLOC_PARSE_RULE_INC, parser->rule_stack_alloc / 2);
+        rule_stack_t *rs = m_renew(rule_stack_t, parser->rule_stack, parser->rule_stack_alloc, new_alloc);
         parser->rule_stack = rs;
-        parser->rule_stack_alloc += MICROPY_ALLOC_PARSE_RULE_INC;
+        parser->rule_stack_alloc = new_alloc;
     }
     rule_stack_t *rs = &parser->rule_stack[parser->rule_stack_top++];
     rs->src_line = src_line;
@@ -533,9 +534,10 @@ STATIC mp_parse_node_t peek_result(parser_t *parser, size_t pos) {
 
 STATIC void push_result_node(parser_t *parser, mp_parse_node_t pn) {
     if (parser->result_stack_top >= parser->result_stack_alloc) {
-        mp_parse_node_t *stack = m_renew(mp_parse_node_t, parser->result_stack, parser->result_stack_alloc, parser->result_stack_alloc + MICROPY_ALLOC_PARSE_RESULT_INC);
+        size_t new_alloc = parser->result_stack_alloc + MAX(MICROPY_ALLOC_PARSE_RESULT_INC, parser->result_stack_alloc / 2);
+        mp_parse_node_t *stack = m_renew(mp_parse_node_t, parser->result_stack, parser->result_stack_alloc, new_alloc);
         parser->result_stack = stack;
-        parser->result_stack_alloc += MICROPY_ALLOC_PARSE_RESULT_INC;
+        parser->result_stack_alloc = new_alloc;
     }
     parser->result_stack[parser->result_stack_top++] = pn;
 }
@@ -543,7 +545,7 @@ STATIC void push_result_node(parser_t *parser, mp_parse_node_t pn) {
 STATIC mp_parse_node_t make_node_const_object(parser_t *parser, size_t src_line, mp_obj_t obj) {
     mp_parse_node_struct_t *pn = parser_alloc(parser, sizeof(mp_parse_node_struct_t) + sizeof(mp_obj_t));
     pn->source_line = src_line;
-    #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D
+    #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D && UINTPTR_MAX < UINT64_MAX
     // nodes are 32-bit pointers, but need to store 64-bit object
     pn->kind_num_nodes = RULE_const_object | (2 << 8);
     pn->nodes[0] = (uint64_t)obj;
@@ -560,7 +562,7 @@ STATIC mp_parse_node_t make_node_const_object(parser_t *parser, size_t src_line,
 STATIC mp_parse_node_t make_node_const_object_optimised(parser_t *parser, size_t src_line, mp_obj_t obj) {
     if (mp_obj_is_small_int(obj)) {
         mp_int_t val = MP_OBJ_SMALL_INT_VALUE(obj);
-        #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D
+        #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D && UINTPTR_MAX < UINT64_MAX
         // A parse node is only 32-bits and the small-int value must fit in 31-bits
         if (((val ^ (val << 1)) & 0xffffffff80000000) != 0) {
             return make_node_const_object(parser, src_line, obj);
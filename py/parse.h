@@ -83,7 +83,7 @@ static inline mp_parse_node_t mp_parse_node_new_leaf(size_t kind, mp_int_t arg)
 }
 
 static inline mp_obj_t mp_parse_node_extract_const_object(mp_parse_node_struct_t *pns) {
-    #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D
+    #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D && UINTPTR_MAX < UINT64_MAX
     // nodes are 32-bit pointers, but need to extract 64-bit object
     return (uint64_t)pns->nodes[0] | ((uint64_t)pns->nodes[1] << 32);
     #else
@@ -246,6 +246,11 @@ $(HEADER_BUILD)/root_pointers.h: $(HEADER_BUILD)/root_pointers.collected $(PY_SR
 	@$(ECHO) "GEN $@"
 	$(Q)$(PYTHON) $(PY_SRC)/make_root_pointers.py $< > $@
 
+# build a list of ROM map lookup hints for py/map.c.
+$(HEADER_BUILD)/maphints.h: $(HEADER_BUILD)/maphints.collected $(PY_SRC)/make_map_hints.py
+	@$(ECHO) "GEN $@"
+	$(Q)$(PYTHON) $(PY_SRC)/make_map_hints.py $< > $@
+
 # Standard C functions like memset need to be compiled with special flags so
 # the compiler does not optimise these functions in terms of themselves.
 CFLAGS_BUILTIN ?= -ffreestanding -fno-builtin -fno-lto
@@ -258,6 +263,9 @@ $(PY_BUILD)/nlr%.o: CFLAGS += -Os
 # optimising gc for speed; 5ms down to 4ms on pybv2
 $(PY_BUILD)/gc.o: CFLAGS += $(CSUPEROPT)
 
+# optimising the element-wise loops of the array module lets them be vectorised
+$(PY_BUILD)/modarray.o: CFLAGS += $(CSUPEROPT)
+
 # optimising vm for speed, adds only a small amount to code size but makes a huge difference to speed (20% faster)
 $(PY_BUILD)/vm.o: CFLAGS += $(CSUPEROPT)
 # Optimizing vm.o for modern deeply pipelined CPUs with branch predictors
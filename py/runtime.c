@@ -129,6 +129,18 @@ void mp_init(void) {
     }
     #endif
 
+    #if MICROPY_PY_RE && MICROPY_PY_RE_CACHE_SIZE
+    for (size_t i = 0; i < MICROPY_PY_RE_CACHE_SIZE; ++i) {
+        MP_STATE_VM(re_cache[i]) = NULL;
+    }
+    #endif
+
+    #if MICROPY_PY_BUILTINS_STR_FORMAT_CACHE_SIZE
+    for (size_t i = 0; i < MICROPY_PY_BUILTINS_STR_FORMAT_CACHE_SIZE; ++i) {
+        MP_STATE_VM(str_format_cache[i]) = NULL;
+    }
+    #endif
+
     #if MICROPY_VFS
     // initialise the VFS sub-system
     MP_STATE_VM(vfs_cur) = NULL;
@@ -160,6 +172,8 @@ void mp_init(void) {
     #if MICROPY_PY_SYS_SETTRACE
     MP_STATE_THREAD(prof_trace_callback) = MP_OBJ_NULL;
     MP_STATE_THREAD(prof_callback_is_executing) = false;
+    #endif
+    #if MICROPY_TRACK_FRAMES
     MP_STATE_THREAD(current_code_state) = NULL;
     #endif
 
@@ -347,7 +347,103 @@ STATIC mp_obj_t stream_readall(mp_obj_t self_in) {
     }
 }
 
+#if MICROPY_STREAMS_READ_BUFFER
+
+// Refill an empty read-ahead buffer from the device, allocating it if needed.
+// Returns the number of bytes now buffered, 0 at EOF, or MP_STREAM_ERROR.
+mp_uint_t mp_stream_rbuf_fill(mp_stream_rbuf_t *rb, mp_obj_t stream, int *errcode) {
+    if (rb->buf == NULL) {
+        rb->buf = m_new(byte, rb->alloc);
+    }
+    rb->pos = 0;
+    rb->len = 0;
+    mp_uint_t out_sz = rb->read(stream, rb->buf, rb->alloc, errcode);
+    if (out_sz != MP_STREAM_ERROR) {
+        rb->len = out_sz;
+    }
+    return out_sz;
+}
+
+mp_uint_t mp_stream_rbuf_read(mp_stream_rbuf_t *rb, mp_obj_t stream, void *buf, mp_uint_t size, int *errcode) {
+    if (rb->pos == rb->len) {
+        if (size == 0 || size >= rb->alloc) {
+            // Nothing buffered and the request is big enough to go straight
+            // to the device (this also covers unbuffered streams).
+            return rb->read(stream, buf, size, errcode);
+        }
+        mp_uint_t out_sz = mp_stream_rbuf_fill(rb, stream, errcode);
+        if (out_sz == 0 || out_sz == MP_STREAM_ERROR) {
+            return out_sz;
+        }
+    }
+    mp_uint_t n = MIN(size, (mp_uint_t)(rb->len - rb->pos));
+    memcpy(buf, rb->buf + rb->pos, n);
+    rb->pos += n;
+    return n;
+}
+
+// Implementation of readline() for streams with a read-ahead buffer: each
+// chunk of buffered data is searched for the newline with memchr and copied
+// out in one go.
+STATIC mp_obj_t stream_buffered_readline(mp_obj_t stream, mp_stream_rbuf_t *rb, mp_int_t max_size, bool is_text) {
+    vstr_t vstr;
+    vstr_init(&vstr, 0);
+    for (;;) {
+        if (rb->pos == rb->len) {
+            int error;
+            mp_uint_t out_sz = mp_stream_rbuf_fill(rb, stream, &error);
+            if (out_sz == MP_STREAM_ERROR) {
+                if (mp_is_nonblocking_error(error)) {
+                    if (vstr.len == 0) {
+                        // Same as the unbuffered case below, return None.
+                        vstr_clear(&vstr);
+                        return mp_const_none;
+                    }
+                    break;
+                }
+                vstr_clear(&vstr);
+                mp_raise_OSError(error);
+            }
+            if (out_sz == 0) {
+                break;
+            }
+        }
+        const byte *start = rb->buf + rb->pos;
+        size_t n = rb->len - rb->pos;
+        if (max_size != -1 && (size_t)max_size - vstr.len < n) {
+            n = max_size - vstr.len;
+        }
+        const byte *nl = memchr(start, '\n', n);
+        if (nl != NULL) {
+            n = nl - start + 1;
+        }
+        rb->pos += n;
+        if (vstr.len == 0 && (nl != NULL || vstr.len + n == (size_t)max_size)) {
+            // The whole line was buffered, so create the object directly.
+            vstr_clear(&vstr);
+            if (is_text) {
+                return mp_obj_new_str((const char *)start, n);
+            } else {
+                return mp_obj_new_bytes(start, n);
+            }
+        }
+        vstr_add_strn(&vstr, (const char *)start, n);
+        if (nl != NULL || vstr.len == (size_t)max_size) {
+            break;
+        }
+    }
+
+    if (is_text) {
+        return mp_obj_new_str_from_vstr(&vstr);
+    } else {
+        return mp_obj_new_bytes_from_vstr(&vstr);
+    }
+}
+
+#endif // MICROPY_STREAMS_READ_BUFFER
+
 // Unbuffered, inefficient implementation of readline() for raw I/O files.
+// Streams with a read-ahead buffer are handed off to stream_buffered_readline.
 STATIC mp_obj_t stream_unbuffered_readline(size_t n_args, const mp_obj_t *args) {
     const mp_stream_p_t *stream_p = mp_get_stream(args[0]);
 
@@ -356,6 +452,13 @@ STATIC mp_obj_t stream_unbuffered_readline(size_t n_args, const mp_obj_t *args)
         max_size = MP_OBJ_SMALL_INT_VALUE(args[1]);
     }
 
+    #if MICROPY_STREAMS_READ_BUFFER
+    mp_stream_rbuf_t *rb = mp_stream_get_rbuf(args[0], stream_p);
+    if (rb != NULL) {
+        return stream_buffered_readline(args[0], rb, max_size, stream_p->is_text);
+    }
+    #endif
+
     vstr_t vstr;
     if (max_size != -1) {
         vstr_init(&vstr, max_size);
@@ -511,6 +614,89 @@ STATIC mp_obj_t stream_ioctl(size_t n_args, const mp_obj_t *args) {
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_stream_ioctl_obj, 2, 3, stream_ioctl);
 
+#if MICROPY_STREAMS_COPY_FD
+STATIC int stream_get_fileno(mp_obj_t stream, const mp_stream_p_t *stream_p) {
+    int error;
+    mp_uint_t res = stream_p->ioctl == NULL ? MP_STREAM_ERROR : stream_p->ioctl(stream, MP_STREAM_GET_FILENO, 0, &error);
+    return res == MP_STREAM_ERROR ? -1 : (int)res;
+}
+#endif
+
+mp_uint_t mp_stream_copy(mp_obj_t src, mp_obj_t dst, mp_uint_t len, int *errcode) {
+    const mp_stream_p_t *src_p = mp_get_stream(src);
+    #if !MICROPY_STREAMS_READ_BUFFER && !MICROPY_STREAMS_COPY_FD
+    (void)src_p;
+    #endif
+    mp_uint_t done = 0;
+    *errcode = 0;
+
+    #if MICROPY_STREAMS_READ_BUFFER
+    // Data that src has already read ahead goes first.
+    mp_stream_rbuf_t *rb = mp_stream_get_rbuf(src, src_p);
+    if (rb != NULL && rb->pos != rb->len) {
+        mp_uint_t n = MIN(len, (mp_uint_t)(rb->len - rb->pos));
+        done = mp_stream_write_exactly(dst, rb->buf + rb->pos, n, errcode);
+        rb->pos += done;
+        if (*errcode != 0 || done == len) {
+            return done;
+        }
+    }
+    #endif
+
+    #if MICROPY_STREAMS_COPY_FD
+    // If both streams are backed by file descriptors let the OS do the copy,
+    // unless dst has its own read-ahead data which writes must account for.
+    const mp_stream_p_t *dst_p = mp_get_stream(dst);
+    int src_fd = stream_get_fileno(src, src_p);
+    int dst_fd = stream_get_fileno(dst, dst_p);
+    #if MICROPY_STREAMS_READ_BUFFER
+    mp_stream_rbuf_t *dst_rb = mp_stream_get_rbuf(dst, dst_p);
+    if (dst_rb != NULL && dst_rb->pos != dst_rb->len) {
+        dst_fd = -1;
+    }
+    #endif
+    if (src_fd >= 0 && dst_fd >= 0) {
+        bool first = true;
+        while (done < len) {
+            mp_uint_t out_sz = mp_hal_stream_copy_fd(src_fd, dst_fd, len - done, errcode);
+            if (out_sz == MP_STREAM_ERROR) {
+                if (first && *errcode == MP_EINVAL) {
+                    // Not supported for these streams, use the generic copy.
+                    *errcode = 0;
+                    break;
+                }
+                return done;
+            }
+            if (out_sz == 0) {
+                return done;
+            }
+            done += out_sz;
+            first = false;
+        }
+        if (done == len) {
+            return done;
+        }
+    }
+    #endif
+
+    // Generic copy through a single buffer.
+    mp_uint_t buf_size = MIN(len - done, MICROPY_STREAMS_READ_BUFFER_SIZE);
+    byte *buf = m_new(byte, buf_size);
+    while (done < len) {
+        mp_uint_t n = mp_stream_rw(src, buf, MIN(len - done, buf_size), errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
+        if (*errcode != 0 || n == 0) {
+            break;
+        }
+        mp_uint_t out_sz = mp_stream_write_exactly(dst, buf, n, errcode);
+        done += out_sz;
+        if (*errcode != 0) {
+            break;
+        }
+    }
+    m_del(byte, buf, buf_size);
+    return done;
+}
+
 #if MICROPY_STREAMS_POSIX_API
 /*
  * POSIX-like functions
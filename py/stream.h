@@ -74,8 +74,63 @@ typedef struct _mp_stream_p_t {
     mp_uint_t (*write)(mp_obj_t obj, const void *buf, mp_uint_t size, int *errcode);
     mp_uint_t (*ioctl)(mp_obj_t obj, mp_uint_t request, uintptr_t arg, int *errcode);
     mp_uint_t is_text : 1; // default is bytes, set this for text stream
+    #if MICROPY_STREAMS_READ_BUFFER
+    uint16_t rbuf_offset; // offset of the object's mp_stream_rbuf_t, 0 if it has none
+    #endif
 } mp_stream_p_t;
 
+#if MICROPY_STREAMS_READ_BUFFER
+// Read-ahead buffer which a stream object can embed.  The object's read method
+// passes through mp_stream_rbuf_read() and its stream protocol sets rbuf_offset
+// to the buffer's offset within the object, which lets readline() and iteration
+// scan for the newline in the buffer instead of reading one byte at a time.  Seek, tell and
+// write must account for the data that was read ahead, see
+// mp_stream_rbuf_unread().  If alloc is 0 the stream is unbuffered.
+typedef struct _mp_stream_rbuf_t {
+    // Reads from the underlying device.
+    mp_uint_t (*read)(mp_obj_t obj, void *buf, mp_uint_t size, int *errcode);
+    byte *buf;
+    size_t alloc;
+    size_t pos;
+    size_t len;
+} mp_stream_rbuf_t;
+
+static inline void mp_stream_rbuf_init(mp_stream_rbuf_t *rb, mp_uint_t (*read)(mp_obj_t obj, void *buf, mp_uint_t size, int *errcode), size_t alloc) {
+    rb->read = read;
+    rb->buf = NULL;
+    rb->alloc = alloc;
+    rb->pos = 0;
+    rb->len = 0;
+}
+
+// Number of bytes read ahead from the device but not yet consumed.
+static inline mp_uint_t mp_stream_rbuf_unread(const mp_stream_rbuf_t *rb) {
+    return rb->len - rb->pos;
+}
+
+static inline void mp_stream_rbuf_discard(mp_stream_rbuf_t *rb) {
+    rb->pos = 0;
+    rb->len = 0;
+}
+
+// Get the read-ahead buffer of a stream, or NULL if it's unbuffered.  The buffer
+// is found from the stream protocol of the object's own type, so it can't be
+// confused with that of a stream which the object wraps.
+static inline mp_stream_rbuf_t *mp_stream_get_rbuf(mp_obj_t stream, const mp_stream_p_t *stream_p) {
+    if (stream_p->rbuf_offset == 0) {
+        return NULL;
+    }
+    mp_stream_rbuf_t *rb = (mp_stream_rbuf_t *)((byte *)MP_OBJ_TO_PTR(stream) + stream_p->rbuf_offset);
+    if (rb->alloc == 0) {
+        return NULL;
+    }
+    return rb;
+}
+
+mp_uint_t mp_stream_rbuf_read(mp_stream_rbuf_t *rb, mp_obj_t stream, void *buf, mp_uint_t size, int *errcode);
+mp_uint_t mp_stream_rbuf_fill(mp_stream_rbuf_t *rb, mp_obj_t stream, int *errcode);
+#endif
+
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mp_stream_read_obj);
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mp_stream_read1_obj);
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mp_stream_readinto_obj);
@@ -118,6 +173,17 @@ mp_uint_t mp_stream_rw(mp_obj_t stream, void *buf, mp_uint_t size, int *errcode,
 
 void mp_stream_write_adaptor(void *self, const char *buf, size_t len);
 
+// Copy up to len bytes from src to dst, stopping early at EOF.  On error
+// *errcode is set and the number of bytes copied until then is returned.
+mp_uint_t mp_stream_copy(mp_obj_t src, mp_obj_t dst, mp_uint_t len, int *errcode);
+
+#if MICROPY_STREAMS_COPY_FD
+// Provided by the port: copy up to len bytes from src_fd to dst_fd within the
+// OS.  Returns the number of bytes copied, 0 at EOF, or MP_STREAM_ERROR; an
+// error of MP_EINVAL means the pair of file descriptors isn't supported.
+mp_uint_t mp_hal_stream_copy_fd(int src_fd, int dst_fd, mp_uint_t len, int *errcode);
+#endif
+
 #if MICROPY_STREAMS_POSIX_API
 #include <sys/types.h>
 // Functions with POSIX-compatible signatures
@@ -35,6 +35,7 @@
 #include "py/runtime.h"
 #include "py/bc0.h"
 #include "py/profile.h"
+#include "py/mphal.h"
 
 // *FORMAT-OFF*
 
@@ -187,6 +188,15 @@
     } \
 } while(0)
 
+#elif MICROPY_TRACK_FRAMES
+
+// Only keep the chain of running frames, for profilers to walk.
+#define FRAME_SETUP() (MP_STATE_THREAD(current_code_state) = code_state)
+#define FRAME_ENTER() (code_state->prev_state = MP_STATE_THREAD(current_code_state))
+#define FRAME_LEAVE() (MP_STATE_THREAD(current_code_state) = code_state->prev_state)
+#define FRAME_UPDATE()
+#define TRACE_TICK(current_ip, current_sp, is_exception)
+
 #else // MICROPY_PY_SYS_SETTRACE
 #define FRAME_SETUP()
 #define FRAME_ENTER()
@@ -195,6 +205,58 @@
 #define TRACE_TICK(current_ip, current_sp, is_exception)
 #endif // MICROPY_PY_SYS_SETTRACE
 
+#if MICROPY_PY_MICROPYTHON_VM_STATS
+
+mp_vm_stats_t mp_vm_stats;
+
+// Count the opcode about to be executed, and the pair it makes with the one
+// executed before it in this frame.
+#define VM_STATS_OPCODE(op) do { \
+    ++mp_vm_stats.opcode[op]; \
+    ++mp_vm_stats.opcode_pair[vm_stats_last_op][op]; \
+    vm_stats_last_op = (op); \
+} while (0)
+
+uint64_t mp_vm_stats_ticks(void) {
+    return MICROPY_PY_MICROPYTHON_VM_STATS_TICKS();
+}
+
+void mp_vm_stats_call(const mp_obj_fun_bc_t *fun, uint64_t start_ticks) {
+    uint64_t ticks = MICROPY_PY_MICROPYTHON_VM_STATS_TICKS() - start_ticks;
+
+    // Functions are looked up by their bytecode with linear probing.
+    size_t start = ((uintptr_t)fun->bytecode / sizeof(uintptr_t)) % MICROPY_PY_MICROPYTHON_VM_STATS_FUNCS;
+    size_t i = start;
+    do {
+        mp_vm_stats_fun_t *entry = &mp_vm_stats.fun[i];
+        if (entry->bytecode == NULL) {
+            const byte *ip = fun->bytecode;
+            MP_BC_PRELUDE_SIG_DECODE(ip);
+            MP_BC_PRELUDE_SIZE_DECODE(ip);
+            qstr block_name = mp_decode_uint_value(ip);
+            #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
+            entry->block_name = fun->context->constants.qstr_table[block_name];
+            entry->source_file = fun->context->constants.qstr_table[0];
+            #else
+            entry->block_name = block_name;
+            entry->source_file = fun->context->constants.source_file;
+            #endif
+            entry->bytecode = fun->bytecode;
+        }
+        if (entry->bytecode == fun->bytecode) {
+            entry->calls += 1;
+            entry->ticks += ticks;
+            return;
+        }
+        i = (i + 1) % MICROPY_PY_MICROPYTHON_VM_STATS_FUNCS;
+    } while (i != start);
+    mp_vm_stats.fun_other_calls += 1;
+}
+
+#else
+#define VM_STATS_OPCODE(op)
+#endif
+
 // fastn has items in reverse order (fastn[0] is local[0], fastn[-1] is local[1], etc)
 // sp points to bottom of stack which grows up
 // returns:
@@ -232,6 +294,7 @@ mp_vm_return_kind_t MICROPY_WRAP_MP_EXECUTE_BYTECODE(mp_execute_bytecode)(mp_cod
         TRACE(ip); \
         MARK_EXC_IP_GLOBAL(); \
         TRACE_TICK(ip, sp, false); \
+        VM_STATS_OPCODE(*ip); \
         goto *entry_table[*ip++]; \
     } while (0)
     #define DISPATCH_WITH_PEND_EXC_CHECK() goto pending_exception_check
@@ -286,6 +349,9 @@ outer_dispatch_loop:
             // local variables that are not visible to the exception handler
             const byte *ip = code_state->ip;
             mp_obj_t *sp = code_state->sp;
+            #if MICROPY_PY_MICROPYTHON_VM_STATS
+            byte vm_stats_last_op = 0;
+            #endif
             #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
             const qstr_short_t *qstr_table = code_state->fun_bc->context->constants.qstr_table;
             #endif
@@ -313,6 +379,7 @@ dispatch_loop:
                 TRACE(ip);
                 MARK_EXC_IP_GLOBAL();
                 TRACE_TICK(ip, sp, false);
+                VM_STATS_OPCODE(*ip);
                 switch (*ip++) {
                 #endif
 
@@ -1414,23 +1481,9 @@ unwind_loop:
             if (nlr.ret_val != &mp_const_GeneratorExit_obj
                 && *code_state->ip != MP_BC_END_FINALLY
                 && *code_state->ip != MP_BC_RAISE_LAST) {
-                const byte *ip = code_state->fun_bc->bytecode;
-                MP_BC_PRELUDE_SIG_DECODE(ip);
-                MP_BC_PRELUDE_SIZE_DECODE(ip);
-                const byte *line_info_top = ip + n_info;
-                const byte *bytecode_start = ip + n_info + n_cell;
-                size_t bc = code_state->ip - bytecode_start;
-                qstr block_name = mp_decode_uint_value(ip);
-                for (size_t i = 0; i < 1 + n_pos_args + n_kwonly_args; ++i) {
-                    ip = mp_decode_uint_skip(ip);
-                }
-                #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
-                block_name = code_state->fun_bc->context->constants.qstr_table[block_name];
-                qstr source_file = code_state->fun_bc->context->constants.qstr_table[0];
-                #else
-                qstr source_file = code_state->fun_bc->context->constants.source_file;
-                #endif
-                size_t source_line = mp_bytecode_get_source_line(ip, line_info_top, bc);
+                qstr source_file, block_name;
+                size_t source_line;
+                mp_code_state_get_location(code_state, &source_file, &block_name, &source_line);
                 mp_obj_exception_add_traceback(MP_OBJ_FROM_PTR(nlr.ret_val), source_file, source_line, block_name);
             }
 
@@ -0,0 +1,73 @@
+# test element-wise arithmetic functions of the array module
+try:
+    import array
+
+    array.add
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# integer typecodes, with wrap-around on overflow
+for tc in "bBhHiIqQ":
+    a = array.array(tc, [5, 2, 100, 120])
+    b = array.array(tc, [3, 1, 50, 10])
+    print(tc, list(array.add(a, b)), list(array.sub(a, b)), list(array.mul(a, 3)))
+    print(tc, list(array.minimum(a, b)), list(array.maximum(a, 60)))
+    print(tc, array.sum(a), array.dot(a, b))
+
+# signed values
+a = array.array("h", [-5, 3, -32768, 32767])
+print(array.add(a, 1), array.sub(a, 1), array.mul(a, -1))
+print(array.minimum(a, 0), array.maximum(a, 0), array.sum(a), array.dot(a, array.array("h", [1, 1, 1, 0])))
+
+# unsigned wrap-around
+print(array.sub(array.array("B", [1, 2]), 3), array.sub(array.array("H", [1, 2]), 3))
+
+# the scalar is converted as when stored in the array
+print(array.add(array.array("B", [1, 2]), 257))
+
+# in-place operation, with the result the same object
+a = array.array("i", [1, 2, 3])
+print(array.add(a, a, a) is a, a)
+print(array.mul(a, 10, a), a)
+
+# bytearray gives a bytearray
+ba = bytearray(b"\x01\x02\xff")
+print(array.add(ba, 1), array.sum(ba), array.dot(ba, b"\x01\x01\x01"))
+
+# memoryview and bytes as inputs and output
+m = memoryview(ba)[1:]
+print(array.add(m, b"\x10\x20"))
+array.sub(m, 1, m)
+print(ba)
+m = memoryview(array.array("h", [1, 2, 3, 4]))
+print(array.add(m[:2], m[2:]), array.sum(m[1:]))
+
+# empty arrays
+print(array.add(array.array("H"), 1), array.sum(array.array("H")), array.dot(b"", b""))
+
+# mismatched types and lengths
+a = array.array("h", [1, 2])
+for args in ((a, array.array("H", [1, 2])), (a, array.array("h", [1]))):
+    try:
+        array.add(*args)
+    except (TypeError, ValueError) as e:
+        print(type(e).__name__, e)
+try:
+    array.add(a, a, array.array("h", [0]))
+except ValueError as e:
+    print("ValueError", e)
+try:
+    array.dot(a, b"\x00\x00")
+except TypeError as e:
+    print("TypeError", e)
+try:
+    array.sum(array.array("O", [1]))
+except TypeError as e:
+    print("TypeError", e)
+
+# output must be writable
+try:
+    array.add(b"\x01", 1, b"\x00")
+except TypeError:
+    print("TypeError")
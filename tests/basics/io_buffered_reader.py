@@ -0,0 +1,50 @@
+import io
+
+try:
+    io.BytesIO
+    io.BufferedReader
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+data = b"first line\nsecond\n\nlast line is longer than the buffer"
+
+buf = io.BufferedReader(io.BytesIO(data), 8)
+print(buf.readline())
+print(buf.read(3))
+print(buf.tell())
+print(buf.readline())
+print(buf.readline())
+print(buf.readline(10))
+print(buf.read())
+print(buf.read())
+
+# iteration and readlines
+print(list(io.BufferedReader(io.BytesIO(data), 4)))
+print(io.BufferedReader(io.BytesIO(data), 16).readlines())
+
+# seek discards read-ahead data
+buf = io.BufferedReader(io.BytesIO(data), 8)
+print(buf.read(2))
+print(buf.seek(-1, 1))
+print(buf.read(3))
+print(buf.seek(6))
+print(buf.readline())
+
+# readinto
+buf = io.BufferedReader(io.BytesIO(data), 8)
+b = bytearray(5)
+print(buf.readinto(b), b)
+
+# context manager closes the underlying stream
+bts = io.BytesIO(data)
+with io.BufferedReader(bts) as buf:
+    print(buf.readline())
+try:
+    bts.read()
+except ValueError:
+    print("ValueError")
+
+# a buffer of 64k or more
+buf = io.BufferedReader(io.BytesIO(b"x" * 70000 + b"\nend\n"), 70000)
+print(len(buf.readline()), buf.readline())
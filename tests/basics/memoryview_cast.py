@@ -0,0 +1,87 @@
+# test memoryview.cast, and strided and 2-dimensional memoryviews
+
+try:
+    memoryview(b"").cast
+except (NameError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+import array
+
+# cast bytes to a wider type and back
+b = bytearray(range(8))
+m = memoryview(b).cast("H")
+print(len(m), m.tolist() == list(array.array("H", b)))
+m2 = m.cast("B")
+print(len(m2), m2.tolist())
+print(len(memoryview(b).cast("@i")))
+
+# cast to 2 dimensions
+m = memoryview(b).cast("B", (2, 4))
+print(m.ndim, m.shape, m.strides)
+print(m.tolist())
+print(m[1, 2], m[-1, -1])
+m[0, 1] = 100
+print(b[1])
+print(len(m), m.tobytes())
+print(m == memoryview(b).cast("B", [2, 4]))
+
+# strided 1-D views
+b = bytearray(range(10))
+m = memoryview(b)
+print(m[::2].tolist(), m[::-3].tolist(), m[1::2].tobytes())
+print(list(m[::3]), len(m[::3]), m[5:2:-1].strides, m[::3].shape)
+m[::2] = bytes(5)
+print(b)
+m[1::2] = m[::-2]
+print(b)
+m[1::2] = memoryview(b)[::2]
+print(b)
+print(bytes(m[::4]) == m[::4].tobytes())
+print(m[::2] == bytes(5), m[::2] == b"abc")
+print(m[5:5:2].tolist(), m[2:5:-1].tobytes())
+
+# strided view of an array and of a cast view
+a = array.array("h", [1, -2, 3, -4, 5, -6])
+m = memoryview(a)[::2]
+print(m.tolist(), m.strides)
+print(memoryview(a).cast("B").cast("h", [3, 2]).tolist())
+print(memoryview(a).cast("B").cast("h")[1::2].tolist())
+
+# a memoryview of a strided memoryview
+m = memoryview(b)[::3]
+print(memoryview(m).tolist(), memoryview(m).strides)
+
+# read-only views stay read-only
+m = memoryview(b"abcdef").cast("B", (2, 3))
+try:
+    m[0, 0] = 1
+except TypeError:
+    print("TypeError")
+
+# errors
+m = memoryview(bytearray(6))
+for args in (("H", (2, 2)), ("B", (2, 2)), ("B", (6, -1))):
+    try:
+        m.cast(*args)
+    except (TypeError, ValueError):
+        print("error")
+# a shape whose product overflows must not wrap around to the buffer size
+import sys
+
+try:
+    memoryview(bytearray(24)).cast("B", (8, (sys.maxsize + 1) // 4 + 3))
+except ValueError:
+    print("ValueError")
+try:
+    m.cast("i")
+except TypeError:
+    print("TypeError")
+try:
+    m[::2].cast("B")
+except TypeError:
+    print("TypeError")
+try:
+    m.cast("B", (2, 3))[0, 3]
+except IndexError:
+    print("IndexError")
@@ -0,0 +1,55 @@
+# test sub-views of 2-dimensional memoryviews (an extension to CPython)
+
+try:
+    memoryview(b"").cast
+except (NameError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+b = bytearray(range(12))
+m = memoryview(b).cast("B", (3, 4))
+
+# rows, columns and sub-regions
+print(m[1].tolist(), m[-1].strides)
+print([r.tolist() for r in m])
+print(m[:, 1].tolist(), m[:, 1].strides)
+print(m[:, 1:3].tolist(), m[:, 1:3].shape)
+print(m[::-1, ::2].tolist(), m[::-1, ::2].strides)
+print(m[1:, ::3].tobytes(), m[1:].tobytes())
+print(m[0:0].shape, m[:, 4:].tolist())
+print(memoryview(m[:, 2]).tolist())
+
+# store into a sub-region
+m[:, 0] = b"xyz"
+print(b)
+m[1, 1:3] = bytes([99, 98])
+print(b)
+m[1:, 2:] = memoryview(bytearray(b"abcd")).cast("B", (2, 2))
+print(b)
+m[2] = m[0]
+print(b)
+
+# overlapping source and destination
+m = memoryview(b)
+m[::2] = m[:6]
+print(b)
+m[::-1] = m
+print(b)
+
+# 1-D views also accept a tuple
+print(m[1::2,].tolist())
+
+# errors
+m = memoryview(bytearray(12)).cast("B", (3, 4))
+try:
+    m[:, 0] = b"ab"
+except ValueError:
+    print("ValueError")
+try:
+    m[0, 0, 0]
+except TypeError:
+    print("TypeError")
+try:
+    memoryview(bytearray(8))[1:5].cast("i")
+except ValueError:
+    print("ValueError")
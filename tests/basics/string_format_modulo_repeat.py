@@ -0,0 +1,50 @@
+# test % formatting repeatedly with the same format string, which may use a
+# cached parsed form of the string after the first time
+
+try:
+    "" % ()
+except TypeError:
+    print("SKIP")
+    raise SystemExit
+
+
+class A:
+    def __repr__(self):
+        return "A()"
+
+    def __str__(self):
+        return "a"
+
+
+def test(fmt, args):
+    for i in range(3):
+        try:
+            print(repr(fmt % args))
+        except (KeyError, TypeError, ValueError) as er:
+            print(type(er).__name__)
+
+
+test("%d", 5)
+test("a%sb%rc", ("x", "y"))
+test("%5d|%-5d|%05d|%+d|% d", (1, 2, 3, 4, 5))
+test("%x %X %#x %o %#o", (255, 255, 255, 8, 8))
+test("%c%c", (65, "b"))
+test("%*d|%.*s|%*.*s", (5, 1, 2, "abc", 8, 3, "defgh"))
+test("%(a)s-%(b)05d", {"a": "x", "b": 7})
+test("100%% %s %%", ("done",))
+test("%s %r", (A(), A()))
+test("%.3s|%5s|%-5s|", ("abcdef", "ab", "cd"))
+test("no fields", ())
+test("", ())
+
+# the same format string with different arguments
+fmt = "<%3s|%r>"
+for args in ((1, 2), ("a", "b"), (True, None)):
+    test(fmt, args)
+
+# errors that depend on the arguments, after the format string has been used
+for args in ((1, 2), (1,), (1, 2, 3), {"a": 1}, ("x", "y")):
+    test("%d %d", args)
+    test("%(a)s", args)
+    test("%*d", args)
+    test("%c", args)
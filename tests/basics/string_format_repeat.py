@@ -0,0 +1,50 @@
+# test formatting repeatedly with the same format string, which may use a
+# cached parsed form of the string after the first time
+
+
+class A:
+    def __repr__(self):
+        return "A()"
+
+    def __str__(self):
+        return "a"
+
+
+def test(fmt, *args, **kwargs):
+    for i in range(3):
+        try:
+            print(repr(fmt.format(*args, **kwargs)))
+        except (IndexError, KeyError, ValueError) as er:
+            print(type(er).__name__)
+
+
+test("{}", 1)
+test("x{}y{}z", 1, "s")
+test("{0}{1}{0}", "a", "b")
+test("{!r} {!s} {}", "q", A(), A())
+test("{:>6}|{:<6}|{:^7}|", "ab", 12, True)
+test("{:+d} {: d} {:x} {:#x} {:o} {:#o} {:b} {:c}", 5, 7, 255, 255, 8, 8, 5, 65)
+test("{name}={value:5}", name="k", value=42)
+test("{{}} {} }}{{", 9)
+test("{:*^10s}", "mid")
+test("{:010}", -42)
+test("{:010}", "s")
+test("{!r:>10}", "x")
+test("{:,}", 1234567)
+test("plain text")
+test("")
+test("{:.3}", "abcdef")
+test("{:}", True)
+test("{:d}", True)
+test("{0:{1}}", 3, 5)
+test("{:{}}", 3, 5)
+
+# the same format string with different arguments
+fmt = "<{:4}|{}>"
+for args in ((1, 2), ("a", "b"), (True, None)):
+    test(fmt, *args)
+
+# errors that depend on the arguments, after the format string has been used
+for args, kwargs in (((1, 2), {}), ((1,), {}), ((), {"x": 1}), (("s",), {})):
+    test("{} {}", *args, **kwargs)
+    test("{x:d}", *args, **kwargs)
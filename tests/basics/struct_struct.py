@@ -0,0 +1,58 @@
+# test struct.Struct and struct.iter_unpack
+
+try:
+    import struct
+
+    struct.Struct
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+s = struct.Struct("<HhIBxq2s")
+print(s.size, s.format, struct.calcsize(s.format))
+
+# pack and unpack agree with the module-level functions
+b = s.pack(1, -2, 3, 4, 5, b"ab")
+print(b, s.unpack(b), struct.unpack(s.format, b))
+
+# unpack_from, with positive and negative offsets
+print(s.unpack_from(b * 2, s.size), s.unpack_from(b * 2, -s.size))
+
+# pack_into
+ba = bytearray(30)
+s.pack_into(ba, 2, 1, 2, 3, 4, 5, b"x")
+print(ba)
+
+# native alignment, counts, padding and byte orders
+for fmt in ("@hb3i0s2x", ">3Hq", "bL", "!hh", "<2s3b"):
+    t = struct.Struct(fmt)
+    values = t.unpack(bytes(range(t.size)))
+    print(fmt, t.size, values, t.pack(*values) == struct.pack(fmt, *values))
+
+# iter_unpack, as a method and a function
+print(list(s.iter_unpack(b * 3)))
+print(list(struct.iter_unpack("<bh", bytes(range(12)))))
+print(list(s.iter_unpack(b"")))
+
+# errors
+for buf in (bytes(7), bytearray(21)):
+    try:
+        s.iter_unpack(buf)
+    except Exception:
+        print("error")
+try:
+    struct.Struct("").iter_unpack(b"")
+except Exception:
+    print("error")
+try:
+    s.unpack(b"123")
+except Exception:
+    print("error")
+try:
+    s.pack_into(bytearray(10), 0, 1)
+except Exception:
+    print("error")
+try:
+    struct.Struct("<Z")
+except Exception:
+    print("error")
@@ -0,0 +1,30 @@
+# test MicroPython-specific features of struct.Struct
+
+try:
+    import struct
+
+    struct.Struct
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+s = struct.Struct("<HhI2s")
+
+# unpack_from can store the values into an existing list
+out = [None] * 4
+print(s.unpack_from(b"\x01\x00\x02\x00\x03\x00\x00\x00ab", 0, out) is out, out)
+print(s.unpack_from(b"xx\x01\x00\xfe\xff\x03\x00\x00\x00cd", 2, out), out)
+print(s.unpack_from(b"\x01\x00\x02\x00\x03\x00\x00\x00ab", 0, None))
+
+# the list must be the right length, and not a tuple
+try:
+    s.unpack_from(bytes(10), 0, [0])
+except ValueError:
+    print("ValueError")
+try:
+    s.unpack_from(bytes(10), 0, (0, 0, 0, 0))
+except TypeError:
+    print("TypeError")
+
+# pack can accept less arguments than required for the format spec
+print(s.pack(1))
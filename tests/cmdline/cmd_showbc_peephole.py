@@ -0,0 +1,12 @@
+# cmdline: -v -v -O1
+# test printing of bytecode with jumps improved by the peephole optimiser
+
+
+def f(a, b):
+    if a:
+        print(a)
+    else:
+        for x in b:
+            if x:
+                continue
+            print(x)
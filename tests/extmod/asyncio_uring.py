@@ -0,0 +1,155 @@
+# test the io_uring backend of asyncio with a server and clients over loopback
+
+try:
+    import asyncio
+    import asyncio.uring
+
+    asyncio.uring.new_event_loop()
+except (ImportError, OSError):
+    print("SKIP")
+    raise SystemExit
+
+PORT = 8004
+
+
+async def handle_connection(reader, writer):
+    print("server: peername", len(writer.get_extra_info("peername")) > 0)
+    line = await reader.readline()
+    print("server: readline", line)
+    if not line:
+        writer.close()
+        await writer.wait_closed()
+        return
+    data = await reader.readexactly(6)
+    print("server: readexactly", data)
+    buf = bytearray(8)
+    n = await reader.readinto(buf)
+    print("server: readinto", buf[:n])
+    # echo back 12 bytes in pieces
+    n = 0
+    while n < 12:
+        data = await reader.read(3)
+        n += len(data)
+        writer.write(data)
+        await writer.drain()
+    writer.write(b"x" * 100000)
+    await writer.drain()
+    writer.close()
+    await writer.wait_closed()
+
+
+async def client(n):
+    reader, writer = await asyncio.open_connection("127.0.0.1", PORT)
+    writer.write(b"line %d\n" % n)
+    writer.write(b"exact!")
+    await writer.drain()
+    await asyncio.sleep_ms(20)
+    writer.write(b"into")
+    await writer.drain()
+    await asyncio.sleep_ms(20)
+    writer.write(b"echo me back")
+    await writer.drain()
+    echoed = await reader.readexactly(12)
+    print("client: echoed", echoed)
+    total = 0
+    while True:
+        data = await reader.read(4096)
+        if not data:
+            break
+        total += len(data)
+    print("client: bulk", total)
+    writer.close()
+    await writer.wait_closed()
+
+
+async def wait_read_cancelled():
+    reader, writer = await asyncio.open_connection("127.0.0.1", PORT)
+    t = asyncio.create_task(reader.read(10))
+    await asyncio.sleep_ms(20)
+    t.cancel()
+    try:
+        await t
+    except asyncio.CancelledError:
+        print("read cancelled")
+    writer.close()
+    await writer.wait_closed()
+    await asyncio.sleep_ms(20)
+
+
+async def handle_send_lines(reader, writer):
+    writer.write(b"hello\nworld\n")
+    await writer.drain()
+    await reader.read(10)
+    writer.close()
+    await writer.wait_closed()
+
+
+async def read_cancelled_after_data():
+    # a read that's cancelled after the peer's data arrived mustn't lose the data
+    server = await asyncio.start_server(handle_send_lines, "127.0.0.1", PORT + 1)
+    reader, writer = await asyncio.open_connection("127.0.0.1", PORT + 1)
+    await asyncio.sleep_ms(20)
+    try:
+        data = await asyncio.wait_for(reader.read(3), 0)
+    except asyncio.TimeoutError:
+        data = b""
+    data += await asyncio.wait_for(reader.readline(), 1)
+    print("after cancel", data, await asyncio.wait_for(reader.read(10), 1))
+    writer.close()
+    await writer.wait_closed()
+    server.close()
+    await server.wait_closed()
+
+
+async def main():
+    server = await asyncio.start_server(handle_connection, "127.0.0.1", PORT)
+    await client(1)
+    await client(2)
+
+    # a flag has no file descriptor, so is polled alongside the ring
+    flag = asyncio.ThreadSafeFlag()
+
+    async def set_flag():
+        await asyncio.sleep_ms(10)
+        flag.set()
+
+    asyncio.create_task(set_flag())
+    await flag.wait()
+    print("flag")
+
+    await wait_read_cancelled()
+    await read_cancelled_after_data()
+
+    # cancel the server while it waits to accept a connection
+    server.close()
+    await server.wait_closed()
+    print("server closed")
+
+
+print("uring")
+asyncio.run(main())
+
+# the default event loop gives the same results
+print("poll")
+asyncio.new_event_loop()
+asyncio.run(main())
+
+# closing a ring, explicitly or by the finaliser, cancels the ops still in flight
+import gc, socket, _uring
+
+s = socket.socket()
+s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(socket.getaddrinfo("127.0.0.1", PORT + 2)[0][-1])
+s.listen(1)
+for close in (True, False):
+    ring = _uring.Ring(4)
+    for _ in range(8):
+        ring.accept(s)
+    ring.poll(s, 1)
+    print(list(ring.wait(10)))
+    if close:
+        ring.close()
+    ring = None
+    gc.collect()
+s.close()
+print("rings closed")
@@ -19,3 +19,8 @@ print(hex(binascii.crc32(b" over the lazy dog", binascii.crc32(b"The quick brown
 print(hex(binascii.crc32(b"\x00" * 16, binascii.crc32(b"\x00" * 16))))
 print(hex(binascii.crc32(b"\xff" * 16, binascii.crc32(b"\xff" * 16))))
 print(hex(binascii.crc32(bytes(range(16, 32)), binascii.crc32(bytes(range(16))))))
+
+# lengths around the 16/64-byte block sizes used by accelerated code paths
+data = bytes(range(256)) * 4
+for n in (63, 64, 65, 79, 80, 127, 128, 129, 1000, 1024):
+    print(n, hex(binascii.crc32(data[:n])), hex(binascii.crc32(data[:n], 0x12345678)))
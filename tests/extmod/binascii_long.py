@@ -0,0 +1,31 @@
+# Test base64 and hex conversions on inputs long enough to use any
+# accelerated code paths, including the transitions to the scalar tail.
+try:
+    import binascii
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+# Deterministic pseudo-random data covering all byte values.
+data = bytes((i * 167 + (i >> 3) * 13) & 0xFF for i in range(300))
+
+for n in (15, 16, 17, 23, 24, 28, 31, 32, 33, 47, 48, 63, 64, 65, 100, 255, 300):
+    d = data[:n]
+    e = binascii.b2a_base64(d)
+    print(n, e)
+    print(binascii.a2b_base64(e) == d)
+    h = binascii.hexlify(d)
+    print(binascii.crc32(h), binascii.unhexlify(h) == d)
+
+# Decoding with line breaks, padding and junk inside a long input.
+e = binascii.b2a_base64(data, newline=False)
+print(binascii.a2b_base64(b"\n".join(e[i : i + 76] for i in range(0, len(e), 76))) == data)
+print(binascii.a2b_base64(e[:40] + b"!" + e[40:]) == data)
+print(binascii.a2b_base64(e[:37] + b"@" + e[37:]) == data)
+print(binascii.a2b_base64(e[:-2] + b"\x80\xff" + e[-2:]) == data)
+print(binascii.a2b_base64(b"Zm9v" * 8 + b"YmFy=" + b"Zm9v" * 8))
+
+try:
+    binascii.a2b_base64(e[:-1] * 2)
+except ValueError:
+    print("ValueError")
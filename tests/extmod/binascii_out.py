@@ -0,0 +1,60 @@
+# Test the MicroPython-specific out= argument of the binascii functions.
+try:
+    import binascii
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    binascii.b2a_base64(b"", out=bytearray(1))
+except TypeError:
+    print("SKIP")
+    raise SystemExit
+
+data = bytes(range(40))
+
+buf = bytearray(64)
+n = binascii.b2a_base64(data, out=buf)
+print(n, buf[:n] == binascii.b2a_base64(data))
+n = binascii.b2a_base64(data, newline=False, out=buf)
+print(n, buf[:n] == binascii.b2a_base64(data, newline=False))
+print(binascii.b2a_base64(b"", newline=False, out=bytearray(0)))
+
+enc = binascii.b2a_base64(data)
+buf = bytearray(50)
+n = binascii.a2b_base64(enc, out=buf)
+print(n, buf[:n] == data, buf[n:])
+mv = memoryview(buf)
+n = binascii.a2b_base64(b"Zm9vYmFy", out=mv[10:])
+print(n, buf[10:16])
+print(binascii.a2b_base64(b"", out=bytearray(0)))
+
+buf = bytearray(80)
+n = binascii.hexlify(data, out=buf)
+print(n, buf[:n] == binascii.hexlify(data))
+n = binascii.hexlify(b"\x01\x02\x03", ":", out=buf)
+print(n, buf[:n])
+print(binascii.hexlify(b"", out=bytearray(0)))
+
+buf = bytearray(4)
+n = binascii.unhexlify(b"deadbeef", out=buf)
+print(n, buf)
+print(binascii.unhexlify(b"", out=buf))
+
+# output buffer too small
+for f, arg in (
+    (binascii.b2a_base64, data),
+    (binascii.a2b_base64, enc),
+    (binascii.hexlify, data),
+    (binascii.unhexlify, b"00" * 5),
+):
+    try:
+        f(arg, out=bytearray(4))
+    except ValueError as er:
+        print("ValueError", er)
+
+# output buffer must be writable
+try:
+    binascii.hexlify(data, out=b"0" * 80)
+except TypeError:
+    print("TypeError")
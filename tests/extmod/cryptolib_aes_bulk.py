@@ -0,0 +1,20 @@
+# Test multi-block and in-place operation, which may take different code
+# paths to single blocks.
+try:
+    from cryptolib import aes
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+data = bytes((i * 7 + 3) & 0xFF for i in range(80))
+iv = bytes(range(16))
+
+for key in (b"1234" * 4, b"12345678" * 4):
+    for mode, args in ((1, ()), (2, (iv,))):
+        enc = aes(key, mode, *args).encrypt(data)
+        print(len(key), mode, enc)
+        buf = bytearray(enc)
+        dec = aes(key, mode, *args)
+        dec.decrypt(buf[:48], memoryview(buf)[:48])
+        dec.decrypt(memoryview(buf)[48:], memoryview(buf)[48:])
+        print(buf == data)
@@ -0,0 +1,110 @@
+try:
+    from cryptolib import aes
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+MODE_GCM = 11
+
+try:
+    aes(b"x" * 16, MODE_GCM, b"x" * 12)
+except ValueError as e:
+    # is GCM support disabled?
+    if e.args[0] == "mode":
+        print("SKIP")
+        raise SystemExit
+    raise e
+
+# Test vectors from the GCM specification (McGrew & Viega), test cases 1-4.
+crypto = aes(bytes(16), MODE_GCM, bytes(12))
+print(crypto.digest())
+crypto = aes(bytes(16), MODE_GCM, bytes(12))
+print(crypto.encrypt(bytes(16)), crypto.digest())
+
+key = bytes.fromhex("feffe9928665731c6d6a8f9467308308")
+iv = bytes.fromhex("cafebabefacedbaddecaf888")
+pt = bytes.fromhex(
+    "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+    "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b391aafd255"
+)
+aad = bytes.fromhex("feedfacedeadbeeffeedfacedeadbeefabaddad2")
+crypto = aes(key, MODE_GCM, iv)
+print(crypto.encrypt(pt), crypto.digest())
+crypto = aes(key, MODE_GCM, iv)
+crypto.update(aad)
+ct = crypto.encrypt(pt[:60])
+tag = crypto.digest()
+print(ct, tag)
+
+# Test case 6: 60-byte IV, and test case 16: 256-bit key.
+iv60 = bytes.fromhex(
+    "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728"
+    "c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b"
+)
+crypto = aes(key, MODE_GCM, iv60)
+crypto.update(aad)
+print(crypto.encrypt(pt[:60]), crypto.digest())
+crypto = aes(key + key, MODE_GCM, iv)
+crypto.update(aad)
+print(crypto.encrypt(pt[:60]), crypto.digest())
+
+# Decrypt in-place and verify, with the full and a truncated tag.
+buf = bytearray(ct)
+crypto = aes(key, MODE_GCM, iv)
+crypto.update(aad)
+crypto.decrypt(buf, buf)
+print(buf == pt[:60])
+crypto.verify(tag)
+crypto.verify(tag[:8])
+
+# Streaming in uneven pieces gives the same result as one call.
+data = bytes(range(256)) * 4
+crypto = aes(key, MODE_GCM, iv)
+crypto.update(aad[:3])
+crypto.update(aad[3:])
+whole = crypto.encrypt(data)
+whole_tag = crypto.digest()
+crypto = aes(key, MODE_GCM, iv)
+crypto.update(aad)
+pieces = b""
+pos = 0
+for n in (1, 15, 16, 17, 64, 100, 5, 0, 300):
+    pieces += crypto.encrypt(data[pos : pos + n])
+    pos += n
+pieces += crypto.encrypt(data[pos:])
+print(pieces == whole, crypto.digest() == whole_tag)
+
+# Tampered data or tag is detected.
+for ct_bad, tag_bad in ((b"\x00" + whole[1:], whole_tag), (whole, whole_tag[:-1] + b"\x00")):
+    crypto = aes(key, MODE_GCM, iv)
+    crypto.update(aad)
+    crypto.decrypt(ct_bad)
+    try:
+        crypto.verify(tag_bad)
+    except ValueError as er:
+        print("ValueError", er)
+
+# Invalid usage.
+crypto = aes(key, MODE_GCM, iv)
+crypto.encrypt(b"abc")
+try:
+    crypto.update(aad)
+except ValueError:
+    print("ValueError")
+crypto.digest()
+try:
+    crypto.encrypt(b"abc")
+except ValueError:
+    print("ValueError")
+try:
+    crypto.verify(b"abc")
+except ValueError:
+    print("ValueError")
+try:
+    aes(key, MODE_GCM)
+except ValueError:
+    print("ValueError")
+try:
+    aes(key, 1).digest()
+except ValueError:
+    print("ValueError")
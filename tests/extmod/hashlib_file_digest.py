@@ -0,0 +1,31 @@
+# test hashlib.file_digest
+
+try:
+    import hashlib, io
+
+    hashlib.file_digest
+    io.BytesIO
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+data = bytes(range(256)) * 20
+
+# by name, and via a callable
+print(hashlib.file_digest(io.BytesIO(data), "sha256").digest())
+print(hashlib.file_digest(io.BytesIO(data), hashlib.sha256).digest())
+print(hashlib.file_digest(io.BytesIO(b""), "sha256").digest())
+
+# small buffer size so that there are many chunks and a short final chunk
+print(hashlib.file_digest(io.BytesIO(data), "sha256", _bufsize=100).digest())
+
+# result is an unfinalised hash object
+h = hashlib.file_digest(io.BytesIO(b"abc"), "sha256")
+h.update(b"def")
+print(h.digest() == hashlib.sha256(b"abcdef").digest())
+
+# unknown hash name
+try:
+    hashlib.file_digest(io.BytesIO(data), "no-such-hash")
+except ValueError:
+    print("ValueError")
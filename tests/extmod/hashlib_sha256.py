@@ -33,3 +33,11 @@ print(hashlib.sha256(b"\xff" * 56).digest())
 # print(h.digest())
 # h.update(b'456')
 # print(h.digest())
+
+# multi-block inputs, fed in pieces that straddle block boundaries
+data = bytes(range(256)) * 9
+print(hashlib.sha256(data).digest())
+h = hashlib.sha256()
+for i in range(0, len(data), 37):
+    h.update(data[i : i + 37])
+print(h.digest())
@@ -0,0 +1,52 @@
+# test search/split/sub on patterns with a literal prefix, and repeated
+# module-level calls that go through the compiled pattern cache
+
+try:
+    import re
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+# literal prefix followed by more complex pattern
+m = re.search("abc[0-9]+", "xxabcyabc123z")
+print(m.group(0))
+print(re.search("abc", "ababab"))
+print(re.search("abc", "xxab"))
+print(re.search("ab", "ab").group(0))
+print(re.search("b", "").group(0) if re.search("b", "") else None)
+
+# prefix interrupted by a repeat or alternation
+print(re.search("ab*c", "xacxabbc").group(0))
+print(re.search("ab?c", "xxabxac").group(0))
+print(re.search("ab+c", "xxabbbc").group(0))
+print(re.search("abc|xyz", "--xyz--").group(0))
+print(re.search("(ab)c", "ababc").group(0))
+print(re.search("(?:ab)?c", "xxc").group(0))
+
+# prefix with escapes and a beginning-of-line assertion later on
+print(re.search("\\.\\.x", "a..b..x").group(0))
+print(re.search("a^", "aaa"))
+print(re.search("a$", "aaa").group(0))
+
+# bytes subject
+print(re.search(b"ll", b"hello").group(0))
+
+# split and sub use the prefilter for every match
+print(re.compile("--").split("a--b--c----d"))
+print(re.sub("ab", "X", "abcabcab"))
+print(re.sub("a(b)", "\\1", "xabyab"))
+
+# repeated module-level calls with the same pattern, plus many distinct
+# patterns to exercise cache eviction
+for i in range(3):
+    print(re.match("[a-z]+", "hello world").group(0))
+for i in range(20):
+    p = "k%d=" % i
+    print(re.search(p, "k1=a k%d=b" % i).group(0), end=" ")
+print()
+print(re.search("k1=", "k1=").group(0))
+
+# str and bytes patterns with the same content are cached independently of
+# the subject type
+print(re.search("ab", "xab").group(0))
+print(re.search(b"ab", b"xab").group(0))
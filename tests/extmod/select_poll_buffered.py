@@ -0,0 +1,39 @@
+# Test select.poll on a stream that has read data ahead into a buffer: the
+# buffered data is ready to read even though the file descriptor isn't.
+
+try:
+    import select, socket
+
+    select.poll
+    socket.socket.makefile
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+addr = socket.getaddrinfo("127.0.0.1", 8005)[0][-1]
+server = socket.socket()
+server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+server.bind(addr)
+server.listen(1)
+client = socket.socket()
+client.connect(addr)
+s, _ = server.accept()
+
+# Send two lines at once, then read one of them.
+client.write(b"a\nb\n")
+f = s.makefile("rb")
+print(f.readline())
+
+poller = select.poll()
+poller.register(f, select.POLLIN)
+print([ev for _, ev in poller.poll(0)])
+for _, ev in poller.ipoll(0):
+    print(ev)
+print(f.readline())
+
+# Nothing is left to read.
+print(poller.poll(0))
+
+client.close()
+s.close()
+server.close()
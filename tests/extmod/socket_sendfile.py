@@ -0,0 +1,61 @@
+# test socket.sendfile() over a loopback TCP connection
+
+try:
+    import io, os, socket
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    s = socket.socket()
+    s.sendfile
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    addr = socket.getaddrinfo("127.0.0.1", 8004)[0][-1]
+    s.bind(addr)
+    s.listen(1)
+except (OSError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+c = socket.socket()
+c.connect(addr)
+a, _ = s.accept()
+
+
+def recv_exactly(n):
+    data = b""
+    while len(data) < n:
+        data += a.recv(n - len(data))
+    return data
+
+
+data = bytes(range(256)) * 40
+with open("testfile", "wb") as f:
+    f.write(data)
+
+with open("testfile", "rb") as f:
+    # whole file
+    print(c.sendfile(f), recv_exactly(len(data)) == data, f.tell())
+
+    # offset and count, after reading ahead from the file
+    f.seek(0)
+    f.read(10)
+    print(c.sendfile(f, 1000, 3000), recv_exactly(3000) == data[1000:4000], f.tell())
+    print(f.read(4) == data[4000:4004])
+
+    # count beyond the end of the file
+    print(c.sendfile(f, len(data) - 5, 100), recv_exactly(5) == data[-5:], f.tell())
+
+    # count must be positive
+    try:
+        c.sendfile(f, 0, 0)
+    except ValueError:
+        print("ValueError")
+
+# a stream that isn't a file
+print(c.sendfile(io.BytesIO(data), 100, 50), recv_exactly(50) == data[100:150])
+
+c.close()
+a.close()
+s.close()
+os.remove("testfile")
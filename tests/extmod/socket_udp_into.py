@@ -0,0 +1,50 @@
+# test receiving UDP datagrams into existing buffers, and scatter/gather I/O
+
+try:
+    import socket
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.recv_into
+    addr = socket.getaddrinfo("127.0.0.1", 8001)[0][-1]
+    s.bind(addr)
+except (OSError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+c = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+buf = bytearray(8)
+
+# recv_into, with and without nbytes
+c.sendto(b"abcdef", addr)
+print(s.recv_into(buf), buf)
+c.sendto(b"123456", addr)
+print(s.recv_into(buf, 3), buf)
+c.sendto(b"xyz", addr)
+print(s.recv_into(memoryview(buf)[4:]), buf)
+try:
+    s.recv_into(buf, 9)
+except ValueError:
+    print("ValueError")
+
+# recvfrom_into
+c.sendto(b"hello", addr)
+n, a = s.recvfrom_into(buf)
+print(n, buf[:n])
+
+# sendmsg gathers the buffers into one datagram
+c.connect(addr)
+print(c.sendmsg([b"ab", bytearray(b"cd"), memoryview(b"efg")]))
+print(s.recv(16))
+
+# recvmsg_into scatters one datagram into the buffers
+c.send(b"0123456789")
+bufs = [bytearray(4), bytearray(4), bytearray(4)]
+n, anc, flags, a = s.recvmsg_into(bufs)
+print(n, anc, bufs)
+
+c.close()
+s.close()
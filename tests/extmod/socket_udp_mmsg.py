@@ -0,0 +1,49 @@
+# test sending and receiving batches of UDP datagrams (MicroPython extension)
+
+try:
+    import socket
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.recvmmsg
+    addr = socket.getaddrinfo("127.0.0.1", 8002)[0][-1]
+    s.bind(addr)
+except (OSError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+c = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+
+# send to an address, receive fewer datagrams than there are buffers
+print(c.sendmmsg([b"one", b"two", bytearray(b"three")], 0, addr))
+bufs = [bytearray(8) for _ in range(4)]
+lengths = [0] * 4
+n = s.recvmmsg(bufs, lengths)
+print(n, lengths[:n], [bufs[i][: lengths[i]] for i in range(n)])
+
+# send on a connected socket, receive with a limit from the lengths list
+c.connect(addr)
+print(c.sendmmsg([b"a", b"bb", b"ccc"]))
+lengths = [0] * 2
+print(s.recvmmsg(bufs, lengths), lengths, bufs[0][:1], bufs[1][:2])
+addrs = [None]
+print(s.recvmmsg(bufs, lengths, 0, addrs), lengths, bufs[0][:3], addrs[0] is not None)
+
+# non-blocking with nothing to receive
+s.setblocking(False)
+try:
+    s.recvmmsg(bufs, lengths)
+except OSError:
+    print("OSError")
+
+# lengths must be a list
+try:
+    s.recvmmsg(bufs, (0, 0))
+except TypeError:
+    print("TypeError")
+
+c.close()
+s.close()
@@ -0,0 +1,66 @@
+# test uctypes.compile, which pre-decodes a descriptor for faster field access
+
+import sys
+
+try:
+    import uctypes
+
+    uctypes.compile
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+desc = {
+    "s0": uctypes.UINT16 | 0,
+    "sub": (0, {"b0": uctypes.UINT8 | 0, "b1": uctypes.UINT8 | 1}),
+    "arr": (uctypes.ARRAY | 0, uctypes.UINT8 | 2),
+    "arr2": (uctypes.ARRAY | 0, 2, {"b": uctypes.UINT8 | 0}),
+    "bf0": uctypes.BFUINT16 | 0 | 0 << uctypes.BF_POS | 4 << uctypes.BF_LEN,
+    "bf1": uctypes.BFUINT16 | 0 | 4 << uctypes.BF_POS | 4 << uctypes.BF_LEN,
+    "bf3": uctypes.BFUINT16 | 0 | 12 << uctypes.BF_POS | 4 << uctypes.BF_LEN,
+    "u32": uctypes.UINT32 | 0,
+    "i32": uctypes.INT32 | 0,
+    "i8": uctypes.INT8 | 1,
+}
+
+cdesc = uctypes.compile(desc)
+print(type(cdesc))
+print(uctypes.compile(cdesc) is cdesc)
+print(uctypes.sizeof(cdesc) == uctypes.sizeof(desc))
+
+# the compiled descriptor gives the same results as the original one
+for layout in (uctypes.LITTLE_ENDIAN, uctypes.BIG_ENDIAN, uctypes.NATIVE):
+    data = bytearray(b"01\xf0\xff")
+    S = uctypes.struct(uctypes.addressof(data), desc, layout)
+    C = uctypes.struct(uctypes.addressof(data), cdesc, layout)
+    print(uctypes.sizeof(C) == uctypes.sizeof(S))
+    for f in ("s0", "bf0", "bf1", "bf3", "u32", "i32", "i8"):
+        print(f, getattr(S, f) == getattr(C, f))
+    print(C.sub.b0, C.sub.b1, C.arr[0], C.arr[1], C.arr2[1].b)
+    C.bf1 = 0xA
+    C.sub.b1 = 0x40
+    C.i8 = -1
+    print(data)
+    C.s0 = 0x1234
+    print(data, hex(S.s0))
+
+print(uctypes.struct(0, cdesc))
+
+# a pointer to a struct
+cdesc = uctypes.compile({"ptr": (uctypes.PTR | 0, {"b": uctypes.UINT8 | 0})})
+data = uctypes.addressof(b"xy").to_bytes(uctypes.sizeof(cdesc), sys.byteorder)
+C = uctypes.struct(uctypes.addressof(data), cdesc)
+print(C.ptr[0].b, C.ptr[1].b)
+
+# unknown field
+try:
+    C.x
+except KeyError as e:
+    print("KeyError", e)
+
+# invalid descriptors
+for d in ([], {"x": []}, {1: uctypes.UINT8 | 0}):
+    try:
+        uctypes.compile(d)
+    except TypeError:
+        print("TypeError")
@@ -0,0 +1,30 @@
+# test element-wise arithmetic functions of the array module with floats
+try:
+    import array
+
+    array.add
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+for tc in "fd":
+    a = array.array(tc, [1.5, -2.0, 4.0])
+    b = array.array(tc, [0.5, 3.0, -1.0])
+    print(tc, list(array.add(a, b)), list(array.sub(a, b)), list(array.mul(a, b)))
+    print(tc, list(array.add(a, 1)), list(array.mul(a, 0.5)), list(array.scale(a, 2)))
+    print(tc, list(array.minimum(a, b)), list(array.maximum(a, 0)))
+    print(tc, array.sum(a), array.dot(a, b))
+
+# scaling integer arrays truncates and saturates
+print(array.scale(array.array("b", [-100, -3, 3, 100]), 1.5))
+print(array.scale(array.array("B", [1, 100, 200]), 1.5))
+print(array.scale(array.array("h", [1000, -1000]), -40.0))
+print(array.scale(array.array("H", [1000, 3]), -1.0))
+a = array.array("i", [10, 20])
+print(array.scale(a, 0.25, a), a)
+
+# an integer array can't be combined with a float scalar
+try:
+    array.add(array.array("i", [1]), 1.5)
+except TypeError:
+    print("TypeError")
@@ -0,0 +1,98 @@
+# test that imported .py files are cached in a __pycache__ directory
+
+import io, sys
+
+try:
+    import os
+
+    os.mkdir
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# We need a directory for testing that doesn't already exist.
+temp_dir = "micropy_test_cache_dir"
+try:
+    os.stat(temp_dir)
+    print("SKIP")
+    raise SystemExit
+except OSError:
+    pass
+
+cache_dir = temp_dir + "/__pycache__"
+os.mkdir(temp_dir)
+os.mkdir(cache_dir)
+sys.path.insert(0, temp_dir)
+
+
+def write(name, data):
+    with open(name, "w") as f:
+        f.write(data)
+
+
+def load():
+    sys.modules.pop("cached", None)
+    import cached
+
+    return cached.x, cached.f()
+
+
+def cleanup():
+    sys.path.pop(0)
+    for name in os.listdir(cache_dir):
+        os.remove(cache_dir + "/" + name)
+    os.remove(temp_dir + "/cached.py")
+    os.rmdir(cache_dir)
+    os.rmdir(temp_dir)
+
+
+write(temp_dir + "/cached.py", "x = 1\ndef f():\n    return (1.5, 'str', b'bytes', (2, 3))\n")
+result = load()
+if os.listdir(cache_dir) != ["cached.mpy"]:
+    # the port doesn't cache bytecode
+    cleanup()
+    print("SKIP")
+    raise SystemExit
+print(result)
+
+# load from the cache
+print(load())
+
+# a change to the source that keeps its length the same is picked up
+write(temp_dir + "/cached.py", "x = 2\ndef f():\n    return (1.5, 'str', b'bytes', (2, 3))\n")
+print(load())
+
+# a truncated cache file is ignored, and replaced
+with open(cache_dir + "/cached.mpy", "rb") as f:
+    data = f.read()
+with open(cache_dir + "/cached.mpy", "wb") as f:
+    f.write(data[: len(data) // 2])
+print(load())
+with open(cache_dir + "/cached.mpy", "rb") as f:
+    print(f.read() == data)
+
+# syntax errors are raised, and don't touch the cache
+write(temp_dir + "/cached.py", "x = (\n")
+try:
+    load()
+except SyntaxError:
+    print("SyntaxError")
+with open(cache_dir + "/cached.mpy", "rb") as f:
+    print(f.read() == data)
+
+# the cache isn't used when the module's path is different, so that tracebacks
+# refer to the path it was actually imported from
+write(temp_dir + "/cached.py", "def f():\n    raise ValueError\n")
+for path in (temp_dir, "./" + temp_dir):
+    sys.path[0] = path
+    sys.modules.pop("cached", None)
+    import cached
+
+    s = io.StringIO()
+    try:
+        cached.f()
+    except ValueError as e:
+        sys.print_exception(e, s)
+    print(('File "%s/cached.py"' % path) in s.getvalue())
+
+cleanup()
@@ -0,0 +1,10 @@
+import bench
+
+
+def test(num):
+    x = 0.0
+    for i in range(num // 10):
+        x = x * 0.5 + 1.0
+
+
+bench.run(test)
@@ -0,0 +1,15 @@
+import bench
+
+
+class Foo:
+    def meth(self):
+        pass
+
+
+def test(num):
+    o = Foo()
+    for i in range(num // 10):
+        m = o.meth
+
+
+bench.run(test)
@@ -0,0 +1,11 @@
+import bench
+
+
+def test(num):
+    l = [1]
+    for i in range(num // 10):
+        for x in l:
+            pass
+
+
+bench.run(test)
@@ -0,0 +1,9 @@
+import bench
+
+
+def test(num):
+    for i in range(num // 10):
+        f = lambda: i
+
+
+bench.run(test)
@@ -0,0 +1,14 @@
+# Array operation
+# Type: bytearray, inplace operation using array.add with the array as
+# output. The loop is done in C, and no extra memory is allocated.
+import array
+import bench
+
+
+def test(num):
+    for i in iter(range(num // 10000)):
+        arr = bytearray(b"\0" * 1000)
+        array.add(arr, 1, arr)
+
+
+bench.run(test)
@@ -0,0 +1,15 @@
+# Array operation
+# Type: bytearray, array.add returning a new array. This method requires
+# allocation of the same amount of memory as original array (to hold
+# result array). On the other hand, input array stays intact.
+import array
+import bench
+
+
+def test(num):
+    for i in iter(range(num // 10000)):
+        arr = bytearray(b"\0" * 1000)
+        arr2 = array.add(arr, 1)
+
+
+bench.run(test)
@@ -0,0 +1,3 @@
+import echo_loopback
+
+echo_loopback.run()
@@ -0,0 +1,5 @@
+import asyncio.uring
+import echo_loopback
+
+asyncio.uring.new_event_loop()
+echo_loopback.run()
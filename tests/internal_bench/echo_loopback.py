@@ -0,0 +1,79 @@
+# Helper for the asyncio_echo benchmarks, which runs an echo server and clients
+# over loopback and prints the elapsed time.  The throughput, the number of
+# times the event loop checked for IO, and the number of read and write system
+# calls are printed to stderr.  With select.poll each IO check is a poll()
+# system call, while io_uring only enters the kernel every few checks.
+
+import sys
+import time
+import asyncio
+
+PORT = 8005
+N_CLIENTS = 256
+N_ROUNDS = 200
+MSG = b"x" * 64
+
+
+def syscalls():
+    # read-like and write-like system calls made so far by this process
+    n = {}
+    with open("/proc/self/io") as f:
+        for line in f:
+            k, v = line.split(":")
+            n[k] = int(v)
+    return n["syscr"], n["syscw"]
+
+
+async def handle(reader, writer):
+    buf = bytearray(len(MSG))
+    while True:
+        n = await reader.readinto(buf)
+        if not n:
+            break
+        writer.write(buf[:n])
+        await writer.drain()
+    writer.close()
+    await writer.wait_closed()
+
+
+async def client():
+    reader, writer = await asyncio.open_connection("127.0.0.1", PORT)
+    for _ in range(N_ROUNDS):
+        writer.write(MSG)
+        await writer.drain()
+        await reader.readexactly(len(MSG))
+    writer.close()
+    await writer.wait_closed()
+
+
+async def main():
+    server = await asyncio.start_server(handle, "127.0.0.1", PORT, backlog=N_CLIENTS)
+    await asyncio.gather(*(client() for _ in range(N_CLIENTS)))
+    server.close()
+    await server.wait_closed()
+
+
+def run():
+    q = asyncio.core._io_queue
+    wait_io_event = q.wait_io_event
+    n_checks = 0
+
+    def counting_wait_io_event(dt):
+        nonlocal n_checks
+        n_checks += 1
+        wait_io_event(dt)
+
+    q.wait_io_event = counting_wait_io_event
+    r0, w0 = syscalls()
+    t = time.ticks_us()
+    asyncio.run(main())
+    t = time.ticks_diff(time.ticks_us(), t)
+    r1, w1 = syscalls()
+    n_msgs = N_CLIENTS * N_ROUNDS
+    print(
+        "{} msgs, {:.0f} msgs/s, {} IO checks, {} reads, {} writes".format(
+            n_msgs, n_msgs * 1e6 / t, n_checks, r1 - r0, w1 - w0
+        ),
+        file=sys.stderr,
+    )
+    print(t / 1e6)
@@ -0,0 +1,3 @@
+import json_requests
+
+json_requests.run()
@@ -0,0 +1,4 @@
+import micropython
+import json_requests
+
+json_requests.run(micropython.arena)
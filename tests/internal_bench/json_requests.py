@@ -0,0 +1,53 @@
+# Helper for the json_requests benchmarks, which parses and answers small JSON
+# requests against a table of users that stays alive throughout, and prints the
+# elapsed time.  Each request makes a few dozen short-lived objects, and the
+# table makes a full collection of the heap relatively expensive.
+
+import time
+import json
+
+N_USERS = 4000
+N_REQUESTS = 100000
+
+
+def make_users():
+    users = {}
+    for i in range(N_USERS):
+        users["u%d" % i] = {"name": "user %d" % i, "score": i * 7 % 1000, "tags": ["a", "b%d" % i]}
+    return users
+
+
+def handle(users, line):
+    req = json.loads(line)
+    user = users.get(req["user"])
+    if user is None:
+        return json.dumps({"id": req["id"], "error": "no such user"})
+    if req["op"] == "add":
+        user["score"] += req["n"]
+    return json.dumps({"id": req["id"], "result": [user[f] for f in req["fields"]]})
+
+
+def requests(n):
+    for i in range(n):
+        op = "add" if i % 4 == 0 else "get"
+        yield '{"id": %d, "op": "%s", "user": "u%d", "n": 1, "fields": ["name", "score"]}' % (
+            i,
+            op,
+            i * 13 % (N_USERS + 10),
+        )
+
+
+def run(arena=None):
+    users = make_users()
+    total = 0
+    t = time.ticks_ms()
+    if arena is None:
+        for line in requests(N_REQUESTS):
+            total += len(handle(users, line))
+    else:
+        for line in requests(N_REQUESTS):
+            with arena():
+                total += len(handle(users, line))
+    t = time.ticks_diff(time.ticks_ms(), t)
+    assert total > 0
+    print(t / 1000)
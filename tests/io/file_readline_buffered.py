@@ -0,0 +1,64 @@
+# test mixing readline() and iteration with read(), seek(), tell() and write(),
+# on files with lines longer than any read-ahead buffer
+
+import os
+
+if not hasattr(os, "remove"):
+    print("SKIP")
+    raise SystemExit
+
+# cleanup in case testfile exists
+try:
+    os.remove("testfile")
+except OSError:
+    pass
+
+lines = [b"%d:" % i + b"x" * (i * 37 % 1500) + b"\n" for i in range(40)]
+data = b"".join(lines) + b"no newline at end"
+with open("testfile", "wb") as f:
+    f.write(data)
+
+# iteration and readlines
+with open("testfile", "rb") as f:
+    print(list(f) == lines + [b"no newline at end"])
+with open("testfile", "rb") as f:
+    print(f.readlines() == lines + [b"no newline at end"])
+with open("testfile") as f:
+    print([len(l) for l in f] == [len(l) for l in lines] + [17])
+
+# readline with a size limit
+with open("testfile", "rb") as f:
+    out = []
+    while True:
+        l = f.readline(100)
+        if not l:
+            break
+        out.append(l)
+    print(max(len(l) for l in out), b"".join(out) == data)
+
+# readline mixed with read, tell and seek
+with open("testfile", "rb") as f:
+    print(f.readline() == lines[0])
+    print(f.read(3) == lines[1][:3])
+    print(f.tell() == len(lines[0]) + 3)
+    print(f.readline() == lines[1][3:])
+    f.seek(-5, 1)
+    print(f.read(5) == lines[1][-5:])
+    f.seek(10)
+    print(f.read(5) == data[10:15])
+    f.seek(-3, 2)
+    print(f.readline())
+    print(f.readline())
+    print(f.tell() == len(data))
+
+# write after readline goes to the position that was read up to
+with open("testfile", "r+b") as f:
+    f.readline()
+    f.write(b"ABC")
+    print(f.tell() == len(lines[0]) + 3)
+    print(f.readline() == lines[1][3:])
+with open("testfile", "rb") as f:
+    f.readline()
+    print(f.read(4) == b"ABC" + lines[1][3:4])
+
+os.remove("testfile")
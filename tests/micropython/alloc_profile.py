@@ -0,0 +1,53 @@
+# test micropython.alloc_profile
+
+import micropython
+
+try:
+    micropython.alloc_profile
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+class A:
+    pass
+
+
+def make(n):
+    return [A() for _ in range(n)]
+
+
+def f():
+    make(10)
+
+
+# nothing is counted before profiling starts
+micropython.alloc_profile(1)
+micropython.alloc_profile(0)
+print(micropython.alloc_profile())
+micropython.alloc_profile_dump()
+
+# sample every allocation, and stop before looking at the results
+micropython.alloc_profile(1)
+f()
+micropython.alloc_profile(0)
+f()
+prof = micropython.alloc_profile()
+
+# the instances of A are all counted against one call stack
+for stack, typ, count, n_bytes in prof:
+    if typ == "A":
+        print([frame[2] for frame in stack], stack[1][1] - stack[2][1], count, n_bytes > 0)
+
+# each site is a different stack or type
+print(len(prof) == len(set((stack, typ) for stack, typ, _, _ in prof)))
+
+# starting again forgets what was counted
+micropython.alloc_profile(1)
+micropython.alloc_profile(0)
+print(micropython.alloc_profile())
+
+try:
+    micropython.alloc_profile(-1)
+except ValueError:
+    print("ValueError")
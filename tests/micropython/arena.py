@@ -0,0 +1,110 @@
+# test micropython.arena: objects that escape an arena must stay alive
+
+import micropython
+
+try:
+    micropython.arena
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+import gc
+
+results = []
+table = {}
+cache = None
+
+
+class Holder:
+    pass
+
+
+holder = Holder()
+
+
+def handle(i):
+    global cache
+    d = {"id": i, "items": [i, i + 1, str(i)], "name": "req%d" % i}
+    t = tuple(d["items"])
+    if i % 97 == 0:
+        # escape into an older list, which grows as a result
+        results.append(d)
+    if i % 101 == 0:
+        # escape into an older dict, which is rehashed as it grows
+        table["k%d" % i] = [t, d["name"]]
+    if i % 103 == 0:
+        # escape into an attribute of an older object, and a global
+        holder.last = d
+        cache = t
+    return "%s:%d" % (d["name"], len(t))
+
+
+# many requests, enough to collect the arena region many times over
+total = 0
+last = None
+for i in range(30000):
+    with micropython.arena():
+        last = handle(i)
+        total += len(last)
+print(total, last)
+
+# a full collection must agree with the arena collections
+gc.collect()
+print(len(results), results[0], results[-1])
+print(len(table), table["k0"], table["k29997"])
+print(holder.last, cache)
+print(sum(d["id"] for d in results), sum(len(v[1]) for v in table.values()))
+
+
+# a value returned from inside an arena, and a closure made in one
+def make(n):
+    with micropython.arena():
+        data = [bytes([65 + (i % 26)]) * 10 for i in range(n)]
+
+        def f():
+            return data[n // 2]
+
+    return data, f
+
+
+data, f = make(5000)
+for i in range(20000):
+    with micropython.arena():
+        [i] * 10
+print(len(data), data[0], data[-1], f())
+
+
+# generators that run across arenas
+def gen():
+    x = []
+    for i in range(1000):
+        with micropython.arena():
+            x.append({"i": i})
+            yield len(x)
+    yield x
+
+
+g = gen()
+for v in g:
+    if isinstance(v, list):
+        print(len(v), v[0], v[-1])
+
+
+# nested arenas, and exceptions propagating out of them
+with micropython.arena():
+    a = [1, 2, 3]
+    with micropython.arena():
+        b = a + [4]
+    c = b + [5]
+print(a, b, c)
+
+try:
+    with micropython.arena():
+        x = {"error": list(range(5))}
+        raise ValueError(x)
+except ValueError as e:
+    err = e
+for i in range(20000):
+    with micropython.arena():
+        str(i)
+print(repr(err))
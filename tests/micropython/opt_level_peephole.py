@@ -0,0 +1,118 @@
+# test that code optimised by the bytecode peephole pass at opt level 1 behaves
+# the same as unoptimised code
+
+import micropython
+
+try:
+    micropython.opt_level
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+code = """
+def cond_continue(n):
+    t = 0
+    for i in range(n):
+        if i & 1:
+            continue
+        t += i
+    return t
+
+def cond_break(n):
+    i = 0
+    while True:
+        i += 1
+        if i > n:
+            break
+    return i
+
+def and_continue(l):
+    out = []
+    for x in l:
+        if x > 1 and x < 5:
+            continue
+        out.append(x)
+    return out
+
+def jump_to_jump(a, b):
+    x = []
+    while a:
+        if b:
+            x.append("b")
+        else:
+            x.append("nb")
+        a -= 1
+    return x
+
+def jump_to_return_none(a):
+    if a:
+        print("a")
+    else:
+        print("not a")
+
+def return_both(a):
+    if a:
+        return 1
+    else:
+        return 2
+
+def in_try(a):
+    try:
+        if a:
+            return "a"
+        else:
+            print("else")
+    finally:
+        print("finally")
+
+def in_with(a):
+    class C:
+        def __enter__(self):
+            print("enter")
+        def __exit__(self, a, b, c):
+            print("exit")
+    with C():
+        if a:
+            print("a")
+        else:
+            print("not a")
+
+def in_except(a):
+    for i in range(3):
+        try:
+            if a == i:
+                raise ValueError(i)
+            if i & 1:
+                continue
+        except ValueError as e:
+            print("caught", e)
+            if a:
+                continue
+        print("i", i)
+
+def gen(n):
+    for i in range(n):
+        if i == 2:
+            continue
+        yield i
+
+print(cond_continue(10))
+print(cond_break(5))
+print(and_continue([0, 1, 2, 3, 4, 5, 6]))
+print(jump_to_jump(2, True), jump_to_jump(1, False))
+jump_to_return_none(True)
+jump_to_return_none(False)
+print(return_both(True), return_both(False))
+print(in_try(True))
+print(in_try(False))
+in_with(True)
+in_with(False)
+in_except(0)
+in_except(1)
+print(list(gen(5)))
+"""
+
+for level in (0, 1):
+    micropython.opt_level(level)
+    exec(code)
+micropython.opt_level(0)
@@ -0,0 +1,44 @@
+# test micropython.vm_stats
+
+import micropython
+
+try:
+    micropython.vm_stats
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+def f(n):
+    x = 0
+    for i in range(n):
+        x += i
+    return x
+
+
+def calls(funcs, name):
+    for file, fun, n, ticks in funcs:
+        if fun == name:
+            return n, ticks >= 0, file == __file__
+    return None
+
+
+micropython.vm_stats(True)
+for _ in range(10):
+    f(5)
+opcodes, pairs, funcs = micropython.vm_stats(True)
+
+print(type(opcodes), type(pairs), type(funcs))
+print(calls(funcs, "f"))
+print(all(isinstance(k, int) and v > 0 for k, v in opcodes.items()))
+print(all(pairs[p] <= opcodes[p[0]] and pairs[p] <= opcodes[p[1]] for p in pairs))
+
+# the loop in f runs 50 times in total, so some opcode ran at least that often
+print(max(opcodes.values()) >= 50)
+print(max(pairs.values()) >= 50)
+
+# the counts were reset
+micropython.vm_stats(True)
+opcodes, pairs, funcs = micropython.vm_stats()
+print(calls(funcs, "f"))
+print(max(opcodes.values()) < 50)
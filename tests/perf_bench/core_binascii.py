@@ -0,0 +1,66 @@
+# This tests base64 and hex encode/decode throughput, writing into
+# preallocated buffers where the out= argument is supported.
+
+import binascii
+
+
+def test_alloc(niter, data):
+    crc = 0
+    for _ in range(niter):
+        e = binascii.b2a_base64(data)
+        crc = binascii.crc32(binascii.a2b_base64(e), crc)
+        h = binascii.hexlify(data)
+        crc = binascii.crc32(binascii.unhexlify(h), crc)
+    return crc
+
+
+def test_out(niter, data, b64, hexbuf, raw):
+    crc = 0
+    for _ in range(niter):
+        n = binascii.b2a_base64(data, out=b64)
+        n = binascii.a2b_base64(memoryview(b64)[:n], out=raw)
+        crc = binascii.crc32(memoryview(raw)[:n], crc)
+        n = binascii.hexlify(data, out=hexbuf)
+        n = binascii.unhexlify(hexbuf, out=raw)
+        crc = binascii.crc32(memoryview(raw)[:n], crc)
+    return crc
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (2, 1024),
+    (50, 10): (4, 1024),
+    (100, 10): (8, 2048),
+    (500, 100): (20, 16384),
+    (1000, 100): (40, 16384),
+    (5000, 100): (200, 16384),
+    (1000, 8000): (4, 1 << 20),
+    (5000, 16000): (10, 2 << 20),
+}
+
+
+def bm_setup(params):
+    niter, size = params
+    data = bytes((i * 167 + (i >> 3) * 13) & 0xFF for i in range(size))
+    try:
+        b64 = bytearray((size + 2) // 3 * 4 + 1)
+        hexbuf = bytearray(2 * size)
+        raw = bytearray(size)
+        binascii.hexlify(b"", out=hexbuf)
+    except TypeError:
+        b64 = None
+    state = None
+
+    def run():
+        nonlocal state
+        if b64 is None:
+            state = test_alloc(niter, data)
+        else:
+            state = test_out(niter, data, b64, hexbuf, raw)
+
+    def result():
+        return niter * size, state
+
+    return run, result
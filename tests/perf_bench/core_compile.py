@@ -0,0 +1,70 @@
+# Test performance of compiling large amounts of source code, as done by
+# programs that generate code and run it with exec or eval.
+
+try:
+    compile
+except NameError:
+    print("SKIP")
+    raise SystemExit
+
+# This is the source of each function in the generated code.
+FUNC = """
+def func{n}(data, limit={n}):
+    total = 0
+    names = ["a{n}", "b{n}", "c{n}"]
+    for i, x in enumerate(data):
+        if x > limit and i % 3 == 0:
+            total += x * {n}
+        elif x < -limit or not names:
+            total -= x
+        else:
+            try:
+                total += data[i + 1] // x
+            except (IndexError, ZeroDivisionError):
+                pass
+    while total > 1000:
+        total //= 2
+        if total & 1:
+            break
+    return {{"total": total, "name": names[total % 3], "flag": total > {n}}}
+
+result{n} = func{n}(list(range(-{n}, {n})))
+"""
+
+
+def test(src, niter):
+    n = 0
+    for _ in range(niter):
+        code = compile(src, "<bench>", "exec")
+        g = {}
+        exec(code, g)
+        n += g["result0"]["total"]
+    return n
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (2, 5),
+    (50, 10): (4, 5),
+    (100, 10): (8, 10),
+    (500, 10): (20, 20),
+    (1000, 10): (40, 20),
+    (5000, 10): (100, 40),
+}
+
+
+def bm_setup(params):
+    nfunc, niter = params
+    src = "".join(FUNC.format(n=n) for n in range(nfunc))
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(src, niter)
+
+    def result():
+        return nfunc * niter, state
+
+    return run, result
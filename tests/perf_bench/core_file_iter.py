@@ -0,0 +1,65 @@
+# This tests reading a text file line by line, with iteration, readline() and
+# readlines(), and reading it in small chunks.  The file is written to the
+# current directory at setup.
+
+import os
+
+FILENAME = "perf_bench_file_iter.tmp"
+
+
+def make_file(nlines):
+    with open(FILENAME, "w") as f:
+        for i in range(nlines):
+            f.write("line {} of the file, with some padding {}\n".format(i, "x" * (i % 50)))
+
+
+def test(niter):
+    n = 0
+    for _ in range(niter):
+        with open(FILENAME) as f:
+            for line in f:
+                n += len(line)
+        with open(FILENAME) as f:
+            while True:
+                line = f.readline()
+                if not line:
+                    break
+                n += 1
+        with open(FILENAME, "rb") as f:
+            n += len(f.readlines())
+        with open(FILENAME, "rb") as f:
+            while True:
+                b = f.read(16)
+                if not b:
+                    break
+                n += b[0]
+    return n
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (50, 1),
+    (50, 10): (100, 1),
+    (100, 10): (200, 1),
+    (500, 10): (1000, 2),
+    (1000, 10): (2000, 2),
+    (5000, 10): (5000, 4),
+}
+
+
+def bm_setup(params):
+    nlines, niter = params
+    state = None
+    make_file(nlines)
+
+    def run():
+        nonlocal state
+        state = test(niter)
+
+    def result():
+        os.remove(FILENAME)
+        return nlines * niter, state
+
+    return run, result
@@ -0,0 +1,43 @@
+# This tests hashing and CRC throughput over buffers and streams.
+
+import hashlib, binascii, io
+
+
+def test(niter, data):
+    crc = 0
+    for _ in range(niter):
+        h = hashlib.sha256(data)
+        h.update(data)
+        crc = binascii.crc32(data, crc)
+        crc = binascii.crc32(h.digest(), crc)
+        f = io.BytesIO(data)
+        crc = binascii.crc32(hashlib.file_digest(f, "sha256", _bufsize=1024).digest(), crc)
+    return crc
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (2, 1024),
+    (50, 10): (4, 1024),
+    (100, 10): (8, 2048),
+    (500, 10): (40, 2048),
+    (1000, 10): (40, 4096),
+    (5000, 10): (200, 4096),
+}
+
+
+def bm_setup(params):
+    niter, size = params
+    data = bytes(i & 0xFF for i in range(size))
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter, data)
+
+    def result():
+        return niter * size, state
+
+    return run, result
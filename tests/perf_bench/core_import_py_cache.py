@@ -0,0 +1,125 @@
+# Test performance of importing a package of many .py files, as a program does
+# when it starts.  The bytecode of the modules is cached in __pycache__ by the
+# first import, and later imports load the cached bytecode if the port supports
+# it, otherwise they compile the .py files again.
+
+import sys
+
+try:
+    import os
+
+    os.mkdir
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+PKG = "micropy_bench_pkg"
+NMOD = 50
+
+# This is the source of each module in the package.
+MOD = """
+import micropy_bench_pkg
+
+CONST = (1, 2.5, "three", b"four")
+
+
+class Item{n}:
+    def __init__(self, value):
+        self.value = value
+        self.history = []
+
+    def update(self, x):
+        self.history.append(x)
+        self.value = (self.value * 31 + x) % 1000003
+        return self.value
+
+    def __repr__(self):
+        return "Item{n}(%d)" % self.value
+
+
+def make(n):
+    items = [Item{n}(i) for i in range(n)]
+    for i, item in enumerate(items):
+        if i % 2:
+            item.update(i)
+        else:
+            item.update(-i)
+    return items
+
+
+def checksum(items):
+    total = 0
+    for item in items:
+        total += item.value
+    return total
+
+
+try:
+    result = checksum(make({n} % 7 + 1))
+except ValueError as er:
+    result = str(er)
+"""
+
+
+def cleanup():
+    for d in (PKG + "/__pycache__", PKG):
+        try:
+            names = os.listdir(d)
+        except OSError:
+            continue
+        for name in names:
+            try:
+                os.remove(d + "/" + name)
+            except OSError:
+                pass
+        os.rmdir(d)
+
+
+def setup():
+    cleanup()
+    os.mkdir(PKG)
+    os.mkdir(PKG + "/__pycache__")
+    with open(PKG + "/__init__.py", "w") as f:
+        f.write("")
+    for n in range(NMOD):
+        with open(PKG + "/mod%d.py" % n, "w") as f:
+            f.write(MOD.replace("{n}", str(n)))
+
+
+def test(nloop):
+    total = 0
+    for _ in range(nloop):
+        for name in list(sys.modules):
+            if name.startswith(PKG):
+                del sys.modules[name]
+        for n in range(NMOD):
+            total += __import__(PKG + ".mod%d" % n, None, None, ["result"]).result
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (1,),
+    (1000, 10): (10,),
+    (5000, 10): (40,),
+}
+
+
+def bm_setup(params):
+    (nloop,) = params
+    state = None
+    setup()
+    sys.path.insert(0, "")
+    test(1)  # populate the cache
+
+    def run():
+        nonlocal state
+        state = test(nloop)
+
+    def result():
+        cleanup()
+        return nloop * NMOD, state
+
+    return run, result
@@ -0,0 +1,67 @@
+# Test performance of accessing parts of a 2-dimensional image and reinterpreting
+# a buffer as 16-bit samples, using zero-copy memoryviews if they support
+# 2-dimensional slicing, otherwise copying the data out of the buffer.
+
+import array
+
+W = 64
+H = 48
+
+
+def make_views(buf):
+    try:
+        img = memoryview(buf).cast("B", (H, W))
+        img[0:1, 0:1]
+    except (AttributeError, NotImplementedError, TypeError):
+        return None
+    return img
+
+
+def test(buf, niter):
+    img = make_views(buf)
+    total = 0
+    for i in range(niter):
+        x = i % W
+        y = i % (H // 2)
+        if img is not None:
+            col = img[:, x].tobytes()
+            tile = img[y : y + 16, x // 2 : x // 2 + 16].tobytes()
+            samples = memoryview(buf).cast("h")
+            total += samples[y] + samples[-x - 1]
+            total += sum(samples[y :: W // 2])
+        else:
+            col = bytes(buf[r * W + x] for r in range(H))
+            tile = b"".join(buf[r * W + x // 2 : r * W + x // 2 + 16] for r in range(y, y + 16))
+            samples = array.array("h", buf)
+            total += samples[y] + samples[-x - 1]
+            total += sum(samples[r] for r in range(y, len(samples), W // 2))
+        total += sum(col) + tile[-1] + len(tile)
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (5,),
+    (50, 10): (10,),
+    (100, 10): (20,),
+    (500, 10): (100,),
+    (1000, 10): (200,),
+    (5000, 10): (1000,),
+}
+
+
+def bm_setup(params):
+    (niter,) = params
+    buf = bytearray((i * 7 + i // W) & 0xFF for i in range(W * H))
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(buf, niter)
+
+    def result():
+        return niter, state
+
+    return run, result
@@ -0,0 +1,56 @@
+# This tests repeated module-level re calls with string patterns, which
+# compile (or fetch from cache) the pattern on every call, and searches
+# for patterns with a literal prefix through a long subject.
+
+import re
+
+LOG = (
+    "2024-01-01 12:00:00 INFO  worker-1 request id=1234 path=/api/v1/items status=200\n"
+    "2024-01-01 12:00:01 DEBUG worker-2 cache miss key=user:42\n"
+    "2024-01-01 12:00:02 WARN  worker-1 slow request id=1235 took=1532ms\n"
+    "2024-01-01 12:00:03 ERROR worker-3 request id=1236 failed: timeout\n"
+)
+
+
+def test(niter):
+    text = LOG * 8
+    n = 0
+    for _ in range(niter):
+        for line in LOG.split("\n"):
+            if re.match("[0-9]+-[0-9]+-[0-9]+", line):
+                n += 1
+            m = re.search("id=[0-9]+", line)
+            if m:
+                n += len(m.group(0))
+        n += len(re.sub("worker-", "w", text))
+        n += len(re.compile("status=").split(text))
+        m = re.search("failed: [a-z]+", text)
+        n += len(m.group(0))
+    return n
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (2,),
+    (50, 10): (4,),
+    (100, 10): (8,),
+    (500, 10): (40,),
+    (1000, 10): (80,),
+    (5000, 10): (400,),
+}
+
+
+def bm_setup(params):
+    (niter,) = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter)
+
+    def result():
+        return niter, state
+
+    return run, result
@@ -0,0 +1,54 @@
+# Test performance of looking up names in builtin ROM maps: the builtins module
+# (which has more than 50 entries), a large extension module and type locals.
+# The lookups use more distinct names than fit in the map lookup cache.
+
+try:
+    import math
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+def test(niter):
+    m = math
+    s = str
+    for _ in range(niter):
+        # Builtin functions and types, found via the builtins module.
+        abs, all, any, bin, callable, chr, dir, divmod, getattr, hasattr, hash, id
+        isinstance, issubclass, iter, len, max, min, next, oct, ord, pow, print, repr
+        round, setattr, sorted, sum, bool, bytes, bytearray, dict, enumerate, filter
+        float, frozenset, int, list, map, object, range, reversed, set, slice, str
+        tuple, type, zip, OSError, KeyError, ValueError, TypeError, StopIteration
+        # Module attributes.
+        m.pi, m.e, m.sqrt, m.pow, m.exp, m.log, m.cos, m.sin, m.tan, m.acos, m.asin
+        m.atan, m.atan2, m.ceil, m.copysign, m.fabs, m.floor, m.fmod, m.frexp, m.ldexp
+        m.modf, m.isfinite, m.isinf, m.isnan, m.trunc, m.radians, m.degrees
+        # Type locals.
+        s.count, s.endswith, s.find, s.format, s.index, s.isalpha, s.isdigit, s.join
+        s.lower, s.lstrip, s.replace, s.rfind, s.rindex, s.rsplit, s.rstrip, s.split
+        s.startswith, s.strip, s.upper
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (10,),
+    (50, 10): (20,),
+    (100, 10): (50,),
+    (500, 10): (200,),
+    (1000, 10): (1000,),
+    (5000, 10): (5000,),
+}
+
+
+def bm_setup(params):
+    (niter,) = params
+
+    def run():
+        test(niter)
+
+    def result():
+        return niter, None
+
+    return run, result
@@ -0,0 +1,46 @@
+# Test performance of formatting log lines with a few fixed templates, using
+# both str.format and % formatting.
+
+LEVELS = ("DEBUG", "INFO", "WARNING", "ERROR")
+
+
+def test(niter):
+    total = 0
+    for i in range(niter):
+        level = LEVELS[i & 3]
+        line = "{:>8} [{}] {}: {}".format(i * 13, level, "sensor", "reading ok")
+        total += len(line)
+        line = "%s:%s:%s" % (level, "app.net", "connected to %s port %d" % ("10.0.0.1", 8080))
+        total += len(line)
+        line = "{}: t={:.2f} v={:5d} {!r}".format("sample", i / 7, i & 0xFFF, "ok")
+        total += len(line)
+        line = "%-7s %08x %5.1f%%" % (level, i * 2654435761 & 0xFFFFFFFF, (i % 1000) / 10)
+        total += len(line)
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (20,),
+    (50, 10): (50,),
+    (100, 10): (100,),
+    (500, 10): (500,),
+    (1000, 10): (1000,),
+    (5000, 10): (5000,),
+}
+
+
+def bm_setup(params):
+    (niter,) = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter)
+
+    def result():
+        return niter, state
+
+    return run, result
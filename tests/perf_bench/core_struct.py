@@ -0,0 +1,67 @@
+# Test performance of decoding a buffer of fixed-layout binary records, using
+# struct.Struct if it's available, otherwise the module-level functions.
+
+try:
+    import struct
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+FMT = "<HhIBxq"
+
+
+def make_records(n):
+    size = struct.calcsize(FMT)
+    buf = bytearray(n * size)
+    for i in range(n):
+        struct.pack_into(FMT, buf, i * size, i, -i, i * 1000, i & 0xFF, i * i)
+    return bytes(buf)
+
+
+def test(buf, niter):
+    total = 0
+    if hasattr(struct, "Struct"):
+        s = struct.Struct(FMT)
+        size = s.size
+        for _ in range(niter):
+            for a, b, c, d, e in s.iter_unpack(buf):
+                total += a + b + d
+            for off in range(0, len(buf), size):
+                total += s.unpack_from(buf, off)[2]
+    else:
+        size = struct.calcsize(FMT)
+        for _ in range(niter):
+            for off in range(0, len(buf), size):
+                a, b, c, d, e = struct.unpack_from(FMT, buf, off)
+                total += a + b + d
+            for off in range(0, len(buf), size):
+                total += struct.unpack_from(FMT, buf, off)[2]
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (20, 2),
+    (50, 10): (50, 2),
+    (100, 10): (100, 5),
+    (500, 10): (500, 10),
+    (1000, 10): (1000, 20),
+    (5000, 10): (2000, 50),
+}
+
+
+def bm_setup(params):
+    nrec, niter = params
+    buf = make_records(nrec)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(buf, niter)
+
+    def result():
+        return nrec * niter, state
+
+    return run, result
@@ -0,0 +1,84 @@
+# Test performance of reading and writing fields of packed network headers
+# with uctypes, using a compiled descriptor if uctypes.compile is available.
+
+try:
+    import uctypes
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+IPV4 = {
+    "version": uctypes.BFUINT8 | 0 | 4 << uctypes.BF_POS | 4 << uctypes.BF_LEN,
+    "ihl": uctypes.BFUINT8 | 0 | 0 << uctypes.BF_POS | 4 << uctypes.BF_LEN,
+    "tos": uctypes.UINT8 | 1,
+    "total_len": uctypes.UINT16 | 2,
+    "ident": uctypes.UINT16 | 4,
+    "frag": uctypes.UINT16 | 6,
+    "ttl": uctypes.UINT8 | 8,
+    "proto": uctypes.UINT8 | 9,
+    "csum": uctypes.UINT16 | 10,
+    "src": uctypes.UINT32 | 12,
+    "dst": uctypes.UINT32 | 16,
+}
+
+UDP = {
+    "ip": (0, IPV4),
+    "sport": uctypes.UINT16 | 20,
+    "dport": uctypes.UINT16 | 22,
+    "length": uctypes.UINT16 | 24,
+    "csum": uctypes.UINT16 | 26,
+}
+
+
+def test(buf, niter):
+    desc = UDP
+    if hasattr(uctypes, "compile"):
+        desc = uctypes.compile(desc)
+    n = len(buf) // 28
+    pkts = [
+        uctypes.struct(uctypes.addressof(buf) + i * 28, desc, uctypes.BIG_ENDIAN) for i in range(n)
+    ]
+    total = 0
+    for _ in range(niter):
+        for p in pkts:
+            ip = p.ip
+            if ip.version == 4 and ip.proto == 17:
+                ip.ttl -= 1
+                total += ip.ihl + ip.total_len + (ip.src & 0xFF) + (ip.dst >> 24)
+                p.sport, p.dport = p.dport, p.sport
+                total += p.sport + p.length
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (4, 10),
+    (50, 10): (8, 10),
+    (100, 10): (16, 20),
+    (500, 10): (32, 50),
+    (1000, 10): (64, 50),
+    (5000, 10): (128, 100),
+}
+
+
+def bm_setup(params):
+    npkt, niter = params
+    buf = bytearray(npkt * 28)
+    for i in range(npkt):
+        buf[i * 28 : i * 28 + 28] = bytes(
+            [0x45, 0, 0, 28, i >> 8, i & 0xFF, 0, 0, 255, 17, 0, 0]
+            + [10, 0, 0, i & 0xFF, 192, 168, 1, i & 0xFF]
+            + [0x12, i & 0xFF, 0x34, 0x56, 0, 8, 0, 0]
+        )
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(buf, niter)
+
+    def result():
+        return npkt * niter, state
+
+    return run, result
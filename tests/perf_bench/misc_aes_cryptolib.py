@@ -0,0 +1,62 @@
+# Throughput of the AES modes in cryptolib, encrypting and decrypting a
+# buffer in-place so the heap is not used for data.  This is the native
+# counterpart to misc_aes.py.
+
+try:
+    from cryptolib import aes
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+MODES = [(1, None), (2, bytes(16))]
+for mode, iv in ((6, bytes(16)), (11, bytes(12))):
+    try:
+        aes(bytes(16), mode, iv)
+        MODES.append((mode, iv))
+    except ValueError:
+        pass
+
+
+def test(niter, key, buf):
+    zero = bytes(len(buf))
+    ok = True
+    for mode, iv in MODES:
+        for _ in range(niter):
+            enc = aes(key, mode, iv)
+            enc.encrypt(buf, buf)
+            dec = aes(key, mode, iv)
+            dec.decrypt(buf, buf)
+            if mode == 11:
+                dec.verify(enc.digest())
+            ok = ok and buf == zero
+    return ok
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (2, 1024),
+    (50, 10): (4, 1024),
+    (100, 10): (8, 2048),
+    (500, 100): (10, 16384),
+    (1000, 100): (20, 16384),
+    (5000, 100): (100, 16384),
+    (1000, 2000): (4, 1 << 20),
+}
+
+
+def bm_setup(params):
+    niter, size = params
+    key = bytes(range(32))
+    buf = bytearray(size)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter, key, buf)
+
+    def result():
+        return niter * size * len(MODES), state
+
+    return run, result
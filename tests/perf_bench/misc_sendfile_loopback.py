@@ -0,0 +1,75 @@
+# This tests sending a file over a loopback TCP connection in chunks, using
+# socket.sendfile() if it's available, otherwise reading the file and writing
+# to the socket.  The file is written to the current directory at setup.
+
+try:
+    import os, socket
+
+    s_listen = socket.socket()
+    s_listen.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    s_listen.bind(socket.getaddrinfo("127.0.0.1", 8005)[0][-1])
+    s_listen.listen(1)
+except (ImportError, OSError):
+    print("SKIP")
+    raise SystemExit
+
+FILENAME = "perf_bench_sendfile.tmp"
+CHUNK = 16384
+
+
+def test(niter, size):
+    s_send = socket.socket()
+    s_send.connect(socket.getaddrinfo("127.0.0.1", 8005)[0][-1])
+    s_recv, _ = s_listen.accept()
+    buf = bytearray(CHUNK)
+    recv_into = getattr(s_recv, "recv_into", None) or s_recv.readinto
+    total = 0
+    with open(FILENAME, "rb") as f:
+        for _ in range(niter):
+            for offset in range(0, size, CHUNK):
+                # send one chunk, small enough to fit in the socket buffers
+                if hasattr(s_send, "sendfile"):
+                    n = s_send.sendfile(f, offset, CHUNK)
+                else:
+                    f.seek(offset)
+                    n = s_send.write(f.read(CHUNK))
+
+                # receive it back
+                while n:
+                    m = recv_into(memoryview(buf)[:n])
+                    total += buf[m - 1]
+                    n -= m
+    s_send.close()
+    s_recv.close()
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (1, 32768),
+    (50, 10): (2, 32768),
+    (100, 10): (4, 65536),
+    (500, 10): (20, 65536),
+    (1000, 10): (40, 65536),
+    (5000, 10): (200, 65536),
+}
+
+
+def bm_setup(params):
+    niter, size = params
+    state = None
+    with open(FILENAME, "wb") as f:
+        for i in range(size // 256):
+            f.write(bytes((i + j) & 0xFF for j in range(256)))
+
+    def run():
+        nonlocal state
+        state = test(niter, size)
+
+    def result():
+        os.remove(FILENAME)
+        return niter * size, state
+
+    return run, result
@@ -0,0 +1,76 @@
+# This tests sending and receiving batches of small UDP datagrams over the
+# loopback interface, using the batched or zero-copy socket methods where
+# they are available.
+
+try:
+    import socket
+
+    s_recv = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s_recv.bind(socket.getaddrinfo("127.0.0.1", 8003)[0][-1])
+except (ImportError, OSError):
+    print("SKIP")
+    raise SystemExit
+
+BATCH = 16
+
+
+def test(niter):
+    addr = socket.getaddrinfo("127.0.0.1", 8003)[0][-1]
+    s_send = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s_send.connect(addr)
+    msgs = [bytes([65 + i]) * (16 + i) for i in range(BATCH)]
+    bufs = [bytearray(64) for _ in range(BATCH)]
+    lengths = [0] * BATCH
+    total = 0
+    for _ in range(niter):
+        # send a batch, small enough to fit in the socket's receive buffer
+        if hasattr(s_send, "sendmmsg"):
+            s_send.sendmmsg(msgs)
+        else:
+            for m in msgs:
+                s_send.send(m)
+
+        # receive it back
+        if hasattr(s_recv, "recvmmsg"):
+            n = 0
+            while n < BATCH:
+                got = s_recv.recvmmsg(bufs if n == 0 else bufs[n:], lengths)
+                for i in range(got):
+                    total += lengths[i] + bufs[n + i][0]
+                n += got
+        elif hasattr(s_recv, "recv_into"):
+            for b in bufs:
+                total += s_recv.recv_into(b) + b[0]
+        else:
+            for _ in range(BATCH):
+                b = s_recv.recv(64)
+                total += len(b) + b[0]
+    s_send.close()
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (10,),
+    (50, 10): (20,),
+    (100, 10): (40,),
+    (500, 10): (200,),
+    (1000, 10): (400,),
+    (5000, 10): (2000,),
+}
+
+
+def bm_setup(params):
+    (niter,) = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter)
+
+    def result():
+        return niter * BATCH, state
+
+    return run, result
@@ -651,6 +651,8 @@ def run_tests(pyb, tests, args, result_dir, num_threads=1):
         skip_tests.add("misc/sys_settrace_features.py")  # sys.settrace() not supported
         skip_tests.add("misc/sys_settrace_generator.py")  # sys.settrace() not supported
         skip_tests.add("misc/sys_settrace_loop.py")  # sys.settrace() not supported
+        skip_tests.add("micropython/alloc_profile.py")  # native code has no frames
+        skip_tests.add("micropython/vm_stats.py")  # native code isn't counted
         skip_tests.add(
             "micropython/emg_exc.py"
         )  # because native doesn't have proper traceback info
@@ -661,6 +663,7 @@ def run_tests(pyb, tests, args, result_dir, num_threads=1):
             "micropython/opt_level_lineno.py"
         )  # native doesn't have proper traceback info
         skip_tests.add("micropython/schedule.py")  # native code doesn't check pending events
+        skip_tests.add("unix/mod_profiler.py")  # native code has no frames
         skip_tests.add("stress/bytecode_limit.py")  # bytecode specific test
 
     def run_one_test(test_file):
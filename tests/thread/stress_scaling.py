@@ -0,0 +1,56 @@
+# stress test for CPU-bound threads that allocate lots of small objects
+#
+# Running it with an argument, e.g. "micropython stress_scaling.py bench", does
+# a longer run and prints how the elapsed time compares to a single thread.
+# Each thread does the same amount of work, so with enough CPU cores the time
+# should stay close to that of one thread as more threads are added.
+
+import sys
+import time
+import _thread
+
+
+def work(n):
+    # create, use and drop some small lists, tuples, strings and dicts
+    total = 0
+    for i in range(n):
+        lst = [i, i + 1, i + 2]
+        d = {"list": lst, "pair": (i, str(i))}
+        t = tuple(d["list"])
+        assert t[2] - t[0] == 2 and d["pair"][1] == str(i)
+        total += t[1]
+    return total
+
+
+def thread_entry(n):
+    global n_finished
+    result = work(n)
+    with lock:
+        results.append(result)
+        n_finished += 1
+
+
+def run(n_thread, n):
+    global results, n_finished
+    results = []
+    n_finished = 0
+    t0 = time.time()
+    for i in range(n_thread):
+        _thread.start_new_thread(thread_entry, (n,))
+    while n_finished < n_thread:
+        time.sleep(0.01)
+    return time.time() - t0
+
+
+lock = _thread.allocate_lock()
+bench = len(sys.argv) > 1
+
+n = 200000 if bench else 2000
+t1 = None
+for n_thread in (1, 2, 4):
+    dt = run(n_thread, n)
+    print(n_thread, results == n_thread * [n * (n + 1) // 2])
+    if bench:
+        if t1 is None:
+            t1 = dt
+        print("  time {:.3f}s, {:.2f}x the work of 1 thread per unit time".format(dt, n_thread * t1 / dt))
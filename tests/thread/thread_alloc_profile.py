@@ -0,0 +1,49 @@
+# test micropython.alloc_profile with threads allocating at the same time
+
+import micropython
+import _thread
+
+try:
+    micropython.alloc_profile
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+
+class A:
+    pass
+
+
+def thread_entry(n):
+    for i in range(n):
+        A()
+    with lock:
+        global n_finished
+        n_finished += 1
+
+
+lock = _thread.allocate_lock()
+n_thread = 4
+n_alloc = 2000
+n_finished = 0
+
+micropython.alloc_profile(1)
+
+# spawn threads
+for i in range(n_thread):
+    _thread.start_new_thread(thread_entry, (n_alloc,))
+
+# busy wait for threads to finish
+while n_finished < n_thread:
+    pass
+
+micropython.alloc_profile(0)
+
+# every object of type A was made in thread_entry, and while another thread is
+# making its sample some allocations may not be counted
+count = 0
+for stack, type_name, n, n_bytes in micropython.alloc_profile():
+    if type_name == "A":
+        count += n
+        print(stack[-1][2], n_bytes // n > 0)
+print(n_thread * n_alloc // 2 < count <= n_thread * n_alloc)
@@ -97,6 +97,16 @@ import frozentest
 
 print(frozentest.__file__)
 
+# test for freeze_mpy of a module with its globals in ROM
+import frzrom
+
+print(frzrom.__name__, frzrom.__file__, frzrom.X, frzrom.NAME, frzrom.DATA)
+print(frzrom.f(1), frzrom.f(1, 3, 4), list(frzrom.gen(3)))
+try:
+    frzrom.X = 3
+except AttributeError:
+    print("AttributeError")
+
 # test for builtin sub-packages
 from example_package.foo import bar
 
@@ -0,0 +1,40 @@
+# test the profiler module
+
+try:
+    import io, time
+    import profiler
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+def spin(ms):
+    t = time.ticks_ms()
+    while time.ticks_diff(time.ticks_ms(), t) < ms:
+        pass
+
+
+profiler.start(1000, 256)
+spin(200)
+profiler.stop()
+
+# every line is a stack of frames and a count
+out = io.StringIO()
+profiler.dump(out)
+lines = out.getvalue().splitlines()
+stacks = [line.rsplit(" ", 1) for line in lines]
+print(all(int(count) > 0 for _, count in stacks))
+print(any(stack.split(";")[-1].split(":")[1] == "spin" for stack, _ in stacks))
+
+# dumping drains the samples
+out = io.StringIO()
+profiler.dump(out)
+print(repr(out.getvalue()))
+
+# and dumping when stopped does nothing more
+profiler.dump()
+
+try:
+    profiler.start(0)
+except ValueError:
+    print("ValueError")
@@ -557,6 +557,15 @@ function ci_unix_nanbox_run_tests {
     ci_unix_run_tests_full_helper nanbox PYTHON=python2
 }
 
+function ci_unix_nanbox_64bit_build {
+    ci_unix_build_helper VARIANT=nanbox MICROPY_FORCE_32BIT=0 CFLAGS_EXTRA="-DMICROPY_PY_MATH_CONSTANTS=1"
+    ci_unix_build_ffi_lib_helper gcc
+}
+
+function ci_unix_nanbox_64bit_run_tests {
+    ci_unix_run_tests_full_helper nanbox MICROPY_FORCE_32BIT=0
+}
+
 function ci_unix_float_build {
     ci_unix_build_helper VARIANT=standard CFLAGS_EXTRA="-DMICROPY_FLOAT_IMPL=MICROPY_FLOAT_IMPL_FLOAT"
     ci_unix_build_ffi_lib_helper gcc
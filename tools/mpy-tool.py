@@ -126,6 +126,7 @@ MP_PERSISTENT_OBJ_FLOAT = 8
 MP_PERSISTENT_OBJ_COMPLEX = 9
 MP_PERSISTENT_OBJ_TUPLE = 10
 
+MP_SCOPE_FLAG_GENERATOR = 0x01
 MP_SCOPE_FLAG_VIPERRELOC = 0x10
 MP_SCOPE_FLAG_VIPERRODATA = 0x20
 MP_SCOPE_FLAG_VIPERBSS = 0x40
@@ -578,6 +579,7 @@ class CompiledModule:
         self.obj_table_file_offset = obj_table_file_offset
         self.raw_code_file_offset = raw_code_file_offset
         self.escaped_name = escaped_name
+        self.rom_globals = None
 
     def hexdump(self):
         with open(self.mpy_source_file, "rb") as f:
@@ -668,8 +670,21 @@ class CompiledModule:
 
         self.freeze_constants()
 
+        if self.rom_globals is not None:
+            print()
+            self.freeze_rom_globals()
+
         print()
         print("static const mp_frozen_module_t frozen_module_%s = {" % self.escaped_name)
+        self.freeze_constants_init()
+        print("    .rc = &raw_code_%s," % self.raw_code.escaped_name)
+        if self.rom_globals is not None:
+            print("    #if %s" % self.rom_globals[0])
+            print("    .context = &module_context_%s," % self.escaped_name)
+            print("    #endif")
+        print("};")
+
+    def freeze_constants_init(self):
         print("    .constants = {")
         if len(self.qstr_table):
             print(
@@ -683,8 +698,6 @@ class CompiledModule:
         else:
             print("        .obj_table = NULL,")
         print("    },")
-        print("    .rc = &raw_code_%s," % self.raw_code.escaped_name)
-        print("};")
 
     def freeze_constant_obj(self, obj_name, obj):
         global const_str_content, const_int_content, const_obj_content
@@ -822,6 +835,7 @@ class CompiledModule:
         for i, obj in enumerate(self.obj_table):
             obj_name = "const_obj_%s_%u" % (self.escaped_name, i)
             obj_refs.append(self.freeze_constant_obj(obj_name, obj))
+        self.obj_refs = obj_refs
 
         # generate constant table
         print()
@@ -837,6 +851,230 @@ class CompiledModule:
         global const_table_ptr_content
         const_table_ptr_content += len(self.obj_table)
 
+    def analyse_rom_globals(self):
+        # Work out if the module body does nothing except define functions and
+        # constants, in which case its globals can be pre-evaluated into a ROM
+        # dict and the module doesn't need to be executed when it's imported.
+        # This may add qstrs, so must be done before the qstr pool is frozen.
+        self.rom_globals = None
+
+        module_file = self.source_file.str
+        if not module_file.endswith(".py") or module_file.endswith("/__init__.py"):
+            return
+        rc = self.raw_code
+        if rc.code_kind != MP_CODE_BYTECODE:
+            return
+        for child in rc.children:
+            if not child.uses_only_static_globals():
+                return
+
+        # Evaluate the module body.  Each value on the stack is either a C
+        # expression, or a tuple describing a value that's resolved later.
+        condition = "MICROPY_MODULE_FROZEN_ROM_GLOBALS"
+        bc = rc.fun_data
+        ip = rc.offset_opcodes
+        stack = []
+        funs = []
+        names = {}
+        while ip < len(bc):
+            op = bc[ip]
+            fmt, sz, arg, _ = mp_opcode_decode(bc, ip)
+            ip += sz
+            if op == Opcode.MP_BC_LOAD_CONST_FALSE:
+                stack.append("MP_ROM_FALSE")
+            elif op == Opcode.MP_BC_LOAD_CONST_NONE:
+                stack.append("MP_ROM_NONE")
+            elif op == Opcode.MP_BC_LOAD_CONST_TRUE:
+                stack.append("MP_ROM_TRUE")
+            elif op == Opcode.MP_BC_LOAD_CONST_SMALL_INT:
+                stack.append("MP_ROM_INT(%d)" % arg)
+            elif (
+                Opcode.MP_BC_LOAD_CONST_SMALL_INT_MULTI
+                <= op
+                < Opcode.MP_BC_LOAD_CONST_SMALL_INT_MULTI
+                + Opcode.MP_BC_LOAD_CONST_SMALL_INT_MULTI_NUM
+            ):
+                stack.append(
+                    "MP_ROM_INT(%d)"
+                    % (
+                        op
+                        - Opcode.MP_BC_LOAD_CONST_SMALL_INT_MULTI
+                        - Opcode.MP_BC_LOAD_CONST_SMALL_INT_MULTI_EXCESS
+                    )
+                )
+            elif op == Opcode.MP_BC_LOAD_CONST_STRING:
+                stack.append("MP_ROM_QSTR(%s)" % self.qstr_table[arg].qstr_id)
+            elif op == Opcode.MP_BC_LOAD_CONST_OBJ:
+                stack.append(("obj", arg))
+            elif op == Opcode.MP_BC_LOAD_NULL:
+                stack.append(("null",))
+            elif op == Opcode.MP_BC_BUILD_TUPLE:
+                if arg > len(stack):
+                    return
+                items = stack[len(stack) - arg :]
+                del stack[len(stack) - arg :]
+                stack.append(("tuple", items))
+            elif op == Opcode.MP_BC_MAKE_FUNCTION:
+                funs.append((rc.children[arg], []))
+                stack.append(("fun", len(funs) - 1))
+            elif op == Opcode.MP_BC_MAKE_FUNCTION_DEFARGS:
+                # Only positional default arguments that are constants are supported.
+                if len(stack) < 2 or stack[-1] != ("null",) or stack[-2][0] != "tuple":
+                    return
+                def_args = stack[-2][1]
+                del stack[-2:]
+                funs.append((rc.children[arg], def_args))
+                stack.append(("fun", len(funs) - 1))
+            elif op == Opcode.MP_BC_IMPORT_NAME:
+                # Support "from micropython import const", the value of which is known.
+                if (
+                    self.qstr_table[arg].str != "micropython"
+                    or stack[-2:] != ["MP_ROM_INT(0)", ("tuple", ["MP_ROM_QSTR(MP_QSTR_const)"])]
+                ):
+                    return
+                del stack[-2:]
+                stack.append(("module",))
+            elif op == Opcode.MP_BC_IMPORT_FROM:
+                if not stack or stack[-1] != ("module",) or self.qstr_table[arg].str != "const":
+                    return
+                stack.append("MP_ROM_PTR(&mp_identity_obj)")
+                # The import must still fail if the micropython module is disabled.
+                condition = "MICROPY_MODULE_FROZEN_ROM_GLOBALS && MICROPY_PY_MICROPYTHON"
+            elif op == Opcode.MP_BC_DUP_TOP:
+                if not stack:
+                    return
+                stack.append(stack[-1])
+            elif op == Opcode.MP_BC_POP_TOP:
+                if not stack:
+                    return
+                stack.pop()
+            elif op == Opcode.MP_BC_STORE_NAME:
+                name = self.qstr_table[arg]
+                if not stack or name.str in ("__name__", "__file__"):
+                    return
+                value = stack.pop()
+                if isinstance(value, tuple) and value[0] not in ("obj", "fun"):
+                    return
+                names[name.str] = (name, value)
+            elif op == Opcode.MP_BC_RETURN_VALUE:
+                if stack != ["MP_ROM_NONE"] or ip != len(bc):
+                    return
+                break
+            else:
+                return
+
+        # Check that the functions, and their default arguments, can be put in ROM.
+        for fun_rc, def_args in funs:
+            if fun_rc.code_kind != MP_CODE_BYTECODE:
+                return
+            for value in def_args:
+                if isinstance(value, tuple) and value[0] != "obj":
+                    return
+
+        # Add the entries that the runtime stores in a module when it's imported.
+        def get_qstr(s):
+            return global_qstrs.find_by_str(s) or global_qstrs.add(s)
+
+        module_name = module_file[: -len(".py")].replace("/", ".")
+        names["__name__"] = (
+            get_qstr("__name__"),
+            "MP_ROM_QSTR(%s)" % get_qstr(module_name).qstr_id,
+        )
+        names["__file__"] = (get_qstr("__file__"), "MP_ROM_QSTR(%s)" % self.source_file.qstr_id)
+
+        # Find the smallest hash table that has no collisions between the keys,
+        # so that lookups need one probe.  Otherwise use a linear table.
+        n = len(names)
+        hashes = [
+            qstrutil.compute_hash(bytes_cons(name, "utf8"), config.MICROPY_QSTR_BYTES_IN_HASH)
+            for name in names
+        ]
+        alloc = None
+        for size in range(n + 1, 4 * n + 1):
+            if len(set(h % size for h in hashes)) == n:
+                alloc = size
+                break
+
+        self.rom_globals = (condition, funs, names, hashes, alloc)
+
+    def freeze_rom_globals(self):
+        condition, funs, names, hashes, alloc = self.rom_globals
+
+        def resolve(value):
+            if isinstance(value, str):
+                return value
+            elif value[0] == "obj":
+                return self.obj_refs[value[1]]
+            else:
+                return "MP_ROM_PTR(&fun_obj_%s)" % funs[value[1]][0].escaped_name
+
+        print("// globals of the module, pre-evaluated into ROM")
+        print("#if %s" % condition)
+        print("static const mp_module_context_t module_context_%s;" % self.escaped_name)
+
+        for fun_rc, def_args in funs:
+            if fun_rc.scope_flags & MP_SCOPE_FLAG_GENERATOR:
+                fun_type = "mp_type_gen_wrap"
+            else:
+                fun_type = "mp_type_fun_bc"
+            print("static const mp_rom_obj_fun_bc_t fun_obj_%s = {" % fun_rc.escaped_name)
+            print("    .base = { &%s }," % fun_type)
+            print("    .context = &module_context_%s," % self.escaped_name)
+            if len(fun_rc.children):
+                print("    .child_table = (void *)&children_%s," % fun_rc.escaped_name)
+            else:
+                print("    .child_table = NULL,")
+            print("    .bytecode = fun_data_%s," % fun_rc.escaped_name)
+            print("    #if MICROPY_PY_SYS_SETTRACE")
+            print("    .rc = &raw_code_%s," % fun_rc.escaped_name)
+            print("    #endif")
+            if def_args:
+                print("    .extra_args = { %s }," % ", ".join(resolve(v) for v in def_args))
+            print("};")
+
+        # In a linear table __file__ is last, so it can be excluded by the length.
+        entries = [(name, resolve(value)) for name, value in names.values()]
+        if alloc:
+            slots = [h % alloc for h in hashes]
+        else:
+            slots = list(range(len(entries)))
+        print(
+            "static const mp_rom_map_elem_t module_globals_table_%s[%u] = {"
+            % (self.escaped_name, alloc or len(entries))
+        )
+        for slot, (name, value) in sorted(zip(slots, entries), key=lambda x: x[0]):
+            if name.str == "__file__":
+                print("    #if MICROPY_PY___FILE__")
+            print("    [%u] = { MP_ROM_QSTR(%s), %s }," % (slot, name.qstr_id, value))
+            if name.str == "__file__":
+                print("    #endif")
+        print("};")
+        print("static const mp_obj_dict_t module_globals_%s = {" % self.escaped_name)
+        print("    .base = { &mp_type_dict },")
+        print("    .map = {")
+        print("        .all_keys_are_qstrs = 1,")
+        print("        .is_fixed = 1,")
+        print("        .is_ordered = %u," % (alloc is None))
+        print("        .used = %u - !MICROPY_PY___FILE__," % len(entries))
+        if alloc:
+            print("        .alloc = %u," % alloc)
+        else:
+            print("        .alloc = %u - !MICROPY_PY___FILE__," % len(entries))
+        print(
+            "        .table = (mp_map_elem_t *)(mp_rom_map_elem_t *)module_globals_table_%s,"
+            % self.escaped_name
+        )
+        print("    },")
+        print("};")
+        print("static const mp_module_context_t module_context_%s = {" % self.escaped_name)
+        print(
+            "    .module = { { &mp_type_module }, (mp_obj_dict_t *)&module_globals_%s },"
+            % self.escaped_name
+        )
+        self.freeze_constants_init()
+        print("};")
+        print("#endif")
+
 
 class RawCode(object):
     # a set of all escaped names, to make sure they are unique
@@ -889,6 +1127,24 @@ class RawCode(object):
         for rc in self.children:
             rc.disassemble()
 
+    def uses_only_static_globals(self):
+        # Return whether this code, and the code nested within it, only reads
+        # the globals of its module, and doesn't access them as a dict.
+        if self.code_kind != MP_CODE_BYTECODE:
+            return False
+        bc = self.fun_data
+        ip = self.offset_opcodes
+        while ip < len(bc):
+            op = bc[ip]
+            fmt, sz, arg, _ = mp_opcode_decode(bc, ip)
+            ip += sz
+            if op in (Opcode.MP_BC_STORE_GLOBAL, Opcode.MP_BC_DELETE_GLOBAL):
+                return False
+            if op in (Opcode.MP_BC_LOAD_NAME, Opcode.MP_BC_LOAD_GLOBAL):
+                if self.qstr_table[arg].str in ("globals", "exec", "eval", "execfile"):
+                    return False
+        return all(rc.uses_only_static_globals() for rc in self.children)
+
     def freeze_children(self, prelude_ptr=None):
         # Freeze children and generate table of children.
         if len(self.children):
@@ -1397,6 +1653,10 @@ def disassemble_mpy(compiled_modules):
 
 
 def freeze_mpy(firmware_qstr_idents, compiled_modules):
+    # find modules that can have their globals in ROM, which may add qstrs
+    for cm in compiled_modules:
+        cm.analyse_rom_globals()
+
     # add to qstrs
     new = {}
     for q in global_qstrs.qstrs:
@@ -1410,6 +1670,7 @@ def freeze_mpy(firmware_qstr_idents, compiled_modules):
     print('#include "py/mpconfig.h"')
     print('#include "py/objint.h"')
     print('#include "py/objstr.h"')
+    print('#include "py/objfun.h"')
     print('#include "py/emitglue.h"')
     print('#include "py/nativeglue.h"')
     print()
@@ -1419,6 +1680,16 @@ def freeze_mpy(firmware_qstr_idents, compiled_modules):
     print("#endif")
     print()
 
+    if any(cm.rom_globals is not None for cm in compiled_modules):
+        # The ROM globals dicts are hash tables laid out using the qstr hashes.
+        print(
+            "#if MICROPY_MODULE_FROZEN_ROM_GLOBALS && MICROPY_QSTR_BYTES_IN_HASH != %u"
+            % config.MICROPY_QSTR_BYTES_IN_HASH
+        )
+        print('#error "incompatible MICROPY_QSTR_BYTES_IN_HASH"')
+        print("#endif")
+        print()
+
     if config.MICROPY_LONGINT_IMPL == config.MICROPY_LONGINT_IMPL_MPZ:
         print("#if MPZ_DIG_SIZE != %u" % config.MPZ_DIG_SIZE)
         print('#error "incompatible MPZ_DIG_SIZE"')